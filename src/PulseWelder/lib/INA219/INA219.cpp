@@ -3,6 +3,8 @@
 * Jan-14-2020: Improved response time, by hogthrob for Sparky Welding Project.
 *   Added arduino.h to supress _delay() warnings.
 *   Fixed math in INA219::calibrate() to support shunt values less than 0.001 ohms.
+* Oct-16-2026: Modified for the I2C Engine: Optional transport hooks (setTransport) and currentFromRaw().
+*   Register reads use a repeated start instead of a separate pointer write.
 *
 * TI INA219 hi-side i2c current/power monitor Library
 *
@@ -43,13 +45,25 @@
 #include <Arduino.h>
 
 
-INA219::INA219(): last_addr(-1) {
+INA219::INA219(): last_addr(-1), write_fn(NULL), read_fn(NULL) {
+}
+
+
+// install transport hooks. Both must be provided, otherwise Wire is used.
+void INA219::setTransport(INA219WriteFn wr, INA219ReadFn rd)
+{
+  if (wr != NULL && rd != NULL) {
+    write_fn = wr;
+    read_fn = rd;
+  }
 }
 
 
 void INA219::begin(uint8_t addr)
 {
-  Wire.begin();
+  if (write_fn == NULL) {
+    Wire.begin();
+  }
   i2c_address = addr;
   gain = D_GAIN;
   last_addr = -1;
@@ -159,6 +173,12 @@ float INA219::shuntCurrent()
   return (read16(I_SHUNT_R) * current_lsb);
 }
 
+// converts a raw shunt current register value to amps
+float INA219::currentFromRaw(int16_t raw)
+{
+  return (raw * current_lsb);
+}
+
 // returns the bus power in watts
 float INA219::busPower()
 {
@@ -176,6 +196,14 @@ void INA219::write16(uint8_t a, uint16_t d) {
   uint8_t temp;
   temp = (uint8_t)d;
   d >>= 8;
+
+  if (write_fn != NULL) {
+    uint8_t buf[3] = { a, (uint8_t)d, temp };
+    last_addr = a;
+    write_fn(i2c_address, buf, 3);
+    return;
+  }
+
   Wire.beginTransmission(i2c_address); // start transmission to device
   last_addr = a;
 
@@ -196,6 +224,13 @@ void INA219::write16(uint8_t a, uint16_t d) {
 int16_t INA219::read16(uint8_t a) {
   uint16_t ret;
 
+  if (read_fn != NULL) {
+    uint8_t buf[2] = { 0, 0 };
+    read_fn(i2c_address, a, buf, 2); // pointer write, repeated start, 2 data bytes
+    last_addr = a;
+    return (int16_t)((buf[0] << 8) | buf[1]);
+  }
+
   if (last_addr != a) {
     // move the pointer to reg. of interest, null argument
     write16(a, 0);
@@ -5,6 +5,8 @@
 *
 * 6 May 2012 by John De Cristofaro
 * Jan-14-2020: Improved response time, by hogthrob for Sparky Welding Project.
+* Oct-16-2026: Modified for the I2C Engine: Optional transport hooks (setTransport) and currentFromRaw().
+*              Allows the device to be serviced by a queued I2C engine instead of Wire.
 *
 *
 * Tested at standard i2c 100kbps signaling rate.
@@ -90,6 +92,11 @@
 #define D_V_SHUNT_MAX		0.3
 #define D_I_MAX_EXPECTED	1
 
+// Optional transport hooks. When installed with setTransport() the Wire library is not used.
+// Each returns true if the device acknowledged the transaction.
+typedef bool (*INA219WriteFn)(uint8_t i2c_addr, const uint8_t *data, uint8_t len);           // Write len bytes.
+typedef bool (*INA219ReadFn)(uint8_t i2c_addr, uint8_t reg, uint8_t *data, uint8_t len);     // Set pointer, repeated start, read.
+
 
 class INA219
 {
@@ -99,6 +106,9 @@ class INA219
 	// by default uses addr = 0x40 (both a-pins tied low)
 	void begin(uint8_t addr = D_I2C_ADDRESS);
 
+	// install transport hooks, call before begin()
+	void setTransport(INA219WriteFn write_fn, INA219ReadFn read_fn);
+
 	void calibrate(float r_shunt = D_SHUNT, float v_shunt_max = D_V_SHUNT_MAX, float v_bus_max = D_V_BUS_MAX, float i_max_expected = D_I_MAX_EXPECTED);
 
 	void configure(uint8_t range = D_RANGE, uint8_t gain = D_GAIN, uint8_t bus_adc = D_BUS_ADC, uint8_t shunt_adc = D_SHUNT_ADC, uint8_t mode = D_MODE);
@@ -112,6 +122,9 @@ class INA219
 	float shuntCurrent();
 	float busPower();
 
+	// converts a raw I_SHUNT_R register value (read elsewhere) to amps
+	float currentFromRaw(int16_t raw);
+
 
   private:
 	uint8_t i2c_address;
@@ -123,6 +136,9 @@ class INA219
 
 	int last_addr;
 
+	INA219WriteFn write_fn;
+	INA219ReadFn read_fn;
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,198 @@
+/*
+   File: Arduino.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. PC (Linux) stand-in for the Arduino core, used by the controller core simulator (ctrlSim.cpp). It only has the
+      parts used by the controller core files and the INA219 library: Types, String, Serial, and the timing functions.
+   2. millis(), micros(), and delay() use the simulated clock (halSim.cpp), not the PC clock. delay() advances it.
+   3. The critical section and mutex macros do nothing; The simulator runs the Control Task and I2C Engine in one
+      thread.
+   4. Serial output goes to stdout. Each line starts with the simulated time, in seconds. Set Serial.echo = false to
+      discard it (fast regression runs).
+ */
+#ifndef __ARDUINO_SIM_H__
+#define __ARDUINO_SIM_H__
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define ARDUINO 10805
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x02
+#define INPUT_PULLUP 0x05
+#define LED_BUILTIN 5
+#define DEC 10
+#define HEX 16
+#define BIN 2
+#define IRAM_ATTR
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef uint8_t byte;
+typedef int     portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portMAX_DELAY 0xffffffff
+
+typedef void *SemaphoreHandle_t;
+
+#define xSemaphoreCreateMutex() ((SemaphoreHandle_t)(1))
+#define xSemaphoreTake(sem, ticks) ((void)(sem), (void)(ticks), 1)
+#define xSemaphoreGive(sem) ((void)(sem), 1)
+
+// Arduino String, on top of std::string.
+class String {
+public:
+
+  String(void) {}
+  String(const char *s) : str(s == NULL ? "" : s) {}
+  String(const std::string& s) : str(s) {}
+  String(char c) : str(1, c) {}
+  String(unsigned char value, unsigned char base = DEC) : str(fromInt(value, base)) {}
+  String(int value, unsigned char base = DEC) : str(fromInt(value, base)) {}
+  String(unsigned int value, unsigned char base = DEC) : str(fromInt(value, base)) {}
+  String(long value, unsigned char base = DEC) : str(fromInt(value, base)) {}
+  String(unsigned long value, unsigned char base = DEC) : str(fromInt(value, base)) {}
+  String(long long value, unsigned char base = DEC) : str(fromInt(value, base)) {}
+  String(unsigned long long value, unsigned char base = DEC) : str(fromInt(value, base)) {}
+  String(float value, unsigned char decimals = 2) : str(fromFloat(value, decimals)) {}
+  String(double value, unsigned char decimals = 2) : str(fromFloat(value, decimals)) {}
+
+  const char* c_str(void) const           { return str.c_str(); }
+  unsigned int length(void) const         { return (unsigned int)(str.length()); }
+  char charAt(unsigned int idx) const     { return idx < str.length() ? str[idx] : 0; }
+  bool startsWith(const String& s) const  { return str.compare(0, s.str.length(), s.str) == 0; }
+  bool endsWith(const String& s) const
+  {
+    return (str.length() >= s.str.length()) && (str.compare(str.length() - s.str.length(), s.str.length(), s.str) == 0);
+  }
+
+  int indexOf(char c, unsigned int from = 0) const
+  {
+    size_t pos = str.find(c, from);
+
+    return pos == std::string::npos ? -1 : (int)(pos);
+  }
+
+  String substring(unsigned int from) const { return from < str.length() ? String(str.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const
+  {
+    return from < str.length() && to > from ? String(str.substr(from, to - from)) : String();
+  }
+
+  long toInt(void) const                  { return strtol(str.c_str(), NULL, 10); }
+  float toFloat(void) const               { return strtof(str.c_str(), NULL); }
+  void toLowerCase(void)                  { for (size_t i = 0; i < str.length(); i++) str[i] = (char)(tolower(str[i])); }
+  void trim(void)
+  {
+    size_t first = str.find_first_not_of(" \t\r\n");
+    size_t last  = str.find_last_not_of(" \t\r\n");
+
+    str = first == std::string::npos ? std::string() : str.substr(first, last - first + 1);
+  }
+
+  String& operator+=(const String& s)     { str += s.str; return *this; }
+  bool operator==(const String& s) const  { return str == s.str; }
+  bool operator!=(const String& s) const  { return str != s.str; }
+  friend String operator+(const String& a, const String& b) { return String(a.str + b.str); }
+
+private:
+
+  static std::string fromInt(long long value, unsigned char base)
+  {
+    char buf[72];
+
+    if (base == DEC) {
+      snprintf(buf, sizeof(buf), "%lld", value);
+    }
+    else {
+      snprintf(buf, sizeof(buf), base == HEX ? "%llx" : "%llo", (unsigned long long)(value));
+    }
+    return buf;
+  }
+
+  static std::string fromInt(unsigned long long value, unsigned char base)
+  {
+    char buf[72];
+
+    snprintf(buf, sizeof(buf), base == HEX ? "%llx" : base == DEC ? "%llu" : "%llo", value);
+    return buf;
+  }
+
+  static std::string fromInt(int value, unsigned char base)           { return fromInt((long long)(value), base); }
+  static std::string fromInt(long value, unsigned char base)          { return fromInt((long long)(value), base); }
+  static std::string fromInt(unsigned int value, unsigned char base)  { return fromInt((unsigned long long)(value), base); }
+  static std::string fromInt(unsigned long value, unsigned char base) { return fromInt((unsigned long long)(value), base); }
+  static std::string fromInt(unsigned char value, unsigned char base) { return fromInt((unsigned long long)(value), base); }
+
+  static std::string fromFloat(double value, unsigned char decimals)
+  {
+    char buf[64];
+
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    return buf;
+  }
+
+  std::string str;
+};
+
+// Serial Log port, written to stdout.
+class SimSerial {
+public:
+
+  bool echo = true; // Lines are written to stdout.
+
+  void begin(unsigned long baud)              { (void)(baud); }
+  int  available(void)                        { return 0; }
+  int  availableForWrite(void)                { return 4096; }
+  int  read(void)                             { return -1; }
+  void flush(void)                            { fflush(stdout); }
+  void print(const String& s);
+  void println(const String& s)               { print(s); print(String("\n")); }
+  void println(void)                          { print(String("\n")); }
+  void print(const char *s)                   { print(String(s)); }
+  void println(const char *s)                 { println(String(s)); }
+  template<class T> void print(T value)       { print(String(value)); }
+  template<class T> void println(T value)     { println(String(value)); }
+  template<class T> void print(T value, int base)   { print(String(value, (unsigned char)(base))); }
+  template<class T> void println(T value, int base) { println(String(value, (unsigned char)(base))); }
+
+private:
+
+  bool lineStart = true; // Next character starts a new line.
+};
+
+extern SimSerial Serial;
+
+unsigned long millis(void);
+unsigned long micros(void);
+void          delay(unsigned long ms);
+void          delayMicroseconds(unsigned int us);
+void          pinMode(uint8_t pin, uint8_t mode);
+void          digitalWrite(uint8_t pin, uint8_t val);
+int           digitalRead(uint8_t pin);
+long          map(long x, long inMin, long inMax, long outMin, long outMax);
+
+#endif // ifndef __ARDUINO_SIM_H__
+
+// EOF
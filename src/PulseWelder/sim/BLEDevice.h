@@ -0,0 +1,33 @@
+/*
+   File: BLEDevice.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. PC stand-in for the ESP32 BLE library. Only the types used by the PulseWelder.h prototypes are declared; The
+      Bluetooth FOB code is not part of the controller core simulator.
+ */
+#ifndef __BLE_DEVICE_SIM_H__
+#define __BLE_DEVICE_SIM_H__
+
+#include <Arduino.h>
+
+class BLEAddress {
+public:
+
+  BLEAddress(const char *addr) { (void)(addr); }
+};
+
+class BLEAdvertisedDevice {};
+
+#endif // ifndef __BLE_DEVICE_SIM_H__
+
+// EOF
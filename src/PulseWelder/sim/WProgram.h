@@ -0,0 +1,24 @@
+/*
+   File: WProgram.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. The INA219 library tests ARDUINO before it includes Arduino.h, so on the PC it asks for the pre-1.0 header.
+ */
+#ifndef __WPROGRAM_SIM_H__
+#define __WPROGRAM_SIM_H__
+
+#include <Arduino.h>
+
+#endif // ifndef __WPROGRAM_SIM_H__
+
+// EOF
@@ -0,0 +1,62 @@
+/*
+   File: Wire.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. PC stand-in for the Arduino Wire library, on the virtual bus (simBus.h). Code that uses Wire directly (the
+      INA219 library without transport hooks) reaches the device models as on hardware. Each transaction advances
+      the simulated time by its bus time. The controller core uses the I2C Engine instead.
+   2. endTransmission() returns 0 (ACK) or 2 (address NACK). requestFrom() returns the number of bytes read, 0 for a
+      NACK.
+ */
+#ifndef __WIRE_SIM_H__
+#define __WIRE_SIM_H__
+
+#include <Arduino.h>
+
+#define WIRE_BUFFER_LEN 32
+
+class TwoWire {
+public:
+
+  bool    begin(void)                       { return true; }
+  void    beginTransmission(uint8_t addr)   { txAddr = addr; txLen = 0; }
+  size_t  write(uint8_t data)
+  {
+    if (txLen >= WIRE_BUFFER_LEN) {
+      return 0;
+    }
+    txBuf[txLen++] = data;
+    return 1;
+  }
+
+  uint8_t endTransmission(bool stop = true);
+  uint8_t requestFrom(int addr,
+                      int len);
+  int     available(void)                   { return rxLen - rxPos; }
+  int     read(void)                        { return rxPos < rxLen ? rxBuf[rxPos++] : -1; }
+
+private:
+
+  uint8_t txAddr = 0;
+  uint8_t txBuf[WIRE_BUFFER_LEN];
+  uint8_t txLen = 0;
+  uint8_t rxBuf[WIRE_BUFFER_LEN];
+  uint8_t rxLen = 0;
+  uint8_t rxPos = 0;
+};
+
+extern TwoWire Wire;
+
+#endif // ifndef __WIRE_SIM_H__
+
+// EOF
@@ -0,0 +1,128 @@
+/*
+   File: arduinoSim.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. PC implementation of the Arduino stand-in (Arduino.h, Wire.h in this folder). See ctrlSim.cpp for the build.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "simBus.h"
+#include "../src/hal.h"
+
+SimSerial Serial;
+TwoWire   Wire;
+
+// *********************************************************************************************
+// Write text to stdout, with the simulated time at the start of each line.
+void SimSerial::print(const String& s)
+{
+  const char *p = s.c_str();
+
+  if (!echo) {
+    return;
+  }
+
+  for (; *p != 0; p++) {
+    if (lineStart) {
+      printf("%10.4f  ", halSimSeconds());
+      lineStart = false;
+    }
+    putchar(*p);
+    lineStart = *p == '\n';
+  }
+}
+
+// *********************************************************************************************
+unsigned long millis(void)
+{
+  return halMillis();
+}
+
+// *********************************************************************************************
+unsigned long micros(void)
+{
+  return halMicros();
+}
+
+// *********************************************************************************************
+// Advances the simulated clock (the device models keep running).
+void delay(unsigned long ms)
+{
+  halSimAdvance(ms * 1000UL);
+}
+
+// *********************************************************************************************
+void delayMicroseconds(unsigned int us)
+{
+  halSimAdvance(us);
+}
+
+// *********************************************************************************************
+// GPIO is not used by the controller core (see hal.h); These only satisfy the INA219 library and other callers.
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  (void)(pin);
+  (void)(mode);
+}
+
+// *********************************************************************************************
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  (void)(pin);
+  (void)(val);
+}
+
+// *********************************************************************************************
+int digitalRead(uint8_t pin)
+{
+  (void)(pin);
+  return HIGH;
+}
+
+// *********************************************************************************************
+// Write the buffered bytes (beginTransmission(), write()) to the virtual bus. txLen = 0 is an address probe.
+// On exit, returns 0 if the device acknowledged, else 2 (address NACK).
+uint8_t TwoWire::endTransmission(bool stop)
+{
+  bool ack = simBus.i2cXfer(txAddr, txBuf, txLen, NULL, 0);
+
+  (void)(stop);
+  halSimAdvance(SimBus::i2cTimeUs(txLen, 0));
+  txLen = 0;
+
+  return ack ? 0 : 2;
+}
+
+// *********************************************************************************************
+// Read len bytes from a device. On exit, returns the number of bytes read (0 for a NACK).
+uint8_t TwoWire::requestFrom(int addr, int len)
+{
+  bool ack;
+
+  len   = constrain(len, 0, WIRE_BUFFER_LEN);
+  ack   = simBus.i2cXfer((uint8_t)(addr), NULL, 0, rxBuf, (uint8_t)(len));
+  rxPos = 0;
+  rxLen = ack ? (uint8_t)(len) : 0;
+  halSimAdvance(SimBus::i2cTimeUs(0, (uint8_t)(len)));
+
+  return rxLen;
+}
+
+// *********************************************************************************************
+long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// EOF
@@ -0,0 +1,257 @@
+/*
+   File: ina219Model.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Register-level INA219 model, see ina219Model.h.
+ */
+
+#include <Arduino.h>
+#include "INA219.h"
+#include "ina219Model.h"
+
+#define INA_CNVR 0x0002        // Conversion Ready, Bus Voltage register.
+#define INA_OVF 0x0001         // Math Overflow, Bus Voltage register.
+#define INA_SHUNT_LSB 0.00001f // Shunt Voltage register LSB, in Volts.
+#define INA_BUS_LSB 0.004f     // Bus Voltage LSB, in Volts.
+#define INA_SHUNT_FS 4000      // Shunt Voltage full scale at PGA /1 (40mV), in counts.
+
+// *********************************************************************************************
+Ina219Model::Ina219Model(void)
+{
+  shuntIn = 0;
+  busIn   = 0;
+  clearFaults();
+  reset();
+}
+
+// *********************************************************************************************
+// Power-on reset (also the RST bit). All registers return to their defaults.
+void Ina219Model::reset(void)
+{
+  memset(regs, 0, sizeof(regs));
+  regs[CONFIG_R] = CONFIG_DEFAULT;
+  pointer        = 0;
+  phaseUs        = 0;
+  shuntSum       = 0;
+  busSum         = 0;
+  busy           = true; // Default mode is continuous shunt and bus.
+  convCnt        = 0;
+}
+
+// *********************************************************************************************
+// Set the analog inputs: Shunt (IN+ to IN-) and Bus (IN- to GND) Volts.
+void Ina219Model::setInputs(float shuntVolts, float busVolts)
+{
+  shuntIn = shuntVolts;
+  busIn   = busVolts;
+}
+
+// *********************************************************************************************
+// On exit, returns the conversion time for a 4 bit ADC setting (BADC or SADC field), in uS.
+uint32_t Ina219Model::adcTimeUs(uint8_t adc)
+{
+  static const uint32_t avgUs[8] = { 532, 1060, 2130, 4260, 8510, 17020, 34050, 68100 };
+  static const uint32_t resUs[4] = { 84, 148, 276, 532 };
+
+  return adc & 0x08 ? avgUs[adc & 0x07] : resUs[adc & 0x03];
+}
+
+// *********************************************************************************************
+// On exit, returns the time for one conversion in the configured mode (shunt plus bus), in uS. Zero if none.
+uint32_t Ina219Model::convTimeUs(void) const
+{
+  uint8_t mode = regs[CONFIG_R] & 0x07;
+
+  return (mode & 0x01 ? adcTimeUs((regs[CONFIG_R] >> SADC1) & 0x0f) : 0) +
+         (mode & 0x02 ? adcTimeUs((regs[CONFIG_R] >> BADC1) & 0x0f) : 0);
+}
+
+// *********************************************************************************************
+// Run the ADC for us. A conversion's input is integrated over its conversion time.
+void Ina219Model::step(uint32_t us)
+{
+  uint8_t  mode    = regs[CONFIG_R] & 0x07;
+  uint32_t shuntUs = mode & 0x01 ? adcTimeUs((regs[CONFIG_R] >> SADC1) & 0x0f) : 0;
+  uint32_t totalUs = convTimeUs();
+  uint32_t n;
+
+  while (busy && (us > 0)) {
+    if (totalUs == 0) {
+      busy = false;
+      break;
+    }
+
+    if (phaseUs < shuntUs) {
+      n         = min(us, shuntUs - phaseUs);
+      shuntSum += (double)(shuntIn) * n;
+    }
+    else {
+      n       = min(us, totalUs - phaseUs);
+      busSum += (double)(busIn) * n;
+    }
+    phaseUs += n;
+    us      -= n;
+
+    if (phaseUs >= totalUs) {
+      finishConversion();
+      phaseUs  = 0;
+      shuntSum = 0;
+      busSum   = 0;
+      busy     = (mode & 0x04) != 0; // Continuous modes start again; Triggered modes stop.
+    }
+  }
+}
+
+// *********************************************************************************************
+// Update the result registers at the end of a conversion, and set CNVR.
+void Ina219Model::finishConversion(void)
+{
+  uint16_t cfg   = regs[CONFIG_R];
+  uint8_t  mode  = cfg & 0x07;
+  uint8_t  sadc  = (cfg >> SADC1) & 0x0f;
+  uint8_t  badc  = (cfg >> BADC1) & 0x0f;
+  int32_t  limit = INA_SHUNT_FS << ((cfg >> PG0) & 0x03);
+  int32_t  busFs = cfg & (1 << BRNG) ? 8000 : 4000; // 32V or 16V range, in 4mV counts.
+  uint32_t shuntUs;
+  int32_t  shunt;
+  int32_t  bus;
+  int32_t  current;
+  uint32_t power;
+  bool     ovf = false;
+
+  if (mode & 0x01) {
+    shuntUs = adcTimeUs(sadc);
+    shunt   = lround(shuntSum / shuntUs / INA_SHUNT_LSB);
+    shunt   = constrain(shunt, -limit, limit);
+
+    if ((sadc & 0x08) == 0) {                      // 9 to 11 bits: Low bits are lost.
+      shunt = (shunt >> (3 - (sadc & 0x03))) << (3 - (sadc & 0x03));
+    }
+    regs[V_SHUNT_R] = (uint16_t)(shunt);
+  }
+
+  bus = regs[V_BUS_R] >> 3;
+
+  if (mode & 0x02) {
+    bus = lround(busSum / adcTimeUs(badc) / INA_BUS_LSB);
+    bus = constrain(bus, 0, busFs);
+
+    if ((badc & 0x08) == 0) {
+      bus = (bus >> (3 - (badc & 0x03))) << (3 - (badc & 0x03));
+    }
+  }
+
+  current = ((int32_t)((int16_t)(regs[V_SHUNT_R])) * regs[CAL_R]) / 4096;
+
+  if ((current > INT16_MAX) || (current < INT16_MIN)) {
+    ovf     = true;
+    current = constrain(current, (int32_t)(INT16_MIN), (int32_t)(INT16_MAX));
+  }
+  power = (uint32_t)(labs(current)) * (uint32_t)(bus) / 5000;
+
+  if (power > UINT16_MAX) {
+    ovf   = true;
+    power = UINT16_MAX;
+  }
+
+  regs[I_SHUNT_R] = (uint16_t)(current);
+  regs[P_BUS_R]   = (uint16_t)(power);
+  regs[V_BUS_R]   = (uint16_t)((bus << 3) | INA_CNVR | (ovf ? INA_OVF : 0));
+  convCnt++;
+}
+
+// *********************************************************************************************
+// Register write. The result registers are read-only.
+void Ina219Model::writeReg(uint8_t addr, uint16_t data)
+{
+  if ((addr >= INA_MODEL_REGS) || stuck[addr]) {
+    return;
+  }
+
+  if (addr == CONFIG_R) {
+    if (data & (1 << RST)) {
+      reset();
+      return;
+    }
+    regs[CONFIG_R]  = data & 0x3fff;
+    regs[V_BUS_R]  &= ~INA_CNVR;
+    phaseUs         = 0; // Conversion restarts (triggered modes: starts).
+    shuntSum        = 0;
+    busSum          = 0;
+    busy            = (data & 0x03) != 0;
+  }
+  else if (addr == CAL_R) {
+    regs[CAL_R] = data & 0xfffe;
+  }
+}
+
+// *********************************************************************************************
+// I2C transaction: Pointer byte, optional 16 bit write data; Read returns the pointer register, MSB first.
+// On exit, returns true (the INA219 acknowledges every byte).
+bool Ina219Model::i2cXfer(const uint8_t *tx, uint8_t txLen, uint8_t *rx, uint8_t rxLen)
+{
+  uint16_t value;
+
+  if (txLen > 0) {
+    pointer = tx[0];
+  }
+
+  if (txLen >= 3) {
+    writeReg(pointer, (uint16_t)((tx[1] << 8) | tx[2]));
+  }
+
+  if (rxLen > 0) {
+    value = reg(pointer);
+
+    if (pointer == P_BUS_R) {
+      regs[V_BUS_R] &= ~INA_CNVR;
+    }
+
+    for (uint8_t i = 0; i < rxLen; i++) {
+      rx[i] = i == 0 ? value >> 8 : i == 1 ? value & 0xff : 0xff;
+    }
+  }
+
+  return true;
+}
+
+// *********************************************************************************************
+// On exit, returns what a register reads (no side effects). Unused pointer values read zero.
+uint16_t Ina219Model::reg(uint8_t addr) const
+{
+  if (addr >= INA_MODEL_REGS) {
+    return 0;
+  }
+
+  return stuck[addr] ? stuckVal[addr] : regs[addr];
+}
+
+// *********************************************************************************************
+// Fault injection: The register reads value from now on; Writes to it are lost.
+void Ina219Model::stickRegister(uint8_t addr, uint16_t value)
+{
+  if (addr < INA_MODEL_REGS) {
+    stuck[addr]    = true;
+    stuckVal[addr] = value;
+  }
+}
+
+// *********************************************************************************************
+// Remove the register faults.
+void Ina219Model::clearFaults(void)
+{
+  memset(stuck, 0, sizeof(stuck));
+  memset(stuckVal, 0, sizeof(stuckVal));
+}
+
+// EOF
@@ -0,0 +1,82 @@
+/*
+   File: ina219Model.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Register-level model of the TI INA219 Current Sensor, for the virtual bus (simBus.h). Registers 00h to 05h
+      with the datasheet bit layouts and reset values. Writing RST resets every register; Bit 14 of the
+      Configuration and bit 0 of the Calibration read as zero.
+   2. Modes 0 to 7: Power-down, triggered (single conversion started by a Configuration write), ADC off, and
+      continuous. The shunt conversion runs first, then the bus conversion; The result registers and CNVR are updated
+      when both (as selected by the mode) are done. The conversion time comes from the SADC/BADC fields: 84 to 532uS
+      for 9 to 12 bits, 1.06 to 68.1mS for 2 to 128 sample averaging.
+   3. Each conversion is the average input over its conversion time (the ADC integrates). 9 to 11 bit results lose
+      the low bits. The Shunt Voltage saturates at the PGA range. Current = Shunt * Cal / 4096, Power = Current *
+      Bus / 5000. OVF is set if the Current or Power is out of range. Reading the Power register clears CNVR, as does
+      a Configuration write.
+   4. An I2C write sets the register pointer (first byte) and, with two more bytes, writes the register. A read
+      returns the pointer register, MSB first. The INA219 library's Wire read16() writes zero to a register to move
+      the pointer; The model does the same as the chip (the firmware uses the transport hooks instead).
+   5. Fault injection: stickRegister() freezes what a register reads (writes are lost).
+ */
+#ifndef __INA219_MODEL_H__
+#define __INA219_MODEL_H__
+
+#include "simBus.h"
+
+#define INA_MODEL_REGS 6 // Registers 00h to 05h.
+
+class Ina219Model : public SimDevice {
+public:
+
+  Ina219Model(void);
+
+  bool        i2cXfer(const uint8_t *tx,
+                      uint8_t        txLen,
+                      uint8_t       *rx,
+                      uint8_t        rxLen);
+  void        step(uint32_t us);
+  const char* name(void) const { return "INA219"; }
+
+  void        reset(void);
+  void        setInputs(float shuntVolts,
+                        float busVolts);
+  uint16_t    reg(uint8_t addr) const;
+  uint32_t    convTimeUs(void) const;
+  uint32_t    conversions(void) const { return convCnt; }
+  void        stickRegister(uint8_t  addr,
+                            uint16_t value);
+  void        clearFaults(void);
+
+private:
+
+  static uint32_t adcTimeUs(uint8_t adc);
+  void            writeReg(uint8_t  addr,
+                           uint16_t data);
+  void            finishConversion(void);
+
+  uint16_t regs[INA_MODEL_REGS];     // Register contents.
+  bool     stuck[INA_MODEL_REGS];    // Register is frozen (fault injection).
+  uint16_t stuckVal[INA_MODEL_REGS]; // Value read from a frozen register.
+  uint8_t  pointer;                  // Register pointer.
+  float    shuntIn;                  // Shunt input, in Volts.
+  float    busIn;                    // Bus input, in Volts.
+  double   shuntSum;                 // Shunt input totalizer for the conversion in progress, in Volt-uS.
+  double   busSum;                   // Bus input totalizer for the conversion in progress, in Volt-uS.
+  uint32_t phaseUs;                  // Time into the conversion in progress, in uS.
+  bool     busy;                     // A conversion is in progress.
+  uint32_t convCnt;                  // Completed conversions.
+};
+
+#endif // ifndef __INA219_MODEL_H__
+
+// EOF
@@ -0,0 +1,201 @@
+/*
+   File: mcpPotModel.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Register-level MCP4xHV51 Digital Pot model, see mcpPotModel.h.
+ */
+
+#include <Arduino.h>
+#include "mcpPotModel.h"
+#include "../src/digPot.h"
+
+#define MCP_SDO_OK 0xff  // SPI command byte response, valid Write/Increment/Decrement.
+#define MCP_SDO_RD 0xfe  // SPI command byte response, valid Read (D8 = 0).
+#define MCP_SDO_ERR 0xfd // SPI response, CMDERR (bit 1) low.
+#define MCP_WIPER_POR 0x80
+
+// *********************************************************************************************
+McpPotModel::McpPotModel(void)
+{
+  clearFaults();
+  reset();
+}
+
+// *********************************************************************************************
+// Power-on reset: Wiper at mid scale, all terminals connected.
+void McpPotModel::reset(void)
+{
+  wiper    = MCP_WIPER_POR;
+  tcon     = POT_TCON_DEF;
+  readAddr = POT_WIPER_ADDR;
+  wiperCnt = 0;
+}
+
+// *********************************************************************************************
+// On exit, returns the register for a memory address (command byte form, AD3:AD0 in the upper bits), else NULL.
+uint8_t *McpPotModel::regPtr(uint8_t memAddr)
+{
+  if ((memAddr & 0xf0) == POT_WIPER_ADDR) {
+    return &wiper;
+  }
+  else if ((memAddr & 0xf0) == POT_TCON_ADDR) {
+    return &tcon;
+  }
+
+  return NULL;
+}
+
+// *********************************************************************************************
+// On exit, returns the command length in bytes: 1 for Increment and Decrement, else 2.
+int McpPotModel::cmdLength(uint8_t cmd) const
+{
+  return ((cmd & 0x0c) == POT_INC_CMD) || ((cmd & 0x0c) == POT_DEC_CMD) ? 1 : 2;
+}
+
+// *********************************************************************************************
+// On exit, returns true if the command byte is valid (existing register; Increment and Decrement only for the Wiper).
+bool McpPotModel::validCmd(uint8_t cmd)
+{
+  if (regPtr(cmd) == NULL) {
+    return false;
+  }
+
+  return cmdLength(cmd) == 2 || (cmd & 0xf0) == POT_WIPER_ADDR;
+}
+
+// *********************************************************************************************
+// Execute a valid command. data is the Write data; A Read returns the register in readData.
+void McpPotModel::command(uint8_t cmd, uint8_t data, uint8_t *readData)
+{
+  uint8_t *reg    = regPtr(cmd);
+  bool     frozen = reg == &wiper ? wiperStuck : tconStuck;
+  uint8_t  before = wiper;
+
+  switch (cmd & 0x0c) {
+    case POT_WR_CMD:
+      *reg = frozen ? *reg : cmd & 0x01 ? 0xff : data; // D8 set is full scale on the 8 bit part.
+      break;
+
+    case POT_INC_CMD:
+      *reg = frozen || (*reg == 0xff) ? *reg : *reg + 1;
+      break;
+
+    case POT_DEC_CMD:
+      *reg = frozen || (*reg == 0x00) ? *reg : *reg - 1;
+      break;
+
+    case POT_RD_CMD:
+      *readData = *reg;
+      readAddr  = cmd & 0xf0;
+      break;
+  }
+
+  wiperCnt += wiper != before ? 1 : 0;
+}
+
+// *********************************************************************************************
+// MCP41HV51 SPI frame. Each command byte responds with the CMDERR status, see mcpPotModel.h.
+void McpPotModel::spiXfer(const uint8_t *tx, uint8_t *rx, size_t len)
+{
+  uint8_t resp[2];
+  uint8_t data;
+  bool    err = false;
+  size_t  i   = 0;
+  size_t  n;
+
+  while (i < len) {
+    n       = err ? 1 : cmdLength(tx[i]);
+    resp[0] = MCP_SDO_ERR;
+    resp[1] = MCP_SDO_ERR;
+
+    if (!err && validCmd(tx[i])) {
+      resp[0] = (tx[i] & 0x0c) == POT_RD_CMD ? MCP_SDO_RD : MCP_SDO_OK;
+      resp[1] = MCP_SDO_OK;
+      data    = 0;
+
+      if (i + n <= len) {                // A 16 bit command cut short by CS is not executed.
+        command(tx[i], n == 2 ? tx[i + 1] : 0, &data);
+        resp[1] = (tx[i] & 0x0c) == POT_RD_CMD ? data : MCP_SDO_OK;
+      }
+    }
+    else {
+      err = true; // Ignored until CS goes high.
+      n   = 1;
+    }
+
+    for (size_t j = 0; (j < n) && (i + j < len); j++) {
+      if (rx != NULL) {
+        rx[i + j] = resp[j];
+      }
+    }
+    i += n;
+  }
+}
+
+// *********************************************************************************************
+// MCP45HV51 I2C transaction: Commands, then (repeated start) read. A zero length transaction is an address probe.
+// On exit, returns false if a command byte was not acknowledged (invalid command).
+bool McpPotModel::i2cXfer(const uint8_t *tx, uint8_t txLen, uint8_t *rx, uint8_t rxLen)
+{
+  uint8_t data;
+  uint8_t i = 0;
+  int     n;
+
+  while (i < txLen) {
+    if (!validCmd(tx[i])) {
+      return false; // NACK; The earlier commands in this transaction were executed.
+    }
+    n = cmdLength(tx[i]);
+
+    if ((n == 1) || (i + 1 < txLen) || ((tx[i] & 0x0c) == POT_RD_CMD)) {
+      command(tx[i], i + 1 < txLen ? tx[i + 1] : 0, &data);
+    }
+    i += n;
+  }
+
+  for (uint8_t j = 0; j < rxLen; j++) {
+    rx[j] = j % 2 == 0 ? 0x00 : reg(readAddr);
+  }
+
+  return true;
+}
+
+// *********************************************************************************************
+// On exit, returns a register (command byte form memory address), or 0 for an unused address.
+uint8_t McpPotModel::reg(uint8_t memAddr) const
+{
+  return (memAddr & 0xf0) == POT_WIPER_ADDR ? wiper : (memAddr & 0xf0) == POT_TCON_ADDR ? tcon : 0;
+}
+
+// *********************************************************************************************
+// Fault injection: The register is set to value and frozen there.
+void McpPotModel::stickRegister(uint8_t memAddr, uint8_t value)
+{
+  uint8_t *reg = regPtr(memAddr);
+
+  if (reg != NULL) {
+    *reg        = value;
+    wiperStuck |= reg == &wiper;
+    tconStuck  |= reg == &tcon;
+  }
+}
+
+// *********************************************************************************************
+// Remove the register faults.
+void McpPotModel::clearFaults(void)
+{
+  wiperStuck = false;
+  tconStuck  = false;
+}
+
+// EOF
@@ -0,0 +1,73 @@
+/*
+   File: mcpPotModel.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Register-level model of the Microchip MCP45HV51 (I2C) and MCP41HV51 (SPI) 8 bit Digital Pot, for the virtual
+      bus (simBus.h). Attach it at POT_I2C_ADDR or at the SPI chip select, as on the board.
+   2. Volatile Wiper (00h, power-up 0x80) and TCON (04h, power-up 0xFF) registers. Command byte: AD3:AD0, C1:C0,
+      D9:D8. Write (00) and Read (11) are 16 bit commands (command, data); Increment (01) and Decrement (10) are 8 bit
+      and only valid for the Wiper. Increment stops at 0xFF and Decrement at 0x00. D8 set writes full scale.
+   3. SPI: Commands are decoded from the byte stream while CS is low. During each command byte SDO outputs ones
+      except CMDERR (bit 1), which is zero for an invalid command; For a Read, bit 0 is D8 and the data byte is the
+      register. After an error the rest of the frame is ignored (CMDERR stays low). This is the status bit checked
+      by digitalPotWrite() and digitalPotRead().
+   4. I2C: An invalid command byte is not acknowledged (NACK). A read returns 0x00 (D8) then the register addressed by
+      the last Read command.
+   5. Fault injection: stickRegister() freezes a register (Writes, Increments, and Decrements are lost).
+ */
+#ifndef __MCP_POT_MODEL_H__
+#define __MCP_POT_MODEL_H__
+
+#include "simBus.h"
+
+class McpPotModel : public SimDevice {
+public:
+
+  McpPotModel(void);
+
+  bool        i2cXfer(const uint8_t *tx,
+                      uint8_t        txLen,
+                      uint8_t       *rx,
+                      uint8_t        rxLen);
+  void        spiXfer(const uint8_t *tx,
+                      uint8_t       *rx,
+                      size_t         len);
+  const char* name(void) const { return "MCP4xHV51"; }
+
+  void        reset(void);
+  uint8_t     reg(uint8_t memAddr) const;
+  uint32_t    wiperChanges(void) const { return wiperCnt; }
+  void        stickRegister(uint8_t memAddr,
+                            uint8_t value);
+  void        clearFaults(void);
+
+private:
+
+  uint8_t *regPtr(uint8_t memAddr);
+  int      cmdLength(uint8_t cmd) const;
+  bool     validCmd(uint8_t cmd);
+  void     command(uint8_t  cmd,
+                   uint8_t  data,
+                   uint8_t *readData);
+
+  uint8_t  wiper;      // Volatile Wiper register.
+  uint8_t  tcon;       // TCON register.
+  uint8_t  readAddr;   // Register address of the last Read command (I2C reads).
+  bool     wiperStuck; // Wiper register is frozen (fault injection).
+  bool     tconStuck;  // TCON register is frozen (fault injection).
+  uint32_t wiperCnt;   // Wiper register changes.
+};
+
+#endif // ifndef __MCP_POT_MODEL_H__
+
+// EOF
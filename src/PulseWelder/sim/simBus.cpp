@@ -0,0 +1,272 @@
+/*
+   File: simBus.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. PC virtual I2C and SPI bus, see simBus.h. The bus does not advance the simulated time; The callers (I2C Engine,
+      Wire) account for the bus time.
+ */
+
+#include <Arduino.h>
+#include "simBus.h"
+#include "../src/PulseWelder.h"
+#include "../src/config.h"
+
+SimBus simBus;
+
+// *********************************************************************************************
+// Default I2C access: The device does not acknowledge.
+bool SimDevice::i2cXfer(const uint8_t *tx, uint8_t txLen, uint8_t *rx, uint8_t rxLen)
+{
+  (void)(tx);
+  (void)(txLen);
+  (void)(rx);
+  (void)(rxLen);
+
+  return false;
+}
+
+// *********************************************************************************************
+// Default SPI access: MISO is not driven (reads zeros).
+void SimDevice::spiXfer(const uint8_t *tx, uint8_t *rx, size_t len)
+{
+  (void)(tx);
+
+  if (rx != NULL) {
+    memset(rx, 0, len);
+  }
+}
+
+// *********************************************************************************************
+SimBus::SimBus(void)
+{
+  memset(slots, 0, sizeof(slots));
+  memset(&missing, 0, sizeof(missing));
+}
+
+// *********************************************************************************************
+// On exit, returns the slot of the device at an I2C address (spi = false) or chip select pin, else NULL.
+SimBus::Slot *SimBus::find(bool spi, uint8_t id)
+{
+  for (int i = 0; i < SIM_BUS_SLOTS; i++) {
+    if ((slots[i].dev != NULL) && (slots[i].spi == spi) && (slots[i].id == id)) {
+      return &slots[i];
+    }
+  }
+
+  return NULL;
+}
+
+// *********************************************************************************************
+// On exit, returns false if the address (chip select) is in use or all slots are full.
+bool SimBus::attach(bool spi, uint8_t id, SimDevice *dev)
+{
+  if (find(spi, id) != NULL) {
+    return false;
+  }
+
+  for (int i = 0; i < SIM_BUS_SLOTS; i++) {
+    if (slots[i].dev == NULL) {
+      memset(&slots[i], 0, sizeof(Slot));
+      slots[i].dev = dev;
+      slots[i].spi = spi;
+      slots[i].id  = id;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// *********************************************************************************************
+// Attach a device at a 7 bit I2C address. On exit, returns false if the address is in use.
+bool SimBus::attachI2c(uint8_t addr, SimDevice *dev)
+{
+  return attach(false, addr, dev);
+}
+
+// *********************************************************************************************
+// Attach a device at a SPI chip select pin. On exit, returns false if the pin is in use.
+bool SimBus::attachSpi(uint8_t csPin, SimDevice *dev)
+{
+  return attach(true, csPin, dev);
+}
+
+// *********************************************************************************************
+// Remove a device from the bus (all of its addresses).
+void SimBus::detach(SimDevice *dev)
+{
+  for (int i = 0; i < SIM_BUS_SLOTS; i++) {
+    if (slots[i].dev == dev) {
+      slots[i].dev = NULL;
+    }
+  }
+}
+
+// *********************************************************************************************
+// I2C transaction: Write txLen bytes, then read rxLen bytes. A zero length transaction is an address probe.
+// On exit, returns true if the device acknowledged. A NACK reads all ones (bus pull-ups).
+bool SimBus::i2cXfer(uint8_t addr, const uint8_t *tx, uint8_t txLen, uint8_t *rx, uint8_t rxLen)
+{
+  Slot         *slot   = find(false, addr);
+  SimBusCounts *counts = slot != NULL ? &slot->counts : &missing;
+  bool          ack    = false;
+
+  counts->xfers++;
+  counts->bytes += txLen + rxLen;
+  counts->busUs += i2cTimeUs(txLen, rxLen);
+
+  if (slot != NULL) {
+    slot->seq++;
+
+    if (slot->nackCnt > 0) {
+      slot->nackCnt--;
+    }
+    else if ((slot->nackEvery == 0) || (slot->seq % slot->nackEvery != 0)) {
+      ack = slot->dev->i2cXfer(tx, txLen, rx, rxLen);
+    }
+  }
+
+  if (!ack) {
+    counts->nacks++;
+
+    if (rx != NULL) {
+      memset(rx, 0xff, rxLen);
+    }
+  }
+
+  return ack;
+}
+
+// *********************************************************************************************
+// SPI transaction of len bytes. rx may be NULL.
+void SimBus::spiXfer(uint8_t csPin, const uint8_t *tx, uint8_t *rx, size_t len)
+{
+  Slot *slot = find(true, csPin);
+
+  if (slot == NULL) {
+    missing.xfers++;
+    missing.bytes += len;
+
+    if (rx != NULL) {
+      memset(rx, 0, len);
+    }
+    return;
+  }
+
+  slot->counts.xfers++;
+  slot->counts.bytes += len;
+  slot->dev->spiXfer(tx, rx, len);
+}
+
+// *********************************************************************************************
+// Run the attached devices for us. A device on both buses is only run once.
+void SimBus::step(uint32_t us)
+{
+  for (int i = 0; i < SIM_BUS_SLOTS; i++) {
+    bool first = slots[i].dev != NULL;
+
+    for (int j = 0; first && (j < i); j++) {
+      first = slots[j].dev != slots[i].dev;
+    }
+
+    if (first) {
+      slots[i].dev->step(us);
+    }
+  }
+}
+
+// *********************************************************************************************
+// Fault injection: NACK the next count I2C transactions to addr, and every Nth one after that (every = 0 is off).
+void SimBus::injectNack(uint8_t addr, uint32_t count, uint32_t every)
+{
+  Slot *slot = find(false, addr);
+
+  if (slot != NULL) {
+    slot->nackCnt   = count;
+    slot->nackEvery = every;
+    slot->seq       = 0;
+  }
+}
+
+// *********************************************************************************************
+// Remove all injected bus faults.
+void SimBus::clearFaults(void)
+{
+  for (int i = 0; i < SIM_BUS_SLOTS; i++) {
+    slots[i].nackCnt   = 0;
+    slots[i].nackEvery = 0;
+  }
+}
+
+// *********************************************************************************************
+// Get the traffic counters of a device (both buses), or the totals if dev = NULL. rst = true clears them.
+void SimBus::getCounts(SimBusCounts *counts, SimDevice *dev, bool rst)
+{
+  memset(counts, 0, sizeof(SimBusCounts));
+
+  for (int i = 0; i < SIM_BUS_SLOTS; i++) {
+    if ((slots[i].dev != NULL) && ((dev == NULL) || (slots[i].dev == dev))) {
+      counts->xfers += slots[i].counts.xfers;
+      counts->nacks += slots[i].counts.nacks;
+      counts->bytes += slots[i].counts.bytes;
+      counts->busUs += slots[i].counts.busUs;
+
+      if (rst) {
+        memset(&slots[i].counts, 0, sizeof(SimBusCounts));
+      }
+    }
+  }
+
+  if (dev == NULL) {
+    counts->xfers += missing.xfers;
+    counts->nacks += missing.nacks;
+    counts->bytes += missing.bytes;
+    counts->busUs += missing.busUs;
+
+    if (rst) {
+      memset(&missing, 0, sizeof(SimBusCounts));
+    }
+  }
+}
+
+// *********************************************************************************************
+// Print the traffic counters, one line per attached device.
+void SimBus::printCounts(void)
+{
+  for (int i = 0; i < SIM_BUS_SLOTS; i++) {
+    if (slots[i].dev != NULL) {
+      printf("    %-10s %s 0x%02x: %7u xfers, %5u NACK, %8u bytes, %8uuS bus time.\n", slots[i].dev->name(),
+             slots[i].spi ? "CS " : "I2C", slots[i].id, slots[i].counts.xfers, slots[i].counts.nacks,
+             slots[i].counts.bytes, slots[i].counts.busUs);
+    }
+  }
+
+  if (missing.xfers > 0) {
+    printf("    %-10s        : %7u xfers, %5u NACK, %8u bytes, %8uuS bus time.\n", "(none)", missing.xfers,
+           missing.nacks, missing.bytes, missing.busUs);
+  }
+}
+
+// *********************************************************************************************
+// On exit, returns the I2C bus time of a transaction at I2C_BUS_HZ (start, addresses, data, ACKs, stop), in uS.
+uint32_t SimBus::i2cTimeUs(uint8_t txLen, uint8_t rxLen)
+{
+  uint32_t bytes = txLen + rxLen;
+
+  bytes += (txLen > 0) || (rxLen == 0) ? 1 : 0; // Write address.
+  bytes += rxLen > 0 ? 1 : 0;                   // Read address (repeated start).
+
+  return (uint32_t)((bytes * 9 + 2) * 1000000ULL / I2C_BUS_HZ);
+}
+
+// EOF
@@ -0,0 +1,120 @@
+/*
+   File: simBus.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. PC virtual I2C and SPI bus for the register-level device models (ina219Model.h, mcpPotModel.h). The simulated
+      I2C Engine (halSim.cpp), halSpiXfer(), and the Wire stand-in all use the one bus (simBus), so every transaction
+      from the firmware or the INA219 library is counted here.
+   2. A device is attached at a 7 bit I2C address or a SPI chip select pin. An I2C transaction to an empty address
+      is NACKed. A SPI transaction to an empty chip select reads all zeros (MISO pull-down).
+   3. Fault injection: injectNack() NACKs the next count I2C transactions to an address, and/or every Nth one.
+      The device models have their own register faults (stuck registers).
+ */
+#ifndef __SIM_BUS_H__
+#define __SIM_BUS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SIM_BUS_SLOTS 8 // Attached devices (both buses).
+
+// Register-level device model on the virtual bus.
+class SimDevice {
+public:
+
+  virtual ~SimDevice(void) {}
+
+  // I2C transaction: Write txLen bytes, then (repeated start) read rxLen bytes. Returns false for a NACK.
+  virtual bool i2cXfer(const uint8_t *tx,
+                       uint8_t        txLen,
+                       uint8_t       *rx,
+                       uint8_t        rxLen);
+
+  // SPI transaction of len bytes (chip select low for the whole transfer). rx may be NULL.
+  virtual void spiXfer(const uint8_t *tx,
+                       uint8_t       *rx,
+                       size_t         len);
+
+  // Run the device for us (conversions, timers).
+  virtual void step(uint32_t us) { (void)(us); }
+
+  virtual const char* name(void) const = 0;
+};
+
+// Virtual bus traffic counters, per device or totals.
+struct SimBusCounts {
+  uint32_t xfers;  // Transactions.
+  uint32_t nacks;  // NACKed I2C transactions (missing device, invalid command, or injected).
+  uint32_t bytes;  // Data bytes moved (both directions, not including addresses).
+  uint32_t busUs;  // Bus time, in uS (I2C only, at I2C_BUS_HZ).
+};
+
+class SimBus {
+public:
+
+  SimBus(void);
+
+  bool attachI2c(uint8_t    addr,
+                 SimDevice *dev);
+  bool attachSpi(uint8_t    csPin,
+                 SimDevice *dev);
+  void detach(SimDevice *dev);
+  bool i2cXfer(uint8_t        addr,
+               const uint8_t *tx,
+               uint8_t        txLen,
+               uint8_t       *rx,
+               uint8_t        rxLen);
+  void spiXfer(uint8_t        csPin,
+               const uint8_t *tx,
+               uint8_t       *rx,
+               size_t         len);
+  void step(uint32_t us);
+  void injectNack(uint8_t  addr,
+                  uint32_t count,
+                  uint32_t every = 0);
+  void clearFaults(void);
+  void getCounts(SimBusCounts *counts,
+                 SimDevice    *dev,
+                 bool          rst);
+  void printCounts(void);
+
+  static uint32_t i2cTimeUs(uint8_t txLen,
+                            uint8_t rxLen);
+
+private:
+
+  struct Slot {
+    SimDevice   *dev;
+    bool         spi;       // Chip select pin, else I2C address.
+    uint8_t      id;        // I2C address or chip select pin.
+    uint32_t     nackCnt;   // Injected: NACK the next nackCnt transactions.
+    uint32_t     nackEvery; // Injected: NACK every Nth transaction, 0 = off.
+    uint32_t     seq;       // Transactions since injectNack(), for nackEvery.
+    SimBusCounts counts;
+  };
+
+  Slot        *find(bool    spi,
+                    uint8_t id);
+  bool         attach(bool       spi,
+                      uint8_t    id,
+                      SimDevice *dev);
+
+  Slot         slots[SIM_BUS_SLOTS];
+  SimBusCounts missing; // Traffic to empty addresses and chip selects.
+};
+
+extern SimBus simBus;
+
+#endif // ifndef __SIM_BUS_H__
+
+// EOF
@@ -64,6 +64,92 @@
     - Updated config.h
       Revised default shunt ohms.
       Revised default Min/Max Amps values. Requires recalibrating PWM controller trim pot for maximum current (~125A).
+    V1.4, (unreleased):
+    - Added Control Task (control.cpp). Measurements and Pulse modulation now run in a hardware timer paced FreeRTOS
+      task (CONTROL_RATE_HZ in config.h), so blocking UI, audio, and Bluetooth code no longer stretches pulse timing.
+      Optional jitter/overrun statistics log (CONTROL_STATS_LOG in config.h).
+    - Added Welding Voltage streaming (VDC_DMA_ON in config.h). The ADC is sampled at tens of kHz via I2S DMA and reduced
+      to per-block Avg, Min, Max, and RMS volts (see getVdcBlock()). The displayed Volts value is unchanged.
+    - Added I2C Engine (i2cBus.cpp). INA219 and MCP45HV51 traffic is queued to a dedicated task using ESP-IDF command
+      links; Pot writes have priority over sensor reads. Bus speed is selectable (I2C_BUS_HZ in config.h). Latency
+      counters are included in the CONTROL_STATS_LOG report. The Wire library is no longer used.
+    - setPotAmps() uses a compile-time Amps to Wiper table and only writes the Digital Pot when the Wiper value changes.
+      Optional periodic Wiper readback check (POT_VERIFY_TIME in config.h).
+    - Added optional Closed-Loop Current Regulation (CURRENT_REG_ON in config.h). A PI regulator (currentReg.cpp) with
+      anti-windup and rate limit trims the Digital Pot so measured Amps track the Amps setting. Gains can be tuned with
+      the Simulated Welder step response benchmark (weldSim.cpp), on a PC or at boot (REG_BENCHMARK in config.h).
+    - Added Anti-Stick (ANTI_STICK_ON in config.h, arcCtrl.cpp). A stuck rod (sustained short circuit voltage with
+      current flowing) reduces the current to ARC_OFF_AMPS within STICK_TIME; Current is restored when the short clears.
+      Uses the 1mS Welding Voltage blocks. The detector can be tested on a PC with synthetic waveforms (weldSim.cpp).
+    - Added Arc Force (ARC_FORCE_ON in config.h). Current is boosted in proportion to arc voltage sag, limited to
+      MAX_SET_AMPS. Voltage block to Pot write latency is included in the CONTROL_STATS_LOG report. Shorter I2S DMA
+      buffers (1.6mS). The response time can be checked on a PC with the Simulated Welder (weldSim.cpp).
+    - Added Hot Start (HOT_START_ON in config.h, hotStart.cpp). Current is boosted at each rod strike, held for the Hot
+      Start time, then ramped down to the Amps setting. Strikes are detected from the fast Welding Voltage and Amps
+      edges. Boost (%) and time are saved in EEPROM and adjusted on the new Arc Settings page (touch the arrow on the
+      Machine Settings title bar). The strike response can be checked on a PC with the Simulated Welder (weldSim.cpp).
+    - Added Arc State Machine (arcState.cpp, detectArcState()). Open circuit, strike, stable arc, short circuit, stuck,
+      and arc out states are detected from the fast voltage and current levels and slopes. State changes are published
+      to subscribers; Pulse modulation, Current Regulation, live Amps display, and Bluetooth auto-reconnect now use the
+      arc state instead of averaged Amps thresholds. PULSE_AMPS_THRS was removed from config.h.
+    - Added Pulse waveforms: Square, Trapezoid (PULSE_RAMP_PC in config.h), Sine, and Sawtooth, from compile-time tables
+      (pulseWave.cpp). The waveform is advanced by a phase accumulator in the Control Task at PULSE_UPDATE_HZ instead
+      of millis() comparisons. The waveform is saved in EEPROM and selected on the new Pulse Shape page (arrow on the
+      Arc Settings title bar), which shows the pulse shape at the present Amps and background settings.
+    - Added Telemetry Recorder (TELEMETRY_REC_ON in config.h, recorder.cpp). Each Control Task tick (Amps, Volts, Pot
+      wiper, Pulse phase, Arc state) is kept in a PSRAM ring buffer. Rod strike, arc out, stuck rod, and over temperature
+      events capture a pre/post trigger window. Captures are listed and dumped as CSV with Serial Log commands ("rec").
+      platformio.ini now enables the D32 Pro's PSRAM (BOARD_HAS_PSRAM).
+    - Added binary Telemetry stream (TELEMETRY_ON in config.h, telemetry.cpp). Measurements, arc state changes, events,
+      and settings changes are sent as COBS framed, CRC-16 checked records from lock-free queues by a low priority task.
+      tools/telemetry_decode.py splits the stream into per-record CSV (or Parquet) files and the text log.
+    - Replaced the Amps and Volts 16 sample averaging buffers with fixed-point filters (filters.cpp): Median spike
+      rejection, a fast filter for the arc features (getFastAmps(), getFastVoltsCv()), and a slow filter for the display.
+      Settings are in config.h. Without VDC_DMA_ON the Arc State Machine now uses the fast Volts. The filter CPU time
+      is measured on a PC (weldSim.cpp) or at boot (FILTER_BENCHMARK in config.h). The Current Regulator uses the
+      fast Amps.
+    - Added Weld Session statistics (session.cpp, weldStats.cpp). Each rod burn's arc time, mean/peak Amps and Volts,
+      and arc energy are streamed (Welford's method) in the Control Task and the last SESSION_HISTORY sessions are saved
+      in EEPROM. The new Weld Stats page (arrow on the Pulse Shape title bar) shows them; Entering the bead length shows
+      the heat input in kJ/mm (SESSION_EFF_PC in config.h).
+    - Welding Volts are converted with a table (one load per ADC code) built at boot from the ADC calibration curve,
+      attenuator scale, and an optional two-point correction (VDC_CAL_ON in config.h). Voltage blocks now hold the
+      exact RMS value. The 5V display dead zone was replaced by zeroing only the ADC codes below 100mV.
+    - INA219 conversion-synchronized reads (INA219_SYNC_ON in config.h). The Conversion Ready flag is polled and only
+      new 17mS conversions are passed to the Amps filter. Sample rate and latency are logged with the Control Task
+      statistics.
+    - Adaptive INA219 conversion mode (INA219_ADAPT_ON in config.h). Fast 12-bit conversions during strikes, shorts,
+      stuck rods and pulse edges, 32-sample hardware averaging during steady burn and idle. The mode change count and
+      Configuration write time are logged with the Control Task statistics. weldSim checks the strike detection time
+      and display noise.
+    - Amps calibration table (up to 6 points, saved in E2Prom/NVS) with an on-screen calibration wizard (Amps
+      Calibration page, after Weld Stats) and "cal" serial commands. measureCurrent() applies it with a piecewise-linear
+      lookup (pwlTable.cpp). SHUNT_OHMS is now only the starting scale.
+    - Automatic Digital Pot characterization ("pot sweep" serial command, potSweep.cpp). Measures the Amps at 9 Wiper
+      codes on a load bank or long arc and builds a monotonic Amps to Wiper table for setPotAmps() (saved in E2Prom/NVS).
+      weldSim checks the setting error on a nonlinear welder.
+    - Predictive overheat warning (thermal.cpp, thermalModel.cpp). An I²t model fed by the RMS welding current warns
+      (voice, orange Amps bar) before the OC LED trips, and optionally derates the current (THERMAL_DERATE_ON in
+      config.h). OC trips correct the model (saved in E2Prom). weldSim replays welds on a reference welder or from a
+      Serial Log capture.
+    - Added fault and alarm Event Log (eventLog.cpp). Boots, hardware failures, OC alerts, heat warnings, INA219 wiring
+      errors, Digital Pot I/O errors and Bluetooth disconnects are saved in a wear-leveled flash ring ("evlog"
+      partition, new partitions_16MB.csv; SPIFFS is 64KB smaller). Writes are batched and held while the arc burns;
+      Flash sectors are erased only while the arc is off. "log" serial commands list, dump and summarize the events.
+      Flash the new partition table once (full upload), then re-run uploadfs: The old SPIFFS image does not fit.
+    - Hardware abstraction layer (hal.h) for the controller core. Arc On/Off and Pulse modulation moved from misc.cpp
+      to arcCtrl.cpp and pulseWave.cpp. The core runs on a PC (ctrlSim.cpp, halSim.cpp, sim folder) with simulated
+      INA219, Digital Pot, Volts ADC and welder: Scenario regression checks and Recorder capture replay.
+    - Register-level INA219 and MCP4xHV51 models on a virtual I2C/SPI bus (sim folder), with NACK and stuck register
+      fault injection and per-device transaction counters. "ctrlsim dev" runs the INA219 library and digPot.cpp
+      against them.
+    - Home page Amps, Volts and Amps bar are drawn off-screen (tftCanvas.cpp, PSRAM) and only the changed pixels are
+      sent to the display, in one burst. No more value flicker. TFT_CANVAS_ON in config.h; "tft" serial command shows
+      the pixels and time per frame.
+    - Display transfers are queued to a Display Engine task on core 0 (tftDisplay.cpp), so page draws no longer stall
+      loop(). Bitmaps are sent as pixel runs. A bus hold is kept to TFT_BURST_PX pixels for the Touch controller and
+      the MCP41HV51 (SPI) Digital Pot variant. TFT_ASYNC_ON in config.h; "tft" shows the page draw and loop() stall
+      times, and the Control Task overruns since the last "tft".
 
    Notes:
    1. This "Arduino" project must be compiled with VSCode / Platformio. Do not use the Arduino IDE.
@@ -71,10 +157,6 @@
    3. The INA219 "High-Side" current sensor is being used in a Low-side configuration. Therefore Bus voltage and
       power measurements are not available.
    4. MUST remove the existing shunt resistor on the Adafruit/clone INA219 PCB. See project documentation.
-   5. Future Feature Wishlist Ideas (not implemented):
-      Anti-Stick: Severely reduce output current if low weld voltage occurs for a prolonged period.
-      Arc Force (Dig): Proportionly increase output current during voltage sags.
-      Hot Start: Momemtarily increase output current during arc starts. Typical period is 0.5S.
  */
 
 #include <Arduino.h>
@@ -86,32 +168,38 @@
 #include "digPot.h"
 #include "config.h"
 #include "speaker.h"
+#include "tftDisplay.h"
 
 // INA219 Current Sensor
 INA219 ina219;
 
 // LCD Touchscreen Setup
-Adafruit_ILI9341 tft = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_RST);
+TftDisplay tft = TftDisplay(TFT_CS, TFT_DC, TFT_RST);
 XPT2046_Touchscreen ts(TS_CS);
 
 // Global System Vars
-int  Amps             = 0;                  // Measured Welding Amps (allow +/- range).
 byte arcSwitch        = DEF_SET_ARC;        // Welder Arc Current On/Off state. Pseudo Boolean, byte for EEPROM.
 bool bleConnected     = false;              // Flag, Bluetooth is connected to FOB.
 byte bleSwitch        = DEF_SET_BLE;        // Bluetooth Low Energy On/Off Switch. Pseudo boolean, byte used for EEPROM.
 int  buttonClick      = CLICK_NONE;         // Bluetooth FOB Button click type, single or double click.
 bool i2cInitComplete  = false;              // Flag, Shows that the i2c port has been configured.
+byte hotStartPc       = DEF_SET_HOT_PC;     // Hot Start boost (%). Zero is Off.
+byte hotStartX10      = DEF_SET_HOT_X10;    // Hot Start time, in seconds times ten.
 bool overTempAlert    = false;              // Flag, Over-Temperature Alarm.
-bool pulseState       = true;               // Arc Pulse modulation state (on/off).
 byte pulseSwitch      = DEF_SET_PULSE;      // Pulse Mode On/Off state. Pseudo Boolean; Byte used for EEPROM.
 byte pulseFreqX10     = DEF_SET_FRQ_X10;    // Arc modulation frequency for Pulse mode.
 byte pulseAmpsPc      = DEF_SET_PULSE_AMPS; // Arc modulation Background Current (%) for Pulse mode.
+byte pulseWave        = DEF_SET_WAVE;       // Arc modulation waveform for Pulse mode.
 byte setAmps          = DEF_SET_AMPS;       // Default Welding Amps *User Setting*.
 bool setAmpsTimerFlag = false;              // Flag, User has Changed Amps Setting.
 bool spiInitComplete  = false;              // SPI Port Initialization is Complete flag.
 byte spkrVolSwitch    = DEF_SET_VOL;        // Audio Volume, five levels.
 byte systemError      = ERROR_NONE;         // General hardware error state (bad current sensor or bad Digital Pot).
-unsigned int Volts    = 0;                  // Measured Welding Volts.
+
+// Control Task Shared Vars. Written by the Control Task, read by the UI. Word sized for atomic updates.
+volatile int  Amps          = 0;    // Measured Welding Amps (allow +/- range).
+volatile bool pulseState    = true; // Arc Pulse modulation state (on/off).
+volatile unsigned int Volts = 0;    // Measured Welding Volts.
 
 // *********************************************************************************************
 
@@ -121,7 +209,11 @@ void setup()
 
   delay(500);                   // Allow power to stabilize.
   WiFi.mode(WIFI_OFF);          // Disable WiFi, Not Used. Bluetooth not affected.
+#ifdef TELEMETRY_ON
+  Serial.begin(TELEM_BAUD);     // Telemetry stream shares the Serial Log port; It needs a high baud rate.
+#else // ifdef TELEMETRY_ON
   Serial.begin(BAUD_RATE);      // Use User Config baud rate for Serial Log Messages.
+#endif // ifdef TELEMETRY_ON
 
   pinMode(  TFT_CS, OUTPUT);    // TFT Select, Output
   pinMode( LED_PIN, OUTPUT);    // LED Drive, Output
@@ -146,10 +238,16 @@ void setup()
   tft.begin();                   // Initialize TFT Display.
   tft.setRotation(1);            // Home is upper left.
   tft.fillScreen(ILI9341_BLACK); // CLS.
+#ifdef TFT_ASYNC_ON
+  if (!tft.beginAsync()) {       // Start the Display Engine.
+    Serial.println("Display Engine: Did Not Start, Drawing Synchronously.");
+  }
+#endif // ifdef TFT_ASYNC_ON
+  initScreenCanvas();            // Home page off-screen canvases.
   Serial.println("Initialized TFT Display & Touch Sensor.");
 
   // Initialize EEPROM emulation.
-  EEPROM.begin(512);
+  EEPROM.begin(EEPROM_SIZE);
 
   if (EEPROM.read(INIT_ADDR) != INIT_BYTE)
   {
@@ -161,6 +259,9 @@ void setup()
     //        pulseAmpsPc = DEF_SET_AMPS;
     //        spkrVolSwitch = DEF_SET_VOL;
     //        pulseFreqX10 = DEF_SET_FRQ_X10;
+    //        hotStartPc = DEF_SET_HOT_PC;
+    //        hotStartX10 = DEF_SET_HOT_X10;
+    //        pulseWave = DEF_SET_WAVE;
 
     EEPROM.write(      INIT_ADDR, INIT_BYTE);
     EEPROM.write(   AMP_SET_ADDR, setAmps);
@@ -170,8 +271,15 @@ void setup()
     EEPROM.write(    ARC_SW_ADDR, arcSwitch);
     EEPROM.write(    BLE_SW_ADDR, bleSwitch);
     EEPROM.write(PULSE_AMPS_ADDR, pulseAmpsPc);
+    EEPROM.write(    HOT_PC_ADDR, hotStartPc);
+    EEPROM.write(    HOT_TM_ADDR, hotStartX10);
+    EEPROM.write(PULSE_WAVE_ADDR, pulseWave);
     EEPROM.commit();
     Serial.println("Initialized Virgin EEPROM (detected first use).");
+    initSessions(true); // Erase the Weld Session history.
+    initAmpsCal(true);  // Erase the Amps calibration.
+    initPotSweep(true); // Erase the Pot characterization.
+    initThermal(true);  // Erase the learned thermal model.
   }
   else
   {
@@ -196,16 +304,43 @@ void setup()
     pulseAmpsPc = EEPROM.read(PULSE_AMPS_ADDR);
     pulseAmpsPc = constrain(pulseAmpsPc, MIN_PULSE_AMPS_PC, MAX_PULSE_AMPS_PC);
 
+    if ((EEPROM.read(HOT_PC_ADDR) > MAX_HOT_PC) || (EEPROM.read(HOT_TM_ADDR) > MAX_HOT_X10)) {
+      EEPROM.write(HOT_PC_ADDR, hotStartPc); // Hot Start settings are blank (0xFF) on EEPROMs initialized before V1.4.
+      EEPROM.write(HOT_TM_ADDR, hotStartX10);
+      EEPROM.commit();
+    }
+
+    hotStartPc = EEPROM.read(HOT_PC_ADDR);
+    hotStartPc = constrain(hotStartPc, MIN_HOT_PC, MAX_HOT_PC);
+
+    hotStartX10 = EEPROM.read(HOT_TM_ADDR);
+    hotStartX10 = constrain(hotStartX10, MIN_HOT_X10, MAX_HOT_X10);
+
+    if (EEPROM.read(PULSE_WAVE_ADDR) >= PULSE_WAVE_CNT) {
+      EEPROM.write(PULSE_WAVE_ADDR, pulseWave); // Blank (0xFF) on EEPROMs initialized before V1.4.
+      EEPROM.commit();
+    }
+    pulseWave = EEPROM.read(PULSE_WAVE_ADDR);
+
     Serial.println("Restored settings from EEPROM.");
+    initSessions(false);
+    initAmpsCal(false);
+    initPotSweep(false);
+    initThermal(false);
     Serial.println(            " -> Welding Amps: " + String(setAmps) + "A");
     Serial.println(            " -> Volume Level: " + String(spkrVolSwitch) + "%");
     Serial.println(            " -> Pulse Switch: " + String((pulseSwitch == PULSE_ON ? "On" : "Off")));
     Serial.println(            " -> Pulse Freq  : " + String(PulseFreqHz(), 1) + "Hz");
     Serial.println(            " -> Pulse Amps  : " + String(pulseAmpsPc) + "%");
+    Serial.println(            " -> Pulse Wave  : " + String(pulseWaveName(pulseWave)));
     Serial.println(            " -> Arc Switch  : " + String((arcSwitch == ARC_ON ? "On" : "Off")));
     Serial.println(            " -> Bluetooth Sw: " + String((bleSwitch == BLE_ON ? "On" : "Off")));
+    Serial.println(            " -> Hot Start   : " + String(hotStartPc) + "%, " + String(hotStartX10 / 10.0f, 1) + "S");
   }
 
+  // Fault and alarm Event Log (flash partition).
+  initEventLog();
+
   // Setup ADC
   initVdcAdc(); // Initialize the Welding Voltage ADC.
   Serial.println("Initialized ADC.");
@@ -220,6 +355,10 @@ void setup()
     systemError |= ERROR_DIGPOT;
   }
 
+  if (systemError != ERROR_NONE) {
+    evlogEvent(EVT_HW_ERROR, systemError, 0);
+  }
+
   // Set Arc Weld Current (Update Digital Pot and PWM Control pin).
   controlArc(arcSwitch, VERBOSE_ON);
 
@@ -252,6 +391,7 @@ void setup()
 
   // Done with initialization. Show Home Page or Hardware Error Page.
   if (systemError == ERROR_NONE) {  // Hardware is OK.
+    initControlTask();              // Start the timer driven Measurement & Pulse Modulation task.
     drawHomePage();
     Serial.println("System Initialization Complete: Success!");
   }
@@ -261,6 +401,7 @@ void setup()
     setPotAmps(MIN_AMPS, VERBOSE_ON); // Minimize Amps even if Digital POT is non-functional.
     #ifdef DEMO_MODE
      Serial.println("System Warning: Operating in Demo Mode; Do NOT attempt to weld.");
+     initControlTask();
      drawHomePage();
     #else
      Serial.println("System Hardware Fails! Repair needed; Do NOT attempt to weld.");
@@ -280,18 +421,12 @@ void loop()
 {
   static long currentMillis      = 0; // Led Flash Timer.
   static long previousBleMillis  = 0; // Timer for Bluetooth BLE scan.
-  static long previousMeasMillis = 0; // Timer for Measurement.
 
   // Housekeeping.
   currentMillis = millis();
 
   // System Tick Timers Tasks
-  if (currentMillis - previousMeasMillis >= MEAS_TIME) {
-    previousMeasMillis = currentMillis;
-    measureCurrent();
-    measureVoltage();
-  }
-
+  // Note: Amps & Volts measurement and Pulse Modulation are performed by the Control Task (see control.cpp).
   if (currentMillis - previousBleMillis > CHK_BLE_TIME) {
     previousBleMillis = millis();
     checkBleConnection(); // Check the Bluetooth iTAG FOB Button server connection.
@@ -301,8 +436,17 @@ void loop()
   spkr.fillBuffer();     // Fill the sound buffer with data.
   showHeartbeat();       // Display Flashing Heartbeat icon.
   checkForAlerts();      // Check for alert conditions.
+  processThermal();      // Update the thermal model (heat warning, derating, OC trip learning).
   processScreen();       // Process Menu System (touch screen).
-  pulseModulation();     // Update the Arc Pulse Current if pulse mode is enabled.
+  refreshPulseIcon();    // Redraw the Pulse lightning icon if the Control Task changed the pulse state.
+  processArcEvents();    // Log Anti-Stick events.
+  processControlStats(); // Log the Control Task's timing statistics (if enabled).
+  processSerialCmds();   // Serial Log commands (Recorder, Amps Calibration, Pot Characterization, Heat, Log, TFT).
+  processRecorder();     // Log new Telemetry captures, send capture dumps.
+  processSessions();     // Save finished Weld Sessions.
+  processAmpsCal();      // Finish Amps Calibration captures, save calibration changes.
+  processPotSweep();     // Run the Pot characterization sweep, save its results.
+  processEventLog();     // Write logged events to flash (held while the arc burns), send Event Log dumps.
   remoteControl();       // Check the BLE FOB remote control for button presses.
 }
 
@@ -318,4 +462,4 @@ void loop()
    }
  */
 
-// EOF
\ No newline at end of file
+// EOF
\ No newline at end of file
@@ -16,6 +16,7 @@
 #define __PULSE_WELDER_H__
 
 #include "BLEDevice.h"
+#include "arcState.h"
 
 // *********************************************************************************************
 // VERSION STRING: Must be updated with each public release! The version is shown on the boot screen.
@@ -51,8 +52,30 @@
 
 // Amps & Volts Defines.
 #define MIN_VOLTS 18          // Minimum output volts. Change volts text color if VDC too low.
-#define MIN_DET_AMPS 2        // Minimum output welding current before reporting measured Amps.
 #define AMPS_MIN_FOR_PULSE 40 // Minimum output welding current for Pulse Modulation.
+#define ARC_FORCE_SPAN 8      // Voltage sag below ARC_FORCE_VOLTS for full Arc Force boost.
+
+// Arc State Machine Defines
+#define ARC_OCV_VOLTS 45      // Open circuit voltage threshold. Arc is out (or not struck) above this voltage.
+#define ARC_STRIKE_VOLTS 35   // Rod strike threshold, for slow voltage falls. Must be less than ARC_OCV_VOLTS.
+#define ARC_DET_AMPS 5        // Welding current threshold for the current edges, in Amps.
+#define ARC_EDGE_VPMS 2       // Voltage edge slope, in Volts per mS.
+#define ARC_EDGE_APMS 1       // Current edge slope, in Amps per mS.
+#define ARC_SLOPE_TIME 2      // Slope filter time constant, in mS.
+#define ARC_STABLE_TIME 100   // Arc time after a strike before the arc is stable, in mS.
+#define ARC_OUT_TIME 2000     // Time after the arc goes out (without a restrike) before it is open circuit, in mS.
+#define ARC_SUBSCRIBERS 8     // Maximum number of Arc State subscribers.
+
+// Hot Start Defines
+#define HOT_ARM_VOLTS 45      // Open circuit voltage threshold for arming the Hot Start strike detector.
+#define HOT_ARM_TIME 100      // Time at open circuit voltage to arm the strike detector, in mS.
+#define HOT_STRIKE_VOLTS 35   // Rod strike voltage threshold (falling edge). Must be less than HOT_ARM_VOLTS.
+#define HOT_RAMP_TIME 200     // Hot Start ramp down time (after the boost time), in mS.
+#define HOT_PC_STEP 5         // Step size for Hot Start boost (%) setting.
+#define MIN_HOT_PC 0          // Minimum Hot Start boost (%). Zero is Off.
+#define MAX_HOT_PC 100        // Maximum Hot Start boost (%).
+#define MIN_HOT_X10 1         // Minimum Hot Start time, in seconds times ten.
+#define MAX_HOT_X10 20        // Maximum Hot Start time, in seconds times ten.
 
 // Arc Mode Defines
 #define ARC_OFF 0             // Arc Current Off, boolean flag.
@@ -71,6 +94,18 @@
 #define CLICK_BUSY 3              // Bluetooth Button FOB, busy processing click counter.
 #define RECONNECT_TRIES 10        // Bluetooth max attempted auto reconnect count before giving up.
 
+// Control Task Defines
+#define CONTROL_ISR_TMR 1         // Control Task Interrupt Timer to Use (DAC Audio uses timer 0).
+#define CONTROL_TASK_CORE 1       // CPU Core for the Control Task. Same core as loop(), Bluetooth stack is on core 0.
+#define CONTROL_TASK_PRIO 5       // Control Task Priority. Must be higher than loop() task's priority (1).
+#define CONTROL_TASK_STACK 4096   // Control Task Stack Size, in bytes.
+
+// Display Engine Defines
+#define TFT_RING_JOBS 1024        // Display Engine job queue size. Must be a power of two.
+#define TFT_TASK_CORE 0           // CPU Core for the Display Engine. Not the loop() core, so loop() runs during transfers.
+#define TFT_TASK_PRIO 1           // Display Engine Priority.
+#define TFT_TASK_STACK 2048       // Display Engine Stack Size, in bytes.
+
 // EEPROM Defines.
 #define INIT_BYTE 0xA5            // EEProm Initialization Stamping Byte.
 #define INIT_ADDR 0               // E2Prom Address for Init byte.
@@ -81,6 +116,18 @@
 #define PULSE_AMPS_ADDR 5         // E2Prom Address for Pulse Amps (%).
 #define ARC_SW_ADDR 6             // E2Prom Address for Arc On/Off Switch.
 #define BLE_SW_ADDR 7             // E2Prom Address for BlueTooth On/Off Switch.
+#define HOT_PC_ADDR 8             // E2Prom Address for Hot Start boost (%).
+#define HOT_TM_ADDR 9             // E2Prom Address for Hot Start time (scaled 10X).
+#define PULSE_WAVE_ADDR 10        // E2Prom Address for Pulse waveform.
+#define LAST_SET_ADDR PULSE_WAVE_ADDR // Last E2Prom settings Address. Update when a setting is added.
+#define CAL_ADDR 16               // E2Prom Address of the Amps calibration points.
+#define CAL_REC_SIZE 26           // E2Prom Amps calibration record size, sizeof(AmpsCalRec).
+#define POT_SWEEP_ADDR 42         // E2Prom Address of the Pot characterization sweep results.
+#define POT_SWEEP_REC_SIZE 20     // E2Prom Pot characterization record size, sizeof(PotSweepRec).
+#define THERMAL_ADDR 62           // E2Prom Address of the learned continuous Amps (thermal model), and its check byte.
+#define SESSION_ADDR 64           // E2Prom Address of the Weld Session history (SESSION_HISTORY records).
+#define SESSION_REC_SIZE 28       // E2Prom Weld Session record size, sizeof(WeldSession).
+#define EEPROM_SIZE 512           // E2Prom emulation size, in bytes.
 
 // FOB Defines.
 #define iTAG_FOB 1
@@ -108,6 +155,8 @@
 #define SAMPLE_12BITS   3         // 12 bits, 532uS per acq.
 #define BUS_V_MAX      1.0        // Maximum Bus voltage (same as shunt voltage), in VDC.
 #define MAX_I_EXPECTED 200.0      // Maximum Expected Current, in Amps.
+#define INA219_AVG_CONV_US 17020  // SAMPLE_AVG_32 conversion time (32 x 532uS), in uS.
+#define INA219_CNVR 0x02          // Conversion Ready flag, Bus Voltage register (V_BUS_R) low byte.
 
 // LED Defines
 #define LED_OFF HIGH              // Built-In LED Off state.
@@ -129,6 +178,70 @@
 #define DEF_SET_PULSE_AMPS 50     // Default Pulse Amps (%).
 #define MIN_PULSE_AMPS_PC 35      // Minimum Pulse Amps as percent of current setting.
 #define MAX_PULSE_AMPS_PC 90      // Maximum Pulse Amps as percent of current setting.
+#define PULSE_WAVE_SQUARE 0       // Square Pulse waveform.
+#define PULSE_WAVE_TRAP 1         // Trapezoid Pulse waveform (ramp is PULSE_RAMP_PC in config.h).
+#define PULSE_WAVE_SINE 2         // Sine Pulse waveform.
+#define PULSE_WAVE_SAW 3          // Sawtooth Pulse waveform.
+#define PULSE_WAVE_CNT 4          // Number of Pulse waveforms.
+#define PULSE_TABLE_BITS 7        // Pulse waveform table size, in bits (2^7 = 128 entries per period).
+#define PULSE_TABLE_SIZE (1 << PULSE_TABLE_BITS)
+#define PULSE_LEVEL_MAX 255       // Pulse waveform level for the Amps setting. Level 0 is the background current.
+
+// Amps Calibration Defines
+#define CAL_POINTS 6              // Number of Amps calibration points.
+#define CAL_CAPTURE_MS 2000       // Welder reading capture time, in mS.
+#define CAL_MIN_AMPS 20           // Lowest welder reading for a calibration point, in Amps.
+#define CAL_METER_STEP 5          // Meter reading adjustment step, in 0.1A.
+
+// Pot Characterization Defines
+#define POT_SWEEP_POINTS 9        // Number of Wiper codes measured, evenly spaced from 0x00 to 0xff.
+
+// Thermal Model Defines
+#define THERMAL_CLEAR_PC (THERMAL_WARN_PC - 10) // Warning and derating end below this heat, percent of the trip point.
+#define THERMAL_MIN_TRIP_PC 50    // Lowest model heat for a thermal OC trip (lower is an over-current trip), percent.
+#define THERMAL_NO_TRIP_PC 110    // Model heat without an OC trip that raises the continuous Amps, percent.
+#define THERMAL_LEARN_PC 50       // Continuous Amps correction per OC trip, percent of the error.
+#define THERMAL_MIN_CONT 40       // Continuous Amps learning limits.
+#define THERMAL_MAX_CONT 200
+
+// Event Log Defines
+#define EVLOG_PART_NAME "evlog"   // Event Log flash partition label (partitions_16MB.csv).
+#define EVLOG_REC_SIZE 16         // Event record size, in bytes.
+#define EVLOG_QUEUE 32            // Events held in RAM until they are written to flash.
+#define EVLOG_FLUSH_TIME 2000     // Longest time an event waits in RAM while the arc is off, in mS.
+#define EVLOG_HOLD_TIME 60000     // Repeats of an event code within this time are not logged, in mS.
+#define EVLOG_LIST_LINES 20       // Events listed by the "log" serial command.
+#define EVLOG_DUMP_LINES 16       // Most event log lines sent per loop() pass.
+#define EVT_BOOT 1                // Event codes. Boot, p1 = ESP32 reset reason.
+#define EVT_HW_ERROR 2            // Hardware failure at boot, p1 = systemError bits.
+#define EVT_OC_ALERT 3            // OC LED alert on, p1 = model heat %, p2 = Amps setting.
+#define EVT_OC_END 4              // OC LED alert off, p1 = model heat %.
+#define EVT_HEAT_WARN 5           // Thermal model warning on, p1 = model heat %, p2 = Amps setting.
+#define EVT_HEAT_LIMIT 6          // Thermal derating changed, p1 = Amps limit, p2 = model heat %.
+#define EVT_INA_WIRING 7          // INA219 wiring error (negative current), p1 = reading, in 0.1A.
+#define EVT_POT_IO 8              // Digital Pot I/O error, p1 = error count, p2 = Wiper.
+#define EVT_POT_VERIFY 9          // Digital Pot readback mismatch, p1 = mismatch count.
+#define EVT_BLE_LOST 10           // Bluetooth FOB connection lost.
+#define EVT_LOG_DROP 11           // Event Log RAM queue overflow, p1 = events lost.
+#define EVT_CODES 12              // Number of event codes.
+
+// Weld Session Defines
+#define SESSION_EMPTY 0xFFFF      // Weld Session number of an unused (erased) record.
+#define SESSION_FLAG_PULSE 0x01   // Pulse mode was on.
+#define SESSION_FLAG_STUCK 0x02   // The rod stuck at least once.
+#define SESSION_TRAVEL_STEP 10    // Travel length adjustment step, in mm.
+#define SESSION_TRAVEL_MAX 2000   // Longest travel length, in mm.
+
+// Telemetry Recorder Defines
+#define REC_CAPTURES 16           // Number of capture windows kept. The oldest is replaced.
+#define REC_HEAP_KB 24            // Ring buffer size (in KB) used if PSRAM is not found.
+#define REC_DUMP_LINES 16         // Most capture dump lines sent per loop() pass.
+#define REC_TRIG_STRIKE 0x01      // Capture trigger, rod strike (from open circuit or arc out).
+#define REC_TRIG_OUT 0x02         // Capture trigger, arc went out.
+#define REC_TRIG_SHORT 0x04       // Capture trigger, stuck rod (short circuit longer than STICK_TIME).
+#define REC_TRIG_HEAT 0x08        // Capture trigger, over temperature alert.
+#define REC_TRIG_USER 0x10        // Capture trigger, serial command.
+#define SERIAL_CMD_LEN 40         // Longest serial command line.
 
 // System Error defines
 #define ERROR_NONE   0b00000000
@@ -137,6 +250,7 @@
 
 // Timers
 #define CHK_BLE_TIME 250         // Check Bluetooth Connection Timer, in mS.
+#define CONTROL_STATS_TIME 10000 // Control Task Statistics Log Time, in mS.
 #define DAC_ISR_TMR 0            // DAC Audio Interrupt Timer to Use.
 #define DOUBLE_CLICK_TIME 750    // Bluetooth FOB Button Click Timer, in mS.
 #define EEP_DELAY_TIME 3500      // Delay Time before writing Volume value to EEPROM.
@@ -144,6 +258,7 @@
 #define MEAS_TIME 5              // Measurement Refresh Time, in mS.
 #define RECONNECT_DLY_TIME 20000 // Delay time before attempting a Bluetooth re-connect.
 #define SPLASH_TIME 2500         // Timespan for showing Splash Screen at boot.
+#define THERMAL_TIME 100         // Thermal model update time, in mS.
 
 // *********************************************************************************************
 enum StartMode {
@@ -153,13 +268,100 @@ enum StartMode {
 
 extern StartMode startMode;
 
+// Amps Calibration Prototypes
+// Amps calibration points, as saved in E2Prom. CAL_REC_SIZE bytes.
+struct AmpsCalRec {
+  uint16_t readX10[CAL_POINTS];  // Welder (uncalibrated) reading, in 0.1A. Zero if the point is unused.
+  uint16_t meterX10[CAL_POINTS]; // Clamp meter reading, in 0.1A.
+  uint8_t  version;              // Record layout version.
+  uint8_t  check;                // Checksum of the record, see calCheck().
+};
+
+bool    ampsCalCmd(const String& cmd);
+int32_t calibrateAmps(int32_t rawMa);
+bool    getAmpsCalPoint(int       point,
+                        uint16_t *readX10,
+                        uint16_t *meterX10);
+byte    getCalAmps(void);
+void    initAmpsCal(bool erase);
+bool    isAmpsCapturing(void);
+void    processAmpsCal(void);
+bool    setAmpsCalPoint(int      point,
+                        uint16_t readX10,
+                        uint16_t meterX10);
+void    setCalAmps(byte amps);
+bool    startAmpsCapture(int point);
+
 // Amps & Volts Measurement Prototypes
+struct VdcBlock {
+  uint32_t timeUs;  // Completion time of block, in uS (lower 32 bits of esp_timer).
+  uint16_t samples; // Number of ADC samples in block.
+  uint16_t avgCv;   // Average Welding Volts, in centivolts (0.01V).
+  uint16_t minCv;   // Minimum Welding Volts, in centivolts.
+  uint16_t maxCv;   // Maximum Welding Volts, in centivolts.
+  uint16_t rmsCv;   // RMS Welding Volts, in centivolts.
+};
+
+// INA219 acquisition statistics.
+struct InaStats {
+  uint32_t samples;      // New shunt conversions passed to the Amps filter.
+  uint32_t polls;        // Conversion Ready (status) reads. Zero if INA219_SYNC_ON is disabled.
+  uint32_t shuntReads;   // Shunt current register reads.
+  uint32_t sampleHz;     // Effective sample rate, in Hz.
+  uint32_t latencyAvgUs; // Average time from Conversion Ready poll to Amps filter update, in uS.
+  uint32_t latencyMaxUs; // Worst time from Conversion Ready poll to Amps filter update, in uS.
+  uint32_t modeChanges;  // Conversion mode changes (INA219_ADAPT_ON).
+  uint32_t modeAvgUs;    // Average Configuration write time (queued to done), in uS.
+  uint32_t fastPc;       // Time spent in the fast conversion mode, in percent.
+};
+
+bool getVdcBlock(VdcBlock *blk);
+void getInaStats(InaStats *stats,
+                 bool      rst);
+void inaFastWindow(void);
 void initVdcAdc(void);
 void measureCurrent(void);
 void measureVoltage(void);
+void sampleVoltage(void);
+int  getFastAmps(void);
+int  getFastVoltsCv(void);
 void resetCurrentBuffer(void);
 void resetVdcBuffer(void);
 
+// Arc Feature Prototypes
+struct ArcLatency {
+  uint32_t count; // Number of Pot writes caused by the arc features.
+  uint32_t avgUs; // Average time from Voltage block to completed Pot write, in uS.
+  uint32_t maxUs; // Worst time from Voltage block to completed Pot write, in uS.
+};
+
+// Arc State change event. Subscribers are called by the Control Task; They must be short and must not block.
+struct ArcEvent {
+  ArcState state;      // New state.
+  ArcState prevState;  // Previous state.
+  uint32_t timeUs;     // Time of the state change (Voltage block time), in uS.
+  uint32_t prevUs;     // Time spent in the previous state, in uS.
+  float    volts;      // Welding Volts at the state change.
+  int      amps;       // Welding Amps (non-averaged) at the state change.
+};
+
+typedef void (*ArcStateCallback)(const ArcEvent& evt);
+
+void     bleArcEvent(const ArcEvent& evt);
+void     detectArcState(void);
+ArcState getArcState(void);
+bool     subscribeArcState(ArcStateCallback callback);
+void     getArcLatency(ArcLatency *lat,
+                       bool        rst);
+void     inaArcEvent(const ArcEvent& evt);
+void     initArcCtrl(void);
+byte     outputAmps(byte amps);
+byte     outputLimitAmps(void);
+void     processArcCtrl(void);
+void     processArcEvents(void);
+void     pulseArcEvent(const ArcEvent& evt);
+void     screenArcEvent(const ArcEvent& evt);
+
 // Bluetooth Prototypes
 bool connectToServer(BLEAddress pAddress);
 bool isBleServerConnected(void);
@@ -173,16 +375,84 @@ void scanBlueTooth(void);
 void setupBle(unsigned int scanSeconds);
 void stopBle(void);
 
+// Control Task Prototypes
+struct ControlStats {
+  uint32_t ticks;       // Number of Control Task ticks processed.
+  uint32_t overruns;    // Number of timer ticks missed because a previous tick ran too long.
+  uint32_t jitterMaxUs; // Worst deviation of the tick period from nominal, in uS.
+  uint32_t execAvgUs;   // Average tick execution time, in uS.
+  uint32_t execMaxUs;   // Worst tick execution time, in uS.
+};
+
+// One Control Task tick of welding data, for the Telemetry Recorder and Telemetry stream. 12 bytes.
+struct WeldSample {
+  uint32_t timeUs;  // Sample time, in uS (lower 32 bits of esp_timer).
+  int16_t  amps;    // Welding Amps (non-averaged).
+  uint16_t voltsCv; // Welding Volts, in centivolts (0.01V).
+  uint8_t  wiper;   // Digital Pot Wiper value (255 if unknown).
+  uint8_t  phase;   // Pulse waveform phase, 0-255 is one pulse period.
+  uint8_t  state;   // Arc State (ArcState enum).
+  uint8_t  flags;   // SAMPLE_FLAG_xxx bits.
+};
+
+#define SAMPLE_FLAG_ARC_ON 0x01   // Arc current is switched on.
+#define SAMPLE_FLAG_PULSE 0x02    // Pulse waveform is in its low (background) half.
+#define SAMPLE_FLAG_HEAT 0x04     // Over temperature alert.
+
+// One Weld Session (rod burn) summary, as saved in E2Prom. SESSION_REC_SIZE bytes.
+struct WeldSession {
+  uint16_t number;      // Session number, counts up. SESSION_EMPTY if unused.
+  uint16_t travelMm;    // Travel (bead) length, in mm. Entered on the Weld Stats page, 0 if not entered.
+  uint32_t arcMs;       // Arc on time, in mS.
+  uint32_t energyJ;     // Arc energy, in Joules.
+  uint16_t meanAmpsX10; // Mean Amps, times ten.
+  uint16_t sdAmpsX10;   // Amps standard deviation, times ten.
+  uint16_t peakAmps;    // Peak Amps.
+  uint16_t meanVoltsCv; // Mean Volts, in centivolts.
+  uint16_t sdVoltsCv;   // Volts standard deviation, in centivolts.
+  uint16_t peakVoltsCv; // Peak Volts, in centivolts.
+  uint8_t  setAmps;     // Amps setting at the strike.
+  uint8_t  flags;       // SESSION_FLAG_xxx bits.
+  uint8_t  check;       // Checksum of the record, see sessionCheck().
+};
+
+void controlTick(void);
+void getControlStats(ControlStats *stats,
+                     bool          rst);
+void initControlTask(void);
+void processControlStats(void);
+byte regulatedAmps(byte amps);
+
+// Pot Characterization Prototypes
+// Pot characterization sweep results, as saved in E2Prom. POT_SWEEP_REC_SIZE bytes.
+struct PotSweepRec {
+  uint16_t ampsX10[POT_SWEEP_POINTS]; // Measured Amps at each Wiper code, in 0.1A. All zero if not characterized.
+  uint8_t  version;                   // Record layout version.
+  uint8_t  check;                     // Checksum of the record, see sweepCheck().
+};
+
+void initPotSweep(bool erase);
+bool isPotSweeping(void);
+void processPotSweep(void);
+bool potSweepCmd(const String& cmd);
+bool startPotSweep(void);
+
 // Digital Pot Protoypes
 bool digitalPotWrite(byte dataValue,
                      byte memAddr);
 byte digitalPotRead(byte memAddr);
 bool initDigitalPot(byte chipAddr,
                     int  spi_cs);
-void setPotAmps(byte ampVal,
+uint32_t getPotWriteUs(void);
+int  getPotWiper(void);
+bool setPotAmps(byte ampVal,
                 bool verbose);
+void setPotOverride(int value);
+void setPotTable(const byte *table);
 
 // Display Prototypes
+bool adjustHotStartPc(bool direction);
+bool adjustHotStartTime(bool direction);
 bool adjustPulseFreq(bool direction);
 void displayAmps(bool forceRefresh);
 void displayOverTempAlert(void);
@@ -200,12 +470,25 @@ void drawCaution(int  x,
 void drawHeart(int  x,
                int  y,
                bool state);
+void drawHotStartPcSettings(bool update_only);
+void drawHotStartTmSettings(bool update_only);
+void drawArcSettingsPage(void);
+void drawPulseShapePage(void);
+void drawPulseWaveSettings(bool update_only);
+void drawWeldStats(bool update_only);
+void drawWeldStatsPage(void);
+void refreshWeldStats(void);
+void drawAmpsCal(bool update_only);
+void drawAmpsCalPage(void);
+void refreshAmpsCal(void);
+void refreshThermal(void);
 void drawErrorPage(void);
 void drawHomePage(void);
 void drawInfoPage(void);
 void drawInfoPage6011(void);
 void drawInfoPage6013(void);
 void drawInfoPage7018(void);
+void drawNextArrow(void);
 void drawOverTempAlert(void);
 void drawPulseAmpsSettings(bool update_only);
 void drawPulseHzSettings(bool update_only);
@@ -213,11 +496,43 @@ void drawPulseIcon(void);
 void drawPulseLightning(void);
 void drawSettingsPage(void);
 void getTouchPoints(void);
+void initScreenCanvas(void);
 void processScreen(void);
+bool screenCmd(const String& cmd);
 void showBleStatus(int command);
 void showHeartbeat(void);
 void updateVolumeIcon(void);
 
+// Event Log Prototypes
+// One Event Log record, as saved in flash. EVLOG_REC_SIZE bytes. An erased record has seq = 0xFFFFFFFF.
+struct EventRec {
+  uint32_t seq;    // Record sequence number, never repeats.
+  uint32_t timeMs; // Time since boot, in mS.
+  uint16_t boot;   // Boot number.
+  uint8_t  code;   // Event code, EVT_xxx.
+  uint8_t  check;  // Checksum of the other bytes. A torn (power lost) record fails the check.
+  int16_t  p1;     // Event parameters, see the EVT_xxx defines.
+  int16_t  p2;
+};
+
+// Event Log iterator, see evlogBegin().
+struct EvlogIter {
+  uint32_t slot;        // Record slot.
+  uint32_t left;        // Slots not visited.
+  bool     newestFirst; // Visit order.
+};
+
+bool  eventLogCmd(const String& cmd);
+bool  evlogBegin(EvlogIter *it,
+                 bool       newestFirst);
+void  evlogEvent(byte    code,
+                 int16_t p1,
+                 int16_t p2);
+bool  evlogNext(EvlogIter *it,
+                EventRec  *rec);
+void  initEventLog(void);
+void  processEventLog(void);
+
 // Graphics Prototypes
 void fillArc(int          x,
              int          y,
@@ -237,12 +552,54 @@ bool  initCurrentSensor(void);
 int   getFobClick(bool rst);
 void  checkForAlerts(void);
 float PulseFreqHz(void);
+byte  getPulsePhase(void);
+void  initPulseWave(void);
 void  pulseModulation(void);
+void  processSerialCmds(void);
+const char *pulseWaveName(byte wave);
+byte  pulseWaveLevel(byte wave,
+                     int  idx);
+void  refreshPulseIcon(void);
 void  remoteControl(void);
-void detectArcState(void);
 
 // SPIFFS Prototypes
 void  spiffsInit(void);
 
+// Weld Session Prototypes
+bool  getWeldSession(int          age,
+                     WeldSession *ses);
+void  initSessions(bool erase);
+void  processSessions(void);
+void  sessionArcEvent(const ArcEvent& evt);
+void  sessionSample(const WeldSample& smp);
+bool  setSessionTravel(int      age,
+                       uint16_t travelMm);
+
+// Telemetry Stream Prototypes
+void  initTelemetry(void);
+void  telemArcEvent(const ArcEvent& evt);
+void  telemEvent(byte    code,
+                 int32_t value);
+void  telemSample(const WeldSample& smp);
+void  telemSetting(byte id,
+                   int  value);
+
+// Telemetry Recorder Prototypes
+void  initRecorder(void);
+void  recArcEvent(const ArcEvent& evt);
+void  recordSample(const WeldSample& smp);
+void  processRecorder(void);
+bool  recorderCmd(const String& cmd);
+void  triggerRecorder(byte trig);
+
+// Thermal Model Prototypes
+float getThermalHeat(void);
+void  initThermal(bool erase);
+bool  isThermalWarning(void);
+void  processThermal(void);
+bool  thermalCmd(const String& cmd);
+byte  thermalLimitAmps(byte amps);
+void  thermalSample(const WeldSample& smp);
+
 #endif
 // EOF
@@ -0,0 +1,372 @@
+/*
+   File: ampsCal.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Welding Amps calibration. Up to CAL_POINTS pairs of (welder reading, clamp meter reading) are saved in E2Prom
+      (the ESP32 EEPROM library stores it in NVS), so each welder is calibrated without a recompile. SHUNT_OHMS in
+      config.h is the starting (uncalibrated) scale.
+   2. The points are entered on the Amps Calibration page (or with the "cal" serial commands, for scripted fleet
+      calibration). A point's welder reading is the average of the uncalibrated Amps over CAL_CAPTURE_MS. Only
+      readings taken while the arc is established are used, so the open circuit time before the strike (and after the
+      arc goes out), Hot Start, and Anti-Stick do not pull the average off.
+   3. measureCurrent() passes every reading through calibrateAmps(), a piecewise-linear lookup (pwlTable.cpp). loop()
+      builds a new table in the spare slot and then switches calActive, so the Control Task never waits. The Control
+      Task publishes the slot it is reading (calInUse); A rebuild waits until the Control Task has left the spare slot,
+      so back-to-back rebuilds ("cal clear") never write a table that is being read.
+   4. Changes are saved after EEP_DELAY_TIME without changes (flash wear).
+   5. The Amps Calibration page holds each point's Amps setting with setCalAmps(). outputAmps() uses the held value
+      instead of the user's setAmps, which is never changed (it is saved in E2Prom and changed by the BLE fob).
+ */
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "PulseWelder.h"
+#include "arcState.h"
+#include "pwlTable.h"
+#include "config.h"
+
+#define CAL_VERSION 1 // Calibration record layout version.
+
+// Global System vars
+extern byte setAmps; // Welding Amps *User Setting*.
+
+static_assert(sizeof(AmpsCalRec) == CAL_REC_SIZE, "CAL_REC_SIZE does not match AmpsCalRec.");
+static_assert(CAL_ADDR + CAL_REC_SIZE <= SESSION_ADDR, "Amps calibration overlaps the Weld Session history.");
+
+// Local Scope Vars
+static AmpsCalRec    calRec;                 // Calibration points (loop() only).
+static PwlTable      calTables[2];           // Active and spare calibration tables.
+static volatile int  calActive  = 0;         // calTables[] index used by the Control Task.
+static volatile int  calInUse   = -1;        // calTables[] index the Control Task is reading, -1 = None (calMux).
+static volatile bool capturing  = false;     // A welder reading is being captured.
+static volatile byte calAmps    = 0;         // Amps setting held by the Amps Calibration page, 0 = None.
+static int64_t       capSumMa   = 0;         // Capture total, in mA (Control Task, under calMux).
+static uint32_t      capCnt     = 0;         // Capture reading count.
+static int           capPoint   = -1;        // Calibration point being captured.
+static unsigned long capMillis  = 0;         // Capture start time, in mS.
+static bool          calDirty   = false;     // A calibration point was changed, E2Prom commit is pending.
+static unsigned long calMillis  = 0;         // Time of the last change, in mS.
+static portMUX_TYPE  calMux     = portMUX_INITIALIZER_UNLOCKED; // Protects the capture totals.
+
+// *********************************************************************************************
+// On exit, returns the checksum of the calibration record (all bytes except the checksum).
+static uint8_t calCheck(const AmpsCalRec& rec)
+{
+  const uint8_t *data = (const uint8_t *)(&rec);
+  uint8_t sum = 0xa5;
+
+  for (size_t i = 0; i < offsetof(AmpsCalRec, check); i++) {
+    sum = (sum << 1 | sum >> 7) ^ data[i];
+  }
+
+  return sum;
+}
+
+// *********************************************************************************************
+// Build the calibration table from calRec in the spare slot, then make it active.
+// On exit, returns false if the points are not monotonic (the active table is unchanged).
+static bool buildCalTable(const AmpsCalRec& rec)
+{
+  int32_t xs[CAL_POINTS];
+  int32_t ys[CAL_POINTS];
+  int32_t x;
+  int32_t y;
+  int     n = 0;
+  int     j;
+  int     spare = calActive ^ 1;
+  bool    busy  = true;
+
+  for (int i = 0; i < CAL_POINTS; i++) { // Insertion sort by welder reading.
+    if (rec.readX10[i] == 0) {
+      continue;
+    }
+    x = rec.readX10[i] * 100; // 0.1A to mA.
+    y = rec.meterX10[i] * 100;
+
+    for (j = n; (j > 0) && (xs[j - 1] > x); j--) {
+      xs[j] = xs[j - 1];
+      ys[j] = ys[j - 1];
+    }
+    xs[j] = x;
+    ys[j] = y;
+    n++;
+  }
+
+  while (busy) { // The Control Task may still be reading the spare slot (it was active before the last rebuild).
+    portENTER_CRITICAL(&calMux);
+    busy = calInUse == spare;
+    portEXIT_CRITICAL(&calMux);
+
+    if (busy) {
+      delay(1);
+    }
+  }
+
+  if (!calTables[spare].load(xs, ys, n)) {
+    return false;
+  }
+  calActive = spare;
+
+  return true;
+}
+
+// *********************************************************************************************
+// Schedule the E2Prom commit of calRec.
+static void saveCalRec(void)
+{
+  calRec.version = CAL_VERSION;
+  calRec.check   = calCheck(calRec);
+  EEPROM.put(CAL_ADDR, calRec);
+  calDirty  = true;
+  calMillis = millis();
+}
+
+// *********************************************************************************************
+// Load the Amps calibration. Call from setup() after EEPROM.begin().
+// On entry erase = true to clear the calibration (virgin EEPROM).
+void initAmpsCal(bool erase)
+{
+  EEPROM.get(CAL_ADDR, calRec);
+
+  if (erase || (calRec.version != CAL_VERSION) || (calRec.check != calCheck(calRec))) {
+    memset(&calRec, 0, sizeof(calRec));
+    calRec.version = CAL_VERSION;
+    calRec.check   = calCheck(calRec);
+    EEPROM.put(CAL_ADDR, calRec);
+    EEPROM.commit();
+  }
+
+  if (!buildCalTable(calRec)) {
+    Serial.println("Amps Calibration: Saved points are not monotonic, ignored.");
+    calTables[calActive].clear();
+  }
+
+  Serial.println("Amps Calibration: " + (calTables[calActive].points() == 0 ? String("None (SHUNT_OHMS only)") :
+                                         String(calTables[calActive].points()) + " Points") + ".");
+}
+
+// *********************************************************************************************
+// Apply the calibration to an uncalibrated Amps reading (mA). Called by the Control Task (measureCurrent()).
+// On exit, returns the calibrated reading, in mA.
+int32_t calibrateAmps(int32_t rawMa)
+{
+  int32_t calMa;
+
+  if (capturing && arcEstablished(getArcState())) {
+    portENTER_CRITICAL(&calMux);
+    capSumMa += rawMa;
+    capCnt++;
+    portEXIT_CRITICAL(&calMux);
+  }
+
+  if (rawMa <= 0) {
+    return rawMa;
+  }
+
+  portENTER_CRITICAL(&calMux); // Claim the active slot, buildCalTable() will not write it.
+  calInUse = calActive;
+  portEXIT_CRITICAL(&calMux);
+
+  calMa = calTables[calInUse].lookup(rawMa);
+
+  portENTER_CRITICAL(&calMux);
+  calInUse = -1;
+  portEXIT_CRITICAL(&calMux);
+
+  return calMa;
+}
+
+// *********************************************************************************************
+// Hold the Amps setting used to capture a calibration point, without changing the user's setAmps.
+// On entry amps = 0 to release the hold. The Digital Pot is refreshed.
+void setCalAmps(byte amps)
+{
+  calAmps = amps == 0 ? 0 : constrain(amps, MIN_SET_AMPS, MAX_SET_AMPS);
+  setPotAmps(outputAmps(setAmps), VERBOSE_ON);
+}
+
+// *********************************************************************************************
+// On exit, returns the Amps setting held by the Amps Calibration page, 0 = None.
+byte getCalAmps(void)
+{
+  return calAmps;
+}
+
+// *********************************************************************************************
+// Start capturing the welder reading for a calibration point. The welder must be welding (or on a load bank).
+// On exit, returns false if the point is out of range or a capture is in progress.
+bool startAmpsCapture(int point)
+{
+  if ((point < 0) || (point >= CAL_POINTS) || capturing) {
+    return false;
+  }
+
+  portENTER_CRITICAL(&calMux);
+  capSumMa = 0;
+  capCnt   = 0;
+  portEXIT_CRITICAL(&calMux);
+  capPoint  = point;
+  capMillis = millis();
+  capturing = true;
+  Serial.println("Amps Calibration: Capturing point " + String(point + 1) + ".");
+
+  return true;
+}
+
+// *********************************************************************************************
+// On exit, returns true if a welder reading is being captured.
+bool isAmpsCapturing(void)
+{
+  return capturing;
+}
+
+// *********************************************************************************************
+// Get a calibration point, in 0.1A. On exit, returns false if the point is unused.
+bool getAmpsCalPoint(int point, uint16_t *readX10, uint16_t *meterX10)
+{
+  if ((point < 0) || (point >= CAL_POINTS) || (calRec.readX10[point] == 0)) {
+    return false;
+  }
+
+  *readX10  = calRec.readX10[point];
+  *meterX10 = calRec.meterX10[point];
+
+  return true;
+}
+
+// *********************************************************************************************
+// Set a calibration point, in 0.1A. readX10 = 0 clears the point.
+// On exit, returns false if the point would make the calibration non-monotonic (not changed).
+bool setAmpsCalPoint(int point, uint16_t readX10, uint16_t meterX10)
+{
+  AmpsCalRec rec = calRec;
+
+  if ((point < 0) || (point >= CAL_POINTS)) {
+    return false;
+  }
+
+  rec.readX10[point]  = readX10;
+  rec.meterX10[point] = readX10 == 0 ? 0 : meterX10;
+
+  if (!buildCalTable(rec)) {
+    return false;
+  }
+
+  calRec = rec;
+  saveCalRec();
+
+  return true;
+}
+
+// *********************************************************************************************
+// Finish a capture and commit calibration changes. Called from loop().
+void processAmpsCal(void)
+{
+  int64_t  sum;
+  uint32_t cnt;
+  uint16_t readX10;
+  uint16_t meterX10;
+
+  if (capturing && (millis() - capMillis >= CAL_CAPTURE_MS)) {
+    portENTER_CRITICAL(&calMux);
+    capturing = false;
+    sum       = capSumMa;
+    cnt       = capCnt;
+    portEXIT_CRITICAL(&calMux);
+
+    readX10 = cnt == 0 ? 0 : (uint16_t)(constrain((sum / cnt + 50) / 100, 0LL, 9999LL));
+
+    if (readX10 * 100 < CAL_MIN_AMPS * 1000) {
+      Serial.println("Amps Calibration: Point " + String(capPoint + 1) + " not captured, no welding current.");
+    }
+    else {
+      meterX10 = (uint16_t)((calTables[calActive].lookup(readX10 * 100) + 50) / 100); // Start at the present reading.
+
+      if (setAmpsCalPoint(capPoint, readX10, meterX10)) {
+        Serial.println("Amps Calibration: Point " + String(capPoint + 1) + " reads " + String(readX10 / 10.0f, 1) + "A.");
+      }
+      else {
+        Serial.println("Amps Calibration: Point " + String(capPoint + 1) + " rejected, not monotonic.");
+      }
+    }
+    refreshAmpsCal();
+  }
+
+  if (calDirty && (millis() - calMillis >= EEP_DELAY_TIME)) {
+    calDirty = false;
+    EEPROM.commit();
+    Serial.println("Amps Calibration saved.");
+  }
+}
+
+// *********************************************************************************************
+// Amps Calibration serial commands: cal list, cal set <point> <reading> <meter> (Amps), cal clear [point].
+// On exit, returns false if cmd is not a calibration command.
+bool ampsCalCmd(const String& cmd)
+{
+  uint16_t readX10;
+  uint16_t meterX10;
+  int      point;
+  int      sp1;
+  int      sp2;
+
+  if (!cmd.startsWith("cal")) {
+    return false;
+  }
+
+  if (cmd == "cal list") {
+    Serial.println("Amps Calibration: " + String(calTables[calActive].points()) + " Table Points.");
+
+    for (int i = 0; i < CAL_POINTS; i++) {
+      if (getAmpsCalPoint(i, &readX10, &meterX10)) {
+        Serial.println(" #" + String(i + 1) + ": Reading " + String(readX10 / 10.0f, 1) + "A, Meter " +
+                       String(meterX10 / 10.0f, 1) + "A.");
+      }
+    }
+  }
+  else if (cmd.startsWith("cal set ")) {
+    sp1      = cmd.indexOf(' ', 8);
+    sp2      = sp1 < 0 ? -1 : cmd.indexOf(' ', sp1 + 1);
+    point    = cmd.substring(8).toInt() - 1;
+    readX10  = sp2 < 0 ? 0 : (uint16_t)(cmd.substring(sp1 + 1, sp2).toFloat() * 10.0f + 0.5f);
+    meterX10 = sp2 < 0 ? 0 : (uint16_t)(cmd.substring(sp2 + 1).toFloat() * 10.0f + 0.5f);
+
+    if ((readX10 == 0) || !setAmpsCalPoint(point, readX10, meterX10)) {
+      Serial.println("# error: bad point, or not monotonic");
+    }
+    else {
+      Serial.println("Amps Calibration: Point " + String(point + 1) + " set.");
+      refreshAmpsCal();
+    }
+  }
+  else if (cmd == "cal clear") {
+    for (int i = 0; i < CAL_POINTS; i++) {
+      setAmpsCalPoint(i, 0, 0);
+    }
+    Serial.println("Amps Calibration: Cleared.");
+    refreshAmpsCal();
+  }
+  else if (cmd.startsWith("cal clear ")) {
+    point = cmd.substring(10).toInt() - 1;
+    Serial.println(setAmpsCalPoint(point, 0, 0) ? "Amps Calibration: Point " + String(point + 1) + " cleared." :
+                   String("# error: bad point"));
+    refreshAmpsCal();
+  }
+  else {
+    Serial.println("Amps Calibration Commands: cal list, cal set <n> <reading> <meter>, cal clear [n].");
+  }
+
+  return true;
+}
+
+// EOF
@@ -0,0 +1,88 @@
+/*
+   File: antiStick.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+ */
+
+#include "antiStick.h"
+
+// *********************************************************************************************
+StickDetector::StickDetector(void)
+{
+  cfg.stickVolts = 0;
+  cfg.minAmps    = 0;
+  cfg.detectSec  = 0;
+  cfg.clearVolts = 0;
+  cfg.clearSec   = 0;
+  reset();
+}
+
+// *********************************************************************************************
+// Load the detector settings and clear the stuck state.
+void StickDetector::begin(const StickCfg& newCfg)
+{
+  cfg = newCfg;
+  reset();
+}
+
+// *********************************************************************************************
+// Clear the stuck state and timers.
+void StickDetector::reset(void)
+{
+  lowTime  = 0;
+  highTime = 0;
+  isStuck  = false;
+}
+
+// *********************************************************************************************
+// Process one voltage sample (or sample block) that covers dt seconds.
+// Current is only checked on entry to the stuck state; Once stuck, only the voltage can clear it.
+// On exit, returns true if the rod is stuck.
+bool StickDetector::update(float volts, float amps, float dt)
+{
+  if (!isStuck) {
+    if ((volts < cfg.stickVolts) && (amps >= cfg.minAmps)) {
+      lowTime += dt;
+
+      if (lowTime >= cfg.detectSec) {
+        isStuck  = true;
+        highTime = 0;
+      }
+    }
+    else {
+      lowTime = 0;
+    }
+  }
+  else {
+    if (volts >= cfg.clearVolts) {
+      highTime += dt;
+
+      if (highTime >= cfg.clearSec) {
+        isStuck = false;
+        lowTime = 0;
+      }
+    }
+    else {
+      highTime = 0;
+    }
+  }
+
+  return isStuck;
+}
+
+// *********************************************************************************************
+// On exit, returns true if the rod is stuck.
+bool StickDetector::stuck(void) const
+{
+  return isStuck;
+}
+
+// EOF
@@ -0,0 +1,52 @@
+/*
+   File: antiStick.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Anti-Stick Detector. A stuck rod is a dead short: Low arc voltage while welding current is flowing. Brief shorts
+      from metal droplets are normal and are ignored by requiring the short to last for the detect time.
+   2. This file and antiStick.cpp do not use the Arduino libraries. They can be compiled on a PC, see weldSim.cpp.
+ */
+#ifndef __ANTI_STICK_H__
+#define __ANTI_STICK_H__
+
+// Anti-Stick Detector settings.
+struct StickCfg {
+  float stickVolts; // Short circuit threshold, in Volts. Arc voltage below this is a short.
+  float minAmps;    // Minimum welding current for a stuck rod, in Amps.
+  float detectSec;  // Time the short must last to be declared a stuck rod, in seconds.
+  float clearVolts; // Voltage that shows the short has cleared, in Volts.
+  float clearSec;   // Time the voltage must stay above clearVolts, in seconds.
+};
+
+class StickDetector {
+public:
+
+  StickDetector(void);
+  void begin(const StickCfg& cfg);
+  void reset(void);
+  bool update(float volts,
+              float amps,
+              float dt);
+  bool stuck(void) const;
+
+private:
+
+  StickCfg cfg;      // Detector settings.
+  float    lowTime;  // Time spent in short circuit, in seconds.
+  float    highTime; // Time spent above clearVolts while stuck, in seconds.
+  bool     isStuck;  // Stuck rod state.
+};
+
+#endif // ifndef __ANTI_STICK_H__
+
+// EOF
@@ -0,0 +1,447 @@
+/*
+   File: arcCtrl.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Arc Features. processArcCtrl() is called by the Control Task on every tick. It uses the fast Welding Voltage
+      blocks (VDC_DMA_ON) and the non-averaged Amps (getFastAmps()), not the averaged values shown on the display.
+   2. All Amps requests for the Digital Pot pass through outputAmps(), which applies the arc features to the requested
+      (demand) Amps. The arc features must not call setPotAmps() with any other value. A Wiper held by the Pot
+      characterization sweep (setPotOverride()) is limited by outputLimitAmps() instead. The Amps setting held by
+      the Amps Calibration page (setCalAmps()) replaces the requested Amps.
+   3. Anti-Stick (ANTI_STICK_ON in config.h): A stuck rod reduces the current to ARC_OFF_AMPS until the short clears.
+   4. Arc Force (ARC_FORCE_ON in config.h): Current is boosted in proportion to arc voltage sag. The time from the
+      Voltage block that caused a boost change to the completed Digital Pot write is measured, see getArcLatency().
+   5. Hot Start (HOT_START_ON in config.h): Current is boosted at each rod strike, then ramped down to the requested
+      Amps. The boost level and time are user settings (hotStartPc, hotStartX10). When both Hot Start and Arc Force
+      are boosting, the larger boost is used.
+   6. Arc State Machine (arcState.cpp): detectArcState() is called by the Control Task on every tick. State changes
+      are published to the subscribers (subscribeArcState()) so other modules do not infer the arc state from the
+      averaged Amps. Without VDC_DMA_ON the state machine uses the (slower) Volts control filter, getFastVoltsCv().
+   7. Arc On/Off (controlArc()) and the OC LED alert check (checkForAlerts()) use the Hardware Abstraction Layer
+      (hal.h), so this file also runs in the PC simulator (ctrlSim.cpp).
+ */
+
+#include <Arduino.h>
+#include "antiStick.h"
+#include "arcForce.h"
+#include "arcState.h"
+#include "hal.h"
+#include "hotStart.h"
+#include "PulseWelder.h"
+#include "telemetry.h"
+#include "config.h"
+
+#define ARC_MAX_DT 0.01f // Longest Voltage block interval used by the detectors, in seconds.
+
+// Global System vars
+extern byte arcSwitch;   // Welding Arc On/Off Switch.
+extern byte hotStartPc;  // Hot Start boost (%).
+extern byte hotStartX10; // Hot Start time, in seconds times ten.
+extern bool overTempAlert; // Over Temperature (OC) Alert.
+extern byte setAmps;     // Welding Amps *User Setting*.
+extern volatile unsigned int Volts; // Measured Welding Volts.
+
+// Local Scope Vars
+static volatile byte     demandAmps = MIN_AMPS; // Latest Amps request, before the arc features are applied.
+static volatile bool     stickState = false;    // Anti-Stick has reduced the current.
+static volatile uint32_t stickCnt   = 0;        // Number of stuck rod events.
+static volatile byte     forceAmps  = 0;        // Arc Force boost, in Amps.
+static volatile byte     hotAmps    = 0;        // Hot Start boost, in Amps.
+static volatile uint32_t strikeCnt  = 0;        // Number of Hot Start rod strikes.
+static uint32_t          lastBlkUs  = 0;        // Time of the last Voltage block processed, in uS.
+static uint32_t          detectUs   = 0;        // Time of the Voltage block that caused a pending Pot write, in uS.
+static ArcLatency        latency;               // Arc Force detection to Pot write latency.
+static uint64_t          latencyTotalUs = 0;    // Latency totalizer, for average.
+static portMUX_TYPE      latencyMux = portMUX_INITIALIZER_UNLOCKED; // Protects the latency counters.
+static ArcStateMachine   arcStateMachine;       // Arc State Machine.
+static volatile ArcState arcStateNow = ARC_ST_OPEN; // Latest arc state.
+static ArcStateCallback  subscribers[ARC_SUBSCRIBERS]; // Arc State change subscribers.
+static volatile int      subscriberCnt = 0;     // Number of Arc State subscribers.
+static portMUX_TYPE      subscriberMux = portMUX_INITIALIZER_UNLOCKED; // Protects the subscriber list.
+#ifdef ANTI_STICK_ON
+static StickDetector stickDetector;             // Anti-Stick Detector.
+#endif // ifdef ANTI_STICK_ON
+#ifdef ARC_FORCE_ON
+static ArcForce arcForce;                       // Arc Force (Dig).
+#endif // ifdef ARC_FORCE_ON
+#ifdef HOT_START_ON
+static HotStart hotStart;                       // Hot Start.
+#endif // ifdef HOT_START_ON
+
+// *********************************************************************************************
+// Load the arc feature settings. Called once by initControlTask().
+void initArcCtrl(void)
+{
+  ArcStateCfg stateCfg;
+  stateCfg.ocvVolts    = ARC_OCV_VOLTS;
+  stateCfg.strikeVolts = ARC_STRIKE_VOLTS;
+  stateCfg.shortVolts  = STICK_VOLTS;
+  stateCfg.clearVolts  = STICK_CLEAR_VOLTS;
+  stateCfg.minAmps     = ARC_DET_AMPS;
+  stateCfg.edgeVps     = ARC_EDGE_VPMS * 1000.0f;
+  stateCfg.edgeAps     = ARC_EDGE_APMS * 1000.0f;
+  stateCfg.slopeSec    = ARC_SLOPE_TIME / 1000.0f;
+  stateCfg.stableSec   = ARC_STABLE_TIME / 1000.0f;
+  stateCfg.stuckSec    = STICK_TIME / 1000.0f;
+  stateCfg.outSec      = ARC_OUT_TIME / 1000.0f;
+  arcStateMachine.begin(stateCfg);
+
+#ifdef ANTI_STICK_ON
+  StickCfg stickCfg;
+  stickCfg.stickVolts = STICK_VOLTS;
+  stickCfg.minAmps    = STICK_AMPS;
+  stickCfg.detectSec  = STICK_TIME / 1000.0f;
+  stickCfg.clearVolts = STICK_CLEAR_VOLTS;
+  stickCfg.clearSec   = STICK_CLEAR_TIME / 1000.0f;
+  stickDetector.begin(stickCfg);
+  Serial.println("Anti-Stick Enabled: " + String(STICK_VOLTS) + "V for " + String(STICK_TIME) + "mS.");
+#endif // ifdef ANTI_STICK_ON
+
+#ifdef ARC_FORCE_ON
+  ArcForceCfg forceCfg;
+  forceCfg.forcePc        = ARC_FORCE_PC;
+  forceCfg.thresholdVolts = ARC_FORCE_VOLTS;
+  forceCfg.spanVolts      = ARC_FORCE_SPAN;
+  forceCfg.minAmps        = STICK_AMPS;
+  forceCfg.maxAmps        = MAX_SET_AMPS;
+  arcForce.begin(forceCfg);
+  Serial.println("Arc Force Enabled: " + String(ARC_FORCE_PC) + "% below " + String(ARC_FORCE_VOLTS) + "V.");
+#endif // ifdef ARC_FORCE_ON
+
+#ifdef HOT_START_ON
+  HotStartCfg hotCfg;
+  hotCfg.boostPc     = hotStartPc;
+  hotCfg.holdSec     = hotStartX10 / 10.0f;
+  hotCfg.rampSec     = HOT_RAMP_TIME / 1000.0f;
+  hotCfg.armVolts    = HOT_ARM_VOLTS;
+  hotCfg.armSec      = HOT_ARM_TIME / 1000.0f;
+  hotCfg.strikeVolts = HOT_STRIKE_VOLTS;
+  hotCfg.minAmps     = STICK_AMPS;
+  hotCfg.maxAmps     = MAX_SET_AMPS;
+  hotStart.begin(hotCfg);
+  Serial.println("Hot Start Enabled: " + String(hotStartPc) + "% for " + String(hotStartX10 / 10.0f, 1) + "S.");
+#endif // ifdef HOT_START_ON
+}
+
+// *********************************************************************************************
+// Apply the thermal derating limit, arc features (and Closed-Loop Regulator trim) to the requested Amps.
+// Use with setPotAmps(), for example setPotAmps(outputAmps(setAmps), VERBOSE_OFF).
+// On exit, returns the Amps value to send to the Digital Pot.
+byte outputAmps(byte amps)
+{
+  byte held = getCalAmps();
+
+  amps       = thermalLimitAmps(held != 0 ? held : amps);
+  demandAmps = amps;
+
+  if (stickState) {
+    return ARC_OFF_AMPS;
+  }
+
+  return (byte)(constrain((int)(regulatedAmps(amps)) + max(forceAmps, hotAmps), MIN_AMPS, MAX_SET_AMPS));
+}
+
+// *********************************************************************************************
+// On exit, returns the most Amps the Digital Pot may deliver: ARC_OFF_AMPS while the Arc is off or Anti-Stick has
+// reduced the current, else the thermal derating limit (at most MAX_SET_AMPS). Used by setPotAmps() for a held Wiper.
+byte outputLimitAmps(void)
+{
+  if ((arcSwitch != ARC_ON) || stickState) {
+    return ARC_OFF_AMPS;
+  }
+
+  return thermalLimitAmps(MAX_SET_AMPS);
+}
+
+// *********************************************************************************************
+// Run the arc feature detectors on the newest Welding Voltage block. Called by the Control Task.
+// The Digital Pot is updated immediately when a feature changes the output.
+void processArcCtrl(void)
+{
+  VdcBlock blk;
+  float    dt;
+  bool     changed = false;
+  uint32_t writeUs = getPotWriteUs();
+
+  if ((detectUs != 0) && ((int32_t)(writeUs - detectUs) >= 0)) { // Pending Pot write has completed.
+    portENTER_CRITICAL(&latencyMux);
+    latency.count++;
+    latency.maxUs   = max(latency.maxUs, writeUs - detectUs);
+    latencyTotalUs += writeUs - detectUs;
+    portEXIT_CRITICAL(&latencyMux);
+    detectUs = 0;
+  }
+
+  if (!getVdcBlock(&blk) || (blk.timeUs == lastBlkUs)) {
+    return; // No new Voltage block.
+  }
+  dt        = lastBlkUs == 0 ? 0 : (blk.timeUs - lastBlkUs) / 1000000.0f;
+  dt        = dt > ARC_MAX_DT ? ARC_MAX_DT : dt;
+  lastBlkUs = blk.timeUs;
+
+  if (arcSwitch != ARC_ON) {
+#ifdef ANTI_STICK_ON
+    stickDetector.reset();
+#endif // ifdef ANTI_STICK_ON
+#ifdef ARC_FORCE_ON
+    arcForce.reset();
+#endif // ifdef ARC_FORCE_ON
+#ifdef HOT_START_ON
+    hotStart.reset();
+#endif // ifdef HOT_START_ON
+    stickState = false;
+    forceAmps  = 0;
+    hotAmps    = 0;
+    return;
+  }
+
+#ifdef ANTI_STICK_ON
+  if (stickDetector.update(blk.avgCv / 100.0f, getFastAmps(), dt) != stickState) {
+    stickState = stickDetector.stuck();
+    stickCnt  += stickState ? 1 : 0;
+    changed    = true;
+  }
+#endif // ifdef ANTI_STICK_ON
+
+#ifdef ARC_FORCE_ON
+  byte boost = (byte)(arcForce.update(blk.avgCv / 100.0f, getFastAmps(), regulatedAmps(demandAmps)) + 0.5f);
+
+  if (boost != forceAmps) {
+    forceAmps = boost;
+    changed   = true;
+  }
+#endif // ifdef ARC_FORCE_ON
+
+#ifdef HOT_START_ON
+  bool wasActive = hotStart.active();
+
+  hotStart.setBoost(hotStartPc, hotStartX10 / 10.0f);
+  byte hotBoost = (byte)(hotStart.update(blk.avgCv / 100.0f, getFastAmps(), regulatedAmps(demandAmps), dt) + 0.5f);
+  strikeCnt += (hotStart.active() && !wasActive) ? 1 : 0;
+
+  if (hotBoost != hotAmps) {
+    hotAmps = hotBoost;
+    changed = true;
+  }
+#endif // ifdef HOT_START_ON
+
+  if (changed && setPotAmps(outputAmps(demandAmps), VERBOSE_OFF) && (detectUs == 0)) {
+    detectUs = blk.timeUs; // Pot write started, measure the latency when it completes.
+  }
+}
+
+// *********************************************************************************************
+// Arc State Machine. Called by the Control Task on every tick.
+// Uses the newest Voltage block (VDC_DMA_ON) or the averaged Volts. State changes are sent to the subscribers.
+void detectArcState(void)
+{
+  static uint32_t lastUs = 0; // Time of the last update, in uS.
+  ArcEvent evt;
+  float    volts;
+  float    dt;
+  int      i;
+  int      cnt;
+
+#ifdef VDC_DMA_ON
+  VdcBlock blk;
+
+  if (!getVdcBlock(&blk) || (blk.timeUs == lastUs)) {
+    return; // No new Voltage block.
+  }
+  volts      = blk.avgCv / 100.0f;
+  evt.timeUs = blk.timeUs;
+#else // ifdef VDC_DMA_ON
+  volts      = getFastVoltsCv() / 100.0f;
+  evt.timeUs = halMicros();
+#endif // ifdef VDC_DMA_ON
+  dt     = lastUs == 0 ? 0 : (evt.timeUs - lastUs) / 1000000.0f;
+  dt     = dt > ARC_MAX_DT ? ARC_MAX_DT : dt;
+  lastUs = evt.timeUs;
+
+  if (arcSwitch != ARC_ON) {
+    volts = ARC_OCV_VOLTS; // Arc current is off; Treat as open circuit (rod cannot burn).
+  }
+
+  evt.amps = getFastAmps();
+
+  if (!arcStateMachine.update(volts, evt.amps, dt)) {
+    return;
+  }
+
+  evt.state     = arcStateMachine.state();
+  evt.prevState = arcStateMachine.prevState();
+  evt.prevUs    = (uint32_t)(arcStateMachine.prevSec() * 1000000.0f);
+  evt.volts     = volts;
+  arcStateNow   = evt.state;
+
+  portENTER_CRITICAL(&subscriberMux);
+  cnt = subscriberCnt;
+  portEXIT_CRITICAL(&subscriberMux);
+
+  for (i = 0; i < cnt; i++) { // Subscribers are never removed, the list can be read without the lock.
+    subscribers[i](evt);
+  }
+}
+
+// *********************************************************************************************
+// On exit, returns the latest arc state.
+ArcState getArcState(void)
+{
+  return arcStateNow;
+}
+
+// *********************************************************************************************
+// Add an Arc State change subscriber. The callback is called by the Control Task; Keep it short (set flags).
+// On exit, returns false if the subscriber list is full.
+bool subscribeArcState(ArcStateCallback callback)
+{
+  bool success = false;
+
+  portENTER_CRITICAL(&subscriberMux);
+
+  if (subscriberCnt < ARC_SUBSCRIBERS) {
+    subscribers[subscriberCnt] = callback;
+    subscriberCnt++;
+    success = true;
+  }
+  portEXIT_CRITICAL(&subscriberMux);
+
+  if (!success) {
+    Serial.println("Arc State: Subscriber list is full!");
+  }
+
+  return success;
+}
+
+// *********************************************************************************************
+// Get a copy of the Arc Force latency counters (Voltage block to completed Digital Pot write).
+// On entry rst = true to clear the worst-case value after it is copied.
+void getArcLatency(ArcLatency *lat, bool rst)
+{
+  portENTER_CRITICAL(&latencyMux);
+  *lat       = latency;
+  lat->avgUs = latency.count == 0 ? 0 : (uint32_t)(latencyTotalUs / latency.count);
+
+  if (rst) {
+    latency.maxUs = 0;
+  }
+  portEXIT_CRITICAL(&latencyMux);
+}
+
+// *********************************************************************************************
+// Log the arc feature events. Called from loop().
+void processArcEvents(void)
+{
+  static uint32_t reportedStickCnt  = 0;
+  static uint32_t reportedStrikeCnt = 0;
+  static bool     reportedStick    = false;
+
+  if (stickCnt != reportedStickCnt) {
+    reportedStickCnt = stickCnt;
+    Serial.println("Anti-Stick: Stuck Rod Detected, Current Reduced to " + String(ARC_OFF_AMPS) + " Amps.");
+    telemEvent(TLM_EVT_STICK, reportedStickCnt);
+  }
+
+  if (strikeCnt != reportedStrikeCnt) {
+    reportedStrikeCnt = strikeCnt;
+    Serial.println("Hot Start: Rod Strike Detected, Boost " + String(hotStartPc) + "% for " + String(hotStartX10 / 10.0f, 1) + "S.");
+    telemEvent(TLM_EVT_HOT_START, reportedStrikeCnt);
+  }
+
+  if (reportedStick && !stickState) {
+    Serial.println("Anti-Stick: Short Cleared, Current Restored.");
+    telemEvent(TLM_EVT_UNSTICK, 0);
+  }
+  reportedStick = stickState;
+}
+
+// *********************************************************************************************
+// Check Welder's OC Led signal for alert condition. Could be over-heat or over-current state.
+void checkForAlerts(void)
+{
+    bool wasAlert = overTempAlert;
+
+    overTempAlert = halOcAlert(); // Get OC Warning LED State.
+    if(overTempAlert != wasAlert) {
+        telemEvent(TLM_EVT_HEAT, overTempAlert);
+        evlogEvent(overTempAlert ? EVT_OC_ALERT : EVT_OC_END, (int16_t)(lroundf(getThermalHeat())), setAmps);
+    }
+    if(overTempAlert) {
+        arcSwitch = ARC_OFF;
+        disableArc(VERBOSE_OFF);         // Disable Arc current.
+    }
+}
+
+// *********************************************************************************************
+// Control Welding Arc Current.
+// state = ARC_ON or ARC_OFF
+// verbose = VERBOSE_ON (true) for expanded log messages, else VERBOSE_OFF (false) for less messages.
+void controlArc(bool state, bool verbose)
+{
+  if (state == ARC_ON)
+  {
+    enableArc(verbose);
+  }
+  else
+  {
+    disableArc(verbose);
+  }
+}
+
+// *********************************************************************************************
+// Disable the Arc current.
+// verbose = VERBOSE_ON (true) for expanded log messages, else VERBOSE_OFF (false) for less messages.
+// PWM Shutdown control option requires hardware mod; Lift SG3525A pin 10, connect it
+// to ESP32's SHDN_PIN (default is GPIO15)
+void disableArc(bool verbose)
+{
+  arcSwitch = ARC_OFF;
+
+  setPotAmps(ARC_OFF_AMPS, verbose); // Set Digital Pot to lowest welding current.
+
+  #ifdef PWM_ARC_CTRL
+   halPwmEnable(false);  // Disable PWM Controller.
+   if (verbose == VERBOSE_ON) {
+     Serial.println("Arc Current Turned Off (Disabled PWM Controller).");
+   }
+  #else
+   halPwmEnable(true); // PWM feature disabled by config.h; Don't shutdown!
+   if (verbose == VERBOSE_ON) {
+     Serial.println("Arc Current Suppressed (Reduced to " + String(ARC_OFF_AMPS) + " Amps).");
+   }
+  #endif
+}
+
+// *********************************************************************************************
+// Enable the Arc current.
+// verbose = VERBOSE_ON (true) for expanded log messages, else VERBOSE_OFF (false) for less messages.
+// PWM Shutdown control option requires hardware mod; Lift SG3525A pin 10, connect ot
+// to ESP32's SHDN_PIN (default is GPIO15)
+void enableArc(bool verbose)
+{
+    if(overTempAlert) {
+        if (verbose == VERBOSE_ON) {
+            Serial.println("Arc Current Cannot be Turned On (Alarm State!)");
+        }
+    }
+    else {
+        arcSwitch = ARC_ON;
+        setPotAmps(outputAmps(setAmps), verbose); // Refresh Digital Pot.
+        halPwmEnable(true);
+        if (verbose == VERBOSE_ON) {
+            Serial.println("Arc Current Turned On (" + String(setAmps) + " Amps).");
+        }
+    }
+}
+
+// EOF
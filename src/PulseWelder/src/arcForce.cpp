@@ -0,0 +1,76 @@
+/*
+   File: arcForce.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+ */
+
+#include "arcForce.h"
+
+// *********************************************************************************************
+ArcForce::ArcForce(void)
+{
+  cfg.forcePc        = 0;
+  cfg.thresholdVolts = 0;
+  cfg.spanVolts      = 1;
+  cfg.minAmps        = 0;
+  cfg.maxAmps        = 0;
+  reset();
+}
+
+// *********************************************************************************************
+// Load the Arc Force settings and clear the boost.
+void ArcForce::begin(const ArcForceCfg& newCfg)
+{
+  cfg           = newCfg;
+  cfg.spanVolts = cfg.spanVolts < 0.1f ? 0.1f : cfg.spanVolts;
+  reset();
+}
+
+// *********************************************************************************************
+// Clear the boost.
+void ArcForce::reset(void)
+{
+  boostAmps = 0;
+}
+
+// *********************************************************************************************
+// Calculate the boost for the newest arc voltage.
+// demandAmps is the requested Amps before the boost. demandAmps + boost never exceeds cfg.maxAmps.
+// On exit, returns the boost, in Amps.
+float ArcForce::update(float volts, float amps, float demandAmps)
+{
+  float sag;
+
+  if ((amps < cfg.minAmps) || (volts >= cfg.thresholdVolts)) {
+    boostAmps = 0;
+    return boostAmps;
+  }
+
+  sag       = (cfg.thresholdVolts - volts) / cfg.spanVolts;
+  sag       = sag > 1.0f ? 1.0f : sag;
+  boostAmps = demandAmps * cfg.forcePc * sag / 100.0f;
+
+  if (demandAmps + boostAmps > cfg.maxAmps) {
+    boostAmps = cfg.maxAmps - demandAmps;
+    boostAmps = boostAmps < 0 ? 0 : boostAmps;
+  }
+
+  return boostAmps;
+}
+
+// *********************************************************************************************
+// On exit, returns the present boost, in Amps.
+float ArcForce::boost(void) const
+{
+  return boostAmps;
+}
+
+// EOF
@@ -0,0 +1,50 @@
+/*
+   File: arcForce.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Arc Force (Dig). When the arc gets short the arc voltage sags. The current is boosted in proportion to the sag
+      so the rod does not snuff out. No boost above thresholdVolts, full boost at (thresholdVolts - spanVolts).
+   2. This file and arcForce.cpp do not use the Arduino libraries. They can be compiled on a PC, see weldSim.cpp.
+ */
+#ifndef __ARC_FORCE_H__
+#define __ARC_FORCE_H__
+
+// Arc Force settings.
+struct ArcForceCfg {
+  float forcePc;        // Boost at full sag, percent of the requested Amps.
+  float thresholdVolts; // Sag threshold, in Volts. No boost above this voltage.
+  float spanVolts;      // Sag (below thresholdVolts) for full boost, in Volts.
+  float minAmps;        // Minimum welding current for boost (arc is established), in Amps.
+  float maxAmps;        // Boosted current limit, in Amps.
+};
+
+class ArcForce {
+public:
+
+  ArcForce(void);
+  void  begin(const ArcForceCfg& cfg);
+  void  reset(void);
+  float update(float volts,
+               float amps,
+               float demandAmps);
+  float boost(void) const;
+
+private:
+
+  ArcForceCfg cfg;      // Arc Force settings.
+  float       boostAmps; // Present boost, in Amps.
+};
+
+#endif // ifndef __ARC_FORCE_H__
+
+// EOF
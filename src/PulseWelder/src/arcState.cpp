@@ -0,0 +1,221 @@
+/*
+   File: arcState.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+ */
+
+#include "arcState.h"
+
+// *********************************************************************************************
+ArcStateMachine::ArcStateMachine(void)
+{
+  cfg.ocvVolts    = 0;
+  cfg.strikeVolts = 0;
+  cfg.shortVolts  = 0;
+  cfg.clearVolts  = 0;
+  cfg.minAmps     = 0;
+  cfg.edgeVps     = 0;
+  cfg.edgeAps     = 0;
+  cfg.slopeSec    = 0;
+  cfg.stableSec   = 0;
+  cfg.stuckSec    = 0;
+  cfg.outSec      = 0;
+  reset();
+}
+
+// *********************************************************************************************
+// Load the Arc State Machine settings and return to the open circuit state.
+void ArcStateMachine::begin(const ArcStateCfg& newCfg)
+{
+  cfg = newCfg;
+  reset();
+}
+
+// *********************************************************************************************
+// Return to the open circuit state and clear the slope history.
+void ArcStateMachine::reset(void)
+{
+  curState  = ARC_ST_OPEN;
+  oldState  = ARC_ST_OPEN;
+  curSec    = 0;
+  oldSec    = 0;
+  arcSec    = 0;
+  shortSec  = 0;
+  lastVolts = 0;
+  lastAmps  = 0;
+  voltSlope = 0;
+  ampSlope  = 0;
+  primed    = false;
+}
+
+// *********************************************************************************************
+// Change state. The time spent in the old state is kept for the state change event.
+void ArcStateMachine::enter(ArcState newState)
+{
+  oldState = curState;
+  oldSec   = curSec;
+  curState = newState;
+  curSec   = 0;
+  arcSec   = 0;
+  shortSec = 0;
+}
+
+// *********************************************************************************************
+// On exit, returns true if the voltage or current shows a rod strike (from open circuit or arc out).
+bool ArcStateMachine::isStrike(float volts, float amps) const
+{
+  return (volts < cfg.strikeVolts) ||
+         ((volts < cfg.ocvVolts) && (voltSlope <= -cfg.edgeVps)) ||
+         ((amps >= cfg.minAmps) && (ampSlope >= cfg.edgeAps));
+}
+
+// *********************************************************************************************
+// Run the state machine on the newest arc voltage and current. Call every dt seconds.
+// On exit, returns true if the state changed.
+bool ArcStateMachine::update(float volts, float amps, float dt)
+{
+  ArcState entryState = curState;
+  float    k;
+
+  if (primed && (dt > 0)) { // Filtered slopes.
+    k          = dt >= cfg.slopeSec ? 1.0f : dt / cfg.slopeSec;
+    voltSlope += (((volts - lastVolts) / dt) - voltSlope) * k;
+    ampSlope  += (((amps - lastAmps) / dt) - ampSlope) * k;
+  }
+  lastVolts = volts;
+  lastAmps  = amps;
+  primed    = true;
+  curSec   += dt;
+
+  switch (curState) {
+    case ARC_ST_OPEN:
+
+      if (isStrike(volts, amps)) {
+        enter(ARC_ST_STRIKE);
+      }
+      break;
+
+    case ARC_ST_STRIKE:
+
+      if (volts >= cfg.ocvVolts) { // Rod lifted before the arc was established.
+        enter(ARC_ST_OUT);
+      }
+      else if (volts < cfg.shortVolts) { // Rod contact or droplet short; Arc time is paused, not cleared.
+        shortSec += dt;
+
+        if (shortSec >= cfg.stuckSec) {
+          enter(ARC_ST_STUCK);
+        }
+      }
+      else {
+        shortSec = 0;
+        arcSec  += dt;
+
+        if (arcSec >= cfg.stableSec) {
+          enter(ARC_ST_STABLE);
+        }
+      }
+      break;
+
+    case ARC_ST_STABLE:
+
+      if ((volts >= cfg.ocvVolts) || ((amps < cfg.minAmps) && (ampSlope <= -cfg.edgeAps))) {
+        enter(ARC_ST_OUT);
+      }
+      else if (volts < cfg.shortVolts) {
+        enter(ARC_ST_SHORT);
+      }
+      break;
+
+    case ARC_ST_SHORT:
+
+      if (volts >= cfg.ocvVolts) {
+        enter(ARC_ST_OUT);
+      }
+      else if (volts >= cfg.clearVolts) { // Droplet transfer complete.
+        enter(ARC_ST_STABLE);
+      }
+      else if (curSec >= cfg.stuckSec) {
+        enter(ARC_ST_STUCK);
+      }
+      break;
+
+    case ARC_ST_STUCK:
+
+      if (volts >= cfg.ocvVolts) { // Rod pulled free.
+        enter(ARC_ST_OUT);
+      }
+      else if (volts >= cfg.clearVolts) { // Short cleared, arc is re-established.
+        enter(ARC_ST_STRIKE);
+      }
+      break;
+
+    case ARC_ST_OUT:
+
+      if ((volts < cfg.ocvVolts) && isStrike(volts, amps)) {
+        enter(ARC_ST_STRIKE);
+      }
+      else if (curSec >= cfg.outSec) {
+        enter(ARC_ST_OPEN);
+      }
+      break;
+
+    default:
+      enter(ARC_ST_OPEN);
+      break;
+  }
+
+  return curState != entryState;
+}
+
+// *********************************************************************************************
+// On exit, returns the present state.
+ArcState ArcStateMachine::state(void) const
+{
+  return curState;
+}
+
+// *********************************************************************************************
+// On exit, returns the state before the last state change.
+ArcState ArcStateMachine::prevState(void) const
+{
+  return oldState;
+}
+
+// *********************************************************************************************
+// On exit, returns the time in the present state, in seconds.
+float ArcStateMachine::stateSec(void) const
+{
+  return curSec;
+}
+
+// *********************************************************************************************
+// On exit, returns the time spent in the previous state, in seconds.
+float ArcStateMachine::prevSec(void) const
+{
+  return oldSec;
+}
+
+// *********************************************************************************************
+// On exit, returns the filtered voltage slope, in Volts per second.
+float ArcStateMachine::dvdt(void) const
+{
+  return voltSlope;
+}
+
+// *********************************************************************************************
+// On exit, returns the filtered current slope, in Amps per second.
+float ArcStateMachine::didt(void) const
+{
+  return ampSlope;
+}
+
+// EOF
@@ -0,0 +1,107 @@
+/*
+   File: arcState.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Arc State Machine. Classifies the welding arc from the arc voltage and current levels and their slopes (dV/dt,
+      dI/dt). The slopes are first order filtered (slopeSec) so a single noisy sample is not an edge.
+   2. States:
+      ARC_ST_OPEN:   Open circuit, no rod contact. Voltage above ocvVolts.
+      ARC_ST_STRIKE: Rod strike. Falling voltage edge from open circuit (or rising current edge). Becomes stable after
+                     stableSec in the arc voltage range (short circuit time is not counted).
+      ARC_ST_STABLE: Arc established, voltage between shortVolts and ocvVolts.
+      ARC_ST_SHORT:  Short circuit (droplet transfer), voltage below shortVolts.
+      ARC_ST_STUCK:  Short circuit for longer than stuckSec (rod is stuck to the work).
+      ARC_ST_OUT:    Arc went out (voltage jumped back to open circuit). Becomes open after outSec without a restrike.
+   3. This file and arcState.cpp do not use the Arduino libraries. They can be compiled on a PC, see weldSim.cpp.
+ */
+#ifndef __ARC_STATE_H__
+#define __ARC_STATE_H__
+
+enum ArcState {
+  ARC_ST_OPEN = 0,
+  ARC_ST_STRIKE,
+  ARC_ST_STABLE,
+  ARC_ST_SHORT,
+  ARC_ST_STUCK,
+  ARC_ST_OUT,
+  ARC_ST_COUNT // Number of states.
+};
+
+// Arc State Machine settings.
+struct ArcStateCfg {
+  float ocvVolts;    // Open circuit threshold, in Volts. Arc goes out above this voltage.
+  float strikeVolts; // Strike threshold, in Volts. A slow voltage fall below this level is also a strike.
+  float shortVolts;  // Short circuit threshold, in Volts.
+  float clearVolts;  // Short has cleared above this voltage, in Volts. Must be greater than shortVolts.
+  float minAmps;     // Welding current threshold, in Amps.
+  float edgeVps;     // Voltage edge slope, in Volts per second.
+  float edgeAps;     // Current edge slope, in Amps per second.
+  float slopeSec;    // Slope filter time constant, in seconds.
+  float stableSec;   // Time in the arc voltage range before a strike is stable, in seconds.
+  float stuckSec;    // Short circuit time before the rod is stuck, in seconds.
+  float outSec;      // Time after arc out (without a restrike) before open circuit, in seconds.
+};
+
+class ArcStateMachine {
+public:
+
+  ArcStateMachine(void);
+  void     begin(const ArcStateCfg& cfg);
+  void     reset(void);
+  bool     update(float volts,
+                  float amps,
+                  float dt);
+  ArcState state(void) const;
+  ArcState prevState(void) const;
+  float    stateSec(void) const;
+  float    prevSec(void) const;
+  float    dvdt(void) const;
+  float    didt(void) const;
+
+private:
+
+  void     enter(ArcState newState);
+  bool     isStrike(float volts,
+                    float amps) const;
+
+  ArcStateCfg cfg;      // Arc State Machine settings.
+  ArcState    curState; // Present state.
+  ArcState    oldState; // Previous state.
+  float       curSec;   // Time in present state, in seconds.
+  float       oldSec;   // Time spent in previous state, in seconds.
+  float       arcSec;   // Time in the arc voltage range (strike only), in seconds.
+  float       shortSec; // Continuous short circuit time (strike only), in seconds.
+  float       lastVolts; // Previous voltage, for slope.
+  float       lastAmps; // Previous current, for slope.
+  float       voltSlope; // Filtered dV/dt, in Volts per second.
+  float       ampSlope; // Filtered dI/dt, in Amps per second.
+  bool        primed;   // Slope history is valid.
+};
+
+// *********************************************************************************************
+// On exit, returns true if welding current is flowing (rod is in contact or arcing).
+inline bool arcBurning(ArcState state)
+{
+  return (state == ARC_ST_STRIKE) || (state == ARC_ST_STABLE) || (state == ARC_ST_SHORT) || (state == ARC_ST_STUCK);
+}
+
+// *********************************************************************************************
+// On exit, returns true if the arc is established (stable arc or a droplet short).
+inline bool arcEstablished(ArcState state)
+{
+  return (state == ARC_ST_STABLE) || (state == ARC_ST_SHORT);
+}
+
+#endif // ifndef __ARC_STATE_H__
+
+// EOF
@@ -36,7 +36,7 @@ extern XT_MusicScore_Class highBeep;
 extern XT_MusicScore_Class lowBeep;
 
 // Extern Globals
-extern int  Amps;         // Measured Welding Amps.
+extern volatile int Amps; // Measured Welding Amps.
 extern bool bleConnected; // Bluetooth connected flag.
 extern byte bleSwitch;    // Menu Switch, Bluetooth On/Off.
 extern int  buttonClick;  // Bluetooth FOB Button click type, single or double click.
@@ -71,6 +71,7 @@ static bool doScan         = false;      // Flag that indicates that Service sca
 static bool newFobClick    = false;      // Flag that indicates that FOB Button pressed.
 static int  fobClick       = CLICK_NONE; // FOB Button click (press) type.
 static int  reconnectCount = 0;          // Counter for number of automatic reconnects.
+static volatile bool arcIdle = true;     // Arc is open circuit (Arc State event), not burning a rod.
 
 // *********************************************************************************************
 static void notifyCallback(
@@ -154,6 +155,7 @@ class MyClientCallback : public BLEClientCallbacks {
   {
     bleConnected = false;
     Serial.println("BlueTooth Lost Connection (onDisconnect)");
+    evlogEvent(EVT_BLE_LOST, 0, 0);
   }
 };
 
@@ -451,6 +453,14 @@ bool reconnectTimer(bool rst)
   return result;
 }
 
+// *********************************************************************************************
+// Arc State change subscriber for Bluetooth. Called by the Control Task.
+// Auto-reconnect is blocking code, it waits until the arc is open circuit (ARC_OUT_TIME after the arc goes out).
+void bleArcEvent(const ArcEvent& evt)
+{
+  arcIdle = evt.state == ARC_ST_OPEN;
+}
+
 // *********************************************************************************************
 // Check the Bluetooth FOB Button server connection.
 // Perform auto-reconnect if a paired connection has been disconnected.
@@ -475,7 +485,7 @@ void checkBleConnection(void)
 
   // We were connected, but the connection has been lost. Try to find it again.
   // Do not attempt reconnect while burning a rod stick because it is blocking code.
-  if ((Amps <= MIN_DET_AMPS) && !bleConnected && doScan && reconnectTimer(false) && (reconnectCount < RECONNECT_TRIES))
+  if (arcIdle && !bleConnected && doScan && reconnectTimer(false) && (reconnectCount < RECONNECT_TRIES))
   {
     if (++reconnectCount < RECONNECT_TRIES) {
       Serial.println("Attempting BLE Auto-Reconnect #" + String(reconnectCount) + " (of " + String(RECONNECT_TRIES) + ") ...");
@@ -32,10 +32,54 @@
 
 // ************************************************************************************************************************
 // INA219 Defines
+// SHUNT_OHMS is the uncalibrated Amps scale. Calibrate each welder against a clamp meter on the Amps Calibration page
+// (Settings, next arrow to Weld Stats, next arrow), or with the "cal" serial commands; No recompile is needed.
 #define SHUNT_OHMS 0.000428     // ZX7-200's internal Shunt ohms. Reduce value to increase displayed realtime current.
 //#define SHUNT_OHMS 0.000375   // Shunt value used by user @hogthrob. See https://github.com/thomastech/Sparky/issues/2
 #define SHUNT_V_MAX 0.125       // Maximum voltage across shunt, in VDC.
 #define INA219_AVG_ON           // Use 32 samples per Shunt Acquistion (hardware avg). Comment this line to disable.
+#define INA219_SYNC_ON          // Read the shunt only after each 17mS conversion (Conversion Ready flag). Needs AVG_ON.
+#define INA219_ADAPT_ON         // Fast conversions during strikes, shorts, and pulse edges. Needs INA219_SYNC_ON.
+#define INA219_FAST_ADC 3       // Fast conversion: 0 = 9 bits (84uS), 1 = 10 bits, 2 = 11 bits, 3 = 12 bits (532uS).
+#define INA_FAST_HOLD_MS 100    // Fast mode is kept this long after a strike, short, or pulse edge, in mS.
+
+// ************************************************************************************************************************
+// Welding Voltage Sampling Defines
+// Streaming mode continuously samples the Welding Voltage using the I2S peripheral's DMA. Each block of samples is
+// reduced to Avg, Min, Max, and RMS volts so that brief arc shorts and arc outages are detected.
+#define VDC_DMA_ON              // Stream Welding Voltage via I2S DMA. Comment this line to use single ADC reads.
+#define VDC_DMA_RATE 40000      // Streaming ADC sample rate, in Hz. Allowed int values: 10000 to 100000.
+#define VDC_BLOCK_SIZE 40       // ADC samples per Voltage block (40 samples @ 40KHz = 1mS). Allowed: 8 to 1024.
+
+// Two-point Welding Volts correction, for the 47K / 1.8K attenuator resistor tolerance. Measure the welding voltage
+// with a meter at a low and a high voltage (e.g., a load resistor and open circuit) and enter the meter (TRUE) and
+// welder (READ, Telemetry or Recorder dump) values, in centivolts (0.01V).
+//#define VDC_CAL_ON            // Uncomment this line to enable the two-point correction.
+#define VDC_CAL_READ_LO 1500    // Welder reading at the low point, in centivolts.
+#define VDC_CAL_TRUE_LO 1500    // Meter reading at the low point, in centivolts.
+#define VDC_CAL_READ_HI 6000    // Welder reading at the high point, in centivolts.
+#define VDC_CAL_TRUE_HI 6000    // Meter reading at the high point, in centivolts.
+
+// ************************************************************************************************************************
+// Measurement Filter Defines
+// Amps and Volts are measured every 5mS. Each passes through a median (spike rejection) stage, then two fixed-point
+// averaging filters: A fast one for the arc features and the current regulator, and a slow one for the display.
+// The time constants are 2^SHIFT measurements (0 = no averaging, 3 = 8 x 5mS = 40mS). A median of N measurements adds
+// (N - 1) / 2 measurements of delay. The Amps median rejects a single bad INA219 conversion.
+// With INA219_SYNC_ON an Amps measurement is one INA219 conversion (17mS), so AMPS_DISP_SHIFT 4 = 16 x 17mS = 272mS.
+// The display filter must be steadier than the V1.3 16 sample average (spike error and noise); weldSim checks it.
+// In the INA219 fast mode (INA219_ADAPT_ON) each 5mS Amps measurement is one unaveraged conversion; AMPS_FAST_DISP_SHIFT
+// is used instead of AMPS_DISP_SHIFT, 4 = 16 x 5mS = 80mS. Lower values are noisier than the averaging mode display.
+// The strike detection time and display noise can be checked on a PC, see weldSim.cpp.
+// The filter timing can be checked on a PC or at boot (FILTER_BENCHMARK), see weldSim.cpp.
+#define AMPS_MEDIAN_N 3         // Amps median window, in measurements. Allowed values: 1 (off), 3, 5, 7.
+#define AMPS_CTRL_SHIFT 0       // Amps control filter time constant, 2^n measurements. Allowed int values: 0 to 4.
+#define AMPS_DISP_SHIFT 4       // Amps display filter time constant, 2^n measurements. Allowed int values: 0 to 8.
+#define AMPS_FAST_DISP_SHIFT 4  // Amps display filter time constant, INA219 fast mode. Allowed int values: 0 to 8.
+#define VOLTS_MEDIAN_N 3        // Volts median window, in measurements. Allowed values: 1 (off), 3, 5, 7.
+#define VOLTS_CTRL_SHIFT 1      // Volts control filter time constant, 2^n measurements. Allowed int values: 0 to 4.
+#define VOLTS_DISP_SHIFT 4      // Volts display filter time constant, 2^n measurements. Allowed int values: 0 to 8.
+//#define FILTER_BENCHMARK      // Uncomment this line to log the filter timing (CPU cycles per sample) at boot.
 
 // ************************************************************************************************************************
 // Welding Amps & Volts Defines
@@ -44,7 +88,131 @@
 #define MIN_AMPS 65             // Enter actual Minimum welder output Amps (50A typical). Use clamp-on ammeter to cal.
 #define MAX_SET_AMPS MAX_AMPS   // Maximum permitted welder output Amps. Typically <= MAX_AMPS.
 #define MIN_SET_AMPS MIN_AMPS   // Minimum permitted welder output Amps. Typically >= MIN_AMPS.
-#define PULSE_AMPS_THRS 50      // Pulse Amps Threshold. Current must meet or exceed this value to permit pulse modulation.
+
+// ************************************************************************************************************************
+// Thermal Model Defines
+// The thermal model estimates the welder's heat from the RMS welding current, so it can warn (voice and an orange Amps
+// bar) before the welder's OC protection trips. Set THERMAL_CONT_AMPS to the welder's rated Amps * sqrt(duty cycle),
+// for example 110A at 60% = 85A. Each thermal OC trip corrects it (saved in E2Prom); The "heat" serial command shows
+// the model. Serial Log captures (the "Thermal: Weld end" lines) can be replayed on a PC, see weldSim.cpp.
+#define THERMAL_CONT_AMPS 90    // Continuous (100% duty cycle) Amps. Allowed int values: 40 to 200.
+#define THERMAL_TAU_SEC 300     // Heatsink time constant, in seconds. Allowed int values: 60 to 1800.
+#define THERMAL_FAST_SEC 30     // Power device time constant, in seconds. Allowed int values: 5 to 120.
+#define THERMAL_FAST_PC 25      // Power device share of the heat, in percent. Allowed int values: 0 to 60.
+#define THERMAL_WARN_PC 80      // Warning heat, percent of the OC trip point. Allowed int values: 50 to 95.
+#define THERMAL_DERATE_PC 85    // Derating heat, percent of the OC trip point. Allowed: THERMAL_WARN_PC to 99.
+//#define THERMAL_DERATE_ON     // Uncomment this line to limit the welding current at THERMAL_DERATE_PC.
+
+// ************************************************************************************************************************
+// Control Task Defines
+// Amps & Volts measurements and Pulse modulation run in a dedicated task that is paced by a hardware timer.
+// This keeps the Pulse timing steady while the touchscreen, audio, or Bluetooth code is busy.
+#define CONTROL_RATE_HZ 1000    // Control Task Update Rate, in Hz. Allowed int values: 200 to 10000.
+//#define CONTROL_STATS_LOG     // Uncomment this line to periodically log the Control Task's timing statistics.
+
+// ************************************************************************************************************************
+// Pulse Waveform Defines
+// The Pulse waveform (Square, Trapezoid, Sine, Sawtooth) is chosen on the Pulse Shape settings page. The Digital Pot is
+// updated by the Control Task at PULSE_UPDATE_HZ; Edges between updates are timed by the Pulse edge timer, so they are
+// not on the 1mS tick grid (see pulseWave.cpp).
+#define PULSE_UPDATE_HZ 1000    // Pulse waveform update rate, in Hz. Must divide evenly into CONTROL_RATE_HZ.
+#define PULSE_RAMP_PC 10        // Trapezoid ramp time, percent of the pulse period. Allowed int values: 1 to 40.
+
+// ************************************************************************************************************************
+// I2C Bus Defines
+// The INA219 Current Sensor and I2C Digital Pot are serviced by the I2C Engine (i2cBus.cpp); Transactions are queued
+// so the Control Task never waits on the bus. Long wires or weak pull-up resistors may require the 100KHz speed.
+#define I2C_BUS_HZ 400000       // I2C Bus Speed, in Hz. Allowed values: 100000, 400000, 1000000.
+
+// ************************************************************************************************************************
+// Digital Pot Defines
+// The Digital Pot is only written when the Wiper value changes. The readback check periodically confirms the Pot
+// holds the last written value (and rewrites it if not).
+#define POT_VERIFY_TIME 5000    // Wiper readback check interval, in mS. Allowed: 100 to 60000. Comment line to disable.
+
+// The Pot characterization sweep ("pot sweep" serial command) measures the welder's Amps at POT_SWEEP_POINTS Wiper
+// codes, so the Amps setting matches the delivered current. Weld on a load bank (or hold a long arc) with Pulse mode
+// off; Do the Amps calibration first. Each step waits POT_SWEEP_SETTLE_MS, then averages Amps for POT_SWEEP_AVG_MS.
+#define POT_SWEEP_SETTLE_MS 1500 // Settling time after each Wiper step, in mS. Allowed: 200 to 10000.
+#define POT_SWEEP_AVG_MS 1000    // Amps averaging time at each Wiper step, in mS. Allowed: 200 to 10000.
+
+// ************************************************************************************************************************
+// Closed-Loop Current Regulation Defines
+// The PI regulator trims the Digital Pot so that the measured Amps track the Amps setting. The trim is learned while the
+// arc is established with Pulse mode off; It is held (and applied to both pulse levels) at other times.
+// Gains can be tuned on a PC with the Simulated Welder, see weldSim.cpp.
+//#define CURRENT_REG_ON        // Uncomment this line to enable closed-loop current regulation.
+#define REG_RATE_HZ 20          // Regulator update rate, in Hz. Allowed int values: 5 to 50.
+#define REG_KP_X100 30          // Proportional gain, times 100. Allowed int values: 0 to 500.
+#define REG_KI_X100 400         // Integral gain (per second), times 100. Allowed int values: 0 to 2000.
+#define REG_TRIM_MAX 20         // Maximum trim, +/- Amps. Allowed int values: 1 to 50.
+#define REG_SLEW_MAX 100        // Maximum trim change rate, in Amps per second. Allowed int values: 10 to 1000.
+//#define REG_BENCHMARK         // Uncomment this line to log the regulator step response (Simulated Welder) at boot.
+
+// ************************************************************************************************************************
+// Arc Feature Defines
+// Anti-Stick: A stuck rod (low arc voltage with current flowing) reduces the welding current to ARC_OFF_AMPS. Normal
+// current is restored when the short clears (rod is freed). Requires VDC_DMA_ON.
+#define ANTI_STICK_ON           // Enable Anti-Stick protection. Comment this line to disable.
+#define STICK_VOLTS 8           // Stuck rod (short circuit) threshold, in Volts. Allowed int values: 2 to 15.
+#define STICK_AMPS 20           // Minimum welding current for stuck rod detection, in Amps. Allowed int values: 5 to 100.
+#define STICK_TIME 50           // Short circuit time before current is reduced, in mS. Allowed int values: 10 to 90.
+#define STICK_CLEAR_VOLTS 12    // Short has cleared above this voltage, in Volts. Must be greater than STICK_VOLTS.
+#define STICK_CLEAR_TIME 20     // Time above STICK_CLEAR_VOLTS before current is restored, in mS. Allowed: 5 to 500.
+
+// Arc Force (Dig): Current is boosted when the arc voltage sags (short arc) so the rod does not snuff out. The boost
+// starts below ARC_FORCE_VOLTS and reaches ARC_FORCE_PC percent of the Amps setting 8V lower. It is limited to
+// MAX_SET_AMPS. Requires VDC_DMA_ON.
+#define ARC_FORCE_ON            // Enable Arc Force. Comment this line to disable.
+#define ARC_FORCE_PC 30         // Boost at full sag, percent of Amps setting. Allowed int values: 5 to 100.
+#define ARC_FORCE_VOLTS 18      // Arc Force threshold, in Volts. Must be greater than STICK_VOLTS. Allowed: 10 to 30.
+
+// Hot Start: Current is boosted when the rod strikes the work (fast voltage or current edge), held for the Hot Start
+// time, then ramped down to the Amps setting. Boost and time are adjusted on the Arc Settings page. Requires VDC_DMA_ON.
+#define HOT_START_ON            // Enable Hot Start. Comment this line to disable.
+
+// ************************************************************************************************************************
+// Weld Session Statistics Defines
+// Each rod burn (strike to open circuit) is a Weld Session. Arc time, mean/peak Amps and Volts, and arc energy are
+// saved in EEPROM when the session ends. Sessions are shown on the Weld Stats page (arrow on the Pulse Shape title
+// bar), where the bead length can be entered to show the heat input (kJ/mm).
+#define SESSION_HISTORY 16      // Number of sessions kept. The oldest is replaced. Allowed int values: 1 to 16.
+#define SESSION_MIN_TIME 2000   // Shortest arc time that is saved (ignores scratch starts), in mS. Allowed: 100 to 30000.
+#define SESSION_EFF_PC 80       // Arc thermal efficiency for heat input, percent. 80 for MMA. Allowed int values: 50 to 100.
+
+// ************************************************************************************************************************
+// Telemetry Stream Defines
+// Measurements, arc state changes, events, and settings changes are sent on the Serial Log port as binary records
+// (COBS framed, CRC-16 checked). Text log messages are still sent. Use tools/telemetry_decode.py to split the stream
+// into CSV files and the text log. Set platformio.ini's monitor_speed to TELEM_BAUD to view the text log.
+//#define TELEMETRY_ON          // Uncomment this line to enable the Telemetry stream.
+#define TELEM_BAUD 921600       // Serial Log baud rate when the Telemetry stream is enabled. Allowed: 230400 to 2000000.
+#define TELEM_MEAS_HZ 1000      // Measurement record rate, in Hz. Must divide evenly into CONTROL_RATE_HZ.
+
+// ************************************************************************************************************************
+// Telemetry Recorder Defines
+// Every Control Task tick (Amps, Volts, Pot wiper, Pulse phase, Arc state) is kept in a PSRAM ring buffer. Rod strike,
+// arc out, stuck rod, and over temperature events save a capture window around the event. Captures are listed and
+// dumped (CSV) with Serial Log commands; Send "rec help" for the command list.
+#define TELEMETRY_REC_ON        // Enable the Telemetry Recorder. Comment this line to disable.
+#define REC_BUFFER_KB 1536      // PSRAM ring buffer size, in KB. Allowed int values: 64 to 3072.
+#define REC_PRE_TIME 250        // Capture time before the trigger event, in mS. Allowed int values: 10 to 5000.
+#define REC_POST_TIME 750       // Capture time after the trigger event, in mS. Allowed int values: 10 to 5000.
+
+// ************************************************************************************************************************
+// Display Defines
+// The Home page Amps and Volts values and the Amps bar are drawn off-screen (PSRAM). Only the changed pixels are sent to
+// the display, in one burst, so the values do not flicker and the SPI bus is busy for less time. The "tft" serial
+// command shows the pixels and time per frame; Comment the line out (direct drawing, as in V1.3) to compare.
+#define TFT_CANVAS_ON           // Enable the off-screen canvases. Comment this line to draw directly.
+
+// Display transfers are queued to the Display Engine task, which sends them on the other CPU core; loop() (Pulse
+// settings, audio buffer filling, touch) is not held up by page draws. The SPI bus is shared with the Touch controller,
+// and with the Digital Pot on boards with the MCP41HV51 (SPI) variant. A bus hold is kept to TFT_BURST_PX pixels (400
+// pixels is about 0.16mS at 40MHz), so an MCP41HV51 write still fits the 1mS Control Task tick.
+// The "tft" serial command shows the page draw and loop() stall times; Comment the line out to compare.
+#define TFT_ASYNC_ON            // Enable the Display Engine. Comment this line for synchronous drawing.
+#define TFT_BURST_PX 400        // Longest SPI bus hold, in pixels. Allowed int values: 100 to 500.
 
 // ************************************************************************************************************************
 // Optional PWM Arc current control (via PWM IC Shutdown). Requires modification to Welder's main control board.
@@ -63,6 +231,9 @@
 #define DEF_SET_ARC ARC_ON      // Default Arc Current On/Off; ARC_ON, ARC_OFF are allowed.
 #define DEF_SET_BLE BLE_ON      // Default Bluetooth (Key FOB) On/Off; BLE_ON, BLE_OFF are allowed.
 #define DEF_SET_FRQ_X10 10      // Default Pulse Freq Hz, times 10; Allowed int values: 4-9 (0.4-0.9) and 10-50 (1.0-5.0).
+#define DEF_SET_WAVE PULSE_WAVE_SQUARE // Default Pulse waveform; PULSE_WAVE_SQUARE, _TRAP, _SINE, _SAW allowed.
+#define DEF_SET_HOT_PC 30       // Default Hot Start boost (%), multiple of 5; Allowed int values: 0 (Off) to 100.
+#define DEF_SET_HOT_X10 5       // Default Hot Start time, in seconds times 10; Allowed int values: 1 to 20 (0.1 to 2.0S).
 #define DEF_SET_PULSE PULSE_OFF // Default Pulse Mode; PULSE_ON, PULSE_OFF are allowed.
 #define DEF_SET_VOL VOL_MED     // Default DAC Audio Volume; VOL_OFF, VOL_LOW, VOL_MED, VOL_HI, VOL_XHI are allowed.
 
@@ -109,5 +280,197 @@
 #if MIN_SET_AMPS < MIN_AMPS
  #error "MIN_SET_AMPS conflicts with MIN_AMPS. Correction in config.h is required."
 #endif
+
+#if (CONTROL_RATE_HZ < 200) || (CONTROL_RATE_HZ > 10000)
+ #error "CONTROL_RATE_HZ value out of range. Correction in config.h is required."
+#endif
+
+#if (PULSE_UPDATE_HZ < 100) || (PULSE_UPDATE_HZ > CONTROL_RATE_HZ) || (CONTROL_RATE_HZ % PULSE_UPDATE_HZ != 0)
+ #error "PULSE_UPDATE_HZ value out of range. Correction in config.h is required."
+#endif
+
+#if (PULSE_RAMP_PC < 1) || (PULSE_RAMP_PC > 40)
+ #error "PULSE_RAMP_PC value out of range. Correction in config.h is required."
+#endif
+
+#if (DEF_SET_WAVE < PULSE_WAVE_SQUARE) || (DEF_SET_WAVE >= PULSE_WAVE_CNT)
+ #error "DEF_SET_WAVE value out of range. Correction in config.h is required."
+#endif
+
+#if (VDC_DMA_RATE < 10000) || (VDC_DMA_RATE > 100000)
+ #error "VDC_DMA_RATE value out of range. Correction in config.h is required."
+#endif
+
+#if (VDC_BLOCK_SIZE < 8) || (VDC_BLOCK_SIZE > 1024)
+ #error "VDC_BLOCK_SIZE value out of range. Correction in config.h is required."
+#endif
+
+#if (AMPS_MEDIAN_N != 1) && (AMPS_MEDIAN_N != 3) && (AMPS_MEDIAN_N != 5) && (AMPS_MEDIAN_N != 7)
+ #error "AMPS_MEDIAN_N value not supported. Correction in config.h is required."
+#endif
+
+#if (VOLTS_MEDIAN_N != 1) && (VOLTS_MEDIAN_N != 3) && (VOLTS_MEDIAN_N != 5) && (VOLTS_MEDIAN_N != 7)
+ #error "VOLTS_MEDIAN_N value not supported. Correction in config.h is required."
+#endif
+
+#if (AMPS_CTRL_SHIFT < 0) || (AMPS_CTRL_SHIFT > 4) || (VOLTS_CTRL_SHIFT < 0) || (VOLTS_CTRL_SHIFT > 4)
+ #error "AMPS_CTRL_SHIFT or VOLTS_CTRL_SHIFT value out of range. Correction in config.h is required."
+#endif
+
+#if (AMPS_DISP_SHIFT < 0) || (AMPS_DISP_SHIFT > 8) || (VOLTS_DISP_SHIFT < 0) || (VOLTS_DISP_SHIFT > 8)
+ #error "AMPS_DISP_SHIFT or VOLTS_DISP_SHIFT value out of range. Correction in config.h is required."
+#endif
+
+#if defined(INA219_SYNC_ON) && !defined(INA219_AVG_ON)
+ #error "INA219_SYNC_ON requires INA219_AVG_ON. Correction in config.h is required."
+#endif
+
+#if defined(INA219_ADAPT_ON) && !defined(INA219_SYNC_ON)
+ #error "INA219_ADAPT_ON requires INA219_SYNC_ON. Correction in config.h is required."
+#endif
+
+#if (INA219_FAST_ADC < 0) || (INA219_FAST_ADC > 3) || (INA_FAST_HOLD_MS < 10) || (INA_FAST_HOLD_MS > 1000)
+ #error "INA219_FAST_ADC or INA_FAST_HOLD_MS value out of range. Correction in config.h is required."
+#endif
+
+#if (AMPS_FAST_DISP_SHIFT < 0) || (AMPS_FAST_DISP_SHIFT > 8)
+ #error "AMPS_FAST_DISP_SHIFT value out of range. Correction in config.h is required."
+#endif
+
+#if defined(VDC_CAL_ON) && ((VDC_CAL_READ_HI - VDC_CAL_READ_LO < 1000) || (VDC_CAL_TRUE_HI - VDC_CAL_TRUE_LO < 1000))
+ #error "VDC_CAL points must be at least 10V apart. Correction in config.h is required."
+#endif
+
+#if (I2C_BUS_HZ != 100000) && (I2C_BUS_HZ != 400000) && (I2C_BUS_HZ != 1000000)
+ #error "I2C_BUS_HZ value not supported. Correction in config.h is required."
+#endif
+
+#if defined(POT_VERIFY_TIME) && ((POT_VERIFY_TIME < 100) || (POT_VERIFY_TIME > 60000))
+ #error "POT_VERIFY_TIME value out of range. Correction in config.h is required."
+#endif
+
+#if (THERMAL_CONT_AMPS < 40) || (THERMAL_CONT_AMPS > 200) || (THERMAL_TAU_SEC < 60) || (THERMAL_TAU_SEC > 1800)
+ #error "THERMAL_CONT_AMPS or THERMAL_TAU_SEC value out of range. Correction in config.h is required."
+#endif
+
+#if (THERMAL_FAST_SEC < 5) || (THERMAL_FAST_SEC > 120) || (THERMAL_FAST_PC < 0) || (THERMAL_FAST_PC > 60)
+ #error "THERMAL_FAST_SEC or THERMAL_FAST_PC value out of range. Correction in config.h is required."
+#endif
+
+#if (THERMAL_WARN_PC < 50) || (THERMAL_WARN_PC > 95) || (THERMAL_DERATE_PC < THERMAL_WARN_PC) || (THERMAL_DERATE_PC > 99)
+ #error "THERMAL_WARN_PC or THERMAL_DERATE_PC value out of range. Correction in config.h is required."
+#endif
+
+#if (POT_SWEEP_SETTLE_MS < 200) || (POT_SWEEP_SETTLE_MS > 10000) || (POT_SWEEP_AVG_MS < 200) || (POT_SWEEP_AVG_MS > 10000)
+ #error "POT_SWEEP_SETTLE_MS or POT_SWEEP_AVG_MS value out of range. Correction in config.h is required."
+#endif
+
+#if (REG_RATE_HZ < 5) || (REG_RATE_HZ > 50)
+ #error "REG_RATE_HZ value out of range. Correction in config.h is required."
+#endif
+
+#if (REG_KP_X100 < 0) || (REG_KP_X100 > 500)
+ #error "REG_KP_X100 value out of range. Correction in config.h is required."
+#endif
+
+#if (REG_KI_X100 < 0) || (REG_KI_X100 > 2000)
+ #error "REG_KI_X100 value out of range. Correction in config.h is required."
+#endif
+
+#if (REG_TRIM_MAX < 1) || (REG_TRIM_MAX > 50)
+ #error "REG_TRIM_MAX value out of range. Correction in config.h is required."
+#endif
+
+#if (REG_SLEW_MAX < 10) || (REG_SLEW_MAX > 1000)
+ #error "REG_SLEW_MAX value out of range. Correction in config.h is required."
+#endif
+
+#if defined(ANTI_STICK_ON) && !defined(VDC_DMA_ON)
+ #error "ANTI_STICK_ON requires VDC_DMA_ON. Correction in config.h is required."
+#endif
+
+#if (STICK_VOLTS < 2) || (STICK_VOLTS > 15)
+ #error "STICK_VOLTS value out of range. Correction in config.h is required."
+#endif
+
+#if (STICK_AMPS < 5) || (STICK_AMPS > 100)
+ #error "STICK_AMPS value out of range. Correction in config.h is required."
+#endif
+
+#if (STICK_TIME < 10) || (STICK_TIME > 90)
+ #error "STICK_TIME value out of range. Correction in config.h is required."
+#endif
+
+#if STICK_CLEAR_VOLTS <= STICK_VOLTS
+ #error "STICK_CLEAR_VOLTS conflicts with STICK_VOLTS. Correction in config.h is required."
+#endif
+
+#if (STICK_CLEAR_TIME < 5) || (STICK_CLEAR_TIME > 500)
+ #error "STICK_CLEAR_TIME value out of range. Correction in config.h is required."
+#endif
+
+#if defined(ARC_FORCE_ON) && !defined(VDC_DMA_ON)
+ #error "ARC_FORCE_ON requires VDC_DMA_ON. Correction in config.h is required."
+#endif
+
+#if (ARC_FORCE_PC < 5) || (ARC_FORCE_PC > 100)
+ #error "ARC_FORCE_PC value out of range. Correction in config.h is required."
+#endif
+
+#if (ARC_FORCE_VOLTS < 10) || (ARC_FORCE_VOLTS > 30) || (ARC_FORCE_VOLTS <= STICK_VOLTS)
+ #error "ARC_FORCE_VOLTS value out of range. Correction in config.h is required."
+#endif
+
+#if defined(HOT_START_ON) && !defined(VDC_DMA_ON)
+ #error "HOT_START_ON requires VDC_DMA_ON. Correction in config.h is required."
+#endif
+
+#if (DEF_SET_HOT_PC < MIN_HOT_PC) || (DEF_SET_HOT_PC > MAX_HOT_PC) || (DEF_SET_HOT_PC % HOT_PC_STEP != 0)
+ #error "DEF_SET_HOT_PC value out of range. Correction in config.h is required."
+#endif
+
+#if (DEF_SET_HOT_X10 < MIN_HOT_X10) || (DEF_SET_HOT_X10 > MAX_HOT_X10)
+ #error "DEF_SET_HOT_X10 value out of range. Correction in config.h is required."
+#endif
+
+#if (SESSION_HISTORY < 1) || (SESSION_HISTORY > 16)
+ #error "SESSION_HISTORY value out of range. Correction in config.h is required."
+#endif
+
+#if (SESSION_MIN_TIME < 100) || (SESSION_MIN_TIME > 30000)
+ #error "SESSION_MIN_TIME value out of range. Correction in config.h is required."
+#endif
+
+#if (SESSION_EFF_PC < 50) || (SESSION_EFF_PC > 100)
+ #error "SESSION_EFF_PC value out of range. Correction in config.h is required."
+#endif
+
+#if (TELEM_BAUD < 230400) || (TELEM_BAUD > 2000000)
+ #error "TELEM_BAUD value out of range. Correction in config.h is required."
+#endif
+
+#if (TELEM_MEAS_HZ < 1) || (TELEM_MEAS_HZ > CONTROL_RATE_HZ) || (CONTROL_RATE_HZ % TELEM_MEAS_HZ != 0)
+ #error "TELEM_MEAS_HZ value out of range. Correction in config.h is required."
+#endif
+
+#if (TELEM_MEAS_HZ * 20 * 10) > (TELEM_BAUD * 8 / 10)
+ #error "TELEM_BAUD is too slow for TELEM_MEAS_HZ (20 byte frames). Correction in config.h is required."
+#endif
+
+#if (REC_BUFFER_KB < 64) || (REC_BUFFER_KB > 3072)
+ #error "REC_BUFFER_KB value out of range. Correction in config.h is required."
+#endif
+
+#if (REC_PRE_TIME < 10) || (REC_PRE_TIME > 5000)
+ #error "REC_PRE_TIME value out of range. Correction in config.h is required."
+#endif
+
+#if (REC_POST_TIME < 10) || (REC_POST_TIME > 5000)
+ #error "REC_POST_TIME value out of range. Correction in config.h is required."
+#endif
+
+#if (TFT_BURST_PX < 100) || (TFT_BURST_PX > 500)
+ #error "TFT_BURST_PX value out of range. Correction in config.h is required."
+#endif
 // -----------------------------------------------------------------------------------------------------------------------
 // EOF
\ No newline at end of file
@@ -0,0 +1,415 @@
+/*
+   File: control.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. The Control Task performs the Amps & Volts measurements and the Pulse modulation. It is paced by a hardware
+      timer (CONTROL_RATE_HZ in config.h) so that the timing is not affected by blocking code in loop(), such as
+      touchscreen redraws, audio playback, or Bluetooth scans.
+   2. The Control Task must not draw on the TFT. Screen updates are requested with flags that loop() services.
+   3. The INA219 and I2C Digital Pot are serviced by the I2C Engine (i2cBus.cpp). Do not wait on the I2C bus here;
+      Queue transactions with i2cSubmit().
+   4. Optional Closed-Loop Current Regulation (CURRENT_REG_ON in config.h) runs at REG_RATE_HZ. The regulator's trim
+      is added to the Amps sent to the Digital Pot, see regulatedAmps().
+   5. Arc features (arcCtrl.cpp) run on every tick. Digital Pot requests must use outputAmps().
+   6. The Telemetry Recorder (recorder.cpp) and Telemetry stream (telemetry.cpp) use one sample per tick. They must stay
+      last in the tick.
+   7. The tick itself is controlTick(). The PC simulator (ctrlSim.cpp, HAL_SIM) calls it directly with simulated time;
+      The FreeRTOS task and its timer are only built for the ESP32.
+ */
+
+#include <Arduino.h>
+#include "PulseWelder.h"
+#include "currentReg.h"
+#include "hal.h"
+#include "i2cBus.h"
+#include "weldSim.h"
+#include "config.h"
+
+#define CONTROL_PERIOD_US (1000000UL / CONTROL_RATE_HZ)  // Control Task tick period, in uS.
+#define MEAS_TICKS ((MEAS_TIME * CONTROL_RATE_HZ) / 1000) // Number of Control Task ticks per measurement.
+#define REG_TICKS (CONTROL_RATE_HZ / REG_RATE_HZ)         // Number of Control Task ticks per regulator update.
+#define AMPS_CTRL_LAG ((1 << AMPS_CTRL_SHIFT) + (AMPS_MEDIAN_N - 1) / 2) // Regulator feedback lag, in measurements.
+#define PULSE_TICKS (CONTROL_RATE_HZ / PULSE_UPDATE_HZ)    // Number of Control Task ticks per Pulse waveform update.
+#define TELEM_TICKS (CONTROL_RATE_HZ / TELEM_MEAS_HZ)      // Number of Control Task ticks per Telemetry measurement.
+
+// Global System vars
+extern volatile int Amps;   // Live Welding Current.
+extern byte arcSwitch;      // Welding Arc On/Off Switch.
+extern byte pulseSwitch;    // Pulse Mode On/Off Flag.
+extern byte setAmps;        // Welding Amps *User Setting*.
+extern volatile unsigned int Volts; // Measured Welding Volts.
+extern bool overTempAlert;  // Over Temperature (OC) Alert.
+extern volatile bool pulseState; // Arc Pulse modulation state (on/off).
+
+// Local Scope Vars
+#ifndef HAL_SIM
+static TaskHandle_t controlTaskHandle = NULL;                         // Control Task handle, notified by timer ISR.
+static hw_timer_t  *controlTimer      = NULL;                         // Hardware timer that paces the Control Task.
+#endif // ifndef HAL_SIM
+static portMUX_TYPE statsMux          = portMUX_INITIALIZER_UNLOCKED; // Protects the timing statistics.
+static ControlStats controlStats;                                     // Control Task timing statistics.
+static uint64_t     execTotalUs = 0;                                  // Execution time totalizer, for average.
+static volatile int regTrimAmps  = 0;                                 // Closed-Loop Regulator trim, in Amps.
+static volatile bool regArcStable = false;                            // Arc is established (Arc State event).
+#ifdef CURRENT_REG_ON
+static CurrentReg   currentReg;                                       // Closed-Loop Current Regulator.
+#endif // ifdef CURRENT_REG_ON
+
+// *********************************************************************************************
+// Arc State change subscriber for the Closed-Loop Regulator.
+static void regArcEvent(const ArcEvent& evt)
+{
+  regArcStable = arcEstablished(evt.state);
+}
+
+// *********************************************************************************************
+// Closed-Loop Current Regulation. Called by the Control Task at REG_RATE_HZ.
+// The trim is only updated while the arc is established with Pulse mode off. Otherwise it is held.
+static void regulateCurrent(void)
+{
+#ifdef CURRENT_REG_ON
+  if (isPotSweeping() || (getCalAmps() != 0)) { // Sweep holds the Wiper, or Calibration runs open-loop. Trim from zero.
+    currentReg.reset();
+    regTrimAmps = 0;
+  }
+  else if ((arcSwitch == ARC_ON) && (pulseSwitch == PULSE_OFF) && regArcStable && (Amps != 999)) {
+    regTrimAmps = (int)(lroundf(currentReg.update(thermalLimitAmps(setAmps), getFastAmps()))); // Not the display Amps.
+    setPotAmps(outputAmps(setAmps), VERBOSE_OFF); // Pot is only written if the value changed.
+  }
+#endif // ifdef CURRENT_REG_ON
+}
+
+// *********************************************************************************************
+// Collect this tick's welding data (fast Amps, newest Volts, Pot Wiper, Pulse phase, Arc state).
+static void readWeldSample(WeldSample *smp)
+{
+  int wiper = getPotWiper();
+
+  smp->timeUs = halMicros();
+  smp->amps   = (int16_t)(getFastAmps());
+  smp->wiper  = wiper < 0 ? 0xff : (uint8_t)(wiper);
+  smp->phase  = getPulsePhase();
+  smp->state  = (uint8_t)(getArcState());
+  smp->flags  = arcSwitch == ARC_ON ? SAMPLE_FLAG_ARC_ON : 0;
+  smp->flags |= pulseState ? SAMPLE_FLAG_PULSE : 0;
+  smp->flags |= overTempAlert ? SAMPLE_FLAG_HEAT : 0;
+#ifdef VDC_DMA_ON
+  VdcBlock blk;
+  smp->voltsCv = getVdcBlock(&blk) ? blk.avgCv : 0;
+#else // ifdef VDC_DMA_ON
+  smp->voltsCv = (uint16_t)(getFastVoltsCv());
+#endif // ifdef VDC_DMA_ON
+}
+
+// *********************************************************************************************
+// Run one Control Task tick: Measurements, arc features, Pulse modulation, and the tick's welding sample.
+// Called by controlTask() on every timer tick, or directly by the PC simulator (ctrlSim.cpp).
+void controlTick(void)
+{
+  static int measTick  = 0; // Tick counter for measurement refresh.
+  static int regTick   = 0; // Tick counter for regulator update.
+  static int pulseTick = 0; // Tick counter for Pulse waveform update.
+  static int telemTick = 0; // Tick counter for Telemetry measurement records.
+  WeldSample sample;        // This tick's welding data.
+
+  sampleVoltage();  // Drain Welding Voltage DMA samples (if enabled).
+  processArcCtrl(); // Arc features (Anti-Stick, Arc Force, Hot Start), using the newest Voltage block.
+  detectArcState(); // Arc State Machine, publishes state changes to the subscribers.
+
+  if (++measTick >= MEAS_TICKS) {
+    measTick = 0;
+    measureCurrent();
+    measureVoltage();
+  }
+
+  if (++regTick >= REG_TICKS) {
+    regTick = 0;
+    regulateCurrent();
+  }
+
+  if (++pulseTick >= PULSE_TICKS) {
+    pulseTick = 0;
+    pulseModulation();
+  }
+
+  readWeldSample(&sample); // After the Pot has been updated.
+  recordSample(sample);    // Telemetry Recorder.
+  sessionSample(sample);   // Weld Session statistics.
+  thermalSample(sample);   // Thermal model RMS current.
+
+  if (++telemTick >= TELEM_TICKS) {
+    telemTick = 0;
+    telemSample(sample);   // Telemetry stream.
+  }
+}
+
+#ifndef HAL_SIM
+
+// *********************************************************************************************
+// Control Timer Interrupt. Wakes up the Control Task.
+static void IRAM_ATTR onControlTimer(void)
+{
+  BaseType_t taskWoken = pdFALSE;
+
+  vTaskNotifyGiveFromISR(controlTaskHandle, &taskWoken);
+
+  if (taskWoken == pdTRUE) {
+    portYIELD_FROM_ISR();
+  }
+}
+
+// *********************************************************************************************
+// Control Task. Runs once per timer tick.
+static void controlTask(void *param)
+{
+  int64_t lastStart = 0; // Start time of previous tick, in uS.
+  int64_t tickStart;     // Start time of this tick, in uS.
+  int64_t execUs;        // Execution time of this tick, in uS.
+  int64_t jitterUs;      // Tick period deviation, in uS.
+  uint32_t notifyCnt;    // Pending timer ticks. More than one means ticks were missed.
+
+  for (;;) {
+    notifyCnt = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    tickStart = esp_timer_get_time();
+
+    controlTick();
+
+    // Update the timing statistics.
+    execUs   = esp_timer_get_time() - tickStart;
+    jitterUs = lastStart == 0 ? 0 : (tickStart - lastStart) - (int64_t)(CONTROL_PERIOD_US * notifyCnt);
+    jitterUs = jitterUs < 0 ? -jitterUs : jitterUs;
+    lastStart = tickStart;
+
+    portENTER_CRITICAL(&statsMux);
+    controlStats.ticks++;
+    controlStats.overruns   += max(notifyCnt - 1, execUs > CONTROL_PERIOD_US ? 1u : 0u); // Long tick = missed notify.
+    controlStats.jitterMaxUs = max(controlStats.jitterMaxUs, (uint32_t)(jitterUs));
+    controlStats.execMaxUs   = max(controlStats.execMaxUs, (uint32_t)(execUs));
+    execTotalUs             += execUs;
+    portEXIT_CRITICAL(&statsMux);
+  }
+}
+
+#endif // ifndef HAL_SIM
+
+#ifdef REG_BENCHMARK
+// *********************************************************************************************
+// Log the Closed-Loop Regulator step response using the Simulated Welder (open-loop results for comparison).
+// The Simulated Welder has a 10% gain error and +4A offset. Enabled with REG_BENCHMARK in config.h.
+static void runRegBenchmark(void)
+{
+  CurrentRegCfg regCfg;
+  WeldSimCfg    simCfg;
+  RegStepResult res;
+  const float   steps[][2] = { { MIN_SET_AMPS + 5, MAX_SET_AMPS - 15 }, { MAX_SET_AMPS - 15, MIN_SET_AMPS + 5 } };
+
+  regCfg.kp        = REG_KP_X100 / 100.0f;
+  regCfg.ki        = REG_KI_X100 / 100.0f;
+  regCfg.dt        = 1.0f / REG_RATE_HZ;
+  regCfg.trimMax   = REG_TRIM_MAX;
+  regCfg.slewMax   = REG_SLEW_MAX;
+  simCfg.minAmps   = MIN_AMPS;
+  simCfg.maxAmps   = MAX_SET_AMPS;
+  simCfg.gain      = 0.9f;
+  simCfg.offset    = 4.0f;
+  simCfg.tau       = 0.02f;
+#ifdef INA219_SYNC_ON
+  simCfg.measTau   = AMPS_CTRL_LAG * INA219_AVG_CONV_US / 1000000.0f; // measureCurrent()'s control filter.
+#else
+  simCfg.measTau   = AMPS_CTRL_LAG * MEAS_TIME / 1000.0f;
+#endif // ifdef INA219_SYNC_ON
+  simCfg.noiseAmps = 0.5f;
+
+  for (int i = 0; i < 2; i++) {
+    for (int regOn = 0; regOn <= 1; regOn++) {
+      res = runRegStepTest(regCfg, simCfg, regOn, steps[i][0], steps[i][1], 3.0f);
+      Serial.println(String(regOn ? "Regulator Benchmark, PI:   " : "Regulator Benchmark, Open: ") + String(steps[i][0], 0) +
+                     "A to " + String(steps[i][1], 0) + "A, Rise " + String(res.riseSec, 3) + "s, Settle " +
+                     String(res.settleSec, 3) + "s, Overshoot " + String(res.overshoot, 1) + "A, Error " +
+                     String(res.finalErr, 1) + "A, Trim " + String(res.finalTrim, 1) + "A.");
+    }
+  }
+}
+
+#endif // ifdef REG_BENCHMARK
+
+#ifdef FILTER_BENCHMARK
+// *********************************************************************************************
+// CPU cycle counter for the filter benchmark.
+static uint32_t cpuCycles(void)
+{
+  return halCycles();
+}
+
+// *********************************************************************************************
+// Log the Amps and Volts filter CPU time (cycles per sample) and response, with the previous 16 sample average for
+// comparison. Enabled with FILTER_BENCHMARK in config.h.
+static void runFilterBenchmark(void)
+{
+  DualRateCfg       cfgs[2];
+  FilterBenchResult res;
+
+  cfgs[0].medianN   = AMPS_MEDIAN_N;
+  cfgs[0].fastShift = AMPS_CTRL_SHIFT;
+  cfgs[0].slowShift = AMPS_DISP_SHIFT;
+  cfgs[1].medianN   = VOLTS_MEDIAN_N;
+  cfgs[1].fastShift = VOLTS_CTRL_SHIFT;
+  cfgs[1].slowShift = VOLTS_DISP_SHIFT;
+
+  for (int i = 0; i < 2; i++) {
+    res = runFilterBench(cfgs[i], 10000, cpuCycles);
+    Serial.println(String(i == 0 ? "Filter Benchmark, Amps:  " : "Filter Benchmark, Volts: ") +
+                   String(res.dualCycles, 1) + " cycles/sample (16 sample average " + String(res.boxCycles, 1) +
+                   ", Median " + String(res.medianCycles, 1) + ", EMA " + String(res.emaCycles, 1) + ").");
+    Serial.println(String("Filter Benchmark, 90% Step: Fast ") + String(res.fastLag * MEAS_TIME) + "mS, Slow " +
+                   String(res.slowLag * MEAS_TIME) + "mS, Average " + String(res.boxLag * MEAS_TIME) +
+                   "mS. Spike Error: Fast " + String(res.fastSpike, 0) + "%, Slow " + String(res.slowSpike, 0) +
+                   "%, Average " + String(res.boxSpike, 0) + "%. Noise: Slow " + String(res.slowNoise, 1) +
+                   ", Average " + String(res.boxNoise, 1) + ".");
+  }
+}
+
+#endif // ifdef FILTER_BENCHMARK
+
+// *********************************************************************************************
+// Start the Control Task and its pacing timer.
+// Call once from setup(), after the ADC, INA219, and Digital Pot have been initialized.
+// The PC simulator (HAL_SIM) only loads the settings and subscribers; It calls controlTick() itself.
+void initControlTask(void)
+{
+#ifndef HAL_SIM
+  if (controlTaskHandle != NULL) {
+    return; // Already running.
+  }
+#endif // ifndef HAL_SIM
+
+#ifdef CURRENT_REG_ON
+  CurrentRegCfg regCfg;
+  regCfg.kp      = REG_KP_X100 / 100.0f;
+  regCfg.ki      = REG_KI_X100 / 100.0f;
+  regCfg.dt      = 1.0f / REG_RATE_HZ;
+  regCfg.trimMax = REG_TRIM_MAX;
+  regCfg.slewMax = REG_SLEW_MAX;
+  currentReg.begin(regCfg);
+  Serial.println("Closed-Loop Current Regulation Enabled: " + String(REG_RATE_HZ) + "Hz, Kp " + String(regCfg.kp) +
+                 ", Ki " + String(regCfg.ki) + ".");
+#endif // ifdef CURRENT_REG_ON
+
+  initArcCtrl();
+  initPulseWave();
+  initRecorder();
+  initTelemetry();
+
+  // Arc State subscribers. Must be added before the Control Task starts.
+  subscribeArcState(regArcEvent);
+  subscribeArcState(pulseArcEvent);
+  subscribeArcState(screenArcEvent);
+  subscribeArcState(bleArcEvent);
+  subscribeArcState(recArcEvent);
+  subscribeArcState(telemArcEvent);
+  subscribeArcState(sessionArcEvent);
+#ifdef INA219_ADAPT_ON
+  subscribeArcState(inaArcEvent);
+#endif // ifdef INA219_ADAPT_ON
+
+#ifdef REG_BENCHMARK
+  runRegBenchmark();
+#endif // ifdef REG_BENCHMARK
+
+#ifdef FILTER_BENCHMARK
+  runFilterBenchmark();
+#endif // ifdef FILTER_BENCHMARK
+
+#ifndef HAL_SIM
+  xTaskCreatePinnedToCore(controlTask, "Control", CONTROL_TASK_STACK, NULL, CONTROL_TASK_PRIO, &controlTaskHandle,
+                          CONTROL_TASK_CORE);
+
+  controlTimer = timerBegin(CONTROL_ISR_TMR, 80, true);  // Pre-scaler is 80 (1uS per count), count up.
+  timerAttachInterrupt(controlTimer, &onControlTimer, true);
+  timerAlarmWrite(controlTimer, CONTROL_PERIOD_US, true); // Auto-reload.
+  timerAlarmEnable(controlTimer);
+
+  Serial.println("Started Control Task: " + String(CONTROL_RATE_HZ) + "Hz on Core " + String(CONTROL_TASK_CORE) + ".");
+#else // ifndef HAL_SIM
+  Serial.println("Control Task: " + String(CONTROL_RATE_HZ) + "Hz, Simulated.");
+#endif // ifndef HAL_SIM
+}
+
+// *********************************************************************************************
+// Apply the Closed-Loop Regulator trim to the requested Amps.
+// On exit, returns the Amps value to send to the Digital Pot (unchanged if regulation is disabled).
+byte regulatedAmps(byte amps)
+{
+  return (byte)(constrain((int)(amps) + regTrimAmps, MIN_AMPS, MAX_SET_AMPS));
+}
+
+// *********************************************************************************************
+// Get a copy of the Control Task timing statistics.
+// On entry rst = true to clear the worst-case values after they are copied.
+void getControlStats(ControlStats *stats, bool rst)
+{
+  portENTER_CRITICAL(&statsMux);
+  *stats           = controlStats;
+  stats->execAvgUs = controlStats.ticks == 0 ? 0 : (uint32_t)(execTotalUs / controlStats.ticks);
+
+  if (rst) {
+    controlStats.jitterMaxUs = 0;
+    controlStats.execMaxUs   = 0;
+  }
+  portEXIT_CRITICAL(&statsMux);
+}
+
+// *********************************************************************************************
+// Periodically log the Control Task timing and I2C Engine latency statistics. Called from loop().
+// Logging is enabled with CONTROL_STATS_LOG in config.h.
+void processControlStats(void)
+{
+#ifdef CONTROL_STATS_LOG
+  static long previousMillis = 0;
+  ControlStats stats;
+  I2cStats     i2cHigh;
+  I2cStats     i2cLow;
+  ArcLatency   arcLat;
+  InaStats     ina;
+
+  if (halMillis() - previousMillis >= CONTROL_STATS_TIME) {
+    previousMillis = halMillis();
+    getControlStats(&stats, true);
+    Serial.println("Control Task: " + String(stats.ticks) + " ticks, " + String(stats.overruns) + " overruns, Jitter " +
+                   String(stats.jitterMaxUs) + "uS max, Exec " + String(stats.execAvgUs) + "uS avg / " +
+                   String(stats.execMaxUs) + "uS max.");
+
+    getI2cStats(&i2cHigh, I2C_PRIO_HIGH, true);
+    getI2cStats(&i2cLow, I2C_PRIO_LOW, true);
+    Serial.println("I2C Engine: Pot " + String(i2cHigh.count) + " xfers, " + String(i2cHigh.errors) + " errors, " +
+                   String(i2cHigh.dropped) + " dropped, Wait " + String(i2cHigh.waitAvgUs) + "/" + String(i2cHigh.waitMaxUs) +
+                   "uS, Bus " + String(i2cHigh.busAvgUs) + "/" + String(i2cHigh.busMaxUs) + "uS (avg/max).");
+    Serial.println("I2C Engine: Sensor " + String(i2cLow.count) + " xfers, " + String(i2cLow.errors) + " errors, " +
+                   String(i2cLow.dropped) + " dropped, Wait " + String(i2cLow.waitAvgUs) + "/" + String(i2cLow.waitMaxUs) +
+                   "uS, Bus " + String(i2cLow.busAvgUs) + "/" + String(i2cLow.busMaxUs) + "uS (avg/max).");
+
+    getInaStats(&ina, true);
+    Serial.println("INA219: " + String(ina.samples) + " samples (" + String(ina.sampleHz) + "Hz), " +
+                   String(ina.polls) + " ready polls, " + String(ina.shuntReads) + " shunt reads, Latency " +
+                   String(ina.latencyAvgUs) + "uS avg / " + String(ina.latencyMaxUs) + "uS max, " +
+                   String(ina.modeChanges) + " mode changes (" + String(ina.modeAvgUs) + "uS avg), Fast " +
+                   String(ina.fastPc) + "%.");
+
+    getArcLatency(&arcLat, true);
+    Serial.println("Arc Features: " + String(arcLat.count) + " Pot writes, Voltage block to Pot write " +
+                   String(arcLat.avgUs) + "uS avg / " + String(arcLat.maxUs) + "uS max.");
+  }
+#endif // ifdef CONTROL_STATS_LOG
+}
+
+// EOF
@@ -0,0 +1,966 @@
+/*
+   File: ctrlSim.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Controller core simulator (PC, Linux). The unmodified Control Task code (control.cpp, measure.cpp, digPot.cpp,
+      arcCtrl.cpp, pulseWave.cpp) runs against simulated devices (halSim.cpp) with the config.h settings. Only built
+      with HAL_SIM. The UI, audio, Bluetooth, E2Prom, and the Recorder, Session, Telemetry, Thermal, and Event Log
+      services are replaced by the stand-ins at the end of this file.
+   2. Welder plant: The output current follows the Digital Pot (Wiper to Amps is linear from MIN_AMPS to MAX_AMPS,
+      the firmware's assumption, with gain and offset errors) through a time constant. Arc Volts = arcVolts + arcOhms *
+      Amps, with a droplet short every dropPeriod. A strike is a short (rod contact) for STRIKE_SEC. A stuck rod is
+      stickVolts at the welding current. Open circuit is ocvVolts with no current. The OC LED follows a two path heat
+      model (as in weldSim.cpp): It trips at 100% and resets below resetPc.
+   3. Scenarios: Each one runs in its own process (fork), so the controller core starts from power-up, as on the
+      welder. The checks print PASS or FAIL; The exit code is the number of failures (regression tests).
+   4. Replay: A Telemetry Recorder capture ("rec dump <n>" in the Serial Log, saved to a file) is fed to the devices
+      one sample per tick, as fast as the PC can run (or paced at speed times real time). The recorded Amps are the
+      welder's filtered readings, so the simulated INA219 adds its conversion delay again. The Arc State and Wiper are
+      compared with the recording.
+   5. Device checks ("dev"): The INA219 library (through Wire) and digPot.cpp (through the I2C Engine and SPI) run
+      against the register-level device models, with NACK and stuck register faults. Each check runs in its own
+      process and prints the bus transactions it took.
+   6. Build (in the src folder):
+      g++ -O2 -Wall -DHAL_SIM -I../sim -I../lib/INA219 ctrlSim.cpp halSim.cpp arcCtrl.cpp control.cpp digPot.cpp
+          measure.cpp pulseWave.cpp antiStick.cpp arcForce.cpp arcState.cpp currentReg.cpp filters.cpp hotStart.cpp
+          pwlTable.cpp thermalModel.cpp weldSim.cpp weldStats.cpp ../lib/INA219/INA219.cpp ../sim/arduinoSim.cpp
+          ../sim/ina219Model.cpp ../sim/mcpPotModel.cpp ../sim/simBus.cpp -o ctrlsim
+      Usage: ctrlsim [-v] [scenario number]        Run the scenarios (-v shows the controller's Serial Log).
+             ctrlsim dev [-v] [check number]       Run the device checks.
+             ctrlsim replay <capture.csv> [speed] [Amps setting]
+ */
+
+#ifdef HAL_SIM
+
+#include <stdio.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <Arduino.h>
+#include "INA219.h"
+#include "digPot.h"
+#include "hal.h"
+#include "i2cBus.h"
+#include "ina219Model.h"
+#include "mcpPotModel.h"
+#include "simBus.h"
+#include "PulseWelder.h"
+#include "config.h"
+
+#define CONTROL_PERIOD_US (1000000UL / CONTROL_RATE_HZ) // Control Task tick period, in uS.
+#define STRIKE_SEC 0.03f                                 // Rod contact time of a strike, in seconds.
+#define REPLAY_LINE 128                                  // Longest capture line.
+
+// Simulated welder settings.
+struct PlantCfg {
+  float gain;       // Output current gain error (1.0 = the firmware's linear Wiper to Amps).
+  float offset;     // Output current offset error, in Amps.
+  float tauSec;     // Output current time constant, in seconds.
+  float noiseAmps;  // Arc current noise, +/- Amps.
+  float ocvVolts;   // Open circuit Volts.
+  float arcVolts;   // Arc Volts at zero current.
+  float arcOhms;    // Arc resistance, in Ohms.
+  float shortVolts; // Droplet short Volts.
+  float stickVolts; // Stuck rod Volts.
+  float dropPeriod; // Droplet short period, in seconds.
+  float dropSec;    // Droplet short time, in seconds.
+  float contAmps;   // Continuous (100% duty cycle) current for the heat model, in Amps.
+  float tauHeatSec; // Heatsink time constant, in seconds.
+  float fastSec;    // Power device time constant, in seconds.
+  float fastPc;     // Power device share of the heat, percent.
+  float resetPc;    // OC LED resets below this heat, percent.
+};
+
+// Scenario timeline and settings. Times are in seconds, -1 = never.
+struct Scenario {
+  const char *name;
+  float       runSec;     // Run time.
+  float       strikeSec;  // Rod strike.
+  float       stickSec;   // Rod sticks to the work.
+  float       unstickSec; // Stuck rod is freed.
+  float       liftSec;    // Rod lifted, the arc goes out.
+  byte        amps;       // Amps setting.
+  bool        pulse;      // Pulse mode.
+  byte        freqX10;    // Pulse frequency, times ten.
+  float       heatPc;     // Welder heat at the start, percent of the OC trip point.
+  bool        i2cPot;     // MCP45HV51 (I2C) Digital Pot, else MCP41HV51 (SPI).
+};
+
+// Scenario results. Times are in seconds, -1 = did not happen.
+struct SimResult {
+  float    stableSec;    // First ARC_ST_STABLE after the strike.
+  float    stuckSec;     // First ARC_ST_STUCK.
+  float    outSec;       // First ARC_ST_OUT or ARC_ST_OPEN after the lift.
+  float    cutSec;       // Wiper at ARC_OFF_AMPS during the stuck rod.
+  float    restoreSec;   // Wiper back up after the stuck rod was freed.
+  float    ocSec;        // OC LED came on.
+  float    offSec;       // Arc switched off after the OC LED.
+  int      steadyWiper;  // Most common Wiper in the last second of the burn.
+  int      maxWiper;     // Highest Wiper after the strike.
+  int      minWiper;     // Lowest Wiper during the burn.
+  int      pulseEdges;   // Pulse state changes.
+  float    periodErrUs;  // Worst rising Wiper edge time error, from a whole number of pulse periods, in uS.
+  int      riseCnt;      // Rising Wiper edges timed.
+  float    ampsErr;      // Mean |Amps - welder Amps| over the last second of the burn.
+  uint32_t events;       // Event Log events.
+  byte     eventCode;    // First Event Log event code.
+  float    eventSec;     // First Event Log event.
+};
+
+// Device check.
+struct DevCheck {
+  const char *name;
+  int (*run)(void); // Returns the number of failed checks.
+};
+
+// Global System vars, as in PulseWelder.cpp.
+INA219 ina219;
+byte   arcSwitch       = DEF_SET_ARC;
+byte   hotStartPc      = DEF_SET_HOT_PC;
+byte   hotStartX10     = DEF_SET_HOT_X10;
+bool   i2cInitComplete = false;
+bool   overTempAlert   = false;
+byte   pulseAmpsPc     = DEF_SET_PULSE_AMPS;
+byte   pulseFreqX10    = DEF_SET_FRQ_X10;
+byte   pulseSwitch     = DEF_SET_PULSE;
+byte   pulseWave       = DEF_SET_WAVE;
+byte   setAmps         = DEF_SET_AMPS;
+bool   spiInitComplete = false;
+volatile int  Amps          = 0;
+volatile bool pulseState    = true;
+volatile unsigned int Volts = 0;
+
+// Local Scope Vars
+static const PlantCfg plantCfg = { 0.95f, 3.0f, 0.003f, 2.0f, 60.0f, 20.0f, 0.04f, 3.0f, 1.5f, 0.08f, 0.006f, 80.0f,
+                                   300.0f, 30.0f, 25.0f, 90.0f };
+static const Scenario scenarios[] = {
+  { "Strike, weld, and lift (I2C Pot)", 3.0f, 0.5f, -1.0f, -1.0f, 2.5f, 90, false, 10, 0.0f, true },
+  { "Strike, weld, and lift (SPI Pot)", 3.0f, 0.5f, -1.0f, -1.0f, 2.5f, 90, false, 10, 0.0f, false },
+  { "Stuck rod", 3.0f, 0.5f, 1.5f, 2.0f, 2.7f, 100, false, 10, 0.0f, true },
+  { "Pulse mode, 2Hz", 4.5f, 0.3f, -1.0f, -1.0f, -1.0f, 110, true, 20, 0.0f, true },
+  { "Pulse mode, 3Hz (period is not whole mS)", 4.5f, 0.3f, -1.0f, -1.0f, -1.0f, 110, true, 30, 0.0f, true },
+  { "Over temperature", 2.0f, 0.3f, -1.0f, -1.0f, -1.0f, 125, false, 10, 99.0f, true }
+};
+static SimResult result;                 // Results of the scenario being run.
+static float     fastHeat = 0;           // Welder heat model, power device path, percent.
+static float     slowHeat = 0;           // Welder heat model, heatsink path, percent.
+static float     plantAmps = 0;          // Welder output current, in Amps.
+static uint32_t  plantNoise = 777;       // Arc noise generator.
+static double    tickNsTotal = 0;        // PC time spent in controlTick(), in nS.
+static double    tickNsMax   = 0;        // Longest controlTick(), in nS.
+static uint32_t  tickCnt     = 0;        // Number of ticks run.
+
+// *********************************************************************************************
+// On exit, returns the PC's monotonic clock, in nS.
+static double pcNs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+// *********************************************************************************************
+// On exit, returns the welder's output setting for a Wiper value, in Amps.
+static float wiperAmps(int wiper)
+{
+  float cmd = MIN_AMPS + (wiper < 0 ? 0 : wiper) * (float)(MAX_AMPS - MIN_AMPS) / 0xff;
+
+  return plantCfg.gain * cmd + plantCfg.offset;
+}
+
+// *********************************************************************************************
+// On exit, returns the next arc noise value, +/- plantCfg.noiseAmps.
+static float arcNoise(void)
+{
+  plantNoise = plantNoise * 1664525UL + 1013904223UL;
+
+  return ((plantNoise >> 8) / 16777216.0f * 2.0f - 1.0f) * plantCfg.noiseAmps;
+}
+
+// *********************************************************************************************
+// Run the welder and arc for one tick of scenario sc at time t (seconds). Sets the simulated device inputs.
+static void plantStep(const Scenario& sc, float t)
+{
+  HalSimIo *io  = halSimIo();
+  float     dt  = CONTROL_PERIOD_US / 1000000.0f;
+  bool      on  = (sc.strikeSec >= 0) && (t >= sc.strikeSec) && ((sc.liftSec < 0) || (t < sc.liftSec));
+  bool      stuck = (sc.stickSec >= 0) && (t >= sc.stickSec) && (t < sc.unstickSec);
+  float     target;
+  float     heatTarget;
+  float     dropT;
+
+#ifdef PWM_ARC_CTRL
+  target = io->pwmOn ? wiperAmps(io->wiper) : 0;
+#else // ifdef PWM_ARC_CTRL
+  target = wiperAmps(io->wiper);
+#endif // ifdef PWM_ARC_CTRL
+
+  if (!on) {
+    plantAmps = 0;
+    io->amps  = 0;
+    io->volts = plantCfg.ocvVolts;
+  }
+  else {
+    plantAmps += (target - plantAmps) * (1.0f - expf(-dt / plantCfg.tauSec));
+    io->amps   = plantAmps + arcNoise();
+    dropT      = fmodf(t - sc.strikeSec, plantCfg.dropPeriod);
+
+    if ((t - sc.strikeSec < STRIKE_SEC) || stuck) {
+      io->volts = t - sc.strikeSec < STRIKE_SEC ? plantCfg.shortVolts : plantCfg.stickVolts;
+    }
+    else if (dropT >= plantCfg.dropPeriod - plantCfg.dropSec) {
+      io->volts = plantCfg.shortVolts;
+    }
+    else {
+      io->volts = plantCfg.arcVolts + plantCfg.arcOhms * plantAmps;
+    }
+  }
+
+  heatTarget = 100.0f * (plantAmps * plantAmps) / (plantCfg.contAmps * plantCfg.contAmps);
+  fastHeat  += (heatTarget * plantCfg.fastPc / 100.0f - fastHeat) * (1.0f - expf(-dt / plantCfg.fastSec));
+  slowHeat  += (heatTarget * (100.0f - plantCfg.fastPc) / 100.0f - slowHeat) * (1.0f - expf(-dt / plantCfg.tauHeatSec));
+  io->ocAlert = fastHeat + slowHeat >= 100.0f ? true : (fastHeat + slowHeat < plantCfg.resetPc ? false : io->ocAlert);
+}
+
+// *********************************************************************************************
+// Run one Control Task tick, and the loop() services that act on the welder.
+static void runTick(void)
+{
+  double startNs;
+  double ns;
+
+  halSimAdvance(CONTROL_PERIOD_US); // Devices and I2C Engine run up to the tick.
+  startNs = pcNs();
+  controlTick();
+  ns           = pcNs() - startNs;
+  tickNsTotal += ns;
+  tickNsMax    = ns > tickNsMax ? ns : tickNsMax;
+  tickCnt++;
+
+  checkForAlerts();
+  processArcEvents();
+}
+
+// *********************************************************************************************
+// Power-up initialization of the controller core, in the same order as setup().
+// On exit, returns false if the simulated hardware failed its checks.
+static bool startController(bool i2cPot)
+{
+  bool success = true;
+
+  halSimIo()->i2cPot = i2cPot;
+  initVdcAdc();
+  success &= initCurrentSensor();
+  success &= initDigitalPot(POT_I2C_ADDR, POT_CS);
+  controlArc(arcSwitch, VERBOSE_ON);
+  resetCurrentBuffer();
+  resetVdcBuffer();
+  initControlTask();
+
+  return success;
+}
+
+// *********************************************************************************************
+// On exit, returns true (and prints PASS) if ok, else prints FAIL.
+static bool check(bool ok, const char *what, float value, const char *unit)
+{
+  printf("    %s %-52s %8.1f%s\n", ok ? "PASS" : "FAIL", what, value, unit);
+
+  return ok;
+}
+
+// *********************************************************************************************
+// Run one scenario (in its own process). On exit, returns the number of failed checks.
+static int runScenario(const Scenario& sc)
+{
+  uint32_t    ticks   = (uint32_t)(sc.runSec * CONTROL_RATE_HZ);
+  int         fails   = 0;
+  int         offWiper;
+  bool        lastPulse;
+  int         lastWiper = POT_MIN;
+  int         midWiper;
+  int         riseTicks = 0;
+  uint32_t    riseUs  = 0;
+  float       periodUs;
+  float       edgeErrUs;
+  double      errSum  = 0;
+  uint32_t    errCnt  = 0;
+  double      startNs;
+  double      wallSec;
+  float       t;
+  int         wiper;
+  uint32_t    wiperHist[POT_MAX + 1];
+  HalSimStats hs;
+  I2cStats    i2cHigh;
+  I2cStats    i2cLow;
+  InaStats    inaSt;
+
+  memset(&result, 0, sizeof(result));
+  memset(wiperHist, 0, sizeof(wiperHist));
+  result.stableSec  = result.stuckSec = result.outSec = result.cutSec = -1;
+  result.restoreSec = result.ocSec = result.offSec = -1;
+  result.minWiper   = 0xff;
+  setAmps           = sc.amps;
+  pulseSwitch       = sc.pulse ? PULSE_ON : PULSE_OFF;
+  pulseFreqX10      = sc.freqX10;
+  fastHeat          = sc.heatPc * plantCfg.fastPc / 100.0f;
+  slowHeat          = sc.heatPc - fastHeat;
+
+  if (!startController(sc.i2cPot)) {
+    printf("    FAIL Simulated hardware initialization.\n");
+    return 1;
+  }
+
+  offWiper  = map(ARC_OFF_AMPS, MIN_AMPS, MAX_AMPS, POT_MIN, POT_MAX);
+  lastPulse = pulseState;
+  midWiper  = (map(sc.amps, MIN_AMPS, MAX_AMPS, POT_MIN, POT_MAX) +
+               map(sc.amps * pulseAmpsPc / 100, MIN_AMPS, MAX_AMPS, POT_MIN, POT_MAX)) / 2;
+  startNs   = pcNs();
+
+  for (uint32_t i = 0; i < ticks; i++) {
+    t = (float)(i) / CONTROL_RATE_HZ;
+    plantStep(sc, t);
+    runTick();
+    wiper = getPotWiper();
+
+    if ((sc.strikeSec >= 0) && (t >= sc.strikeSec) && ((sc.liftSec < 0) || (t < sc.liftSec))) {
+      result.maxWiper = max(result.maxWiper, wiper);
+
+      if (t >= sc.strikeSec + 1.0f) {
+        result.minWiper = min(result.minWiper, wiper);
+      }
+
+      if (((sc.liftSec < 0) ? sc.runSec : sc.liftSec) - t <= 1.0f) {
+        errSum += fabsf(Amps - plantAmps);
+        errCnt++;
+        wiperHist[constrain(wiper, POT_MIN, POT_MAX)]++; // Arc Force boosts the droplet shorts.
+      }
+    }
+
+    if ((sc.stickSec >= 0) && (t >= sc.stickSec) && (t < sc.unstickSec) && (result.cutSec < 0) && (wiper == offWiper)) {
+      result.cutSec = t;
+    }
+
+    if ((sc.stickSec >= 0) && (t >= sc.unstickSec) && (result.restoreSec < 0) && (wiper > offWiper)) {
+      result.restoreSec = t;
+    }
+
+    if (halSimIo()->ocAlert && (result.ocSec < 0)) {
+      result.ocSec = t;
+    }
+
+    if ((result.ocSec >= 0) && (result.offSec < 0) && (arcSwitch == ARC_OFF) && (wiper == offWiper)) {
+      result.offSec = t;
+    }
+
+    if (pulseState != lastPulse) {
+      lastPulse = pulseState;
+      result.pulseEdges++;
+      riseTicks = pulseState ? 0 : 2; // The rising Wiper edge is in this tick or the next one (queued write).
+    }
+
+    if ((riseTicks > 0) && (halSimIo()->wiper >= midWiper) && (lastWiper < midWiper) &&
+        (t >= sc.strikeSec + (ARC_STABLE_TIME + ARC_STABLIZE_TM) / 1000.0f)) { // Rising Wiper edge, modulating.
+      if (riseUs != 0) { // Edges hidden by Arc Force boosts are skipped: Compare with whole periods.
+        periodUs           = 10000000.0f / sc.freqX10;
+        edgeErrUs          = (float)(halSimIo()->wiperUs - riseUs);
+        edgeErrUs          = fabsf(edgeErrUs - roundf(edgeErrUs / periodUs) * periodUs);
+        result.periodErrUs = max(result.periodErrUs, edgeErrUs);
+        result.riseCnt++;
+      }
+      riseUs    = halSimIo()->wiperUs;
+      riseTicks = 0;
+    }
+    riseTicks -= riseTicks > 0 ? 1 : 0;
+    lastWiper  = halSimIo()->wiper;
+  }
+  wallSec        = (pcNs() - startNs) / 1e9;
+  result.ampsErr = errCnt == 0 ? 0 : (float)(errSum / errCnt);
+
+  for (int w = POT_MIN; w <= POT_MAX; w++) {
+    result.steadyWiper = wiperHist[w] > wiperHist[result.steadyWiper] ? w : result.steadyWiper;
+  }
+
+  Serial.echo = true;
+  halSimStats(&hs);
+  getI2cStats(&i2cHigh, I2C_PRIO_HIGH, false);
+  getI2cStats(&i2cLow, I2C_PRIO_LOW, false);
+  getInaStats(&inaSt, false);
+  printf("    %.1fS simulated in %.3fS (%.0fx real time), controlTick() %.2fuS avg / %.2fuS max.\n", sc.runSec,
+         wallSec, sc.runSec / wallSec, tickNsTotal / tickCnt / 1000.0, tickNsMax / 1000.0);
+  printf("    Bus %u xfers (%.0f/S, %u NACK). I2C Engine queue wait: Pot %u/%uuS, Sensor %u/%uuS (avg/max).\n",
+         hs.busXfers, hs.busXfers / sc.runSec, hs.busNacks, i2cHigh.waitAvgUs, i2cHigh.waitMaxUs, i2cLow.waitAvgUs,
+         i2cLow.waitMaxUs);
+  simBus.printCounts();
+  printf("    INA219 %u conversions, %u samples filtered; Pot %u Wiper changes; %u Event Log events.\n", hs.inaConvs,
+         inaSt.samples, hs.potWrites, result.events);
+
+  if (sc.strikeSec >= 0) {
+    fails += !check((result.stableSec >= 0) && (result.stableSec - sc.strikeSec <= (ARC_STABLE_TIME + 100) / 1000.0f),
+                    "Arc stable after the strike, mS", (result.stableSec - sc.strikeSec) * 1000.0f, "");
+  }
+
+  if ((sc.strikeSec >= 0) && (sc.stickSec < 0) && !sc.pulse && (sc.heatPc < 50)) {
+    fails += !check(result.ampsErr <= 5.0f, "Measured Amps error (last second of burn), A", result.ampsErr, "");
+    fails += !check(result.steadyWiper == map(sc.amps, MIN_AMPS, MAX_AMPS, POT_MIN, POT_MAX) ||
+                    result.steadyWiper == map(sc.amps, MIN_AMPS, MAX_AMPS, POT_MIN, POT_MAX) + 1,
+                    "Steady Wiper matches the Amps setting", result.steadyWiper, "");
+#ifdef HOT_START_ON
+    fails += !check(result.maxWiper > result.steadyWiper, "Hot Start boost above the steady Wiper", result.maxWiper, "");
+#endif // ifdef HOT_START_ON
+  }
+
+  if (sc.liftSec >= 0) {
+    fails += !check((result.outSec >= 0) && (result.outSec - sc.liftSec <= 0.1f), "Arc out after the lift, mS",
+                    (result.outSec - sc.liftSec) * 1000.0f, "");
+  }
+
+#ifdef ANTI_STICK_ON
+  if (sc.stickSec >= 0) {
+    fails += !check((result.stuckSec >= 0) && (result.stuckSec - sc.stickSec <= (STICK_TIME + 30) / 1000.0f),
+                    "Stuck rod detected, mS", (result.stuckSec - sc.stickSec) * 1000.0f, "");
+    fails += !check((result.cutSec >= 0) && (result.cutSec - sc.stickSec <= (STICK_TIME + 40) / 1000.0f),
+                    "Current reduced to ARC_OFF_AMPS, mS", (result.cutSec - sc.stickSec) * 1000.0f, "");
+    fails += !check((result.restoreSec >= 0) && (result.restoreSec - sc.unstickSec <= 0.1f),
+                    "Current restored after release, mS", (result.restoreSec - sc.unstickSec) * 1000.0f, "");
+  }
+#endif // ifdef ANTI_STICK_ON
+
+  if (sc.pulse) {
+    float modSec = sc.runSec - sc.strikeSec - ARC_STABLE_TIME / 1000.0f - ARC_STABLIZE_TM / 1000.0f;
+
+    fails += !check(result.pulseEdges >= (int)(2 * modSec * sc.freqX10 / 10.0f), "Pulse edges",
+                    result.pulseEdges, "");
+    fails += !check((result.riseCnt >= 2) && (result.periodErrUs <= 200.0f), "Pulse edge timing error, uS",
+                    result.periodErrUs, "");
+    fails += !check(result.maxWiper - result.minWiper >= 0x80, "Pulse Wiper swing", result.maxWiper - result.minWiper,
+                    "");
+  }
+
+  if (sc.heatPc >= 50) {
+    fails += !check(result.ocSec >= 0, "OC LED tripped, S", result.ocSec, "");
+    fails += !check((result.offSec >= 0) && (result.offSec - result.ocSec <= 0.01f), "Arc switched off after OC, mS",
+                    (result.offSec - result.ocSec) * 1000.0f, "");
+    fails += !check(result.events > 0, "OC Alert in the Event Log", result.events, "");
+  }
+
+  return fails;
+}
+
+// *********************************************************************************************
+// Replay a Telemetry Recorder capture. speed = 0 runs as fast as possible, else speed times real time.
+// On exit, returns 0 if the file was replayed.
+static int runReplay(const char *path, float speed, byte amps)
+{
+  FILE    *fp = fopen(path, "r");
+  char     line[REPLAY_LINE];
+  long     tUs;
+  float    ampsIn;
+  float    voltsIn;
+  int      wiper;
+  int      phase;
+  int      state;
+  int      flags;
+  int      prevState   = -1;
+  int      simPrev     = -1;
+  uint32_t rows        = 0;
+  uint32_t stateMatch  = 0;
+  uint32_t wiperMatch  = 0;
+  uint32_t recChanges  = 0;
+  uint32_t simChanges  = 0;
+  long     firstBadUs  = 0;
+  bool     firstBad    = false;
+  double   startNs;
+  double   wallSec;
+  double   simSec;
+
+  if (fp == NULL) {
+    printf("Replay: Cannot open %s\n", path);
+    return 1;
+  }
+
+  setAmps = amps;
+
+  while (fgets(line, sizeof(line), fp) != NULL) { // Pulse mode was on if any sample is in the low half.
+    if ((sscanf(line, "%ld,%f,%f,%d,%d,%d,%d", &tUs, &ampsIn, &voltsIn, &wiper, &phase, &state, &flags) == 7) &&
+        (flags & SAMPLE_FLAG_PULSE)) {
+      pulseSwitch = PULSE_ON;
+    }
+  }
+  rewind(fp);
+
+  if (!startController(true)) {
+    printf("Replay: Simulated hardware initialization failed.\n");
+    fclose(fp);
+    return 1;
+  }
+  Serial.echo = false;
+  startNs     = pcNs();
+
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    if (sscanf(line, "%ld,%f,%f,%d,%d,%d,%d", &tUs, &ampsIn, &voltsIn, &wiper, &phase, &state, &flags) != 7) {
+      continue; // Comment or header line.
+    }
+
+    halSimIo()->amps    = ampsIn;
+    halSimIo()->volts   = voltsIn;
+    halSimIo()->ocAlert = (flags & SAMPLE_FLAG_HEAT) != 0;
+    arcSwitch           = flags & SAMPLE_FLAG_ARC_ON ? ARC_ON : ARC_OFF;
+    runTick();
+    rows++;
+
+    stateMatch += getArcState() == state ? 1 : 0;
+    wiperMatch += getPotWiper() == wiper ? 1 : 0;
+    recChanges += (prevState >= 0) && (state != prevState) ? 1 : 0;
+    simChanges += (simPrev >= 0) && (getArcState() != simPrev) ? 1 : 0;
+    prevState   = state;
+    simPrev     = getArcState();
+
+    if (!firstBad && (getArcState() != state)) {
+      firstBad   = true;
+      firstBadUs = tUs;
+    }
+
+    if (speed > 0) { // Paced replay.
+      while ((pcNs() - startNs) / 1e9 < rows / (double)(CONTROL_RATE_HZ) / speed) {}
+    }
+  }
+  fclose(fp);
+  wallSec = (pcNs() - startNs) / 1e9;
+  simSec  = rows / (double)(CONTROL_RATE_HZ);
+
+  if (rows == 0) {
+    printf("Replay: No samples in %s\n", path);
+    return 1;
+  }
+
+  printf("Replay: %u samples (%.3fS) in %.3fS, %.0fx real time.\n", rows, simSec, wallSec, simSec / wallSec);
+  printf("Replay: Arc State matches %.1f%% (%u recorded changes, %u simulated)", 100.0 * stateMatch / rows, recChanges,
+         simChanges);
+  printf(firstBad ? ", first difference at %ld uS.\n" : ".\n", firstBadUs);
+  printf("Replay: Wiper matches %.1f%%.\n", 100.0 * wiperMatch / rows);
+
+  return 0;
+}
+
+// *********************************************************************************************
+// On exit, returns the bus transactions of a device since the last call (counters are cleared).
+static uint32_t busXfers(SimDevice *dev)
+{
+  SimBusCounts counts;
+
+  simBus.getCounts(&counts, dev, true);
+
+  return counts.xfers;
+}
+
+// *********************************************************************************************
+// Wait (simulated time) for the INA219 Conversion Ready flag, polled with the library through Wire.
+// On exit, returns the wait, in uS.
+static uint32_t waitInaReady(INA219& lib)
+{
+  uint32_t startUs = halMicros();
+
+  while (((lib.busVoltageRaw() & INA219_CNVR) == 0) && (halMicros() - startUs < 200000)) {}
+
+  return halMicros() - startUs;
+}
+
+// *********************************************************************************************
+// INA219 library (Wire, no transport hooks) against the register model.
+static int devInaRegs(void)
+{
+  INA219       lib;
+  Ina219Model *ina   = halSimIna();
+  HalSimIo    *io    = halSimIo();
+  int          fails = 0;
+  uint16_t     cfg;
+  float        lsb;
+  float        cal;
+  int16_t      raw;
+  uint32_t     us;
+
+  halSimAdvance(1000); // Attach the devices.
+  busXfers(ina);
+  lib.begin(INA219_ADDR);
+  lib.reset();
+  fails += !check(ina->reg(CONFIG_R) == CONFIG_DEFAULT, "Reset: Configuration register is 0x399F", ina->reg(CONFIG_R),
+                  "");
+
+  cfg = (BUS_RANGE_16V << BRNG) | (PGA_RANGE_160MV << PG0) | (SAMPLE_9BITS << BADC1) | (SAMPLE_12BITS << SADC1) |
+        CONTINUOUS_OP_NO_VDC;
+  lib.configure(BUS_RANGE_16V, PGA_RANGE_160MV, SAMPLE_9BITS, SAMPLE_12BITS, CONTINUOUS_OP_NO_VDC);
+  fails += !check(ina->reg(CONFIG_R) == cfg, "Configuration register (12 bit shunt, continuous)", ina->reg(CONFIG_R),
+                  "");
+
+  lib.calibrate(SHUNT_OHMS, SHUNT_V_MAX, BUS_V_MAX, MAX_I_EXPECTED);
+  lsb    = lib.currentFromRaw(1);
+  cal    = 0.04096f / (lsb * SHUNT_OHMS);
+  fails += !check((ina->reg(CAL_R) & 0x01) == 0 && fabsf(ina->reg(CAL_R) - cal) <= 2.0f,
+                  "Calibration register (bit 0 reads zero)", ina->reg(CAL_R), "");
+
+  io->amps = 100.0f;
+  halSimAdvance(1200);
+  raw    = lib.shuntVoltageRaw();
+  fails += !check(raw == -lround(100.0 * SHUNT_OHMS * 100000.0), "Shunt Voltage register at 100A (10uV counts)", raw,
+                  "");
+  fails += !check(fabsf(lib.shuntCurrent() + 100.0f) <= 0.5f, "Current register (Shunt * Cal / 4096), A",
+                  lib.shuntCurrent(), "");
+
+  lib.configure(BUS_RANGE_16V, PGA_RANGE_160MV, SAMPLE_9BITS, SAMPLE_AVG_32, CONTINUOUS_OP_NO_VDC);
+  us     = waitInaReady(lib);
+  fails += !check((us >= INA219_AVG_CONV_US) && (us <= INA219_AVG_CONV_US + 300), "32 sample conversion time, uS", us,
+                  "");
+  lib.busPower();
+  fails += !check((lib.busVoltageRaw() & INA219_CNVR) == 0, "Power register read clears CNVR", 0, "");
+
+  lib.configure(BUS_RANGE_16V, PGA_RANGE_160MV, SAMPLE_9BITS, SAMPLE_AVG_32, CONTINUOUS_OP_NO_VDC);
+  halSimAdvance(INA219_AVG_CONV_US / 2);
+  io->amps = 0;
+  waitInaReady(lib);
+  raw    = lib.shuntVoltageRaw();
+  fails += !check(abs(raw + 2140) <= 30, "Averaging: 100A for half the conversion", raw, "");
+
+  io->amps = 500.0f;
+  halSimAdvance(2 * INA219_AVG_CONV_US);
+  raw    = lib.shuntVoltageRaw();
+  fails += !check(raw == -16000, "PGA /4 saturation (160mV) at 500A", raw, "");
+
+  io->amps = 101.0f;
+  lib.configure(BUS_RANGE_16V, PGA_RANGE_160MV, SAMPLE_9BITS, SAMPLE_9BITS, CONTINUOUS_OP_NO_VDC);
+  halSimAdvance(200);
+  raw    = lib.shuntVoltageRaw();
+  fails += !check((raw % 8 == 0) && (abs(raw + 4323) < 8), "9 bit conversion (84uS) loses 3 low bits", raw, "");
+
+  printf("    INA219 library through Wire: %u bus transactions.\n", busXfers(ina));
+
+  return fails;
+}
+
+// *********************************************************************************************
+// INA219 faults: Missing (NACK) sensor, and a stuck Current register (wiring error path in measure.cpp).
+static int devInaFaults(void)
+{
+  HalSimIo *io    = halSimIo();
+  int       fails = 0;
+
+  halSimAdvance(1000);
+  simBus.injectNack(INA219_ADDR, 10);
+  fails += !check(!initCurrentSensor(), "initCurrentSensor() fails on NACK", 0, "");
+  simBus.clearFaults();
+
+  fails += !check(startController(true), "Controller starts after the NACKs stop", 0, "");
+  halSimIna()->stickRegister(I_SHUNT_R, 2000); // Positive reading: Shunt wired backwards.
+  io->amps = 0;
+
+  for (int i = 0; i < 200; i++) {
+    runTick();
+  }
+  fails += !check(Amps == 999, "Amps shows the wiring error (999)", Amps, "");
+  fails += !check(result.eventCode == EVT_INA_WIRING, "INA219 wiring error in the Event Log", result.events, "");
+  printf("    200 ticks: %u INA219 bus transactions.\n", busXfers(halSimIna()));
+
+  return fails;
+}
+
+// *********************************************************************************************
+// MCP45HV51 (I2C) through digPot.cpp and the I2C Engine, then raw commands.
+static int devPotI2c(void)
+{
+  McpPotModel *pot;
+  int          fails = 0;
+  int          wiper = map(90, MIN_AMPS, MAX_AMPS, POT_MIN, POT_MAX);
+  uint8_t      cmd[2];
+
+  halSimIo()->i2cPot = true;
+  pot                = halSimPot();
+  fails             += !check(initDigitalPot(POT_I2C_ADDR, POT_CS), "initDigitalPot() finds the MCP45HV51", 0, "");
+  fails             += !check(pot->reg(POT_TCON_ADDR) == POT_TCON_DEF, "TCON register", pot->reg(POT_TCON_ADDR), "");
+  fails             += !check(pot->reg(POT_WIPER_ADDR) == POT_MIN, "Wiper at minimum after init",
+                              pot->reg(POT_WIPER_ADDR), "");
+  printf("    initDigitalPot(): %u bus transactions.\n", busXfers(pot));
+
+  setPotAmps(90, VERBOSE_OFF);
+  halSimAdvance(1000);
+  fails += !check(pot->reg(POT_WIPER_ADDR) == wiper, "setPotAmps(90) Wiper register", pot->reg(POT_WIPER_ADDR), "");
+  fails += !check(busXfers(pot) == 1, "setPotAmps() is one queued transaction", 1, "");
+  setPotAmps(90, VERBOSE_OFF);
+  halSimAdvance(1000);
+  fails += !check(busXfers(pot) == 0, "Unchanged setPotAmps() is not written", 0, "");
+  fails += !check(digitalPotRead(POT_WIPER_ADDR) == wiper, "digitalPotRead() Wiper", wiper, "");
+
+  arcSwitch = ARC_ON; // Pot characterization sweep: The held Wiper is limited by outputLimitAmps().
+  setPotOverride(0xff);
+  setPotAmps(90, VERBOSE_OFF);
+  halSimAdvance(1000);
+  fails += !check(pot->reg(POT_WIPER_ADDR) == map(MAX_SET_AMPS, MIN_AMPS, MAX_AMPS, POT_MIN, POT_MAX),
+                  "Held Wiper is limited to MAX_SET_AMPS", pot->reg(POT_WIPER_ADDR), "");
+  arcSwitch = ARC_OFF;
+  setPotAmps(90, VERBOSE_OFF);
+  halSimAdvance(1000);
+  fails += !check(pot->reg(POT_WIPER_ADDR) == map(ARC_OFF_AMPS, MIN_AMPS, MAX_AMPS, POT_MIN, POT_MAX),
+                  "Held Wiper is cut with the Arc off", pot->reg(POT_WIPER_ADDR), "");
+  setPotOverride(-1);
+  setPotAmps(90, VERBOSE_OFF);
+  halSimAdvance(1000);
+
+  cmd[0] = POT_WIPER_ADDR | POT_INC_CMD;
+  cmd[1] = POT_WIPER_ADDR | POT_INC_CMD;
+  i2cTransfer(POT_I2C_ADDR, cmd, 2, NULL, 0, I2C_PRIO_HIGH);
+  fails += !check(pot->reg(POT_WIPER_ADDR) == wiper + 2, "Two Increments in one transaction",
+                  pot->reg(POT_WIPER_ADDR), "");
+  cmd[0] = POT_WIPER_ADDR | POT_DEC_CMD;
+  i2cTransfer(POT_I2C_ADDR, cmd, 1, NULL, 0, I2C_PRIO_HIGH);
+  fails += !check(pot->reg(POT_WIPER_ADDR) == wiper + 1, "Decrement", pot->reg(POT_WIPER_ADDR), "");
+
+  digitalPotWrite(POT_MAX, POT_WIPER_ADDR);
+  cmd[0] = POT_WIPER_ADDR | POT_INC_CMD;
+  i2cTransfer(POT_I2C_ADDR, cmd, 1, NULL, 0, I2C_PRIO_HIGH);
+  fails += !check(pot->reg(POT_WIPER_ADDR) == POT_MAX, "Increment stops at 0xFF", pot->reg(POT_WIPER_ADDR), "");
+  digitalPotWrite(POT_MIN, POT_WIPER_ADDR);
+  cmd[0] = POT_WIPER_ADDR | POT_DEC_CMD;
+  i2cTransfer(POT_I2C_ADDR, cmd, 1, NULL, 0, I2C_PRIO_HIGH);
+  fails += !check(pot->reg(POT_WIPER_ADDR) == POT_MIN, "Decrement stops at 0x00", pot->reg(POT_WIPER_ADDR), "");
+
+  cmd[0] = (0x02 << 4) | POT_WR_CMD; // Reserved address.
+  cmd[1] = 0x55;
+  fails += !check(!i2cTransfer(POT_I2C_ADDR, cmd, 2, NULL, 0, I2C_PRIO_HIGH), "Reserved address is NACKed", 0, "");
+  cmd[0] = POT_TCON_ADDR | POT_INC_CMD;
+  fails += !check(!i2cTransfer(POT_I2C_ADDR, cmd, 1, NULL, 0, I2C_PRIO_HIGH), "TCON Increment is NACKed", 0, "");
+  printf("    Raw commands: %u bus transactions.\n", busXfers(pot));
+
+  return fails;
+}
+
+// *********************************************************************************************
+// MCP41HV51 (SPI) through digPot.cpp, then raw frames and the CMDERR status bit.
+static int devPotSpi(void)
+{
+  McpPotModel *pot;
+  int          fails = 0;
+  int          wiper = map(90, MIN_AMPS, MAX_AMPS, POT_MIN, POT_MAX);
+  uint8_t      cmd[2];
+  uint8_t      resp[2];
+
+  halSimIo()->i2cPot = false;
+  pot                = halSimPot();
+  fails             += !check(initDigitalPot(POT_I2C_ADDR, POT_CS), "initDigitalPot() finds the MCP41HV51", 0, "");
+  fails             += !check(pot->reg(POT_WIPER_ADDR) == POT_MIN, "Wiper at minimum after init",
+                              pot->reg(POT_WIPER_ADDR), "");
+  printf("    initDigitalPot(): %u bus transactions (I2C probe NACKed first).\n", busXfers(pot));
+
+  setPotAmps(90, VERBOSE_OFF);
+  fails += !check(pot->reg(POT_WIPER_ADDR) == wiper, "setPotAmps(90) Wiper register", pot->reg(POT_WIPER_ADDR), "");
+  fails += !check(busXfers(pot) == 1, "setPotAmps() is one SPI frame", 1, "");
+
+  cmd[0] = POT_WIPER_ADDR | POT_RD_CMD;
+  cmd[1] = 0;
+  halSpiXfer(POT_CS, POT_SPI_HZ, cmd, resp, 2);
+  fails += !check((resp[0] & 0x02) && (resp[1] == wiper), "Read: CMDERR high, data byte is the Wiper", resp[1], "");
+
+  cmd[0] = POT_WIPER_ADDR | POT_INC_CMD;
+  cmd[1] = POT_WIPER_ADDR | POT_INC_CMD;
+  halSpiXfer(POT_CS, POT_SPI_HZ, cmd, resp, 2);
+  fails += !check(pot->reg(POT_WIPER_ADDR) == wiper + 2, "Two 8 bit Increments in one frame",
+                  pot->reg(POT_WIPER_ADDR), "");
+
+  cmd[0] = (0x02 << 4) | POT_WR_CMD;
+  cmd[1] = 0x55;
+  halSpiXfer(POT_CS, POT_SPI_HZ, cmd, resp, 2);
+  fails += !check((resp[0] & 0x02) == 0, "Reserved address: CMDERR low", resp[0], "");
+  cmd[0] = POT_TCON_ADDR | POT_DEC_CMD;
+  halSpiXfer(POT_CS, POT_SPI_HZ, cmd, resp, 1);
+  fails += !check((resp[0] & 0x02) == 0, "TCON Decrement: CMDERR low", resp[0], "");
+
+  halSimPot()->stickRegister(POT_TCON_ADDR, 0x00); // TCON stuck: init must fail.
+  fails += !check(!initDigitalPot(POT_I2C_ADDR, POT_CS), "initDigitalPot() fails with a stuck TCON", 0, "");
+
+  return fails;
+}
+
+// *********************************************************************************************
+// MCP45HV51 bus faults: NACKed queued writes are retried, and a stuck Wiper is caught by the readback check.
+static int devPotFaults(void)
+{
+  McpPotModel *pot;
+  int          fails = 0;
+  int          wiper = map(90, MIN_AMPS, MAX_AMPS, POT_MIN, POT_MAX);
+  double       startSec;
+
+  halSimIo()->i2cPot = true;
+  pot                = halSimPot();
+  initDigitalPot(POT_I2C_ADDR, POT_CS);
+  simBus.injectNack(POT_I2C_ADDR, 2);
+
+  for (int i = 0; i < 20; i++) {
+    setPotAmps(90, VERBOSE_OFF);
+    halSimAdvance(1000);
+  }
+  fails += !check(pot->reg(POT_WIPER_ADDR) == wiper, "Wiper written after 2 NACKs", pot->reg(POT_WIPER_ADDR), "");
+  fails += !check(result.eventCode == EVT_POT_IO, "Pot I/O error in the Event Log", result.events, "");
+
+  simBus.injectNack(POT_I2C_ADDR, 0, 3); // Every third transaction fails.
+
+  for (int i = 0; i < 200; i++) {
+    setPotAmps(i % 2 ? 90 : 100, VERBOSE_OFF);
+    halSimAdvance(1000);
+  }
+  setPotAmps(90, VERBOSE_OFF);
+  halSimAdvance(1000);
+  setPotAmps(90, VERBOSE_OFF);
+  halSimAdvance(1000);
+  fails += !check(pot->reg(POT_WIPER_ADDR) == wiper, "Intermittent NACKs: Final Wiper", pot->reg(POT_WIPER_ADDR), "");
+  simBus.clearFaults();
+
+#ifdef POT_VERIFY_TIME
+  memset(&result, 0, sizeof(result));
+  pot->stickRegister(POT_WIPER_ADDR, 0x10);
+  startSec = halSimSeconds();
+
+  while (halSimSeconds() - startSec < (POT_VERIFY_TIME + 500) / 1000.0) {
+    setPotAmps(90, VERBOSE_OFF);
+    halSimAdvance(1000);
+  }
+  fails += !check(result.eventCode == EVT_POT_VERIFY, "Stuck Wiper: Readback mismatch in the Event Log",
+                  result.events, "");
+  fails += !check(result.eventSec - startSec <= (POT_VERIFY_TIME + 10) / 1000.0, "Stuck Wiper detected, mS",
+                  (result.eventSec - startSec) * 1000.0f, "");
+
+  memset(&result, 0, sizeof(result)); // Wiper writes while the readback is on the bus (Pulse waveform rate).
+  pot->clearFaults();
+  startSec = halSimSeconds();
+
+  while (halSimSeconds() - startSec < (3 * POT_VERIFY_TIME + 500) / 1000.0) {
+    setPotAmps(90 + 10 * ((int)(halSimSeconds() * 10000) % 3), VERBOSE_OFF);
+    halSimAdvance(100);
+  }
+  fails += !check(result.events == 0, "Writes during readback: No mismatch", result.events, "");
+#else // ifdef POT_VERIFY_TIME
+  (void)(startSec);
+#endif // ifdef POT_VERIFY_TIME
+
+  return fails;
+}
+
+static const DevCheck devChecks[] = {
+  { "INA219 registers (INA219 library through Wire)", devInaRegs },
+  { "INA219 faults (NACK, stuck Current register)", devInaFaults },
+  { "MCP45HV51 registers (I2C, digPot.cpp)", devPotI2c },
+  { "MCP41HV51 registers (SPI, digPot.cpp)", devPotSpi },
+  { "MCP45HV51 faults (NACKs, stuck Wiper)", devPotFaults }
+};
+
+// *********************************************************************************************
+int main(int argc, char **argv)
+{
+  bool  dev     = (argc >= 2) && (strcmp(argv[1], "dev") == 0);
+  int   cnt     = dev ? sizeof(devChecks) / sizeof(devChecks[0]) : sizeof(scenarios) / sizeof(scenarios[0]);
+  bool  verbose = false;
+  int   only    = -1;
+  int   fails   = 0;
+  int   status;
+  pid_t pid;
+
+  if ((argc >= 3) && (strcmp(argv[1], "replay") == 0)) {
+    return runReplay(argv[2], argc > 3 ? atof(argv[3]) : 0, argc > 4 ? (byte)(atoi(argv[4])) : DEF_SET_AMPS);
+  }
+
+  for (int i = dev ? 2 : 1; i < argc; i++) {
+    if (strcmp(argv[i], "-v") == 0) {
+      verbose = true;
+    }
+    else {
+      only = atoi(argv[i]);
+    }
+  }
+
+  for (int i = 0; i < cnt; i++) {
+    if ((only >= 0) && (only != i)) {
+      continue;
+    }
+
+    if (dev) {
+      printf("Device check %d: %s\n", i, devChecks[i].name);
+    }
+    else {
+      printf("Scenario %d: %s, %dA%s\n", i, scenarios[i].name, scenarios[i].amps, scenarios[i].pulse ? ", Pulse" : "");
+    }
+    fflush(stdout);
+    pid = fork();
+
+    if (pid == 0) {
+      Serial.echo = verbose;
+      status      = dev ? devChecks[i].run() : runScenario(scenarios[i]);
+      fflush(stdout);
+      _exit(status);
+    }
+    waitpid(pid, &status, 0);
+    fails += WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+  }
+
+  printf("%d check%s failed.\n", fails, fails == 1 ? "" : "s");
+
+  return fails;
+}
+
+// *********************************************************************************************
+// Controller core services that are not simulated.
+// The UI's Arc State subscriber records the scenario's arc events instead.
+void screenArcEvent(const ArcEvent& evt)
+{
+  float t = evt.timeUs / 1000000.0f;
+
+  if ((evt.state == ARC_ST_STABLE) && (result.stableSec < 0)) {
+    result.stableSec = t;
+  }
+  else if ((evt.state == ARC_ST_STUCK) && (result.stuckSec < 0)) {
+    result.stuckSec = t;
+  }
+  else if (((evt.state == ARC_ST_OUT) || (evt.state == ARC_ST_OPEN)) && (result.stableSec >= 0) &&
+           (result.outSec < 0)) {
+    result.outSec = t;
+  }
+}
+
+void evlogEvent(byte code, int16_t p1, int16_t p2)
+{
+  if (result.events++ == 0) {
+    result.eventCode = code;
+    result.eventSec  = halSimSeconds();
+  }
+  Serial.println("Event Log: Code " + String(code) + ", " + String(p1) + ", " + String(p2) + ".");
+}
+
+void bleArcEvent(const ArcEvent& evt)     {}
+int32_t calibrateAmps(int32_t rawMa)      { return rawMa; }
+void drawPulseLightning(void)             {}
+byte getCalAmps(void)                     { return 0; }
+float getThermalHeat(void)                { return 100.0f * (fastHeat + slowHeat) / 100.0f; }
+void initRecorder(void)                   {}
+void initTelemetry(void)                  {}
+bool isPotSweeping(void)                  { return false; }
+void recArcEvent(const ArcEvent& evt)     {}
+void recordSample(const WeldSample& smp)  {}
+void sessionArcEvent(const ArcEvent& evt) {}
+void sessionSample(const WeldSample& smp) {}
+void telemArcEvent(const ArcEvent& evt)   {}
+void telemEvent(byte code, int32_t value) {}
+void telemSample(const WeldSample& smp)   {}
+byte thermalLimitAmps(byte amps)          { return amps; }
+void thermalSample(const WeldSample& smp) {}
+
+#endif // ifdef HAL_SIM
+
+// EOF
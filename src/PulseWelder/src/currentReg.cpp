@@ -0,0 +1,98 @@
+/*
+   File: currentReg.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Anti-Windup uses back-calculation: When the output is clamped (trimMax) or rate limited (slewMax) the integrator
+      is reloaded so that P + I equals the limited output. The integrator never runs away while the arc is
+      current limited, and there is no overshoot when the limit is released.
+ */
+
+#include "currentReg.h"
+
+// *********************************************************************************************
+// Limit value to lo...hi.
+static float clampf(float val, float lo, float hi)
+{
+  return val < lo ? lo : (val > hi ? hi : val);
+}
+
+// *********************************************************************************************
+CurrentReg::CurrentReg(void)
+{
+  cfg.kp      = 0;
+  cfg.ki      = 0;
+  cfg.dt      = 0;
+  cfg.trimMax = 0;
+  cfg.slewMax = 0;
+  reset();
+}
+
+// *********************************************************************************************
+// Load the regulator settings and clear the trim.
+void CurrentReg::begin(const CurrentRegCfg& newCfg)
+{
+  cfg = newCfg;
+  reset();
+}
+
+// *********************************************************************************************
+// Clear the trim and integrator.
+void CurrentReg::reset(void)
+{
+  integ     = 0;
+  trimOut   = 0;
+  isLimited = false;
+}
+
+// *********************************************************************************************
+// Run one regulator update. Call once every cfg.dt seconds.
+// On exit, returns the new trim value, in Amps.
+float CurrentReg::update(float setAmps, float measAmps)
+{
+  float err    = setAmps - measAmps;
+  float prop   = cfg.kp * err;
+  float step   = cfg.slewMax * cfg.dt;
+  float target;
+  float limOut;
+
+  integ  = integ + (cfg.ki * err * cfg.dt);
+  target = prop + integ;
+  limOut = clampf(target, -cfg.trimMax, cfg.trimMax);   // Magnitude limit.
+  limOut = clampf(limOut, trimOut - step, trimOut + step); // Rate limit.
+
+  isLimited = limOut != target;
+
+  if (isLimited) {                                     // Anti-Windup (back-calculation).
+    integ = clampf(limOut - prop, -cfg.trimMax, cfg.trimMax);
+  }
+
+  trimOut = limOut;
+
+  return trimOut;
+}
+
+// *********************************************************************************************
+// On exit, returns the present trim value, in Amps.
+float CurrentReg::trim(void) const
+{
+  return trimOut;
+}
+
+// *********************************************************************************************
+// On exit, returns true if the last update was clamped or rate limited.
+bool CurrentReg::limited(void) const
+{
+  return isLimited;
+}
+
+// EOF
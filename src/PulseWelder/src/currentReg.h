@@ -0,0 +1,53 @@
+/*
+   File: currentReg.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Closed-Loop Current Regulator. A PI controller that calculates an Amps trim value; The trim is added to the
+      user's Amps setting before it is sent to the Digital Pot.
+   2. This file and currentReg.cpp do not use the Arduino libraries. They can be compiled on a PC along with
+      weldSim.cpp for gain tuning.
+ */
+#ifndef __CURRENT_REG_H__
+#define __CURRENT_REG_H__
+
+// Regulator settings.
+struct CurrentRegCfg {
+  float kp;      // Proportional gain, Amps of trim per Amp of error.
+  float ki;      // Integral gain, Amps of trim per Amp of error per second.
+  float dt;      // Update period, in seconds.
+  float trimMax; // Trim limit, +/- Amps.
+  float slewMax; // Trim rate limit, Amps per second.
+};
+
+class CurrentReg {
+public:
+
+  CurrentReg(void);
+  void  begin(const CurrentRegCfg& cfg);
+  void  reset(void);
+  float update(float setAmps,
+               float measAmps);
+  float trim(void) const;
+  bool  limited(void) const;
+
+private:
+
+  CurrentRegCfg cfg;      // Regulator settings.
+  float         integ;    // Integrator state, in Amps.
+  float         trimOut;  // Present trim, in Amps.
+  bool          isLimited; // Last update was clamped or rate limited.
+};
+
+#endif // ifndef __CURRENT_REG_H__
+
+// EOF
@@ -16,12 +16,27 @@
 
    Notes: Beginning with V1.1, support has been added for the MCP41HV51 SPI Digital Pot IC.
           Auto Detection, MCP45HV51 (I2C) or MCP41HV51 (SPI).
+          Beginning with V1.4, the MCP45HV51 is serviced by the I2C Engine (i2cBus.cpp). Wiper updates from
+          setPotAmps() are queued at high priority and do not wait for the bus.
+          The Amps to Wiper conversion is a table built by the compiler. setPotAmps() only writes the Pot when the
+          Wiper value changes; The optional readback check (POT_VERIFY_TIME in config.h) catches lost writes.
+          The compile-time table assumes the welder's Amps are linear with the Wiper. When the Pot characterization
+          sweep (potSweep.cpp) has measured this welder, setPotAmps() uses its table instead (setPotTable()). The sweep
+          holds the Wiper with setPotOverride() while it measures. The held Wiper is limited to the Wiper of
+          outputLimitAmps(), so the Arc off, Anti-Stick, thermal derating, and MAX_SET_AMPS limits still apply.
+          The SPI Pot and timer are used through the Hardware Abstraction Layer (hal.h, PC simulator support).
+          setPotAmps() is called by the Control Task and by loop(). The Wiper compare, cache update, and write are done
+          under a mutex, so the Wiper register and potCache always hold the same value and the writes are in order.
+          The queued readback carries the Wiper value it checks and the write count (potWriteSeq) at submit time. The
+          result is discarded if a Wiper write was queued while the read waited or was on the bus. Writes queued
+          before the read (high priority) complete before it starts; A failed one clears potCache, which also
+          discards the result.
  */
 
 #include <Arduino.h>
-#include <Wire.h>
-#include <SPI.h>
 #include "digPot.h"
+#include "hal.h"
+#include "i2cBus.h"
 #include "PulseWelder.h"
 #include "config.h"
 
@@ -30,6 +45,139 @@ extern bool spiInitComplete; // SPI Port Initialization flag.
 
 static uint8_t csPin = 0;
 static uint8_t chipAddr = 0;
+static volatile uint32_t potErrCnt    = 0;  // Failed queued wiper writes, counted by the I2C Engine callback.
+static volatile uint32_t potVerifyCnt = 0;  // Wiper readback mismatches.
+static volatile int      potCache     = -1; // Wiper value last written to the Pot. -1 = Unknown, forces a write.
+static volatile uint32_t potWriteUs   = 0;  // Completion time of the last Wiper write, in uS.
+static volatile int      potOverride  = -1; // Wiper value held by the characterization sweep. -1 = None.
+static volatile uint32_t potWriteSeq  = 0;  // Counts Wiper writes started, for the readback check.
+static SemaphoreHandle_t potMutex     = NULL; // Serializes setPotAmps() (Control Task and loop()).
+
+// *********************************************************************************************
+// Amps to Wiper lookup table, indexed by (Amps - MIN_AMPS). Built at compile time.
+// Each entry is identical to map(amps, MIN_AMPS, MAX_AMPS, 0x00, 0xff).
+constexpr byte ampsToWiper(int amps)
+{
+  return (byte)(((long)(amps - MIN_AMPS) * (0xff - 0x00)) / (MAX_AMPS - MIN_AMPS) + 0x00);
+}
+
+template<int... Idx>
+struct WiperTable {
+  static const byte wiper[sizeof...(Idx)];
+};
+
+template<int... Idx>
+const byte WiperTable<Idx...>::wiper[sizeof...(Idx)] = { ampsToWiper(MIN_AMPS + Idx)... };
+
+template<int Cnt, int... Idx>
+struct MakeWiperTable : MakeWiperTable<Cnt - 1, Cnt - 1, Idx...> {};
+
+template<int... Idx>
+struct MakeWiperTable<0, Idx...> {
+  typedef WiperTable<Idx...> table;
+};
+
+typedef MakeWiperTable<MAX_SET_AMPS - MIN_AMPS + 1>::table AmpsWiperTable;
+
+static_assert(ampsToWiper(MIN_AMPS) == 0x00, "Wiper table must start at zero.");
+static_assert(ampsToWiper(MAX_AMPS) == 0xff, "Wiper table must end at full scale.");
+
+static const byte *volatile wiperTable = AmpsWiperTable::wiper; // Amps to Wiper table used by setPotAmps().
+
+// *********************************************************************************************
+// I2C Engine callback for queued Digital Pot writes. A failed write forces the next setPotAmps() to rewrite.
+static void potWriteDone(const I2cXfer *xfer)
+{
+  if (!xfer->success) {
+    potCache = -1;
+    potErrCnt++;
+  }
+  else {
+    potWriteUs = halMicros();
+  }
+}
+
+#ifdef POT_VERIFY_TIME
+
+// *********************************************************************************************
+// I2C Engine callback for the Wiper readback check. A mismatch forces the next setPotAmps() to rewrite.
+// xfer->arg holds the write count (upper 24 bits) and the expected Wiper (lower 8 bits) when the read was queued.
+static void potVerifyDone(const I2cXfer *xfer)
+{
+  uint32_t arg      = (uint32_t)((uintptr_t)(xfer->arg));
+  int      expected = arg & 0xff;
+
+  if (((arg >> 8) != (potWriteSeq & 0xffffff)) || (potCache != expected)) {
+    return; // Wiper was written after the read was queued; The next check reads it.
+  }
+
+  if (xfer->success && (xfer->rx[1] != expected)) {
+    potCache = -1;
+    potVerifyCnt++;
+  }
+}
+
+// *********************************************************************************************
+// Read back the Pot Wiper and compare it to the last value written.
+// The I2C read is queued (low priority, after any pending Wiper writes). The SPI read is immediate.
+static void verifyPotWiper(void)
+{
+  if (potCache < 0) {
+    return; // Nothing to check; The next setPotAmps() writes the Pot.
+  }
+
+  if (chipAddr != 0) {
+    I2cXfer xfer;
+
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.addr  = chipAddr;
+    xfer.txLen = 1;
+    xfer.tx[0] = POT_WIPER_ADDR | POT_RD_CMD;
+    xfer.rxLen = 2;
+    xfer.done  = potVerifyDone;
+    xfer.arg   = (void *)((uintptr_t)(((potWriteSeq & 0xffffff) << 8) | (uint32_t)(potCache)));
+    i2cSubmit(&xfer, I2C_PRIO_LOW);
+  }
+  else if (csPin != 0) {
+    if (digitalPotRead(POT_WIPER_ADDR) != potCache) {
+      potCache = -1;
+      potVerifyCnt++;
+    }
+  }
+}
+
+#endif // ifdef POT_VERIFY_TIME
+
+// *********************************************************************************************
+// Queue a write to the MCP45HV51 I2C Digital Pot. Does not wait for the bus.
+// On exit, returns false if the I2C Engine queue is full.
+static bool digitalPotWriteQueued(byte dataValue, byte memAddr)
+{
+  I2cXfer xfer;
+
+  memset(&xfer, 0, sizeof(xfer));
+  xfer.addr  = chipAddr;
+  xfer.txLen = 2;
+  xfer.tx[0] = memAddr | POT_WR_CMD;
+  xfer.tx[1] = dataValue;
+  xfer.done  = potWriteDone;
+
+  if (!i2cSubmit(&xfer, I2C_PRIO_HIGH)) {
+    potErrCnt++;
+    return false;
+  }
+
+  return true;
+}
+
+// *********************************************************************************************
+// Create the setPotAmps() mutex. Called from setup() (Pot initialization), before the Control Task starts.
+static void initPotMutex(void)
+{
+  if (potMutex == NULL) {
+    potMutex = xSemaphoreCreateMutex();
+  }
+}
 
 // *********************************************************************************************
 static bool initDigitalPotShared(void)
@@ -70,15 +218,12 @@ static bool initDigitalPotShared(void)
 bool initDigitalPotSPI(uint8_t csPinPot)
 {
   csPin    = csPinPot;
-  chipAddr = 0; 
+  chipAddr = 0;
+  potCache = -1;
+  initPotMutex();
 
-  pinMode(csPin, OUTPUT);
-  digitalWrite(csPin, HIGH);
-
-  if (spiInitComplete == false) { // Check to see SPI port has already been configured.
-    spiInitComplete = true;
-    SPI.begin();
-  }
+  halSpiBegin(csPin, spiInitComplete == false); // Start the SPI port unless it has already been configured.
+  spiInitComplete = true;
 
   return initDigitalPotShared();
 }
@@ -90,15 +235,15 @@ bool initDigitalPotI2C(byte chipAddrPot)
   bool success = false;
 
   chipAddr = chipAddrPot;
+  potCache = -1;
+  initPotMutex();
 
   if (i2cInitComplete == false) { // Check to see if INA219 has already configured I2C port.
     i2cInitComplete = true;
-    Wire.begin();
+    initI2cBus();
   }
 
-  Wire.beginTransmission(chipAddr);
-
-  if (Wire.endTransmission()) { // Communication Error!
+  if (!i2cProbe(chipAddr)) { // Communication Error!
     success = false;
     Serial.println("Digital POT Failure, Missing at Address 0x" + String(chipAddr, HEX) + ".");
   }
@@ -126,22 +271,126 @@ bool initDigitalPot(byte chipAddrPot, int spi_cs)
 
 // *********************************************************************************************
 // Set the Pot wiper ohms for requested Welding Amps.
+// The Pot is only written if the Wiper value has changed (or a previous write failed).
 // ampVal = Desired Welding Amps.
 // verbose = VERBOSE_ON (true) for expanded log messages, else VERBOSE_OFF (false) for less messages.
-void setPotAmps(byte ampVal, bool verbose)
+// On exit, returns true if a Wiper write was started.
+bool setPotAmps(byte ampVal, bool verbose)
 {
-  byte potVal;
-  uint16_t ohms;
+  static uint32_t reportedErrCnt    = 0; // Queued write errors that have been logged.
+  static uint32_t reportedVerifyCnt = 0; // Readback mismatches that have been logged.
+  bool     written   = false;
+  uint32_t errCnt    = 0;     // New failures to report, counted under the mutex.
+  uint32_t verifyCnt = 0;
+  byte     potVal;
+  int      held = potOverride;
 
   ampVal = constrain(ampVal, MIN_AMPS, MAX_SET_AMPS);
-  ohms   = map(ampVal, MIN_AMPS, MAX_AMPS, POT_MIN_OHMS, POT_MAX_OHMS); // Calculate Ohms.
-  potVal = map(ampVal, MIN_AMPS, MAX_AMPS, 0x00, 0xff);                 // Calculate Dig Pot Wiper Value.
-  digitalPotWrite(potVal, POT_WIPER_ADDR);
+  potVal = wiperTable[ampVal - MIN_AMPS]; // Dig Pot Wiper Value.
+
+  if (held >= 0) {                        // Characterization sweep, ampVal is ignored.
+    potVal = wiperTable[constrain(outputLimitAmps(), MIN_AMPS, MAX_SET_AMPS) - MIN_AMPS];
+    potVal = held < potVal ? (byte)(held) : potVal;
+  }
+
+  if (potMutex != NULL) {
+    xSemaphoreTake(potMutex, portMAX_DELAY);
+  }
+
+  if (potVal != potCache) {
+    potCache = potVal;
+    written  = true;
+    potWriteSeq++;
+
+    if (chipAddr != 0) {                             // I2C Pot, queue the write.
+      if (!digitalPotWriteQueued(potVal, POT_WIPER_ADDR)) {
+        potCache = -1;
+        written  = false;
+      }
+    }
+    else if (!digitalPotWrite(potVal, POT_WIPER_ADDR)) {
+      potCache = -1;
+      written  = false;
+      evlogEvent(EVT_POT_IO, 1, potVal); // Repeats are held by the Event Log.
+    }
+    else {
+      potWriteUs = halMicros();
+    }
+  }
+
+#ifdef POT_VERIFY_TIME
+  static unsigned long verifyMillis = 0;
+
+  if (halMillis() - verifyMillis >= POT_VERIFY_TIME) {
+    verifyMillis = halMillis();
+    verifyPotWiper();
+  }
+#endif // ifdef POT_VERIFY_TIME
+
+  if (potErrCnt != reportedErrCnt) {                 // Failures from earlier queued writes.
+    reportedErrCnt = potErrCnt;
+    errCnt         = potErrCnt;
+  }
+
+  if (potVerifyCnt != reportedVerifyCnt) {
+    reportedVerifyCnt = potVerifyCnt;
+    verifyCnt         = potVerifyCnt;
+  }
+
+  if (potMutex != NULL) {
+    xSemaphoreGive(potMutex);
+  }
+
+  if (errCnt != 0) {
+    Serial.println("I/O Error While Writing to the MCP4xHV51 Digital Pot. Check Hardware.");
+    evlogEvent(EVT_POT_IO, (int16_t)(min(errCnt, (uint32_t)(INT16_MAX))), potVal);
+  }
+
+  if (verifyCnt != 0) {
+    Serial.println("MCP4xHV51 Digital Pot Readback Mismatch, Wiper Rewritten. Check Hardware.");
+    evlogEvent(EVT_POT_VERIFY, (int16_t)(min(verifyCnt, (uint32_t)(INT16_MAX))), potVal);
+  }
 
   if (verbose == VERBOSE_ON) {
-    Serial.println("Set Welding Current to " + String(ampVal) + " Amps. Digital Pot is now " + String(ohms) + " Ohms, Data: 0x" +
-                   String(potVal, HEX));
+    Serial.print("Set Welding Current to ");
+    Serial.print(ampVal);
+    Serial.print(" Amps. Digital Pot is now ");
+    Serial.print(map(ampVal, MIN_AMPS, MAX_AMPS, POT_MIN_OHMS, POT_MAX_OHMS));
+    Serial.print(" Ohms, Data: 0x");
+    Serial.println(potVal, HEX);
   }
+
+  return written;
+}
+
+// *********************************************************************************************
+// Select the Amps to Wiper table used by setPotAmps(). table = NULL selects the compile-time (linear) table.
+// A table has (MAX_SET_AMPS - MIN_AMPS + 1) entries, indexed by (Amps - MIN_AMPS), and must stay valid while in use.
+void setPotTable(const byte *table)
+{
+  wiperTable = table == NULL ? AmpsWiperTable::wiper : table;
+}
+
+// *********************************************************************************************
+// Hold the Wiper at value, regardless of the Amps requested by setPotAmps(). value = -1 ends the hold.
+// The Pot is written by the next setPotAmps() call. The held Wiper never exceeds the Wiper of outputLimitAmps().
+void setPotOverride(int value)
+{
+  potOverride = value < 0 ? -1 : constrain(value, POT_MIN, 0xff);
+}
+
+// *********************************************************************************************
+// On exit, returns the completion time of the last successful Wiper write, in uS (lower 32 bits of esp_timer).
+uint32_t getPotWriteUs(void)
+{
+  return potWriteUs;
+}
+
+// *********************************************************************************************
+// On exit, returns the Wiper value last written to the Pot, or -1 if unknown (write failed or not yet written).
+int getPotWiper(void)
+{
+  return potCache;
 }
 
 // *********************************************************************************************
@@ -151,19 +400,16 @@ bool digitalPotWrite(byte dataValue, byte memAddr)
   bool success = false;
 
   if (chipAddr != 0) {                // Found I2C Digital Pot.
-    Wire.beginTransmission(chipAddr); // I2C Addr
-    Wire.write(memAddr | POT_WR_CMD); // Write Command
-    Wire.write(dataValue);            // Set Pot to Minimum Welding Current.
-    success = Wire.endTransmission() == I2C_ERROR_OK; // Result is true or false bool value.
+    byte cmd[2] = { (byte)(memAddr | POT_WR_CMD), dataValue }; // Write Command, Data.
+    success = i2cTransfer(chipAddr, cmd, 2, NULL, 0, I2C_PRIO_HIGH);
   }
   else if (csPin != 0) {              // Found SPI Digital Pot.
-    digitalWrite(csPin, LOW);
-    byte resp1 = SPI.transfer(memAddr | POT_WR_CMD);
-    SPI.write(dataValue);
-    digitalWrite(csPin, HIGH);
+    byte cmd[2]  = { (byte)(memAddr | POT_WR_CMD), dataValue }; // Write Command, Data.
+    byte resp[2] = { 0, 0 };
+    halSpiXfer(csPin, POT_SPI_HZ, cmd, resp, 2);
 
-    // Bit 1 of resp1 byte must be 1. If 0, either the MCP4xHVx1 signal has issue or not connected.
-    success = ((resp1 & 0x02) == 0x02);  // Result is true or false bool value.
+    // Bit 1 of resp[0] byte must be 1. If 0, either the MCP4xHVx1 signal has issue or not connected.
+    success = ((resp[0] & 0x02) == 0x02);  // Result is true or false bool value.
   }
 
   if (success == false) {
@@ -181,21 +427,19 @@ byte digitalPotRead(byte memAddr)
   bool success = false;
 
   if (chipAddr != 0) {
-    Wire.beginTransmission(chipAddr);                     // Addr
-    Wire.write(memAddr | POT_RD_CMD);                     // Read Command
-    Wire.requestFrom((uint16_t)(chipAddr), (uint8_t)(2)); // Request two bytes from Dig Pot.
-    Wire.read();                                          // Toss out first byte, always zero.
-    dataByte = Wire.read();                               // Get Data.
-    success  = Wire.endTransmission() == I2C_ERROR_OK;    // Result is true or false bool value.
+    byte cmd     = memAddr | POT_RD_CMD;                      // Read Command
+    byte resp[2] = { 0, 0 };
+    success  = i2cTransfer(chipAddr, &cmd, 1, resp, 2, I2C_PRIO_HIGH); // Two bytes, repeated start.
+    dataByte = resp[1];                                       // First byte is always zero.
   }
   else if (csPin != 0) {
-    digitalWrite(csPin, LOW);
-    byte resp1 = SPI.transfer(memAddr | POT_RD_CMD);
-    dataByte = SPI.transfer(0);
-    digitalWrite(csPin, HIGH);
+    byte cmd[2]  = { (byte)(memAddr | POT_RD_CMD), 0 };
+    byte resp[2] = { 0, 0 };
+    halSpiXfer(csPin, POT_SPI_HZ, cmd, resp, 2);
+    dataByte = resp[1];
 
-    success = ((resp1 & 0x02) == 0x02);                 // Result is true or false bool value.
-    // Bit 1 of resp1 byte must be 1. If 0, either the MCP4xHVx1 signal has issue or not connected.
+    success = ((resp[0] & 0x02) == 0x02);                 // Result is true or false bool value.
+    // Bit 1 of resp[0] byte must be 1. If 0, either the MCP4xHVx1 signal has issue or not connected.
   }
 
   if (success == false) {
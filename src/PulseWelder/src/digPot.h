@@ -28,5 +28,6 @@
 #define POT_MAX_CUR 200
 #define POT_MIN_OHMS 0    // Digital Pot ohms at Minimum current.
 #define POT_MAX_OHMS 5000 // Digital Pot ohms at Maximum current.
+#define POT_SPI_HZ 1000000 // SPI Clock for MCP41HV51 (10MHz max).
 
 // EOF
\ No newline at end of file
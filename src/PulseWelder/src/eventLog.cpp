@@ -0,0 +1,496 @@
+/*
+   File: eventLog.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Fault and alarm Event Log. Boots, hardware failures, OC alerts, thermal warnings, INA219 wiring errors, Digital
+      Pot I/O errors and Bluetooth disconnects are saved in the "evlog" flash partition (partitions_16MB.csv) as
+      EVLOG_REC_SIZE byte records (EventRec), so they survive power-off.
+   2. The partition is an append-only ring of 4KB flash sectors. When the ring wraps, the oldest sector is erased
+      ahead of the writes; Every sector is erased the same number of times (wear leveling). At boot the newest sector
+      is found from the first record of each sector, then the write position from the first erased slot.
+   3. evlogEvent() may be called from any task (not from an ISR); It only adds the event to a RAM queue. loop() writes
+      the queue to flash in batches (processEventLog()). Flash writes stall both CPU cores, so the flash is never
+      touched while the arc is burning; Events that do not fit the queue during a weld are counted, and the queue is
+      written after the arc goes out. Repeats of an event code within EVLOG_HOLD_TIME are not logged, except Boot and
+      Log Overflow (each overflow count is logged; If the queue is full it is carried to the next one).
+   4. A sector erase takes tens of mS. The next sector is erased while the arc is off (eraseAhead()), so the flush
+      after a weld usually only writes.
+   5. Records are read through a memory mapped view of the partition (evlogBegin(), evlogNext()).
+   6. Serial Log commands:
+        log             List the newest EVLOG_LIST_LINES events.
+        log all         Send all events, oldest first.
+        log sum         Event counts and the last time of each event.
+        log clear       Erase the Event Log.
+ */
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include <esp_system.h>
+#include "PulseWelder.h"
+#include "arcState.h"
+#include "config.h"
+
+#define EVLOG_SECTOR 4096                                 // Flash sector (erase unit) size, in bytes.
+#define EVLOG_PER_SECTOR (EVLOG_SECTOR / EVLOG_REC_SIZE)  // Records per flash sector.
+#define EVLOG_EMPTY 0xFFFFFFFF                            // Sequence number of an erased record.
+
+static_assert(sizeof(EventRec) == EVLOG_REC_SIZE, "EVLOG_REC_SIZE does not match EventRec.");
+static_assert(EVT_CODES <= 32, "Event codes do not fit the repeat hold mask.");
+
+// Local Scope Vars
+static const esp_partition_t  *evPart  = NULL;     // Event Log partition, NULL if missing.
+static const EventRec         *evMap   = NULL;     // Memory mapped partition (read only).
+static spi_flash_mmap_handle_t evMapHandle;        // Partition map handle.
+static uint32_t                evSlots = 0;        // Record slots in the partition.
+static uint32_t                evHead  = 0;        // Next slot to write.
+static uint32_t                evSeq   = 0;        // Next record sequence number.
+static uint16_t                evBoot  = 0;        // Boot number of this boot.
+static EventRec                evQueue[EVLOG_QUEUE]; // Events waiting to be written to flash.
+static uint32_t                qFirst  = 0;        // Oldest queued event.
+static uint32_t                qCnt    = 0;        // Number of queued events.
+static uint32_t                dropCnt = 0;        // Events lost to a full queue.
+static bool                    evAhead = false;    // The sector at the next sector start (from evHead) is erased.
+static uint32_t                heldMask = 0;       // Event codes with a repeat hold time running (bit per code).
+static uint32_t                heldMs[EVT_CODES];  // Time of the last logged event of each code, in mS.
+static portMUX_TYPE            evMux   = portMUX_INITIALIZER_UNLOCKED; // Protects the queue and hold times.
+static EvlogIter               dumpIt;             // "log all" position.
+static bool                    dumping = false;    // "log all" is being sent by processEventLog().
+
+// *********************************************************************************************
+// On exit, returns the checksum of the event record (all bytes except the checksum).
+static uint8_t recCheck(const EventRec& rec)
+{
+  const uint8_t *data = (const uint8_t *)(&rec);
+  uint8_t sum = 0x5a;
+
+  for (size_t i = 0; i < sizeof(EventRec); i++) {
+    if (i != offsetof(EventRec, check)) {
+      sum = (sum << 1 | sum >> 7) ^ data[i];
+    }
+  }
+
+  return sum;
+}
+
+// *********************************************************************************************
+// On exit, returns true if the record holds an event (not erased, not torn).
+static bool recValid(const EventRec& rec)
+{
+  return (rec.seq != EVLOG_EMPTY) && (rec.code < EVT_CODES) && (rec.check == recCheck(rec));
+}
+
+// *********************************************************************************************
+// On exit, returns the name of an event code.
+static const char *eventName(byte code)
+{
+  static const char *const names[EVT_CODES] = {
+    "None", "Boot", "Hardware Error", "OC Alert", "OC Alert End", "Heat Warning", "Heat Limit", "INA219 Wiring Error",
+    "Pot I/O Error", "Pot Readback Mismatch", "Bluetooth Lost", "Log Overflow"
+  };
+
+  return code < EVT_CODES ? names[code] : "Unknown";
+}
+
+// *********************************************************************************************
+// On exit, returns an event record as one line of text.
+static String eventText(const EventRec& rec)
+{
+  String text = " #" + String(rec.seq) + " Boot " + String(rec.boot) + ", " + String(rec.timeMs / 1000.0f, 1) + "S: " +
+                eventName(rec.code);
+
+  switch (rec.code) {
+    case EVT_BOOT:
+      text += ", Reset Reason " + String(rec.p1);
+      break;
+
+    case EVT_HW_ERROR:
+      text += String((rec.p1 & ERROR_INA219) ? ", INA219" : "") + ((rec.p1 & ERROR_DIGPOT) ? ", Digital Pot" : "");
+      break;
+
+    case EVT_OC_ALERT:
+    case EVT_HEAT_WARN:
+      text += ", Heat " + String(rec.p1) + "%, " + String(rec.p2) + "A";
+      break;
+
+    case EVT_OC_END:
+      text += ", Heat " + String(rec.p1) + "%";
+      break;
+
+    case EVT_HEAT_LIMIT:
+      text += (rec.p1 < MAX_SET_AMPS ? ", " + String(rec.p1) + "A" : String(", Off")) + ", Heat " + String(rec.p2) + "%";
+      break;
+
+    case EVT_INA_WIRING:
+      text += ", " + String(rec.p1 / 10.0f, 1) + "A";
+      break;
+
+    case EVT_POT_IO:
+      text += ", " + String(rec.p1) + " Errors, Wiper 0x" + String(rec.p2 & 0xff, HEX);
+      break;
+
+    case EVT_POT_VERIFY:
+      text += ", " + String(rec.p1) + " Mismatches";
+      break;
+
+    case EVT_LOG_DROP:
+      text += ", " + String(rec.p1) + " Events Lost";
+      break;
+
+    default:
+      break;
+  }
+
+  return text + ".";
+}
+
+// *********************************************************************************************
+// A sector is always written from its first slot. If that record is not valid (erased, torn, or data from before the
+// partition table change) the sector is not used for finding the write position.
+// On exit, returns the sequence number of the first record in a sector, or EVLOG_EMPTY if it is not valid.
+static uint32_t sectorSeq(uint32_t firstSlot)
+{
+  return recValid(evMap[firstSlot]) ? evMap[firstSlot].seq : EVLOG_EMPTY;
+}
+
+// *********************************************************************************************
+// On exit, returns the first slot of the sector the writes enter next (evHead, if it is at a sector start).
+static uint32_t nextSector(void)
+{
+  return ((evHead + EVLOG_PER_SECTOR - 1) / EVLOG_PER_SECTOR * EVLOG_PER_SECTOR) % evSlots;
+}
+
+// *********************************************************************************************
+// On exit, returns true if every byte of a sector is erased.
+static bool sectorErased(uint32_t firstSlot)
+{
+  const uint32_t *word = (const uint32_t *)(&evMap[firstSlot]);
+
+  for (uint32_t i = 0; i < EVLOG_SECTOR / sizeof(uint32_t); i++) {
+    if (word[i] != EVLOG_EMPTY) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// *********************************************************************************************
+// Erase the next sector ahead of the writes, if needed. Not while the arc is burning (stalls both cores).
+static void eraseAhead(void)
+{
+  uint32_t slot;
+
+  if ((evPart == NULL) || evAhead) {
+    return;
+  }
+  slot    = nextSector();
+  evAhead = sectorErased(slot) || (esp_partition_erase_range(evPart, slot * EVLOG_REC_SIZE, EVLOG_SECTOR) == ESP_OK);
+
+  if (!evAhead) {
+    Serial.println("Event Log: Flash erase failed.");
+  }
+}
+
+// *********************************************************************************************
+// Write the queued events to flash. The sector at the write position is erased first if it holds old records.
+// Not while the arc is burning (stalls both cores).
+static void flushEvents(void)
+{
+  EventRec batch[EVLOG_QUEUE];
+  uint32_t cnt;
+  uint32_t dropped;
+  uint32_t run;
+
+  portENTER_CRITICAL(&evMux);
+  cnt = qCnt;
+
+  for (uint32_t i = 0; i < cnt; i++) {
+    batch[i] = evQueue[(qFirst + i) % EVLOG_QUEUE];
+  }
+  qFirst  = (qFirst + cnt) % EVLOG_QUEUE;
+  qCnt    = 0;
+  dropped = dropCnt;
+  dropCnt = 0;
+  portEXIT_CRITICAL(&evMux);
+
+  if (dropped != 0) {
+    evlogEvent(EVT_LOG_DROP, (int16_t)(min(dropped, (uint32_t)(INT16_MAX))), 0); // Written by the next flush.
+  }
+
+  if (evPart == NULL) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < cnt; i += run) {
+    if (evHead % EVLOG_PER_SECTOR == 0) {
+      eraseAhead();
+
+      if (!evAhead) {
+        Serial.println("Event Log: " + String(cnt - i) + " events lost.");
+        return;
+      }
+      evAhead = false; // The next sector is erased after the arc is off.
+    }
+
+    run = min(cnt - i, EVLOG_PER_SECTOR - evHead % EVLOG_PER_SECTOR); // Records that fit the sector.
+
+    for (uint32_t j = i; j < i + run; j++) {
+      batch[j].seq   = evSeq++;
+      batch[j].boot  = evBoot;
+      batch[j].check = recCheck(batch[j]);
+    }
+
+    if (esp_partition_write(evPart, evHead * EVLOG_REC_SIZE, &batch[i], run * EVLOG_REC_SIZE) != ESP_OK) {
+      Serial.println("Event Log: Flash write failed, " + String(cnt - i) + " events lost.");
+      return;
+    }
+    evHead = (evHead + run) % evSlots;
+  }
+}
+
+// *********************************************************************************************
+// Find the Event Log partition and the write position. Call once from setup(), before the first evlogEvent().
+void initEventLog(void)
+{
+  const void *ptr;
+  uint32_t    seq;
+  uint32_t    newestSeq  = EVLOG_EMPTY;
+  uint32_t    newestSlot = 0;
+  uint32_t    slot;
+
+  evPart = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, EVLOG_PART_NAME);
+
+  if ((evPart == NULL) ||
+      (esp_partition_mmap(evPart, 0, evPart->size, SPI_FLASH_MMAP_DATA, &ptr, &evMapHandle) != ESP_OK)) {
+    evPart = NULL;
+    Serial.println("Event Log: No \"" EVLOG_PART_NAME "\" flash partition (partitions_16MB.csv), events are not saved.");
+    evlogEvent(EVT_BOOT, (int16_t)(esp_reset_reason()), 0);
+    return;
+  }
+  evMap   = (const EventRec *)(ptr);
+  evSlots = (evPart->size / EVLOG_SECTOR) * EVLOG_PER_SECTOR;
+
+  for (slot = 0; slot < evSlots; slot += EVLOG_PER_SECTOR) { // Newest sector.
+    seq = sectorSeq(slot);
+
+    if ((seq != EVLOG_EMPTY) && ((newestSeq == EVLOG_EMPTY) || (seq > newestSeq))) {
+      newestSeq  = seq;
+      newestSlot = slot;
+    }
+  }
+
+  if (newestSeq == EVLOG_EMPTY) { // Empty (or never used) partition.
+    evHead = 0;
+    evSeq  = 0;
+    evBoot = 0;
+  }
+  else {
+    for (slot = newestSlot; (slot < newestSlot + EVLOG_PER_SECTOR) && (evMap[slot].seq != EVLOG_EMPTY); slot++) {
+      if (recValid(evMap[slot])) {
+        evSeq  = evMap[slot].seq + 1;
+        evBoot = evMap[slot].boot + 1;
+      }
+    }
+    evHead = slot % evSlots; // A full sector continues at the start of the next one.
+  }
+
+  Serial.println("Event Log: " + String(evPart->size / 1024) + "KB, Boot " + String(evBoot) + ", " + String(evSeq) +
+                 " events recorded.");
+  evlogEvent(EVT_BOOT, (int16_t)(esp_reset_reason()), 0);
+}
+
+// *********************************************************************************************
+// Log an event. It is written to flash later by processEventLog(). Callable from any task, but not from an ISR.
+void evlogEvent(byte code, int16_t p1, int16_t p2)
+{
+  uint32_t  now = millis();
+  EventRec *rec;
+
+  if (code >= EVT_CODES) {
+    return;
+  }
+
+  portENTER_CRITICAL(&evMux);
+
+  if ((heldMask & (1UL << code)) && (now - heldMs[code] < EVLOG_HOLD_TIME) && (code != EVT_BOOT) &&
+      (code != EVT_LOG_DROP)) {
+    portEXIT_CRITICAL(&evMux);
+    return; // Repeat.
+  }
+  heldMask    |= 1UL << code;
+  heldMs[code] = now;
+
+  if (qCnt < EVLOG_QUEUE) {
+    rec         = &evQueue[(qFirst + qCnt) % EVLOG_QUEUE];
+    rec->timeMs = now;
+    rec->code   = code;
+    rec->p1     = p1;
+    rec->p2     = p2;
+    qCnt++;
+  }
+  else {
+    dropCnt += code == EVT_LOG_DROP ? (uint32_t)(p1) : 1; // Keep the lost count for the next Log Overflow event.
+  }
+  portEXIT_CRITICAL(&evMux);
+}
+
+// *********************************************************************************************
+// Start reading the Event Log. Events still in the RAM queue are not included.
+// On exit, returns false if there is no Event Log partition.
+bool evlogBegin(EvlogIter *it, bool newestFirst)
+{
+  it->slot        = evHead;
+  it->left        = evSlots;
+  it->newestFirst = newestFirst;
+
+  return evMap != NULL;
+}
+
+// *********************************************************************************************
+// Read the next event.
+// On exit, returns false if there are no more events.
+bool evlogNext(EvlogIter *it, EventRec *rec)
+{
+  const EventRec *slotRec;
+
+  while (it->left > 0) {
+    it->left--;
+
+    if (it->newestFirst) {
+      it->slot = (it->slot + evSlots - 1) % evSlots;
+      slotRec  = &evMap[it->slot];
+    }
+    else {
+      slotRec  = &evMap[it->slot];
+      it->slot = (it->slot + 1) % evSlots;
+    }
+
+    if (recValid(*slotRec)) {
+      *rec = *slotRec;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// *********************************************************************************************
+// Write the queued events to flash and send the "log all" lines. Called from loop().
+void processEventLog(void)
+{
+  uint32_t cnt;
+  uint32_t firstMs;
+  EventRec rec;
+  int      lines = 0;
+
+  portENTER_CRITICAL(&evMux);
+  cnt     = qCnt;
+  firstMs = evQueue[qFirst].timeMs;
+  portEXIT_CRITICAL(&evMux);
+
+  if (!arcBurning(getArcState())) { // Flash writes stall both cores. Events wait in the queue until the arc is out.
+    if ((cnt != 0) && ((cnt >= EVLOG_QUEUE / 2) || (millis() - firstMs >= EVLOG_FLUSH_TIME))) {
+      flushEvents();
+    }
+    eraseAhead(); // Ready for the flush after the next weld.
+  }
+
+  while (dumping && (lines < EVLOG_DUMP_LINES) && (Serial.availableForWrite() >= 96)) {
+    if (evlogNext(&dumpIt, &rec)) {
+      Serial.println(eventText(rec));
+      lines++;
+    }
+    else {
+      dumping = false;
+      Serial.println("Event Log: End.");
+    }
+  }
+}
+
+// *********************************************************************************************
+// Event Log serial commands: log, log all, log sum, log clear.
+// On exit, returns false if cmd is not an Event Log command.
+bool eventLogCmd(const String& cmd)
+{
+  EvlogIter it;
+  EventRec  rec;
+  EventRec  last[EVT_CODES];
+  uint32_t  counts[EVT_CODES];
+  uint32_t  total = 0;
+  int       lines = 0;
+
+  if (!cmd.startsWith("log")) {
+    return false;
+  }
+
+  if (!evlogBegin(&it, true)) {
+    Serial.println("Event Log: No \"" EVLOG_PART_NAME "\" flash partition.");
+    return true;
+  }
+
+  if (!arcBurning(getArcState())) {
+    flushEvents(); // Include the queued events.
+    evlogBegin(&it, true);
+  }
+
+  if (cmd == "log") {
+    while ((lines < EVLOG_LIST_LINES) && evlogNext(&it, &rec)) {
+      Serial.println(eventText(rec));
+      lines++;
+    }
+    Serial.println("Event Log: " + String(lines) + " newest events, Boot " + String(evBoot) + ".");
+  }
+  else if (cmd == "log all") {
+    evlogBegin(&dumpIt, false);
+    dumping = true;
+  }
+  else if (cmd == "log sum") {
+    memset(counts, 0, sizeof(counts));
+
+    while (evlogNext(&it, &rec)) {
+      if (counts[rec.code]++ == 0) {
+        last[rec.code] = rec; // Newest first.
+      }
+      total++;
+    }
+
+    for (int code = 0; code < EVT_CODES; code++) {
+      if (counts[code] != 0) {
+        Serial.println(" " + String(counts[code]) + "x" + eventText(last[code]));
+      }
+    }
+    Serial.println("Event Log: " + String(total) + " of " + String(evSlots) + " records used, Boot " + String(evBoot) +
+                   ".");
+  }
+  else if (cmd == "log clear") {
+    if (arcBurning(getArcState())) {
+      Serial.println("# error: not while welding");
+    }
+    else if (esp_partition_erase_range(evPart, 0, evPart->size) == ESP_OK) {
+      dumping = false;
+      evHead  = 0;
+      evAhead = true;
+      Serial.println("Event Log: Cleared.");
+    }
+    else {
+      Serial.println("Event Log: Flash erase failed.");
+    }
+  }
+  else {
+    Serial.println("Event Log Commands: log, log all, log sum, log clear.");
+  }
+
+  return true;
+}
+
+// EOF
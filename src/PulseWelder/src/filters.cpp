@@ -0,0 +1,168 @@
+/*
+   File: filters.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+ */
+
+#include "filters.h"
+
+// *********************************************************************************************
+MedianFilter::MedianFilter(void)
+{
+  begin(1);
+}
+
+// *********************************************************************************************
+// Set the window size (1, 3, 5, or 7 samples; Other values are rounded down to an odd size) and clear it.
+void MedianFilter::begin(int n)
+{
+  n    = n > FILTER_MEDIAN_MAX ? FILTER_MEDIAN_MAX : n;
+  n    = n < 1 ? 1 : n;
+  size = n | 1;
+  size = size > n ? size - 2 : size;
+  reset(0);
+}
+
+// *********************************************************************************************
+// Fill the window with value.
+void MedianFilter::reset(int32_t value)
+{
+  for (int i = 0; i < FILTER_MEDIAN_MAX; i++) {
+    window[i] = value;
+  }
+  pos = 0;
+}
+
+// *********************************************************************************************
+// Add a sample. The window is copied and insertion sorted; Seven samples or less, so this is faster than a heap.
+// On exit, returns the median of the last n samples.
+int32_t MedianFilter::update(int32_t x)
+{
+  int32_t sorted[FILTER_MEDIAN_MAX];
+  int32_t val;
+  int     i;
+  int     j;
+
+  if (size == 1) {
+    return x;
+  }
+
+  window[pos] = x;
+  pos         = pos + 1 >= size ? 0 : pos + 1;
+
+  for (i = 0; i < size; i++) {
+    val = window[i];
+
+    for (j = i; (j > 0) && (sorted[j - 1] > val); j--) {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = val;
+  }
+
+  return sorted[size / 2];
+}
+
+// *********************************************************************************************
+EmaFilter::EmaFilter(void)
+{
+  begin(0);
+}
+
+// *********************************************************************************************
+// Set the time constant (2^shift samples) and clear the filter.
+void EmaFilter::begin(int newShift)
+{
+  shift = newShift < 0 ? 0 : newShift;
+  reset(0);
+}
+
+// *********************************************************************************************
+// Preload the filter with value, so the output does not ramp up from zero.
+void EmaFilter::reset(int32_t value)
+{
+  state = value << FILTER_FRAC_BITS;
+}
+
+// *********************************************************************************************
+// Change the time constant (2^shift samples). The filtered value is kept.
+void EmaFilter::setShift(int newShift)
+{
+  shift = newShift < 0 ? 0 : newShift;
+}
+
+// *********************************************************************************************
+// Add a sample. One subtract, two shifts, and one add.
+// On exit, returns the filtered value.
+int32_t EmaFilter::update(int32_t x)
+{
+  state += ((x << FILTER_FRAC_BITS) - state) >> shift;
+
+  return value();
+}
+
+// *********************************************************************************************
+// On exit, returns the filtered value, rounded to the nearest whole unit.
+int32_t EmaFilter::value(void) const
+{
+  return (state + (1 << (FILTER_FRAC_BITS - 1))) >> FILTER_FRAC_BITS;
+}
+
+// *********************************************************************************************
+// Load the filter settings and clear the filters.
+void DualRateFilter::begin(const DualRateCfg& cfg)
+{
+  median.begin(cfg.medianN);
+  fastEma.begin(cfg.fastShift);
+  slowEma.begin(cfg.slowShift);
+}
+
+// *********************************************************************************************
+// Preload all stages with value.
+void DualRateFilter::reset(int32_t value)
+{
+  median.reset(value);
+  fastEma.reset(value);
+  slowEma.reset(value);
+}
+
+// *********************************************************************************************
+// Change the EMA time constants, for a new sample rate. The filtered values are kept.
+void DualRateFilter::setShifts(int fastShift, int slowShift)
+{
+  fastEma.setShift(fastShift);
+  slowEma.setShift(slowShift);
+}
+
+// *********************************************************************************************
+// Add a sample. The spike rejected sample feeds both EMA stages.
+void DualRateFilter::update(int32_t x)
+{
+  int32_t med = median.update(x);
+
+  fastEma.update(med);
+  slowEma.update(med);
+}
+
+// *********************************************************************************************
+// On exit, returns the low lag (control) value.
+int32_t DualRateFilter::fast(void) const
+{
+  return fastEma.value();
+}
+
+// *********************************************************************************************
+// On exit, returns the steady (display) value.
+int32_t DualRateFilter::slow(void) const
+{
+  return slowEma.value();
+}
+
+// EOF
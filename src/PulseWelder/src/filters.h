@@ -0,0 +1,90 @@
+/*
+   File: filters.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Fixed-point measurement filters. Inputs and outputs are integers in the caller's units (mA, mV). No floats and
+      no divides are used per sample.
+   2. MedianFilter: Median of the last N samples (N = 1, 3, 5, 7). Rejects single sample spikes; N = 1 is a pass-through.
+   3. EmaFilter: Exponential moving average, y += (x - y) / 2^shift. The time constant is about 2^shift samples;
+      shift = 0 is a pass-through. The state has FILTER_FRAC_BITS of fraction so small steps are not lost.
+   4. DualRateFilter: One median stage feeding a fast EMA (low lag, for the control features) and a slow EMA (steady
+      numbers, for the display).
+   5. This file and filters.cpp do not use the Arduino libraries. They can be compiled on a PC, see weldSim.cpp.
+ */
+#ifndef __FILTERS_H__
+#define __FILTERS_H__
+
+#include <stdint.h>
+
+#define FILTER_MEDIAN_MAX 7 // Largest median window.
+#define FILTER_FRAC_BITS 8  // EMA state fraction bits. Inputs must be less than 2^(31 - 8 - shift).
+
+class MedianFilter {
+public:
+
+  MedianFilter(void);
+  void    begin(int n);
+  void    reset(int32_t value);
+  int32_t update(int32_t x);
+
+private:
+
+  int32_t window[FILTER_MEDIAN_MAX]; // Last n samples, oldest is replaced.
+  int     size;                      // Window size (n).
+  int     pos;                       // Next window position to replace.
+};
+
+class EmaFilter {
+public:
+
+  EmaFilter(void);
+  void    begin(int shift);
+  void    reset(int32_t value);
+  void    setShift(int newShift);
+  int32_t update(int32_t x);
+  int32_t value(void) const;
+
+private:
+
+  int32_t state; // Filtered value, with FILTER_FRAC_BITS of fraction.
+  int     shift; // Time constant, 2^shift samples.
+};
+
+// Dual Rate Filter settings.
+struct DualRateCfg {
+  int medianN;   // Median window, 1 (off), 3, 5, or 7 samples.
+  int fastShift; // Fast (control) EMA time constant, 2^fastShift samples. 0 is no filtering.
+  int slowShift; // Slow (display) EMA time constant, 2^slowShift samples.
+};
+
+class DualRateFilter {
+public:
+
+  void    begin(const DualRateCfg& cfg);
+  void    reset(int32_t value);
+  void    setShifts(int fastShift,
+                    int slowShift);
+  void    update(int32_t x);
+  int32_t fast(void) const;
+  int32_t slow(void) const;
+
+private:
+
+  MedianFilter median;  // Spike rejection.
+  EmaFilter    fastEma; // Control output.
+  EmaFilter    slowEma; // Display output.
+};
+
+#endif // ifndef __FILTERS_H__
+
+// EOF
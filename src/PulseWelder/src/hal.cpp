@@ -0,0 +1,242 @@
+/*
+   File: hal.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. ESP32 implementation of the controller core Hardware Abstraction Layer, see hal.h. The PC build (HAL_SIM) uses
+      halSim.cpp instead.
+   2. Welding Volts: ADC1_CHANNEL_0 (Pin 36), 11dB attenuation. The eFuse calibration curve is used by halVdcMv().
+      With VDC_DMA_ON the ADC is streamed through the I2S peripheral; halVdcRead() drains the DMA buffers.
+ */
+
+#ifndef HAL_SIM
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <driver/adc.h>
+#include <driver/i2s.h>
+#include <esp_adc_cal.h>
+#include "hal.h"
+#include "PulseWelder.h"
+#include "config.h"
+
+#define VDC_ADC_PORT ADC1_CHANNEL_0
+#define DEFAULT_VREF 1100
+#define VDC_I2S_PORT I2S_NUM_0 // I2S port for DMA sampling. Only I2S0 supports the built-in ADC.
+
+// Local Scope Vars
+static esp_adc_cal_characteristics_t *adc_chars;
+static esp_timer_handle_t pulseTimer = NULL; // Pulse edge one-shot timer.
+static void (*pulseTimerFn)(void)    = NULL; // Pulse edge timer callback.
+
+// *********************************************************************************************
+// On exit, returns the CPU cycle counter.
+uint32_t halCycles(void)
+{
+  return ESP.getCycleCount();
+}
+
+// *********************************************************************************************
+// On exit, returns the time since boot, in uS (lower 32 bits of esp_timer).
+uint32_t halMicros(void)
+{
+  return (uint32_t)(esp_timer_get_time());
+}
+
+// *********************************************************************************************
+// On exit, returns the time since boot, in mS.
+uint32_t halMillis(void)
+{
+  return millis();
+}
+
+// *********************************************************************************************
+// On exit, returns true if the Welder's OC Led is on (over-heat or over-current).
+bool halOcAlert(void)
+{
+  return !digitalRead(OC_PIN);
+}
+
+// *********************************************************************************************
+// esp_timer callback for the Pulse edge timer.
+static void onPulseTimer(void *arg)
+{
+  pulseTimerFn();
+}
+
+// *********************************************************************************************
+// Create the Pulse edge one-shot timer. callback runs in the esp_timer task when the timer expires.
+void halPulseTimerBegin(void (*callback)(void))
+{
+  esp_timer_create_args_t args;
+
+  if (pulseTimer != NULL) {
+    return;
+  }
+
+  memset(&args, 0, sizeof(args));
+  args.callback        = onPulseTimer;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name            = "PulseEdge";
+  pulseTimerFn         = callback;
+
+  if (esp_timer_create(&args, &pulseTimer) != ESP_OK) {
+    pulseTimer = NULL;
+    Serial.println("Pulse Edge Timer Failed, Pulse edges use the Control Task ticks.");
+  }
+}
+
+// *********************************************************************************************
+// Start (or restart) the Pulse edge timer. The callback runs once, delayUs from now.
+void halPulseTimerStart(uint32_t delayUs)
+{
+  if (pulseTimer != NULL) {
+    esp_timer_stop(pulseTimer); // Not running is not an error here.
+    esp_timer_start_once(pulseTimer, delayUs);
+  }
+}
+
+// *********************************************************************************************
+// Drive the optional PWM Shutdown pin (SHDN_PIN). on = true enables the PWM Controller.
+void halPwmEnable(bool on)
+{
+  digitalWrite(SHDN_PIN, on ? PWM_ON : PWM_OFF);
+}
+
+// *********************************************************************************************
+// Setup a SPI device's chip select pin. On entry startBus = true to also start the SPI port.
+void halSpiBegin(uint8_t csPin, bool startBus)
+{
+  pinMode(csPin, OUTPUT);
+  digitalWrite(csPin, HIGH);
+
+  if (startBus) {
+    SPI.begin();
+  }
+}
+
+// *********************************************************************************************
+// Full duplex SPI transfer of len bytes (SPI Mode 0, MSB first) at hz. rx may be NULL.
+void halSpiXfer(uint8_t csPin, uint32_t hz, const uint8_t *tx, uint8_t *rx, size_t len)
+{
+  uint8_t data;
+
+  SPI.beginTransaction(SPISettings(hz, MSBFIRST, SPI_MODE0)); // Don't collide with TFT & Touch traffic.
+  digitalWrite(csPin, LOW);
+
+  for (size_t i = 0; i < len; i++) {
+    data = SPI.transfer(tx[i]);
+
+    if (rx != NULL) {
+      rx[i] = data;
+    }
+  }
+  digitalWrite(csPin, HIGH);
+  SPI.endTransaction();
+}
+
+// *********************************************************************************************
+// Initialize the Welding Volts ADC and its calibration curve. Starts the I2S DMA stream if VDC_DMA_ON is enabled.
+void halVdcBegin(void)
+{
+  // Configure ADC
+  adc1_config_width(ADC_WIDTH_BIT_12);
+  adc1_config_channel_atten(VDC_ADC_PORT, ADC_ATTEN_DB_11);
+
+  // Characterize ADC
+  adc_chars = (esp_adc_cal_characteristics_t *)calloc(1, sizeof(esp_adc_cal_characteristics_t));
+  esp_adc_cal_value_t val_type = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, DEFAULT_VREF, adc_chars);
+
+  if (val_type == ESP_ADC_CAL_VAL_EFUSE_VREF) {
+    Serial.println("ADC eFuse provided Factory Stored Vref Calibration.");      // Best Accuracy.
+  }
+  else if (val_type == ESP_ADC_CAL_VAL_EFUSE_TP) {
+    Serial.println("ADC eFuse provided Factory Stored Two Point Calibration."); // Good Accuracy.
+  }
+  else {
+    Serial.println("ADC eFuse not supported, using Default VRef (1100mV).");    // Low Quality Accuracy.
+  }
+
+#ifdef VDC_DMA_ON
+  // Stream the ADC through the I2S peripheral. The DMA fills the buffers without CPU involvement.
+  i2s_config_t i2s_config;
+  memset(&i2s_config, 0, sizeof(i2s_config));
+  i2s_config.mode                 = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+  i2s_config.sample_rate          = VDC_DMA_RATE;
+  i2s_config.bits_per_sample      = I2S_BITS_PER_SAMPLE_16BIT;
+  i2s_config.channel_format       = I2S_CHANNEL_FMT_ONLY_LEFT;
+  i2s_config.communication_format = I2S_COMM_FORMAT_I2S_MSB;
+  i2s_config.intr_alloc_flags     = ESP_INTR_FLAG_LEVEL1;
+  i2s_config.dma_buf_count        = VDC_DMA_BUF_CNT;
+  i2s_config.dma_buf_len          = VDC_DMA_BUF_LEN;
+  i2s_config.use_apll             = false;
+
+  if ((i2s_driver_install(VDC_I2S_PORT, &i2s_config, 0, NULL) == ESP_OK) &&
+      (i2s_set_adc_mode(ADC_UNIT_1, VDC_ADC_PORT) == ESP_OK)) {
+    adc1_config_channel_atten(VDC_ADC_PORT, ADC_ATTEN_DB_11); // Must be repeated after I2S ADC mode is set.
+    i2s_adc_enable(VDC_I2S_PORT);
+    Serial.println("ADC Welding Voltage Streaming via I2S DMA at " + String(VDC_DMA_RATE) + "Hz.");
+  }
+  else {
+    Serial.println("ADC I2S DMA Initialization Failed!");
+  }
+#endif // ifdef VDC_DMA_ON
+
+  /*    if (esp_adc_cal_check_efuse(ESP_ADC_CAL_VAL_EFUSE_TP) == ESP_OK) {
+      printf("ADC eFuse Two Point: Supported\n");
+     } else {
+      printf("ADC eFuse Two Point: NOT supported\n");
+     }
+
+     //Check Vref is burned into eFuse
+     if (esp_adc_cal_check_efuse(ESP_ADC_CAL_VAL_EFUSE_VREF) == ESP_OK) {
+       printf("ADC eFuse Vref: Supported\n");
+     } else {
+       printf("ADC eFuse Vref: NOT supported\n");
+     }
+   */
+}
+
+// *********************************************************************************************
+// On exit, returns the ADC pin voltage for a raw 12 bit code (eFuse calibration curve), in mV.
+uint32_t halVdcMv(int raw)
+{
+  return esp_adc_cal_raw_to_voltage(raw, adc_chars);
+}
+
+// *********************************************************************************************
+// On exit, returns a single raw ADC reading (not used with VDC_DMA_ON).
+int halVdcRaw(void)
+{
+  return adc1_get_raw(VDC_ADC_PORT);
+}
+
+// *********************************************************************************************
+// Copy up to count streamed ADC samples (VDC_DMA_ON) to buf. Does not wait. The upper 4 bits of each sample are
+// the ADC channel number.
+// On exit, returns the number of samples copied. Fewer than count means the DMA buffers are empty.
+size_t halVdcRead(uint16_t *buf, size_t count)
+{
+  size_t bytesRead = 0;
+
+#ifdef VDC_DMA_ON
+  if (i2s_read(VDC_I2S_PORT, buf, count * sizeof(uint16_t), &bytesRead, 0) != ESP_OK) {
+    return 0;
+  }
+#endif // ifdef VDC_DMA_ON
+
+  return bytesRead / sizeof(uint16_t);
+}
+
+#endif // ifndef HAL_SIM
+
+// EOF
@@ -0,0 +1,94 @@
+/*
+   File: hal.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Hardware Abstraction Layer for the controller core: The Control Task (control.cpp), measurements (measure.cpp),
+      Digital Pot (digPot.cpp), arc features and Arc On/Off (arcCtrl.cpp), and Pulse modulation (pulseWave.cpp).
+      These files reach the hardware only through these functions and the I2C Engine API (i2cBus.h).
+   2. hal.cpp is the ESP32 implementation. When HAL_SIM is defined (PC build) halSim.cpp implements them, and the
+      I2C Engine API, with simulated devices: INA219 and MCP4xHV51 register models on a virtual bus (sim folder),
+      Welding Volts ADC, and the OC LED. The devices are driven by the welder and arc model in ctrlSim.cpp. The UI, audio, storage, and Bluetooth are not simulated.
+   3. halMicros() is the lower 32 bits of esp_timer, the same time base as the uS times in the data structures.
+   4. The Pulse edge timer is a one-shot timer (esp_timer) for Pulse waveform edges between Control Task ticks. Its
+      callback runs in the esp_timer task, not in an ISR.
+ */
+#ifndef __HAL_H__
+#define __HAL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Welding Volts ADC
+#define VDC_SCALE ((47000.0 + 1800.0) / 1800) // Resistor Attenuator on Welding VDC signal.
+#define VDC_DMA_BUF_CNT 8                     // Number of I2S DMA buffers.
+#define VDC_DMA_BUF_LEN 64                    // Samples per I2S DMA buffer. Short buffers reduce Arc Force latency.
+
+uint32_t halCycles(void);
+uint32_t halMicros(void);
+uint32_t halMillis(void);
+bool     halOcAlert(void);
+void     halPulseTimerBegin(void (*callback)(void));
+void     halPulseTimerStart(uint32_t delayUs);
+void     halPwmEnable(bool on);
+void     halSpiBegin(uint8_t csPin,
+                     bool    startBus);
+void     halSpiXfer(uint8_t        csPin,
+                    uint32_t       hz,
+                    const uint8_t *tx,
+                    uint8_t       *rx,
+                    size_t         len);
+void     halVdcBegin(void);
+uint32_t halVdcMv(int raw);
+int      halVdcRaw(void);
+size_t   halVdcRead(uint16_t *buf,
+                    size_t    count);
+
+#ifdef HAL_SIM
+
+// Simulated welder connections. The plant model (ctrlSim.cpp) sets the inputs and reads the outputs.
+struct HalSimIo {
+  float amps;    // Welding current through the shunt, in Amps. Input.
+  float volts;   // Welding Volts at the output terminals. Input.
+  bool  ocAlert; // Welder's OC LED is on. Input.
+  bool  i2cPot;  // Digital Pot type: true = MCP45HV51 (I2C), false = MCP41HV51 (SPI). Input, before initDigitalPot().
+  int   wiper;   // Digital Pot Wiper register (power-up mid scale). Output.
+  bool  pwmOn;   // PWM Controller enabled (SHDN_PIN). Output.
+  uint32_t wiperUs; // Time of the last Wiper register change, in uS (SIM_STEP_US resolution). Output.
+};
+
+// Simulated device traffic counters.
+struct HalSimStats {
+  uint32_t busXfers;   // Virtual bus transactions (I2C and SPI, all devices).
+  uint32_t busNacks;   // NACKed I2C transactions.
+  uint32_t inaXfers;   // INA219 transactions.
+  uint32_t potXfers;   // Digital Pot transactions (either bus).
+  uint32_t potWrites;  // Wiper register changes.
+  uint32_t inaConvs;   // INA219 conversions completed.
+  uint32_t adcSamples; // Welding Volts samples streamed (VDC_DMA_ON).
+};
+
+class Ina219Model;
+class McpPotModel;
+
+Ina219Model *halSimIna(void);
+HalSimIo    *halSimIo(void);
+McpPotModel *halSimPot(void);
+void         halSimAdvance(uint32_t us);
+double       halSimSeconds(void);
+void         halSimStats(HalSimStats *stats);
+
+#endif // ifdef HAL_SIM
+
+#endif // ifndef __HAL_H__
+
+// EOF
@@ -0,0 +1,488 @@
+/*
+   File: halSim.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. PC implementation of the Hardware Abstraction Layer (hal.h) and the I2C Engine API (i2cBus.h). Only built with
+      HAL_SIM, see ctrlSim.cpp for the build. The welder connections are in HalSimIo (halSimIo()).
+   2. Time is simulated. halSimAdvance() moves the clock in SIM_STEP_US steps; Each step runs the devices: INA219
+      conversions, Welding Volts ADC stream (VDC_DMA_ON), and the I2C bus.
+   3. The INA219 and MCP4xHV51 are register-level models (ina219Model.h, mcpPotModel.h in the sim folder) on the
+      virtual bus (simBus.h). The I2C Engine, halSpiXfer(), and Wire all go through simBus, which counts every
+      transaction and injects NACKs. halSimIna() and halSimPot() give the models for register fault injection.
+   4. The INA219 shunt input is the welding current times SHUNT_OHMS, negative (low side shunt). HalSimIo.i2cPot
+      attaches the Pot at POT_I2C_ADDR (MCP45HV51) or POT_CS (MCP41HV51); The other one is missing, as on a board.
+   5. Welding Volts ADC: Linear, SIM_ADC_FS_MV full scale, with +/- SIM_ADC_NOISE codes of noise. The attenuator is
+      VDC_SCALE. With VDC_DMA_ON samples are streamed at VDC_DMA_RATE into VDC_DMA_BUF_CNT * VDC_DMA_BUF_LEN buffers;
+      The oldest samples are lost if they are not read in time.
+   6. I2C Engine: Two priority queues, one transaction on the bus at a time. The bus time is the bit count at
+      I2C_BUS_HZ plus SIM_I2C_SETUP_US. The result is read at the end of the transaction and the callback runs
+      then, between Control Task ticks (the real engine is a separate task). Missing devices NACK.
+ */
+
+#ifdef HAL_SIM
+
+#include <Arduino.h>
+#include <time.h>
+#include "INA219.h"
+#include "digPot.h"
+#include "hal.h"
+#include "ina219Model.h"
+#include "mcpPotModel.h"
+#include "simBus.h"
+#include "i2cBus.h"
+#include "PulseWelder.h"
+#include "config.h"
+
+#define SIM_STEP_US 50                                      // Device model time step, in uS.
+#define SIM_ADC_FS_MV 3300                                  // Simulated ADC full scale (linear), in mV.
+#define SIM_ADC_NOISE 2                                     // Simulated ADC noise, +/- codes.
+#define SIM_I2C_SETUP_US 20                                 // I2C Engine overhead per transaction, in uS.
+#define SIM_VDC_FIFO (VDC_DMA_BUF_CNT * VDC_DMA_BUF_LEN)    // Streamed samples held by the DMA buffers.
+
+// Simulated I2C Engine queue (one per priority level).
+struct SimI2cQueue {
+  I2cXfer xfer[I2C_QUEUE_LEN];
+  int     head; // Oldest entry.
+  int     cnt;  // Number of entries.
+};
+
+// Blocking transaction context, see i2cTransfer().
+struct SimSyncCtx {
+  uint8_t *rx;      // Caller's read buffer.
+  uint8_t  rxLen;   // Caller's read length.
+  bool     success; // Transaction result.
+  bool     done;    // Transaction has completed.
+};
+
+// Local Scope Vars
+static HalSimIo    io = { 0.0f, 60.0f, false, true, 0x80, false, 0 }; // Welder connections.
+static uint32_t    adcSamples = 0;                                 // Welding Volts samples streamed.
+static uint64_t    simUs      = 0;                                 // Simulated time, in uS.
+static Ina219Model ina;                                            // INA219 Current Sensor.
+static McpPotModel pot;                                            // MCP4xHV51 Digital Pot.
+static int         potBus     = -1;                                // Pot attached: 1 = I2C, 0 = SPI, -1 = not yet.
+static uint32_t    noiseSeed  = 12345;                           // ADC noise generator.
+static uint16_t    vdcFifo[SIM_VDC_FIFO];                        // Streamed ADC samples (VDC_DMA_ON).
+static int         vdcHead    = 0;                               // Oldest streamed sample.
+static int         vdcCnt     = 0;                               // Number of streamed samples.
+static uint64_t    vdcAcc     = 0;                               // Sample clock accumulator, in samples * 1000000.
+static SimI2cQueue i2cQueue[I2C_PRIO_CNT];                       // I2C Engine queues, by priority.
+static I2cXfer     busXfer;                                      // Transaction on the bus.
+static int         busPrio    = -1;                              // Priority of busXfer, -1 if the bus is idle.
+static uint64_t    busStartUs = 0;                               // Start time of busXfer, in uS.
+static uint64_t    busEndUs   = 0;                               // End time of busXfer, in uS.
+static I2cStats    i2cStats[I2C_PRIO_CNT];                       // Latency counters, by priority.
+static uint64_t    waitTotalUs[I2C_PRIO_CNT];                    // Queue wait totalizer, for average.
+static void (*pulseTimerFn)(void) = NULL;                        // Pulse edge timer callback.
+static uint64_t    pulseDueUs = 0;                               // Pulse edge timer expiry, in uS. 0 = stopped.
+static uint64_t    busTotalUs[I2C_PRIO_CNT];                     // Bus time totalizer, for average.
+
+// *********************************************************************************************
+// Attach the devices to the virtual bus. The Pot follows HalSimIo.i2cPot (I2C or SPI part).
+static void attachDevices(void)
+{
+  if (potBus < 0) {
+    simBus.attachI2c(INA219_ADDR, &ina);
+  }
+
+  if (potBus != (io.i2cPot ? 1 : 0)) {
+    simBus.detach(&pot);
+
+    if (io.i2cPot) {
+      simBus.attachI2c(POT_I2C_ADDR, &pot);
+    }
+    else {
+      simBus.attachSpi(POT_CS, &pot);
+    }
+    potBus = io.i2cPot ? 1 : 0;
+  }
+}
+
+// *********************************************************************************************
+// On exit, returns the I2C Engine time of a transaction (bus time plus overhead), in uS.
+static uint32_t busTimeUs(const I2cXfer *xfer)
+{
+  return SimBus::i2cTimeUs(xfer->txLen, xfer->rxLen) + SIM_I2C_SETUP_US;
+}
+
+// *********************************************************************************************
+// Run the I2C Engine: Finish the transaction on the bus (callback), then start the next one, high priority first.
+static void i2cService(void)
+{
+  uint32_t busUs;
+  uint32_t waitUs;
+
+  for (;;) {
+    if (busPrio >= 0) {
+      if (simUs < busEndUs) {
+        return; // Still on the bus.
+      }
+
+      busXfer.success = simBus.i2cXfer(busXfer.addr, busXfer.tx, busXfer.txLen, busXfer.rx, busXfer.rxLen);
+      busUs           = (uint32_t)(busEndUs - busStartUs);
+      waitUs          = (uint32_t)(busStartUs) - busXfer.queuedUs;
+
+      i2cStats[busPrio].count++;
+      i2cStats[busPrio].errors   += busXfer.success ? 0 : 1;
+      i2cStats[busPrio].waitMaxUs = max(i2cStats[busPrio].waitMaxUs, waitUs);
+      i2cStats[busPrio].busMaxUs  = max(i2cStats[busPrio].busMaxUs, busUs);
+      waitTotalUs[busPrio]       += waitUs;
+      busTotalUs[busPrio]        += busUs;
+      busPrio                     = -1;
+
+      if (busXfer.done != NULL) {
+        busXfer.done(&busXfer);
+      }
+    }
+
+    for (int prio = 0; prio < I2C_PRIO_CNT; prio++) {
+      if (i2cQueue[prio].cnt > 0) {
+        busXfer             = i2cQueue[prio].xfer[i2cQueue[prio].head];
+        i2cQueue[prio].head = (i2cQueue[prio].head + 1) % I2C_QUEUE_LEN;
+        i2cQueue[prio].cnt--;
+        busPrio    = prio;
+        busStartUs = simUs;
+        busEndUs   = simUs + busTimeUs(&busXfer);
+        break;
+      }
+    }
+
+    if (busPrio < 0) {
+      return; // Queues are empty.
+    }
+  }
+}
+
+// *********************************************************************************************
+// On exit, returns the next ADC noise value, +/- SIM_ADC_NOISE codes.
+static int adcNoise(void)
+{
+  noiseSeed = noiseSeed * 1664525UL + 1013904223UL;
+
+  return (int)((noiseSeed >> 16) % (2 * SIM_ADC_NOISE + 1)) - SIM_ADC_NOISE;
+}
+
+// *********************************************************************************************
+// On exit, returns the ADC code for the present Welding Volts.
+static uint16_t adcCode(void)
+{
+  float mv   = io.volts * 1000.0f / VDC_SCALE;
+  long  code = lroundf(mv * 4095.0f / SIM_ADC_FS_MV) + adcNoise();
+
+  return (uint16_t)(constrain(code, 0L, 4095L));
+}
+
+// *********************************************************************************************
+// Stream the Welding Volts ADC samples (VDC_DMA_ON) for us.
+static void adcStep(uint32_t us)
+{
+#ifdef VDC_DMA_ON
+  vdcAcc += (uint64_t)(us) * VDC_DMA_RATE;
+
+  while (vdcAcc >= 1000000) {
+    vdcAcc -= 1000000;
+
+    if (vdcCnt == SIM_VDC_FIFO) { // DMA buffers are full; The oldest sample is lost.
+      vdcHead = (vdcHead + 1) % SIM_VDC_FIFO;
+      vdcCnt--;
+    }
+    vdcFifo[(vdcHead + vdcCnt) % SIM_VDC_FIFO] = adcCode();
+    vdcCnt++;
+    adcSamples++;
+  }
+#endif // ifdef VDC_DMA_ON
+}
+
+// *********************************************************************************************
+// On exit, returns the PC's cycle counter: The CPU time stamp counter on x86 PCs, otherwise nS.
+uint32_t halCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return (uint32_t)(__builtin_ia32_rdtsc());
+#else // if defined(__x86_64__) || defined(__i386__)
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint32_t)(now.tv_sec * 1000000000UL + now.tv_nsec);
+#endif // if defined(__x86_64__) || defined(__i386__)
+}
+
+// *********************************************************************************************
+// On exit, returns the simulated time, in uS (lower 32 bits).
+uint32_t halMicros(void)
+{
+  return (uint32_t)(simUs);
+}
+
+// *********************************************************************************************
+// On exit, returns the simulated time, in mS.
+uint32_t halMillis(void)
+{
+  return (uint32_t)(simUs / 1000);
+}
+
+// *********************************************************************************************
+// Set the Pulse edge timer callback. The timer runs in halSimAdvance() steps (SIM_STEP_US resolution).
+void halPulseTimerBegin(void (*callback)(void))
+{
+  pulseTimerFn = callback;
+  pulseDueUs   = 0;
+}
+
+// *********************************************************************************************
+// Start (or restart) the Pulse edge timer. The callback runs once, delayUs from now.
+void halPulseTimerStart(uint32_t delayUs)
+{
+  if (pulseTimerFn != NULL) {
+    pulseDueUs = simUs + (delayUs == 0 ? 1 : delayUs);
+  }
+}
+
+// *********************************************************************************************
+// On exit, returns true if the simulated OC Led is on.
+bool halOcAlert(void)
+{
+  return io.ocAlert;
+}
+
+// *********************************************************************************************
+void halPwmEnable(bool on)
+{
+  io.pwmOn = on;
+}
+
+// *********************************************************************************************
+void halSpiBegin(uint8_t csPin, bool startBus)
+{
+  (void)(csPin);
+  (void)(startBus);
+}
+
+// *********************************************************************************************
+// SPI transfer on the virtual bus (MCP41HV51 model at POT_CS). A missing device reads all zeros.
+void halSpiXfer(uint8_t csPin, uint32_t hz, const uint8_t *tx, uint8_t *rx, size_t len)
+{
+  (void)(hz);
+  attachDevices();
+  simBus.spiXfer(csPin, tx, rx, len);
+}
+
+// *********************************************************************************************
+void halVdcBegin(void)
+{
+  Serial.println("ADC Welding Voltage: Simulated, " + String(SIM_ADC_FS_MV) + "mV Full Scale" +
+#ifdef VDC_DMA_ON
+                 ", Streaming at " + String(VDC_DMA_RATE) + "Hz" +
+#endif // ifdef VDC_DMA_ON
+                 ".");
+}
+
+// *********************************************************************************************
+// On exit, returns the ADC pin voltage for a raw 12 bit code, in mV.
+uint32_t halVdcMv(int raw)
+{
+  return (uint32_t)((raw * SIM_ADC_FS_MV + 2047) / 4095);
+}
+
+// *********************************************************************************************
+int halVdcRaw(void)
+{
+  return adcCode();
+}
+
+// *********************************************************************************************
+// Copy up to count streamed ADC samples to buf. On exit, returns the number of samples copied.
+size_t halVdcRead(uint16_t *buf, size_t count)
+{
+  size_t cnt = 0;
+
+  while ((cnt < count) && (vdcCnt > 0)) {
+    buf[cnt++] = vdcFifo[vdcHead];
+    vdcHead    = (vdcHead + 1) % SIM_VDC_FIFO;
+    vdcCnt--;
+  }
+
+  return cnt;
+}
+
+// *********************************************************************************************
+// On exit, returns the simulated welder connections.
+HalSimIo *halSimIo(void)
+{
+  return &io;
+}
+
+// *********************************************************************************************
+// Advance the simulated time by us. The devices and the I2C Engine run in SIM_STEP_US steps.
+void halSimAdvance(uint32_t us)
+{
+  uint32_t step;
+
+  while (us > 0) {
+    step   = us < SIM_STEP_US ? us : SIM_STEP_US;
+    simUs += step;
+    us    -= step;
+    attachDevices();
+    ina.setInputs(-io.amps * SHUNT_OHMS, 0.0f); // Low side: Welding current reads negative; No bus voltage.
+    simBus.step(step);
+    adcStep(step);
+
+    if ((pulseDueUs != 0) && (simUs >= pulseDueUs)) {
+      pulseDueUs = 0;
+      pulseTimerFn();
+    }
+    i2cService();
+    io.wiperUs = pot.reg(POT_WIPER_ADDR) != io.wiper ? (uint32_t)(simUs) : io.wiperUs;
+    io.wiper   = pot.reg(POT_WIPER_ADDR);
+  }
+}
+
+// *********************************************************************************************
+// On exit, returns the simulated time, in seconds.
+double halSimSeconds(void)
+{
+  return simUs / 1000000.0;
+}
+
+// *********************************************************************************************
+// Get the device traffic counters.
+void halSimStats(HalSimStats *stats)
+{
+  SimBusCounts counts;
+
+  attachDevices();
+  simBus.getCounts(&counts, NULL, false);
+  stats->busXfers = counts.xfers;
+  stats->busNacks = counts.nacks;
+  simBus.getCounts(&counts, &ina, false);
+  stats->inaXfers = counts.xfers;
+  simBus.getCounts(&counts, &pot, false);
+  stats->potXfers   = counts.xfers;
+  stats->potWrites  = pot.wiperChanges();
+  stats->inaConvs   = ina.conversions();
+  stats->adcSamples = adcSamples;
+}
+
+// *********************************************************************************************
+// On exit, returns the INA219 model (register fault injection).
+Ina219Model *halSimIna(void)
+{
+  return &ina;
+}
+
+// *********************************************************************************************
+// On exit, returns the MCP4xHV51 model (register fault injection).
+McpPotModel *halSimPot(void)
+{
+  attachDevices();
+  return &pot;
+}
+
+// *********************************************************************************************
+// I2C Engine API (i2cBus.h), simulated.
+void getI2cStats(I2cStats *stats, uint8_t prio, bool rst)
+{
+  *stats           = i2cStats[prio];
+  stats->waitAvgUs = stats->count == 0 ? 0 : (uint32_t)(waitTotalUs[prio] / stats->count);
+  stats->busAvgUs  = stats->count == 0 ? 0 : (uint32_t)(busTotalUs[prio] / stats->count);
+
+  if (rst) {
+    memset(&i2cStats[prio], 0, sizeof(I2cStats));
+    waitTotalUs[prio] = 0;
+    busTotalUs[prio]  = 0;
+  }
+}
+
+// *********************************************************************************************
+bool initI2cBus(void)
+{
+  return true;
+}
+
+// *********************************************************************************************
+// Queue a transaction. On exit, returns false if the queue is full.
+bool i2cSubmit(I2cXfer *xfer, uint8_t prio)
+{
+  SimI2cQueue *q = &i2cQueue[prio];
+
+  if (q->cnt >= I2C_QUEUE_LEN) {
+    i2cStats[prio].dropped++;
+    return false;
+  }
+
+  xfer->queuedUs                          = halMicros();
+  q->xfer[(q->head + q->cnt) % I2C_QUEUE_LEN] = *xfer;
+  q->cnt++;
+
+  return true;
+}
+
+// *********************************************************************************************
+// Completion callback for i2cTransfer().
+static void syncDone(const I2cXfer *xfer)
+{
+  SimSyncCtx *ctx = (SimSyncCtx *)(xfer->arg);
+
+  ctx->success = xfer->success;
+  ctx->done    = true;
+
+  if (ctx->success && (ctx->rxLen > 0)) {
+    memcpy(ctx->rx, xfer->rx, ctx->rxLen);
+  }
+}
+
+// *********************************************************************************************
+// Blocking transaction. The simulated time advances until it has completed.
+// On exit, returns true if the device acknowledged.
+bool i2cTransfer(uint8_t addr, const uint8_t *tx, uint8_t txLen, uint8_t *rx, uint8_t rxLen, uint8_t prio)
+{
+  SimSyncCtx ctx = { rx, rxLen, false, false };
+  I2cXfer    xfer;
+
+  if ((txLen > I2C_XFER_MAX) || (rxLen > I2C_XFER_MAX)) {
+    return false;
+  }
+
+  memset(&xfer, 0, sizeof(xfer));
+  xfer.addr  = addr;
+  xfer.txLen = txLen;
+  xfer.rxLen = rxLen;
+  xfer.done  = syncDone;
+  xfer.arg   = &ctx;
+
+  if (txLen > 0) {
+    memcpy(xfer.tx, tx, txLen);
+  }
+
+  if (!i2cSubmit(&xfer, prio)) {
+    return false;
+  }
+
+  while (!ctx.done) {
+    halSimAdvance(SIM_STEP_US);
+  }
+
+  return ctx.success;
+}
+
+// *********************************************************************************************
+// Check for a device at addr. On exit, returns true if it acknowledged.
+bool i2cProbe(uint8_t addr)
+{
+  return i2cTransfer(addr, NULL, 0, NULL, 0, I2C_PRIO_LOW);
+}
+
+#endif // ifdef HAL_SIM
+
+// EOF
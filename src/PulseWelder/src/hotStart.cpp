@@ -0,0 +1,132 @@
+/*
+   File: hotStart.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+ */
+
+#include <math.h>
+#include "hotStart.h"
+
+// *********************************************************************************************
+HotStart::HotStart(void)
+{
+  cfg.boostPc     = 0;
+  cfg.holdSec     = 0;
+  cfg.rampSec     = 0;
+  cfg.armVolts    = 0;
+  cfg.armSec      = 0;
+  cfg.strikeVolts = 0;
+  cfg.minAmps     = 0;
+  cfg.maxAmps     = 0;
+  reset();
+}
+
+// *********************************************************************************************
+// Load the Hot Start settings and disarm the detector.
+void HotStart::begin(const HotStartCfg& newCfg)
+{
+  cfg = newCfg;
+  reset();
+}
+
+// *********************************************************************************************
+// Disarm the detector and clear the boost.
+void HotStart::reset(void)
+{
+  armed     = false;
+  isActive  = false;
+  armTime   = 0;
+  elapsed   = 0;
+  prevAmps  = 0;
+  boostAmps = 0;
+}
+
+// *********************************************************************************************
+// Change the boost level and time (user settings). Takes effect on the next strike.
+void HotStart::setBoost(float boostPc, float holdSec)
+{
+  cfg.boostPc = boostPc;
+  cfg.holdSec = holdSec;
+}
+
+// *********************************************************************************************
+// Run the strike detector and boost profile on the newest arc voltage and current. Call every dt seconds.
+// demandAmps is the requested Amps before the boost. demandAmps + boost never exceeds cfg.maxAmps.
+// On exit, returns the boost, in Amps.
+float HotStart::update(float volts, float amps, float demandAmps, float dt)
+{
+  float level;
+  float ramp;
+
+  if (!isActive) {
+    if (volts >= cfg.armVolts) { // Open circuit, rod is not touching the work.
+      armTime += dt;
+      armed    = armed || (armTime >= cfg.armSec);
+    }
+    else {
+      armTime = 0;
+    }
+
+    if (armed && (cfg.boostPc > 0) &&
+        ((volts < cfg.strikeVolts) || ((amps >= cfg.minAmps) && (prevAmps < cfg.minAmps)))) {
+      armed    = false;
+      armTime  = 0;
+      isActive = true;
+      elapsed  = 0;
+    }
+  }
+  else {
+    elapsed += dt;
+  }
+  prevAmps = amps;
+
+  if (!isActive) {
+    boostAmps = 0;
+    return boostAmps;
+  }
+
+  if (elapsed < cfg.holdSec) {
+    level = 1.0f;
+  }
+  else if (elapsed < cfg.holdSec + cfg.rampSec) {
+    ramp  = (elapsed - cfg.holdSec) / cfg.rampSec;
+    level = 0.5f * (1.0f + cosf(ramp * 3.14159265f));
+  }
+  else {
+    level    = 0;
+    isActive = false;
+  }
+
+  boostAmps = demandAmps * cfg.boostPc * level / 100.0f;
+
+  if (demandAmps + boostAmps > cfg.maxAmps) {
+    boostAmps = cfg.maxAmps - demandAmps;
+    boostAmps = boostAmps < 0 ? 0 : boostAmps;
+  }
+
+  return boostAmps;
+}
+
+// *********************************************************************************************
+// On exit, returns the present boost, in Amps.
+float HotStart::boost(void) const
+{
+  return boostAmps;
+}
+
+// *********************************************************************************************
+// On exit, returns true while a strike boost is in progress.
+bool HotStart::active(void) const
+{
+  return isActive;
+}
+
+// EOF
@@ -0,0 +1,65 @@
+/*
+   File: hotStart.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Hot Start. The detector is armed after the welder has been at open circuit voltage (above armVolts) for armSec.
+      A strike is the first falling voltage edge below strikeVolts, or the first rising current edge above minAmps,
+      whichever comes first. The averaged Amps value is not used; It lags the strike by almost 100mS.
+   2. The boost is held at boostPc percent of the requested Amps for holdSec, then ramps down to zero over rampSec
+      (raised cosine, no step in the output current).
+   3. This file and hotStart.cpp do not use the Arduino libraries. They can be compiled on a PC, see weldSim.cpp.
+ */
+#ifndef __HOT_START_H__
+#define __HOT_START_H__
+
+// Hot Start settings.
+struct HotStartCfg {
+  float boostPc;     // Boost at strike, percent of the requested Amps. Zero disables Hot Start.
+  float holdSec;     // Full boost time, in seconds.
+  float rampSec;     // Ramp down time (after holdSec), in seconds.
+  float armVolts;    // Open circuit voltage threshold, in Volts.
+  float armSec;      // Time above armVolts to arm the detector, in seconds.
+  float strikeVolts; // Strike voltage threshold, in Volts. Must be less than armVolts.
+  float minAmps;     // Strike current threshold, in Amps.
+  float maxAmps;     // Boosted current limit, in Amps.
+};
+
+class HotStart {
+public:
+
+  HotStart(void);
+  void  begin(const HotStartCfg& cfg);
+  void  reset(void);
+  void  setBoost(float boostPc,
+                 float holdSec);
+  float update(float volts,
+               float amps,
+               float demandAmps,
+               float dt);
+  float boost(void) const;
+  bool  active(void) const;
+
+private:
+
+  HotStartCfg cfg;       // Hot Start settings.
+  bool        armed;     // Open circuit voltage seen, waiting for a strike.
+  bool        isActive;  // Boost in progress.
+  float       armTime;   // Time at open circuit voltage, in seconds.
+  float       elapsed;   // Time since strike, in seconds.
+  float       prevAmps;  // Previous current reading, for edge detection.
+  float       boostAmps; // Present boost, in Amps.
+};
+
+#endif // ifndef __HOT_START_H__
+
+// EOF
@@ -0,0 +1,277 @@
+/*
+   File: i2cBus.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. I2C Engine. The INA219 Current Sensor and the MCP45HV51 Digital Pot share the I2C bus. All traffic is queued
+      to the I2C Engine task, which owns the bus and runs each transaction as an ESP-IDF command link.
+   2. There are two queues. High priority (Digital Pot writes) is always emptied before low priority (sensor reads).
+   3. i2cSubmit() does not block; The result is passed to the transaction's callback. i2cTransfer() is a blocking
+      wrapper for use during initialization and other non time critical places.
+   4. The Arduino Wire library must not be used once the I2C Engine is running; Both would drive the same port.
+   5. The command link is built in a static buffer (ESP-IDF 4.4 and later), so a transaction does not use the heap.
+      Older ESP-IDF versions allocate the link for each transaction.
+ */
+
+#include <Arduino.h>
+#include <driver/i2c.h>
+#if __has_include(<esp_idf_version.h>)
+ #include <esp_idf_version.h>
+#endif // if __has_include(<esp_idf_version.h>)
+#include "PulseWelder.h"
+#include "i2cBus.h"
+#include "config.h"
+
+#define I2C_PORT I2C_NUM_0
+
+#if defined(ESP_IDF_VERSION_VAL)
+ #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 4, 0)
+  #define I2C_LINK_STATIC                            // Command link in cmdBuf[], i2c_cmd_link_create_static().
+  #define I2C_LINK_SIZE I2C_LINK_RECOMMENDED_SIZE(8) // Start, Addr, Write, Start, Addr, Read (2), Stop.
+ #endif // if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 4, 0)
+#endif // if defined(ESP_IDF_VERSION_VAL)
+
+// Blocking transaction context, see i2cTransfer().
+struct I2cSyncCtx {
+  SemaphoreHandle_t doneSem; // Given when transaction completes.
+  uint8_t          *rx;      // Caller's read buffer.
+  uint8_t           rxLen;   // Caller's read length.
+  bool              success; // Transaction result.
+};
+
+// Local Scope Vars
+static TaskHandle_t  i2cTaskHandle = NULL;                         // I2C Engine task.
+static QueueHandle_t i2cQueue[I2C_PRIO_CNT];                       // Transaction queues, by priority.
+static I2cStats      i2cStats[I2C_PRIO_CNT];                       // Latency counters, by priority.
+static uint64_t      waitTotalUs[I2C_PRIO_CNT];                    // Queue wait totalizer, for average.
+static uint64_t      busTotalUs[I2C_PRIO_CNT];                     // Bus time totalizer, for average.
+static portMUX_TYPE  i2cStatsMux = portMUX_INITIALIZER_UNLOCKED;   // Protects the latency counters.
+#ifdef I2C_LINK_STATIC
+static uint8_t       cmdBuf[I2C_LINK_SIZE];                        // Command link buffer (I2C Engine task only).
+#endif // ifdef I2C_LINK_STATIC
+
+// *********************************************************************************************
+// Run one transaction on the bus using an ESP-IDF command link. Called by the I2C Engine task only.
+static bool runXfer(I2cXfer *xfer)
+{
+  esp_err_t err;
+#ifdef I2C_LINK_STATIC
+  i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(cmdBuf, sizeof(cmdBuf));
+#else // ifdef I2C_LINK_STATIC
+  i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+#endif // ifdef I2C_LINK_STATIC
+
+  if (cmd == NULL) {
+    return false;
+  }
+
+  i2c_master_start(cmd);
+
+  if ((xfer->txLen > 0) || (xfer->rxLen == 0)) {           // Write phase (or address probe).
+    i2c_master_write_byte(cmd, (xfer->addr << 1) | I2C_MASTER_WRITE, true);
+
+    if (xfer->txLen > 0) {
+      i2c_master_write(cmd, xfer->tx, xfer->txLen, true);
+    }
+  }
+
+  if (xfer->rxLen > 0) {                                   // Read phase.
+    if (xfer->txLen > 0) {
+      i2c_master_start(cmd);                               // Repeated Start.
+    }
+    i2c_master_write_byte(cmd, (xfer->addr << 1) | I2C_MASTER_READ, true);
+    i2c_master_read(cmd, xfer->rx, xfer->rxLen, I2C_MASTER_LAST_NACK);
+  }
+
+  i2c_master_stop(cmd);
+  err = i2c_master_cmd_begin(I2C_PORT, cmd, pdMS_TO_TICKS(I2C_TIMEOUT_MS));
+#ifdef I2C_LINK_STATIC
+  i2c_cmd_link_delete_static(cmd);
+#else // ifdef I2C_LINK_STATIC
+  i2c_cmd_link_delete(cmd);
+#endif // ifdef I2C_LINK_STATIC
+
+  return err == ESP_OK;
+}
+
+// *********************************************************************************************
+// I2C Engine task. Services the high priority queue first, then the low priority queue.
+static void i2cTask(void *param)
+{
+  I2cXfer  xfer;
+  uint8_t  prio;
+  uint32_t startUs;
+  uint32_t waitUs;
+  uint32_t busUs;
+
+  for (;;) {
+    if (xQueueReceive(i2cQueue[I2C_PRIO_HIGH], &xfer, 0) == pdTRUE) {
+      prio = I2C_PRIO_HIGH;
+    }
+    else if (xQueueReceive(i2cQueue[I2C_PRIO_LOW], &xfer, 0) == pdTRUE) {
+      prio = I2C_PRIO_LOW;
+    }
+    else {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY); // Sleep until a transaction is submitted.
+      continue;
+    }
+
+    startUs      = (uint32_t)(esp_timer_get_time());
+    xfer.success = runXfer(&xfer);
+    busUs        = (uint32_t)(esp_timer_get_time()) - startUs;
+    waitUs       = startUs - xfer.queuedUs;
+
+    portENTER_CRITICAL(&i2cStatsMux);
+    i2cStats[prio].count++;
+    i2cStats[prio].errors   += xfer.success ? 0 : 1;
+    i2cStats[prio].waitMaxUs = max(i2cStats[prio].waitMaxUs, waitUs);
+    i2cStats[prio].busMaxUs  = max(i2cStats[prio].busMaxUs, busUs);
+    waitTotalUs[prio]       += waitUs;
+    busTotalUs[prio]        += busUs;
+    portEXIT_CRITICAL(&i2cStatsMux);
+
+    if (xfer.done != NULL) {
+      xfer.done(&xfer);
+    }
+  }
+}
+
+// *********************************************************************************************
+// Completion callback for blocking transactions.
+static void syncDone(const I2cXfer *xfer)
+{
+  I2cSyncCtx *ctx = (I2cSyncCtx *)(xfer->arg);
+
+  if (ctx->rxLen > 0) {
+    memcpy(ctx->rx, xfer->rx, ctx->rxLen);
+  }
+  ctx->success = xfer->success;
+  xSemaphoreGive(ctx->doneSem);
+}
+
+// *********************************************************************************************
+// Initialize the I2C port and start the I2C Engine task. Safe to call more than once.
+// Bus speed is set by I2C_BUS_HZ in config.h.
+bool initI2cBus(void)
+{
+  i2c_config_t conf;
+
+  if (i2cTaskHandle != NULL) {
+    return true; // Already running.
+  }
+
+  memset(&conf, 0, sizeof(conf));
+  conf.mode             = I2C_MODE_MASTER;
+  conf.sda_io_num       = SDA;
+  conf.sda_pullup_en    = GPIO_PULLUP_ENABLE;
+  conf.scl_io_num       = SCL;
+  conf.scl_pullup_en    = GPIO_PULLUP_ENABLE;
+  conf.master.clk_speed = I2C_BUS_HZ;
+
+  if ((i2c_param_config(I2C_PORT, &conf) != ESP_OK) || (i2c_driver_install(I2C_PORT, conf.mode, 0, 0, 0) != ESP_OK)) {
+    Serial.println("I2C Engine Initialization Failed!");
+    return false;
+  }
+
+  for (int i = 0; i < I2C_PRIO_CNT; i++) {
+    i2cQueue[i] = xQueueCreate(I2C_QUEUE_LEN, sizeof(I2cXfer));
+  }
+
+  xTaskCreatePinnedToCore(i2cTask, "I2C", I2C_TASK_STACK, NULL, CONTROL_TASK_PRIO + 1, &i2cTaskHandle, CONTROL_TASK_CORE);
+  Serial.println("Initialized I2C Engine, Bus Speed " + String(I2C_BUS_HZ / 1000) + "KHz.");
+
+  return true;
+}
+
+// *********************************************************************************************
+// Queue a transaction. Does not block.
+// On exit, returns false if the queue is full (transaction dropped, callback will not be called).
+bool i2cSubmit(I2cXfer *xfer, uint8_t prio)
+{
+  prio           = prio == I2C_PRIO_HIGH ? I2C_PRIO_HIGH : I2C_PRIO_LOW;
+  xfer->queuedUs = (uint32_t)(esp_timer_get_time());
+
+  if (xQueueSend(i2cQueue[prio], xfer, 0) != pdTRUE) {
+    portENTER_CRITICAL(&i2cStatsMux);
+    i2cStats[prio].dropped++;
+    portEXIT_CRITICAL(&i2cStatsMux);
+    return false;
+  }
+
+  xTaskNotifyGive(i2cTaskHandle);
+
+  return true;
+}
+
+// *********************************************************************************************
+// Perform a transaction and wait for it to complete. Do not call from a callback.
+// On exit, returns true if the device acknowledged the transaction.
+bool i2cTransfer(uint8_t addr, const uint8_t *tx, uint8_t txLen, uint8_t *rx, uint8_t rxLen, uint8_t prio)
+{
+  I2cXfer    xfer;
+  I2cSyncCtx ctx;
+
+  if ((i2cTaskHandle == NULL) || (txLen > I2C_XFER_MAX) || (rxLen > I2C_XFER_MAX)) {
+    return false;
+  }
+
+  ctx.doneSem = xSemaphoreCreateBinary();
+  ctx.rx      = rx;
+  ctx.rxLen   = rxLen;
+  ctx.success = false;
+
+  memset(&xfer, 0, sizeof(xfer));
+  xfer.addr  = addr;
+  xfer.txLen = txLen;
+  xfer.rxLen = rxLen;
+  xfer.done  = syncDone;
+  xfer.arg   = &ctx;
+
+  if (txLen > 0) {
+    memcpy(xfer.tx, tx, txLen);
+  }
+
+  if (i2cSubmit(&xfer, prio)) {
+    xSemaphoreTake(ctx.doneSem, portMAX_DELAY);
+  }
+  vSemaphoreDelete(ctx.doneSem);
+
+  return ctx.success;
+}
+
+// *********************************************************************************************
+// Check for a device at the I2C address (address only transaction).
+bool i2cProbe(uint8_t addr)
+{
+  return i2cTransfer(addr, NULL, 0, NULL, 0, I2C_PRIO_LOW);
+}
+
+// *********************************************************************************************
+// Get a copy of the I2C Engine latency counters for a priority level.
+// On entry rst = true to clear the worst-case values after they are copied.
+void getI2cStats(I2cStats *stats, uint8_t prio, bool rst)
+{
+  prio = prio == I2C_PRIO_HIGH ? I2C_PRIO_HIGH : I2C_PRIO_LOW;
+
+  portENTER_CRITICAL(&i2cStatsMux);
+  *stats           = i2cStats[prio];
+  stats->waitAvgUs = i2cStats[prio].count == 0 ? 0 : (uint32_t)(waitTotalUs[prio] / i2cStats[prio].count);
+  stats->busAvgUs  = i2cStats[prio].count == 0 ? 0 : (uint32_t)(busTotalUs[prio] / i2cStats[prio].count);
+
+  if (rst) {
+    i2cStats[prio].waitMaxUs = 0;
+    i2cStats[prio].busMaxUs  = 0;
+  }
+  portEXIT_CRITICAL(&i2cStatsMux);
+}
+
+// EOF
@@ -0,0 +1,69 @@
+/*
+   File: i2cBus.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+ */
+#ifndef __I2C_BUS_H__
+#define __I2C_BUS_H__
+
+#include <Arduino.h>
+
+#define I2C_PRIO_HIGH 0       // Actuator writes (Digital Pot). Always serviced before low priority transactions.
+#define I2C_PRIO_LOW 1        // Sensor reads (INA219).
+#define I2C_PRIO_CNT 2        // Number of priority levels.
+#define I2C_XFER_MAX 4        // Maximum bytes per transaction, each direction.
+#define I2C_QUEUE_LEN 8       // Queued transactions per priority level.
+#define I2C_TIMEOUT_MS 10     // Bus timeout per transaction, in mS.
+#define I2C_TASK_STACK 3072   // I2C Engine task stack size, in bytes.
+
+struct I2cXfer;
+typedef void (*I2cDoneFn)(const I2cXfer *xfer); // Completion callback. Runs in the I2C Engine task, keep it short.
+
+// I2C Transaction. Write txLen bytes, then (repeated start) read rxLen bytes. Either length may be zero.
+struct I2cXfer {
+  uint8_t   addr;               // 7-bit device address.
+  uint8_t   txLen;              // Number of bytes to write.
+  uint8_t   rxLen;              // Number of bytes to read.
+  uint8_t   tx[I2C_XFER_MAX];   // Write data.
+  uint8_t   rx[I2C_XFER_MAX];   // Read data, valid in callback.
+  bool      success;            // Transaction result, valid in callback.
+  I2cDoneFn done;               // Completion callback, may be NULL.
+  void     *arg;                // Callback argument.
+  uint32_t  queuedUs;           // Submit time, filled in by i2cSubmit().
+};
+
+// I2C Engine latency counters, per priority level.
+struct I2cStats {
+  uint32_t count;     // Completed transactions.
+  uint32_t errors;    // Failed transactions (NACK, timeout).
+  uint32_t dropped;   // Transactions rejected because the queue was full.
+  uint32_t waitAvgUs; // Average time spent queued, in uS.
+  uint32_t waitMaxUs; // Worst time spent queued, in uS.
+  uint32_t busAvgUs;  // Average bus time, in uS.
+  uint32_t busMaxUs;  // Worst bus time, in uS.
+};
+
+void getI2cStats(I2cStats *stats,
+                 uint8_t   prio,
+                 bool      rst);
+bool initI2cBus(void);
+bool i2cProbe(uint8_t addr);
+bool i2cSubmit(I2cXfer *xfer,
+               uint8_t  prio);
+bool i2cTransfer(uint8_t        addr,
+                 const uint8_t *tx,
+                 uint8_t        txLen,
+                 uint8_t       *rx,
+                 uint8_t        rxLen,
+                 uint8_t        prio);
+
+#endif
+// EOF
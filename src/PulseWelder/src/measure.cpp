@@ -16,46 +16,245 @@
    1. The INA219 library is custom patched; It has been modified for use with the Sparky project.
    2. The INA219 "High-Side" current sensor is being used in a Low-side configuration. Therefore Bus voltage and
     power measurements are not available.
+   3. The INA219 is serviced by the I2C Engine (i2cBus.cpp). measureCurrent() queues the next shunt current read and
+    uses the result of the previous one, so the Control Task never waits on the I2C bus.
+    With INA219_SYNC_ON the Bus Voltage register's Conversion Ready flag (CNVR) is polled instead, starting
+    MEAS_TIME before the next conversion is due. When it is set, the Power register is read (clears CNVR), then the
+    shunt current. Only new conversions are passed to the Amps filter; See getInaStats() for the rate and latency.
+   4. Welding Volts: initVdcAdc() builds a table (vdcTable) from the ADC calibration curve, the attenuator scale, and
+    the optional two-point correction (VDC_CAL_ON in config.h). Each raw ADC code is converted to centivolts with one
+    table load. Codes below VDC_ADC_MIN_MV, where the ADC is not linear, read as zero.
+   5. With INA219_ADAPT_ON the INA219 is reconfigured at runtime: Fast single conversions (INA219_FAST_ADC) during
+    strikes, shorts, stuck rods, and pulse edges (for INA_FAST_HOLD_MS), hardware averaging during steady burn and
+    idle. Each change costs one Configuration write and the conversion in progress. The Amps display filter uses
+    AMPS_FAST_DISP_SHIFT in the fast mode, so the display noise does not rise.
+   6. Amps (mA) and Volts (mV) are scaled and filtered in fixed-point (filters.cpp). Each has a fast (control) output,
+    see getFastAmps() and getFastVoltsCv(), and a slow (display) output, the Amps and Volts globals. The filter
+    settings are in config.h.
+   7. The ADC and timer are used through the Hardware Abstraction Layer (hal.h), so this file also runs in the PC
+    simulator (ctrlSim.cpp).
  */
 
 #include <Arduino.h>
-#include <driver/adc.h>
-#include <esp_adc_cal.h>
 #include "INA219.h"
+#include "filters.h"
+#include "hal.h"
+#include "i2cBus.h"
 #include "PulseWelder.h"
 #include "config.h"
 
-#define I_AVG_SIZE 16                         // Size of Welder Amps data averaging buffer.
-#define E_AVG_SIZE 16                         // Size of Welder VDC data averaging buffer.
 #define VDC_PIN 36                            // Voltage reading pin.
-#define VDC_SCALE ((47000.0 + 1800.0) / 1800) // Resistor Attenuator on Welding VDC signal.
-#define VDC_ADC_PORT ADC1_CHANNEL_0
-#define DEFAULT_VREF 1100
+#define VDC_TABLE_SIZE 4096                   // ADC code to Volts table size, one entry per 12 bit code.
+#define VDC_ADC_MIN_MV 100                    // ADC is not linear below this pin voltage (11dB attenuation), in mV.
+#define AMPS_NOISE_MA 3000                    // Readings under 3A are noise, in mA.
+#define AMPS_LIMIT_MA 220000                  // Amps reading limit, in mA.
+#define VDC_BLOCK_RING 16                     // Number of Voltage blocks kept in the ring buffer.
+#define INA_POLL_HOLDOFF_US (INA219_AVG_CONV_US - MEAS_TIME * 1000) // No Conversion Ready polls this soon after one.
 
 // External Globals
-extern int Amps;
-extern unsigned int Volts;
+extern volatile int Amps;
+extern volatile unsigned int Volts;
 extern INA219 ina219;
 extern bool i2cInitComplete;
 
 // Local Scope Vars
-static int iAvgBuff[I_AVG_SIZE + 1]; // Amps data averaging buffer.
-static int eAvgBuff[E_AVG_SIZE + 1]; // VDC data averaging buffer.
-static esp_adc_cal_characteristics_t *adc_chars;
+static DualRateFilter ampsFilter;    // Welding Amps filter, in mA.
+static DualRateFilter voltsFilter;   // Welding Volts filter, in mV.
+static uint16_t vdcTable[VDC_TABLE_SIZE];    // Raw ADC code to Welding Volts, in centivolts.
+
+#ifdef VDC_DMA_ON
+static VdcBlock vdcRing[VDC_BLOCK_RING];                    // Ring buffer of recent Voltage blocks.
+static volatile uint32_t vdcBlockSeq = 0;                   // Sequence number of newest Voltage block.
+static uint32_t vdcCvTotal           = 0;                   // Sum of block averages (centivolts), for measureVoltage().
+static uint32_t vdcCvCount           = 0;                   // Number of blocks in vdcCvTotal.
+static portMUX_TYPE vdcMux           = portMUX_INITIALIZER_UNLOCKED; // Protects the Voltage block ring buffer.
+#endif // ifdef VDC_DMA_ON
+
+static I2cXfer shuntXfer;                    // INA219 shunt current read transaction (copied when queued).
+static volatile int16_t shuntRaw     = 0;    // Newest INA219 shunt current register value.
+static volatile bool    shuntPending = false; // Shunt current read is queued or on the bus.
+static int32_t          shuntMaQ8    = 0;    // INA219 shunt current scale, mA per count (8 fraction bits).
+static volatile int     fastAmps     = 0;    // Welding Amps, control filter output.
+static volatile int     fastVoltsCv  = 0;    // Welding Volts, control filter output, in centivolts.
+static InaStats         inaStats;             // INA219 acquisition statistics (count fields only).
+static uint32_t         inaLatencyTotal = 0;  // Sum of the sample latencies, in uS.
+static uint32_t         inaStatsMs      = 0;  // Start of the statistics interval, in mS.
+static portMUX_TYPE     inaMux          = portMUX_INITIALIZER_UNLOCKED; // Protects the shunt result and statistics.
+
+#ifdef INA219_SYNC_ON
+static I2cXfer readyXfer;                     // INA219 Conversion Ready (Bus Voltage register) read.
+static I2cXfer clearXfer;                     // INA219 Power register read, clears Conversion Ready.
+static volatile bool     shuntNew = false;    // shuntRaw holds a conversion not yet filtered.
+static volatile uint32_t readyUs  = 0;        // Start time of the poll that found the conversion, in uS.
+#endif // ifdef INA219_SYNC_ON
+
+#ifdef INA219_ADAPT_ON
+static I2cXfer  modeXfer[2];                  // INA219 Configuration writes, averaging (0) and fast (1) modes.
+static bool     inaFast      = false;         // INA219 is in the fast conversion mode (Control Task only).
+static bool     inaArcFast   = false;         // Arc State needs fast conversions (strike, stuck rod).
+static uint32_t fastUntilUs  = 0;             // End of the fast mode hold time, in uS.
+static uint32_t inaModeTotal = 0;             // Sum of the reconfiguration times, in uS.
+static uint32_t inaFastMs    = 0;             // Time spent in the fast mode, in mS.
+#endif // ifdef INA219_ADAPT_ON
+
+// *********************************************************************************************
+// INA219 library transport hook. Register write via the I2C Engine.
+static bool inaWrite(uint8_t addr, const uint8_t *data, uint8_t len)
+{
+  return i2cTransfer(addr, data, len, NULL, 0, I2C_PRIO_LOW);
+}
+
+// *********************************************************************************************
+// INA219 library transport hook. Register read (pointer write, repeated start) via the I2C Engine.
+static bool inaRead(uint8_t addr, uint8_t reg, uint8_t *data, uint8_t len)
+{
+  return i2cTransfer(addr, &reg, 1, data, len, I2C_PRIO_LOW);
+}
+
+// *********************************************************************************************
+// I2C Engine callback for the shunt current read. Failed reads keep the previous value.
+static void shuntReadDone(const I2cXfer *xfer)
+{
+  portENTER_CRITICAL(&inaMux);
+  inaStats.shuntReads++;
+
+  if (xfer->success) {
+    shuntRaw = (int16_t)((xfer->rx[0] << 8) | xfer->rx[1]);
+#ifdef INA219_SYNC_ON
+    shuntNew = true;
+#endif // ifdef INA219_SYNC_ON
+  }
+  portEXIT_CRITICAL(&inaMux);
+  shuntPending = false;
+}
+
+#ifdef INA219_SYNC_ON
+
+// *********************************************************************************************
+// I2C Engine callback for the Power register read. Conversion Ready is now clear; Read the shunt current.
+static void clearReadDone(const I2cXfer *xfer)
+{
+  if (!i2cSubmit(&shuntXfer, I2C_PRIO_LOW)) {
+    shuntPending = false;
+  }
+}
+
+// *********************************************************************************************
+// I2C Engine callback for the Conversion Ready poll. Starts the clear and shunt reads if a conversion is ready.
+static void readyReadDone(const I2cXfer *xfer)
+{
+  portENTER_CRITICAL(&inaMux);
+  inaStats.polls++;
+  portEXIT_CRITICAL(&inaMux);
+
+  if (xfer->success && (xfer->rx[1] & INA219_CNVR)) {
+    readyUs = xfer->queuedUs;
+
+    if (i2cSubmit(&clearXfer, I2C_PRIO_LOW)) {
+      return;
+    }
+  }
+  shuntPending = false;
+}
+
+#endif // ifdef INA219_SYNC_ON
+
+#ifdef INA219_ADAPT_ON
+
+// *********************************************************************************************
+// I2C Engine callback for the Configuration write. The INA219 restarts its conversion.
+static void modeWriteDone(const I2cXfer *xfer)
+{
+  portENTER_CRITICAL(&inaMux);
+  inaStats.modeChanges++;
+  inaModeTotal += halMicros() - xfer->queuedUs;
+  portEXIT_CRITICAL(&inaMux);
+  shuntPending = false;
+}
+
+// *********************************************************************************************
+// Build the Configuration write for a shunt ADC mode (same settings as initCurrentSensor()).
+static void initModeXfer(I2cXfer *xfer, uint8_t shuntAdc)
+{
+  uint16_t config = BUS_RANGE_16V << BRNG | PGA_RANGE_160MV << PG0 | SAMPLE_9BITS << BADC1 | shuntAdc << SADC1 |
+                    CONTINUOUS_OP_NO_VDC;
+
+  memset(xfer, 0, sizeof(I2cXfer));
+  xfer->addr  = INA219_ADDR;
+  xfer->txLen = 3;
+  xfer->tx[0] = CONFIG_R;
+  xfer->tx[1] = config >> 8;
+  xfer->tx[2] = config & 0xff;
+  xfer->done  = modeWriteDone;
+}
+
+// *********************************************************************************************
+// Switch the INA219 conversion mode if the Arc State or the fast mode hold time calls for it. The Amps display filter
+// is retuned for the new sample rate. Called by the Control Task.
+// On exit, returns true if a Configuration write was queued.
+static bool applyInaMode(void)
+{
+  bool want = inaArcFast || ((int32_t)(fastUntilUs - halMicros()) > 0);
+
+  if ((want == inaFast) || shuntPending || (shuntXfer.addr == 0)) {
+    return false;
+  }
+
+  shuntPending = true;
+  if (!i2cSubmit(&modeXfer[want ? 1 : 0], I2C_PRIO_LOW)) {
+    shuntPending = false;
+    return false;
+  }
+
+  inaFast  = want;
+  readyUs  = halMicros(); // Averaging mode: First conversion is due INA219_AVG_CONV_US from now.
+  shuntNew = false;
+  ampsFilter.setShifts(AMPS_CTRL_SHIFT, want ? AMPS_FAST_DISP_SHIFT : AMPS_DISP_SHIFT);
+
+  return true;
+}
+
+#endif // ifdef INA219_ADAPT_ON
+
+// *********************************************************************************************
+// Request fast INA219 conversions for INA_FAST_HOLD_MS (pulse edges). Called by the Control Task.
+void inaFastWindow(void)
+{
+#ifdef INA219_ADAPT_ON
+  fastUntilUs = halMicros() + INA_FAST_HOLD_MS * 1000UL;
+  applyInaMode();
+#endif // ifdef INA219_ADAPT_ON
+}
+
+// *********************************************************************************************
+// Arc State change subscriber for the INA219 conversion mode. Called by the Control Task.
+// Strikes, shorts, and stuck rods use fast conversions; Steady burn and idle use hardware averaging.
+void inaArcEvent(const ArcEvent& evt)
+{
+#ifdef INA219_ADAPT_ON
+  inaArcFast = (evt.state == ARC_ST_STRIKE) || (evt.state == ARC_ST_STUCK);
+
+  if (inaArcFast || (evt.state == ARC_ST_SHORT)) {
+    inaFastWindow(); // Hold time starts now, so the fast mode outlasts brief droplet shorts.
+  }
+  else {
+    applyInaMode();
+  }
+#endif // ifdef INA219_ADAPT_ON
+}
 
 // *********************************************************************************************
 // Setup the INA219 Current Sensor.
 bool initCurrentSensor(void)
 {
   bool success = false;
-  uint8_t error;
 
-  ina219.begin(INA219_ADDR);
-  Wire.beginTransmission(INA219_ADDR);
-  error           = Wire.endTransmission();
+  initI2cBus();
   i2cInitComplete = true; // Tell world we have setup the i2c port.
+  ina219.setTransport(inaWrite, inaRead);
+  ina219.begin(INA219_ADDR);
 
-  if (error) {
+  if (!i2cProbe(INA219_ADDR)) {
     Serial.println("INA219 Current Sensor Initialization Failed at Address 0x" + String(INA219_ADDR, HEX) + ".");
     success = false;
   }
@@ -71,153 +270,360 @@ bool initCurrentSensor(void)
      Serial.println(" (not using hardware averaging).");
     #endif
     ina219.calibrate(SHUNT_OHMS, SHUNT_V_MAX, BUS_V_MAX, MAX_I_EXPECTED);
+    shuntMaQ8 = (int32_t)(ina219.currentFromRaw(1000) * 256.0f + 0.5f); // 1000 counts in Amps = 1 count in mA.
+
+    memset(&shuntXfer, 0, sizeof(shuntXfer));
+    shuntXfer.addr  = INA219_ADDR;
+    shuntXfer.txLen = 1;
+    shuntXfer.tx[0] = I_SHUNT_R;
+    shuntXfer.rxLen = 2;
+    shuntXfer.done  = shuntReadDone;
+
+#ifdef INA219_SYNC_ON
+    readyXfer       = shuntXfer;
+    readyXfer.tx[0] = V_BUS_R;
+    readyXfer.done  = readyReadDone;
+    clearXfer       = shuntXfer;
+    clearXfer.tx[0] = P_BUS_R;
+    clearXfer.done  = clearReadDone;
+#endif // ifdef INA219_SYNC_ON
+
+#ifdef INA219_ADAPT_ON
+    initModeXfer(&modeXfer[0], SAMPLE_AVG_32);
+    initModeXfer(&modeXfer[1], INA219_FAST_ADC);
+#endif // ifdef INA219_ADAPT_ON
+
+    getInaStats(NULL, true);
     success = true;
   }
 
   return success;
 }
 
+// *********************************************************************************************
+// Build the raw ADC code to Welding Volts table. The ADC calibration curve (eFuse), attenuator scale, and two-point
+// correction are applied once here instead of on every sample. The ADC must be initialized first (halVdcBegin()).
+static void buildVdcTable(void)
+{
+  uint32_t mv;
+  float    cv;
+
+  for (int raw = 0; raw < VDC_TABLE_SIZE; raw++) {
+    mv = halVdcMv(raw);
+    cv = mv * VDC_SCALE / 10.0f;
+#ifdef VDC_CAL_ON
+    cv = VDC_CAL_TRUE_LO + ((cv - VDC_CAL_READ_LO) * (VDC_CAL_TRUE_HI - VDC_CAL_TRUE_LO)) /
+         (float)(VDC_CAL_READ_HI - VDC_CAL_READ_LO);
+#endif // ifdef VDC_CAL_ON
+    vdcTable[raw] = (raw == 0) || (mv < VDC_ADC_MIN_MV) ? 0 : (uint16_t)(constrain(cv + 0.5f, 0.0f, 9999.0f));
+  }
+
+#ifdef VDC_CAL_ON
+  Serial.println("ADC Welding Volts Table: Full Scale " + String(vdcTable[VDC_TABLE_SIZE - 1] / 100.0f, 1) +
+                 "V, Two-Point Correction On.");
+#else // ifdef VDC_CAL_ON
+  Serial.println("ADC Welding Volts Table: Full Scale " + String(vdcTable[VDC_TABLE_SIZE - 1] / 100.0f, 1) + "V.");
+#endif // ifdef VDC_CAL_ON
+}
+
 // *********************************************************************************************
 // Initialize the Volts ADC. We use ADC1_CHANNEL_0, which is Pin 36.
 // This MUST be called in setup() before first use of measureVoltage().
 void initVdcAdc(void)
 {
-  // Configure ADC
-  adc1_config_width(ADC_WIDTH_BIT_12);
-  adc1_config_channel_atten(VDC_ADC_PORT, ADC_ATTEN_DB_11);
+  halVdcBegin(); // Configure, characterize, and start streaming (VDC_DMA_ON).
+  buildVdcTable();
+}
 
-  // Characterize ADC
-  adc_chars = (esp_adc_cal_characteristics_t *)calloc(1, sizeof(esp_adc_cal_characteristics_t));
-  esp_adc_cal_value_t val_type = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, DEFAULT_VREF, adc_chars);
+#ifdef VDC_DMA_ON
 
-  if (val_type == ESP_ADC_CAL_VAL_EFUSE_VREF) {
-    Serial.println("ADC eFuse provided Factory Stored Vref Calibration.");      // Best Accuracy.
-  }
-  else if (val_type == ESP_ADC_CAL_VAL_EFUSE_TP) {
-    Serial.println("ADC eFuse provided Factory Stored Two Point Calibration."); // Good Accuracy.
-  }
-  else {
-    Serial.println("ADC eFuse not supported, using Default VRef (1100mV).");    // Low Quality Accuracy.
-  }
+// *********************************************************************************************
+// Reduce a completed block of Welding Volts samples (centivolts) to Avg, Min, Max, and RMS Welding Volts.
+static void publishVdcBlock(uint32_t cnt, uint32_t sum, uint64_t sumSq, uint16_t cvMin, uint16_t cvMax)
+{
+  VdcBlock *blk;
+  uint16_t  avgCv = (uint16_t)((sum + cnt / 2) / cnt);
+
+  portENTER_CRITICAL(&vdcMux);
+  blk          = &vdcRing[(vdcBlockSeq + 1) % VDC_BLOCK_RING];
+  blk->timeUs  = halMicros();
+  blk->samples = cnt;
+  blk->avgCv   = avgCv;
+  blk->minCv   = cvMin;
+  blk->maxCv   = cvMax;
+  blk->rmsCv   = (uint16_t)(sqrtf((float)(sumSq / cnt)) + 0.5f);
+  vdcBlockSeq++;
+  portEXIT_CRITICAL(&vdcMux);
+
+  vdcCvTotal += avgCv;
+  vdcCvCount++;
+}
 
-  /*    if (esp_adc_cal_check_efuse(ESP_ADC_CAL_VAL_EFUSE_TP) == ESP_OK) {
-      printf("ADC eFuse Two Point: Supported\n");
-     } else {
-      printf("ADC eFuse Two Point: NOT supported\n");
-     }
+#endif // ifdef VDC_DMA_ON
 
-     //Check Vref is burned into eFuse
-     if (esp_adc_cal_check_efuse(ESP_ADC_CAL_VAL_EFUSE_VREF) == ESP_OK) {
-       printf("ADC eFuse Vref: Supported\n");
-     } else {
-       printf("ADC eFuse Vref: NOT supported\n");
-     }
-   */
+// *********************************************************************************************
+// Drain the I2S DMA buffers and reduce the Welding Voltage samples into blocks.
+// Called by the Control Task on every tick. Does nothing if VDC_DMA_ON is disabled in config.h.
+void sampleVoltage(void)
+{
+#ifdef VDC_DMA_ON
+  static uint16_t dmaBuff[VDC_DMA_BUF_LEN]; // Copy of DMA samples.
+  static uint32_t blkCnt   = 0;             // Block sample count.
+  static uint32_t blkSum   = 0;             // Block sample totalizer, in centivolts.
+  static uint64_t blkSumSq = 0;             // Block sample squares totalizer.
+  static uint16_t blkMin   = 0xffff;        // Block minimum sample.
+  static uint16_t blkMax   = 0;             // Block maximum sample.
+  size_t   cnt;
+  uint16_t cv;
+
+  do {
+    cnt = halVdcRead(dmaBuff, VDC_DMA_BUF_LEN);
+
+    for (size_t i = 0; i < cnt; i++) {
+      cv        = vdcTable[dmaBuff[i] & 0x0fff]; // Upper 4 bits are the ADC channel number.
+      blkSum   += cv;
+      blkSumSq += (uint32_t)(cv) * cv;
+      blkMin    = cv < blkMin ? cv : blkMin;
+      blkMax    = cv > blkMax ? cv : blkMax;
+
+      if (++blkCnt >= VDC_BLOCK_SIZE) {
+        publishVdcBlock(blkCnt, blkSum, blkSumSq, blkMin, blkMax);
+        blkCnt   = 0;
+        blkSum   = 0;
+        blkSumSq = 0;
+        blkMin   = 0xffff;
+        blkMax   = 0;
+      }
+    }
+  } while (cnt == VDC_DMA_BUF_LEN);
+#endif // ifdef VDC_DMA_ON
 }
 
 // *********************************************************************************************
-// Measure welder Voltage using data averaging.
+// Get a copy of the newest Welding Voltage block.
+// On exit, returns false if streaming is disabled or no block has been completed yet.
+bool getVdcBlock(VdcBlock *blk)
+{
+  bool success = false;
+
+#ifdef VDC_DMA_ON
+  portENTER_CRITICAL(&vdcMux);
+
+  if (vdcBlockSeq != 0) {
+    *blk    = vdcRing[vdcBlockSeq % VDC_BLOCK_RING];
+    success = true;
+  }
+  portEXIT_CRITICAL(&vdcMux);
+#endif // ifdef VDC_DMA_ON
+
+  return success;
+}
+
+// *********************************************************************************************
+// Measure welder Voltage using the fixed-point filters.
 // Be sure to call initVdcAdc() in setup();
+// When VDC_DMA_ON is enabled the input is the mean of the Voltage blocks completed since the last call.
 void measureVoltage(void)
 {
-  static int avgIndex      = 0; // Index of the current Amps reading
-  static uint32_t totalVdc = 0; // Current totalizer for Amps averaging
-  uint32_t voltage;
-  uint32_t reading;
+  static uint32_t sampleCv = 0; // Newest Welding Volts sample, in centivolts.
+  int32_t vdc;
+
+#ifdef VDC_DMA_ON
+  if (vdcCvCount != 0) {        // Otherwise reuse previous sample; No new blocks.
+    sampleCv   = vdcCvTotal / vdcCvCount;
+    vdcCvTotal = 0;
+    vdcCvCount = 0;
+  }
+#else // ifdef VDC_DMA_ON
+  sampleCv = vdcTable[halVdcRaw() & 0x0fff];
+#endif // ifdef VDC_DMA_ON
+
+  voltsFilter.update((int32_t)(sampleCv) * 10);
+
+  fastVoltsCv = voltsFilter.fast() / 10;
+  vdc         = voltsFilter.slow() / 1000; // Convert from mV to VDC.
+  Volts       = constrain(vdc, 0, 99);
+  // Live readings are in the Telemetry stream (TELEMETRY_ON in config.h).
+}
+
+// *********************************************************************************************
+// Get the INA219 acquisition statistics. On entry rst = true to restart the counts; stats may be NULL.
+void getInaStats(InaStats *stats, bool rst)
+{
+  uint32_t ms = halMillis();
+
+  portENTER_CRITICAL(&inaMux);
+  if (stats != NULL) {
+    *stats              = inaStats;
+    stats->sampleHz     = ms - inaStatsMs > 0 ? (uint32_t)((inaStats.samples * 1000ULL) / (ms - inaStatsMs)) : 0;
+    stats->latencyAvgUs = inaStats.samples > 0 ? inaLatencyTotal / inaStats.samples : 0;
+#ifdef INA219_ADAPT_ON
+    stats->modeAvgUs    = inaStats.modeChanges > 0 ? inaModeTotal / inaStats.modeChanges : 0;
+    stats->fastPc       = ms - inaStatsMs > 0 ? (uint32_t)((inaFastMs * 100ULL) / (ms - inaStatsMs)) : 0;
+#endif // ifdef INA219_ADAPT_ON
+  }
 
-  reading = adc1_get_raw(VDC_ADC_PORT);
-  voltage = esp_adc_cal_raw_to_voltage(reading, adc_chars); // Convert to unscaled mV.
+  if (rst) {
+    memset(&inaStats, 0, sizeof(inaStats));
+    inaLatencyTotal = 0;
+    inaStatsMs      = ms;
+#ifdef INA219_ADAPT_ON
+    inaModeTotal = 0;
+    inaFastMs    = 0;
+#endif // ifdef INA219_ADAPT_ON
+  }
+  portEXIT_CRITICAL(&inaMux);
+}
 
-  totalVdc           = totalVdc - eAvgBuff[avgIndex];
-  eAvgBuff[avgIndex] = voltage;
+// *********************************************************************************************
+// Queue the next INA219 read, unless the last one is still busy. With INA219_SYNC_ON this is a Conversion Ready poll,
+// skipped until the next conversion is almost due. Fast mode (INA219_ADAPT_ON) conversions are shorter than
+// MEAS_TIME, so the shunt current is read directly.
+static void queueShuntRead(void)
+{
+  I2cXfer *xfer = &shuntXfer;
+  bool     fast = false;
 
-  totalVdc  = totalVdc + eAvgBuff[avgIndex];
-  avgIndex += 1;
-  avgIndex  = avgIndex >= E_AVG_SIZE ? 0 : avgIndex;
+#ifdef INA219_ADAPT_ON
+  if (applyInaMode()) {
+    return; // Configuration write is queued.
+  }
+  fast       = inaFast;
+  inaFastMs += inaFast ? MEAS_TIME : 0;
+#endif // ifdef INA219_ADAPT_ON
 
-  voltage = totalVdc / E_AVG_SIZE;
-  Volts   = ((float)(voltage) * VDC_SCALE) / 1000.0f; // Apply Attenuator Scaling, covert from mV to VDC.
-  Volts   = constrain(Volts, 0, 99);
-  Volts   = Volts < 5 ? 0 : Volts;                    // Zero values under 5V due to ADC behavior at low levels.
+  if (shuntPending || (shuntXfer.addr == 0)) {
+    return;
+  }
 
-  /* // Debug
-     static int i = 0;
-     if (i++ > 25)
-     {
-      i = 0;
-      Serial.println("total VDC:" + String(totalVdc) + ", Avg Voltage : " + String(voltage) + ", Voltage:" + String(Volts));
-     }
-   */
+#ifdef INA219_SYNC_ON
+  if (fast) {
+    readyUs = halMicros();
+  }
+  else if (halMicros() - readyUs < INA_POLL_HOLDOFF_US) {
+    return;
+  }
+  else {
+    xfer = &readyXfer;
+  }
+#endif // ifdef INA219_SYNC_ON
+
+  shuntPending = true;
+  if (!i2cSubmit(xfer, I2C_PRIO_LOW)) {
+    shuntPending = false;
+  }
 }
 
 // *********************************************************************************************
-// Measure welder current using data averaging.
+// Measure welder current using the fixed-point filters.
+// The INA219 read is queued to the I2C Engine; This uses the newest completed reading (one MEAS_TIME old).
+// With INA219_SYNC_ON the filters are only updated when a new conversion has been read.
 void measureCurrent(void)
 {
-  static int avgIndex          = 0; // Index of the current Amps reading
-  static int totalAmps         = 0; // Current totalizer for Amps averaging
-  float inaAmps                = 0; // INA219 Amps.
-  static unsigned int delayCnt = 0; // Delay counter for INA219 error message.
+  int32_t  inaMa;                    // INA219 current, in mA.
+  int16_t  raw;                      // Newest shunt current register value.
+  uint32_t latencyUs;                // Conversion Ready poll to filter update, in uS.
+  static unsigned int delayCnt = 0;  // Delay counter for INA219 error message.
+  static bool wiringFault = false;   // INA219 wiring error has been logged (Event Log).
 
 
 #ifdef DEMO_MODE
-  Amps = 0; // Zero out welding current when in Demo Mode.
+  Amps     = 0; // Zero out welding current when in Demo Mode.
+  fastAmps = 0;
   return;
 #endif // ifdef DEMO_MODE
 
-  inaAmps = ina219.shuntCurrent(); // Get Current measurement.
-  inaAmps = constrain(inaAmps, -220.0, +220.0);
-  inaAmps = -inaAmps;              // Invert polarity.
+  queueShuntRead();
 
-  //    Serial.println("Shunt current:" + String(inaAmps) + "A");
-  //    Serial.println("Raw shunt vdc:" + String(ina219.shuntVoltageRaw()));
-  //    Serial.println("Shunt vdc:" + String(ina219.shuntVoltage() * 1000) + "mV");
-
-  if ((inaAmps > -3.0) && (inaAmps < 3.0)) { // Noise.
-    inaAmps = 0.0;
+  portENTER_CRITICAL(&inaMux);
+#ifdef INA219_SYNC_ON
+  if (!shuntNew) {
+    portEXIT_CRITICAL(&inaMux);
+    return; // No new conversion; The last one is already in the filters.
+  }
+  shuntNew  = false;
+  latencyUs = halMicros() - readyUs;
+#else // ifdef INA219_SYNC_ON
+  latencyUs = MEAS_TIME * 1000; // The read was queued on the previous call.
+#endif // ifdef INA219_SYNC_ON
+  raw = shuntRaw;
+  inaStats.samples++;
+  inaStats.latencyMaxUs = max(inaStats.latencyMaxUs, latencyUs);
+  inaLatencyTotal      += latencyUs;
+  portEXIT_CRITICAL(&inaMux);
+
+  inaMa = -(((int32_t)(raw) * shuntMaQ8) >> 8); // Newest Current measurement, polarity inverted.
+  inaMa = constrain(inaMa, -AMPS_LIMIT_MA, AMPS_LIMIT_MA);
+
+  // Live readings are in the Telemetry stream (TELEMETRY_ON in config.h). Do not log them here; Serial text logging
+  // from the Control Task upsets its timing.
+
+  if ((inaMa > -AMPS_NOISE_MA) && (inaMa < AMPS_NOISE_MA)) { // Noise.
+    inaMa = 0;
   }
-  else if (inaAmps < 0.0) {                  // Negative amps? The INA219 is missing the shunt resistor or it is wired "backwards."
-    inaAmps  = 0.0;
-    Amps     = 999;                          // Show "Error" value to alert user.
+  else if (inaMa < 0) { // Negative amps? The INA219 is missing the shunt resistor or it is wired "backwards."
+    ampsFilter.reset(0);
+    fastAmps = 0;
+    Amps     = 999;     // Show "Error" value to alert user.
     delayCnt = 0;
 
-    if (delayCnt++ > 50) {                   // Periodically echo error message.
+    if (!wiringFault) {
+      wiringFault = true;
+      evlogEvent(EVT_INA_WIRING, (int16_t)(constrain(inaMa / 100, -9999L, 0L)), 0);
+    }
+
+    if (delayCnt++ > 50) { // Periodically echo error message.
       delayCnt = 0;
       Serial.println("WARNING: INA219 sensor wiring error!");
     }
     return;
   }
+  wiringFault = false;
 
-  totalAmps          = totalAmps - iAvgBuff[avgIndex];
-  iAvgBuff[avgIndex] = (int)(inaAmps); // Store in buffer.
-  totalAmps          = totalAmps + iAvgBuff[avgIndex];
-  avgIndex          += 1;
-  avgIndex           = avgIndex >= I_AVG_SIZE ? 0 : avgIndex;
-  Amps               = totalAmps / I_AVG_SIZE;
+  inaMa = calibrateAmps(inaMa); // Amps calibration table (ampsCal.cpp).
+  ampsFilter.update(inaMa);
+  fastAmps = ampsFilter.fast() / 1000;
+  Amps     = ampsFilter.slow() / 1000;
+}
 
-  //  Serial.println("totalAmps:" + String(totalAmps) + ", Avg Amps : " + String(Amps));
+// *********************************************************************************************
+// Get the Welding Amps control filter output (AMPS_CTRL_SHIFT). Used by the arc features that must react quickly.
+// Updated every MEAS_TIME, or every INA219 conversion (17mS) with INA219_SYNC_ON. The INA219 conversion adds up to
+// 17mS (INA219_AVG_ON) of delay.
+int getFastAmps(void)
+{
+  return fastAmps;
 }
 
 // *********************************************************************************************
-// Clear out the Welding Amps Averaging Buffer.
+// Get the Welding Volts control filter output (VOLTS_CTRL_SHIFT), in centivolts. Updated every MEAS_TIME.
+int getFastVoltsCv(void)
+{
+  return fastVoltsCv;
+}
+
+// *********************************************************************************************
+// Load the Welding Amps filter settings (config.h) and clear the filter.
 void resetCurrentBuffer(void)
 {
-  int i;
+  DualRateCfg cfg;
 
-  for (i = 0; i < I_AVG_SIZE; i++) {
-    iAvgBuff[i] = 0; // Zero out the entire Amps averaging buffer.
-  }
+  cfg.medianN   = AMPS_MEDIAN_N;
+  cfg.fastShift = AMPS_CTRL_SHIFT;
+  cfg.slowShift = AMPS_DISP_SHIFT;
+  ampsFilter.begin(cfg);
 }
 
 // *********************************************************************************************
-// Clear out the Welding Volts Averaging Buffer.
+// Load the Welding Volts filter settings (config.h) and clear the filter.
 void resetVdcBuffer(void)
 {
-  int i;
+  DualRateCfg cfg;
 
-  for (i = 0; i < E_AVG_SIZE; i++) {
-    eAvgBuff[i] = 0; // Zero out the entire VDC averaging buffer.
-  }
+  cfg.medianN   = VOLTS_MEDIAN_N;
+  cfg.fastShift = VOLTS_CTRL_SHIFT;
+  cfg.slowShift = VOLTS_DISP_SHIFT;
+  voltsFilter.begin(cfg);
 }
 
 // EOF
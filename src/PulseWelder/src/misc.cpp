@@ -14,7 +14,6 @@
  */
 
 #include <Arduino.h>
-#include <Wire.h>
 #include "digPot.h"
 #include "PulseWelder.h"
 #include "config.h"
@@ -28,91 +27,14 @@ extern XT_Wav_Class overHeatMsg;
 extern XT_Wav_Class promoMsg;
 
 // Global System vars
-extern int  Amps;            // Live Welding Current.
+extern volatile int Amps;   // Live Welding Current.
 extern byte arcSwitch;       // Welding Arc On/Off Switch.
 extern int  buttonClick;     // Bluetooth iTAG FOB Button click type, single or double click.
 extern int  fobClick;        // Bluetooth FOB Button Click Value.
 extern bool overTempAlert;   // Over Temperature (OC) Alert.
 extern bool newFobClick;     // Bluetooth FOB Button, new click.
-extern byte pulseAmpsPc;     // Arc modulation Background Current (%) for Pulse mode.
-extern byte pulseFreqX10;    // Pulse Frequency times ten.
-extern bool pulseState;      // Arc Pulse modulation state (on/off).
 extern byte spkrVolSwitch;   // Audio Volume, five levels.
 extern byte setAmps;         // Default Welding Amps *User Setting*.
-extern byte pulseSwitch;     // Pulse Mode On/Off Flag. Pseudo Boolean; byte declared for EEPROM.
-
-// *********************************************************************************************
-// Check Welder's OC Led signal for alert condition. Could be over-heat or over-current state.
-void checkForAlerts(void)
-{
-    overTempAlert = !digitalRead(OC_PIN); // Get OC Warning LED State.
-    if(overTempAlert) {
-        arcSwitch = ARC_OFF;
-        disableArc(VERBOSE_OFF);         // Disable Arc current.
-    }
-}
-
-// *********************************************************************************************
-// Control Welding Arc Current.
-// state = ARC_ON or ARC_OFF
-// verbose = VERBOSE_ON (true) for expanded log messages, else VERBOSE_OFF (false) for less messages.
-void controlArc(bool state, bool verbose)
-{
-  if (state == ARC_ON)
-  {
-    enableArc(verbose);
-  }
-  else
-  {
-    disableArc(verbose);
-  }
-}
-
-// *********************************************************************************************
-// Disable the Arc current.
-// verbose = VERBOSE_ON (true) for expanded log messages, else VERBOSE_OFF (false) for less messages.
-// PWM Shutdown control option requires hardware mod; Lift SG3525A pin 10, connect it
-// to ESP32's SHDN_PIN (default is GPIO15)
-void disableArc(bool verbose)
-{
-  arcSwitch = ARC_OFF;
-
-  setPotAmps(ARC_OFF_AMPS, verbose); // Set Digital Pot to lowest welding current.
-
-  #ifdef PWM_ARC_CTRL
-   digitalWrite(SHDN_PIN, PWM_OFF);  // Disable PWM Controller.
-   if (verbose == VERBOSE_ON) {
-     Serial.println("Arc Current Turned Off (Disabled PWM Controller).");
-   }
-  #else
-   digitalWrite(SHDN_PIN, PWM_ON); // PWM feature disabled by config.h; Don't shutdown!
-   if (verbose == VERBOSE_ON) {
-     Serial.println("Arc Current Suppressed (Reduced to " + String(ARC_OFF_AMPS) + " Amps).");
-   }
-  #endif
-}
-
-// *********************************************************************************************
-// Enable the Arc current.
-// verbose = VERBOSE_ON (true) for expanded log messages, else VERBOSE_OFF (false) for less messages.
-// PWM Shutdown control option requires hardware mod; Lift SG3525A pin 10, connect ot
-// to ESP32's SHDN_PIN (default is GPIO15)
-void enableArc(bool verbose)
-{
-    if(overTempAlert) {
-        if (verbose == VERBOSE_ON) {
-            Serial.println("Arc Current Cannot be Turned On (Alarm State!)");
-        }
-    }
-    else {
-        arcSwitch = ARC_ON;
-        setPotAmps(setAmps, verbose); // Refresh Digital Pot.
-        digitalWrite(SHDN_PIN,PWM_ON);
-        if (verbose == VERBOSE_ON) {
-            Serial.println("Arc Current Turned On (" + String(setAmps) + " Amps).");
-        }
-    }
-}
 
 // *********************************************************************************************
 // Get the iTAG FOB Button Click value.
@@ -189,73 +111,47 @@ void remoteControl(void)
 
         Serial.println(String((setAmps/100) % 10) + "-" + String((setAmps/10) % 10) + "-" + String(setAmps % 10));
 
-        setPotAmps(setAmps, VERBOSE_ON);           // Refresh Digital Pot.
+        setPotAmps(outputAmps(setAmps), VERBOSE_ON); // Refresh Digital Pot.
         spkr.addDigitSounds(setAmps);
         spkr.playSoundList();
     }
   }
 }
 
-
 // *********************************************************************************************
-// Get PulseFreq in Hz as float value.
-float PulseFreqHz(void)
+// Read the Serial Log port for commands (newline terminated). Called from loop().
+// Commands are passed to each handler until one accepts it.
+void processSerialCmds(void)
 {
-  float freq;
-
-  pulseFreqX10 = constrain(pulseFreqX10, MIN_PULSE_FRQ_X10, MAX_PULSE_FRQ_X10);
-  freq         = (float)(pulseFreqX10);
-  freq         = freq / 10.0;
-
-  return freq;
-}
+  static char cmdBuf[SERIAL_CMD_LEN + 1]; // Command line being received.
+  static int  cmdLen = 0;
+  String cmd;
+  int    c;
+
+  while (Serial.available() > 0) {
+    c = Serial.read();
+
+    if ((c != '\n') && (c != '\r')) {
+      if (cmdLen < SERIAL_CMD_LEN) {
+        cmdBuf[cmdLen++] = (char)(c);
+      }
+      continue;
+    }
 
-// *********************************************************************************************
-// Modulate the Welding Arc Current if Pulse Mode is Enabled.
-// Modulation freq is provided by PulseFreqHz() function (user's pulse frequency setting).
-// Pulse current is a percentage of Normal current (user setting pulseAmpsPc).
-// If measured rod arc current is too low the modulation is postponed (normal current is used).
-// On new rod strikes the pulse modulation is delayed to allow the arc to fully ignite.
-void pulseModulation(void)
-{
-  int ampVal;
-  static long previousMillis = 0;
-  static long arcTimer = 0;
-  float period               = 0; // Pulse period.
+    cmdBuf[cmdLen] = 0;
+    cmd            = String(cmdBuf);
+    cmdLen         = 0;
+    cmd.trim();
+    cmd.toLowerCase();
 
-  if (arcSwitch == ARC_ON && pulseSwitch == PULSE_OFF) { // Pulse mode is disabled.
-    if (millis() > previousMillis + 500) {               // Refresh Digital POT every 0.5Sec.
-        previousMillis = millis();
-        arcTimer = millis();
-        setPotAmps(setAmps, VERBOSE_OFF);
+    if (cmd.length() == 0) {
+      continue;
     }
-    pulseState = false;                      // Pulsed current is Off.
-  }
-  else if (arcSwitch == ARC_ON) {
-    period = (1.0 / PulseFreqHz()) / 0.002;  // Convert freq to mS/2.
-    // Serial.println("mS: " + String(period)); // Debug
-
-    if (millis() > previousMillis + (long)(period)) {
-        previousMillis = millis();
-        pulseState = !pulseState;
-        drawPulseLightning();                // Update the Pulse Arc icon.
-        if(Amps < PULSE_AMPS_THRS) {         // Current too low, don't pulse modulate current.
-            arcTimer = millis();
-            setPotAmps(setAmps, VERBOSE_OFF);
-        }
-        else if(millis() > arcTimer+ ARC_STABLIZE_TM) { // Arc should be stabilized, OK to modulate.
-           if(pulseState == PULSE_ON) {      // Pulsed welding current cycle.
-                ampVal = (int)(setAmps) * pulseAmpsPc / 100; // Modulated with Pulse Current (%) Setting.
-                ampVal = constrain(ampVal, MIN_SET_AMPS, MAX_SET_AMPS);
-                setPotAmps((byte)(ampVal), VERBOSE_OFF);
-            }
-            else {                           // Normal welding current cycle.
-                setPotAmps(setAmps, VERBOSE_OFF);
-            }
-        }
+    else if (!recorderCmd(cmd) && !ampsCalCmd(cmd) && !potSweepCmd(cmd) &&
+             !thermalCmd(cmd) && !eventLogCmd(cmd) && !screenCmd(cmd)) {
+      Serial.println("Unknown Serial Command: " + cmd);
     }
   }
-//  Serial.println("Amps: " + String(setAmps) + ", bg: " + String(ampVal));  // Debug.
 }
 
 // *********************************************************************************************
@@ -0,0 +1,324 @@
+/*
+   File: potSweep.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Digital Pot characterization. The welder's current is not linear with the Pot Wiper, so the compile-time table
+      in digPot.cpp can be several Amps off the Amps setting. The sweep steps the Wiper through POT_SWEEP_POINTS codes,
+      waits POT_SWEEP_SETTLE_MS, and averages the (calibrated) Amps for POT_SWEEP_AVG_MS at each code.
+   2. The results are saved in E2Prom. An inverse (Amps to Wiper) table is built from them with pwlTable.cpp, then
+      expanded to one Wiper value per Amps setting for setPotAmps() (setPotTable()). Steps that do not raise the
+      current (noise, or the welder's upper limit) are skipped, so the table is always monotonic.
+   3. Start it with the "pot sweep" serial command while welding on a load bank (or a long arc), Pulse mode off.
+      It is aborted if the arc goes out, the rod sticks, or welding is stopped; The previous table is kept.
+   4. The Closed-Loop Current Regulator is held at zero trim during the sweep (control.cpp).
+   5. The sweep and the table build can be checked on a PC, see runPotSweepTest() in weldSim.cpp.
+   6. The held Wiper is limited by setPotAmps() (outputLimitAmps()): Anti-Stick and the Arc off cut it at once, from
+      the Control Task. When MAX_SET_AMPS or thermal derating holds it below a step, the sweep ends there; The
+      remaining steps are recorded at the last measured current (skipped by the table build).
+   7. The E2Prom commit waits until the arc is out (flash writes stall the Control Task).
+ */
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "PulseWelder.h"
+#include "arcState.h"
+#include "pwlTable.h"
+#include "config.h"
+
+#define SWEEP_VERSION 1 // Pot characterization record layout version.
+
+static_assert(sizeof(PotSweepRec) == POT_SWEEP_REC_SIZE, "POT_SWEEP_REC_SIZE does not match PotSweepRec.");
+static_assert(CAL_ADDR + CAL_REC_SIZE <= POT_SWEEP_ADDR, "Pot characterization overlaps the Amps calibration.");
+static_assert(POT_SWEEP_ADDR + POT_SWEEP_REC_SIZE <= THERMAL_ADDR, "Pot characterization overlaps the thermal data.");
+static_assert(POT_SWEEP_POINTS < PWL_MAX_POINTS, "POT_SWEEP_POINTS does not fit a PwlTable.");
+
+// Global Vars
+extern volatile int Amps; // Live Welding Current.
+extern byte arcSwitch;    // Welding Arc On/Off Switch.
+extern byte pulseSwitch;  // Pulse Mode On/Off Flag.
+extern byte setAmps;      // Welding Amps *User Setting*.
+
+enum SweepState {
+  SWEEP_IDLE,
+  SWEEP_SETTLE,
+  SWEEP_MEASURE
+};
+
+// Local Scope Vars
+static PotSweepRec   sweepRec;                              // Saved sweep results (loop() only).
+static PotSweepRec   newRec;                                // Sweep in progress.
+static byte          sweepWiper[MAX_SET_AMPS - MIN_AMPS + 1]; // Amps to Wiper table used by setPotAmps().
+static volatile bool sweeping    = false;                   // Sweep is running.
+static SweepState    sweepState  = SWEEP_IDLE;              // Sweep step state.
+static int           sweepStep   = 0;                       // Wiper step being measured.
+static unsigned long sweepMillis = 0;                       // Start time of the step state, in mS.
+static long          ampsSum     = 0;                       // Amps total of the step.
+static long          ampsCnt     = 0;                       // Amps reading count of the step.
+static bool          sweepDirty  = false;                   // Results changed, E2Prom commit is pending.
+static unsigned long dirtyMillis = 0;                       // Time of the change, in mS.
+
+// *********************************************************************************************
+// On exit, returns the Wiper code of a sweep step.
+static int stepWiper(int step)
+{
+  return (step * 0xff) / (POT_SWEEP_POINTS - 1);
+}
+
+// *********************************************************************************************
+// On exit, returns the checksum of the sweep record (all bytes except the checksum).
+static uint8_t sweepCheck(const PotSweepRec& rec)
+{
+  const uint8_t *data = (const uint8_t *)(&rec);
+  uint8_t sum = 0x5a;
+
+  for (size_t i = 0; i < offsetof(PotSweepRec, check); i++) {
+    sum = (sum << 1 | sum >> 7) ^ data[i];
+  }
+
+  return sum;
+}
+
+// *********************************************************************************************
+// Build the Amps to Wiper table from the sweep results and select it. Uncharacterized results select the
+// compile-time (linear) table.
+// On exit, returns false if the results are missing or could not be used.
+static bool buildPotTable(const PotSweepRec& rec)
+{
+  PwlTable inverse;
+  int32_t  xs[POT_SWEEP_POINTS];
+  int32_t  ys[POT_SWEEP_POINTS];
+  int32_t  wiper;
+
+  for (int i = 0; i < POT_SWEEP_POINTS; i++) {
+    if (rec.ampsX10[i] == 0) {
+      setPotTable(NULL);
+      return false;
+    }
+    xs[i] = stepWiper(i) << 8;   // Wiper, 8 fraction bits.
+    ys[i] = rec.ampsX10[i] * 100; // 0.1A to mA.
+  }
+
+  if (!inverse.loadInverse(xs, ys, POT_SWEEP_POINTS)) {
+    setPotTable(NULL);
+    return false;
+  }
+
+  setPotTable(NULL); // Control Task uses the compile-time table while sweepWiper[] is rebuilt.
+
+  for (int amps = MIN_AMPS; amps <= MAX_SET_AMPS; amps++) {
+    wiper                       = (inverse.lookup(amps * 1000) + 0x80) >> 8;
+    sweepWiper[amps - MIN_AMPS] = (byte)(constrain(wiper, (int32_t)(0x00), (int32_t)(0xff)));
+  }
+  setPotTable(sweepWiper);
+
+  return true;
+}
+
+// *********************************************************************************************
+// Save the sweep results to E2Prom (after EEP_DELAY_TIME).
+static void saveSweepRec(const PotSweepRec& rec)
+{
+  sweepRec         = rec;
+  sweepRec.version = SWEEP_VERSION;
+  sweepRec.check   = sweepCheck(sweepRec);
+  EEPROM.put(POT_SWEEP_ADDR, sweepRec);
+  sweepDirty  = true;
+  dirtyMillis = millis();
+}
+
+// *********************************************************************************************
+// End the sweep and return the Pot to the Amps setting.
+static void endPotSweep(const String& msg)
+{
+  sweeping   = false;
+  sweepState = SWEEP_IDLE;
+  setPotOverride(-1);
+  setPotAmps(outputAmps(setAmps), VERBOSE_ON);
+  Serial.println("Pot Characterization: " + msg);
+}
+
+// *********************************************************************************************
+// Build the table from the completed sweep and end it. On failure the previous table is restored.
+static void finishPotSweep(void)
+{
+  if (buildPotTable(newRec)) {
+    saveSweepRec(newRec);
+    endPotSweep("Complete, using the measured Amps to Wiper table.");
+  }
+  else {
+    buildPotTable(sweepRec); // Restore the previous table.
+    endPotSweep("Failed, the current did not rise with the Wiper.");
+  }
+}
+
+// *********************************************************************************************
+// Load the Pot characterization. Call from setup() after EEPROM.begin().
+// On entry erase = true to clear the characterization (virgin EEPROM).
+void initPotSweep(bool erase)
+{
+  EEPROM.get(POT_SWEEP_ADDR, sweepRec);
+
+  if (erase || (sweepRec.version != SWEEP_VERSION) || (sweepRec.check != sweepCheck(sweepRec))) {
+    memset(&sweepRec, 0, sizeof(sweepRec));
+    sweepRec.version = SWEEP_VERSION;
+    sweepRec.check   = sweepCheck(sweepRec);
+    EEPROM.put(POT_SWEEP_ADDR, sweepRec);
+    EEPROM.commit();
+  }
+
+  Serial.println(buildPotTable(sweepRec) ? "Pot Characterization: Using the measured Amps to Wiper table." :
+                 "Pot Characterization: None, using the linear Amps to Wiper table.");
+}
+
+// *********************************************************************************************
+// Start the Pot characterization sweep. The welder must be welding on a load bank (or a long arc), Pulse mode off.
+// On exit, returns false if the sweep could not be started.
+bool startPotSweep(void)
+{
+  if (sweeping || (arcSwitch != ARC_ON) || (pulseSwitch != PULSE_OFF)) {
+    return false;
+  }
+
+  memset(&newRec, 0, sizeof(newRec));
+  sweepStep   = 0;
+  sweepState  = SWEEP_SETTLE;
+  sweepMillis = millis();
+  sweeping    = true;
+  setPotOverride(stepWiper(sweepStep));
+  setPotAmps(outputAmps(setAmps), VERBOSE_OFF); // Write the held Wiper.
+  Serial.println("Pot Characterization: Started, " + String(POT_SWEEP_POINTS) + " steps.");
+
+  return true;
+}
+
+// *********************************************************************************************
+// On exit, returns true if the Pot characterization sweep is running.
+bool isPotSweeping(void)
+{
+  return sweeping;
+}
+
+// *********************************************************************************************
+// Run the Pot characterization sweep and commit its results. Called from loop().
+void processPotSweep(void)
+{
+  int wiper = getPotWiper();
+
+  if (sweepState != SWEEP_IDLE) {
+    if ((arcSwitch != ARC_ON) || (pulseSwitch != PULSE_OFF)) {
+      endPotSweep("Aborted, welding was stopped.");
+    }
+    else if ((getArcState() == ARC_ST_STUCK) || (outputLimitAmps() <= ARC_OFF_AMPS)) {
+      endPotSweep("Aborted, stuck rod at Wiper 0x" + String(stepWiper(sweepStep), HEX) + ".");
+    }
+    else if ((sweepStep > 0) && (wiper >= 0) && (wiper < stepWiper(sweepStep))) { // Held below the step.
+      Serial.println("Pot Characterization: Amps limit (MAX_SET_AMPS or derating) at Wiper 0x" + String(wiper, HEX) +
+                     ".");
+
+      for (int i = sweepStep; i < POT_SWEEP_POINTS; i++) {
+        newRec.ampsX10[i] = newRec.ampsX10[sweepStep - 1];
+      }
+      finishPotSweep();
+    }
+    else if (sweepState == SWEEP_SETTLE) {
+      if (millis() - sweepMillis >= POT_SWEEP_SETTLE_MS) {
+        sweepState  = SWEEP_MEASURE;
+        sweepMillis = millis();
+        ampsSum     = 0;
+        ampsCnt     = 0;
+      }
+    }
+    else if (!arcEstablished(getArcState()) || (Amps == 999)) {
+      endPotSweep("Aborted, no arc at Wiper 0x" + String(stepWiper(sweepStep), HEX) + ".");
+    }
+    else {
+      ampsSum += Amps;
+      ampsCnt++;
+
+      if (millis() - sweepMillis >= POT_SWEEP_AVG_MS) {
+        newRec.ampsX10[sweepStep] = (uint16_t)(constrain((ampsSum * 10 + ampsCnt / 2) / ampsCnt, 1L, 9999L));
+        Serial.println(" Wiper 0x" + String(stepWiper(sweepStep), HEX) + ": " +
+                       String(newRec.ampsX10[sweepStep] / 10.0f, 1) + "A.");
+
+        if (++sweepStep < POT_SWEEP_POINTS) {
+          sweepState  = SWEEP_SETTLE;
+          sweepMillis = millis();
+          setPotOverride(stepWiper(sweepStep));
+          setPotAmps(outputAmps(setAmps), VERBOSE_OFF);
+        }
+        else {
+          finishPotSweep();
+        }
+      }
+    }
+  }
+
+  if (sweepDirty && (millis() - dirtyMillis >= EEP_DELAY_TIME) && !arcBurning(getArcState())) {
+    sweepDirty = false;
+    EEPROM.commit();
+    Serial.println("Pot Characterization saved.");
+  }
+}
+
+// *********************************************************************************************
+// Pot Characterization serial commands: pot sweep, pot stop, pot list, pot clear.
+// On exit, returns false if cmd is not a Pot Characterization command.
+bool potSweepCmd(const String& cmd)
+{
+  PotSweepRec rec;
+
+  if (!cmd.startsWith("pot")) {
+    return false;
+  }
+
+  if (cmd == "pot sweep") {
+    if (!startPotSweep()) {
+      Serial.println("# error: sweep is running, or the Arc is off or Pulse mode is on");
+    }
+  }
+  else if (cmd == "pot stop") {
+    if (sweeping) {
+      buildPotTable(sweepRec);
+      endPotSweep("Stopped.");
+    }
+  }
+  else if (cmd == "pot list") {
+    if (sweepRec.ampsX10[0] == 0) {
+      Serial.println("Pot Characterization: None, using the linear Amps to Wiper table.");
+    }
+    else {
+      for (int i = 0; i < POT_SWEEP_POINTS; i++) {
+        Serial.println(" Wiper 0x" + String(stepWiper(i), HEX) + ": " + String(sweepRec.ampsX10[i] / 10.0f, 1) + "A.");
+      }
+
+      for (int amps = MIN_AMPS; amps <= MAX_SET_AMPS; amps += 10) {
+        Serial.println(" " + String(amps) + "A: Wiper 0x" + String(sweepWiper[amps - MIN_AMPS], HEX) + ".");
+      }
+    }
+  }
+  else if (cmd == "pot clear") {
+    if (!sweeping) {
+      memset(&rec, 0, sizeof(rec));
+      saveSweepRec(rec);
+      buildPotTable(sweepRec);
+      Serial.println("Pot Characterization: Cleared, using the linear Amps to Wiper table.");
+    }
+  }
+  else {
+    Serial.println("Pot Characterization Commands: pot sweep, pot stop, pot list, pot clear.");
+  }
+
+  return true;
+}
+
+// EOF
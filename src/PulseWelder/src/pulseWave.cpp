@@ -0,0 +1,297 @@
+/*
+   File: pulseWave.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Pulse Waveform tables, built by the compiler. Each table is one pulse period of PULSE_TABLE_SIZE levels.
+      Level PULSE_LEVEL_MAX is the Amps setting, level zero is the Pulse background current (pulseAmpsPc).
+   2. Every waveform starts with the rising part of the period, the same as the original square wave.
+      Square: Amps setting for the first half period, background for the second half.
+      Trapezoid: Same as square, with linear ramps (PULSE_RAMP_PC of the period, see config.h) on both edges.
+      Sine: Peak at one quarter period, minimum at three quarters.
+      Sawtooth: Steps up to the Amps setting at the start of the period, then ramps down to background.
+   3. Pulse modulation (pulseModulation()) is run by the Control Task. It uses the Hardware Abstraction Layer (hal.h)
+      timer, so it also runs in the PC simulator (ctrlSim.cpp).
+   4. Edge timing: The phase accumulator gives the exact pulse period, but the Control Task only updates every
+      1 / PULSE_UPDATE_HZ. When the next table entry changes the level before the next update, its exact time is
+      computed from the phase and the Pot is written by the Pulse edge timer (halPulseTimerStart()). Square wave
+      edges, the Sawtooth step, and the Trapezoid ramp starts land within the timer latency (tens of uS), not on the
+      1mS tick grid, so the duty cycle is not quantized. Level changes after the first one in an update period (the
+      Sine and ramp slopes at high frequencies) still use the tick.
+ */
+
+#include <Arduino.h>
+#include "hal.h"
+#include "PulseWelder.h"
+#include "config.h"
+
+#define WAVE_HALF (PULSE_TABLE_SIZE / 2)                           // Table entries per half period.
+#define WAVE_RAMP ((PULSE_TABLE_SIZE * PULSE_RAMP_PC + 50) / 100) // Table entries per Trapezoid ramp.
+#define WAVE_PI 3.14159265358979
+
+// Global System vars
+extern byte arcSwitch;           // Welding Arc On/Off Switch.
+extern byte pulseAmpsPc;         // Arc modulation Background Current (%) for Pulse mode.
+extern byte pulseFreqX10;        // Pulse Frequency times ten.
+extern byte pulseSwitch;         // Pulse Mode On/Off Flag. Pseudo Boolean; byte declared for EEPROM.
+extern byte pulseWave;           // Pulse waveform.
+extern volatile bool pulseState; // Arc Pulse modulation state (on/off).
+extern byte setAmps;             // Default Welding Amps *User Setting*.
+
+// Local Scope Vars
+static volatile bool pulseIconFlag = false; // Pulse Arc icon needs redraw (set by Control Task).
+static volatile bool pulseArcStable = false; // Arc is established (Arc State event).
+static volatile uint32_t pulsePhase = 0;     // Pulse waveform phase, one period is 2^32.
+static volatile bool edgeArmed = false;      // Pulse edge timer is set for edgeLevel.
+static volatile byte edgeLevel = 0;          // Waveform level written by the Pulse edge timer.
+
+// *********************************************************************************************
+// Compile-time cosine (Taylor series). Accurate to better than 1 part in 10^6 for -PI <= x <= PI.
+constexpr double waveCosSum(double x2, double term, double sum, int k)
+{
+  return k >= 12 ? sum : waveCosSum(x2, -term * x2 / ((2 * k + 1) * (2 * k + 2)),
+                                    sum - term * x2 / ((2 * k + 1) * (2 * k + 2)), k + 1);
+}
+
+constexpr double waveCos(double x)
+{
+  return waveCosSum(x * x, 1.0, 1.0, 0);
+}
+
+// *********************************************************************************************
+// Waveform levels for table entry idx (0 to PULSE_TABLE_SIZE - 1).
+constexpr byte squareLevel(int idx)
+{
+  return idx < WAVE_HALF ? PULSE_LEVEL_MAX : 0;
+}
+
+constexpr byte trapezoidLevel(int idx)
+{
+  return idx < WAVE_RAMP ? (byte)((PULSE_LEVEL_MAX * (idx + 1L)) / (WAVE_RAMP + 1)) :
+         idx < WAVE_HALF ? PULSE_LEVEL_MAX :
+         idx < WAVE_HALF + WAVE_RAMP ? (byte)(PULSE_LEVEL_MAX - (PULSE_LEVEL_MAX * (idx - WAVE_HALF + 1L)) / (WAVE_RAMP + 1)) :
+         0;
+}
+
+constexpr double sineAngle(int idx)
+{
+  return 2.0 * WAVE_PI * ((idx - PULSE_TABLE_SIZE / 4 + PULSE_TABLE_SIZE) % PULSE_TABLE_SIZE) / PULSE_TABLE_SIZE;
+}
+
+constexpr byte sineLevel(int idx)
+{
+  return (byte)((PULSE_LEVEL_MAX / 2.0) *
+                (1.0 + waveCos(sineAngle(idx) > WAVE_PI ? sineAngle(idx) - 2.0 * WAVE_PI : sineAngle(idx))) + 0.5);
+}
+
+constexpr byte sawtoothLevel(int idx)
+{
+  return (byte)(PULSE_LEVEL_MAX - (PULSE_LEVEL_MAX * (long)(idx)) / (PULSE_TABLE_SIZE - 1));
+}
+
+// *********************************************************************************************
+// Waveform lookup table, indexed by [wave][entry]. Built at compile time.
+template<int... Idx>
+struct WaveTable {
+  static const byte level[PULSE_WAVE_CNT][sizeof...(Idx)];
+};
+
+template<int... Idx>
+const byte WaveTable<Idx...>::level[PULSE_WAVE_CNT][sizeof...(Idx)] = {
+  { squareLevel(Idx)... },
+  { trapezoidLevel(Idx)... },
+  { sineLevel(Idx)... },
+  { sawtoothLevel(Idx)... }
+};
+
+template<int Cnt, int... Idx>
+struct MakeWaveTable : MakeWaveTable<Cnt - 1, Cnt - 1, Idx...> {};
+
+template<int... Idx>
+struct MakeWaveTable<0, Idx...> {
+  typedef WaveTable<Idx...> table;
+};
+
+typedef MakeWaveTable<PULSE_TABLE_SIZE>::table PulseWaveTable;
+
+static_assert(PULSE_WAVE_CNT == 4, "Pulse waveform table and PULSE_WAVE_CNT do not match.");
+static_assert(sineLevel(PULSE_TABLE_SIZE / 4) == PULSE_LEVEL_MAX, "Sine table must peak at one quarter period.");
+static_assert(sineLevel(3 * PULSE_TABLE_SIZE / 4) == 0, "Sine table minimum must be at three quarters period.");
+static_assert(trapezoidLevel(WAVE_HALF - 1) == PULSE_LEVEL_MAX, "Trapezoid ramp is too long.");
+
+// *********************************************************************************************
+// Get the waveform level for table entry idx.
+// On exit, returns 0 (background current) to PULSE_LEVEL_MAX (Amps setting).
+byte pulseWaveLevel(byte wave, int idx)
+{
+  if (wave >= PULSE_WAVE_CNT) {
+    wave = PULSE_WAVE_SQUARE;
+  }
+
+  return PulseWaveTable::level[wave][idx & (PULSE_TABLE_SIZE - 1)];
+}
+
+// *********************************************************************************************
+// On exit, returns the waveform's display name.
+const char *pulseWaveName(byte wave)
+{
+  switch (wave) {
+    case PULSE_WAVE_TRAP:
+      return "Trapezoid";
+
+    case PULSE_WAVE_SINE:
+      return "Sine";
+
+    case PULSE_WAVE_SAW:
+      return "Sawtooth";
+
+    default:
+      return "Square";
+  }
+}
+
+// *********************************************************************************************
+// Get PulseFreq in Hz as float value.
+float PulseFreqHz(void)
+{
+  float freq;
+
+  pulseFreqX10 = constrain(pulseFreqX10, MIN_PULSE_FRQ_X10, MAX_PULSE_FRQ_X10);
+  freq         = (float)(pulseFreqX10);
+  freq         = freq / 10.0;
+
+  return freq;
+}
+
+// *********************************************************************************************
+// On exit, returns the Amps for a waveform level, between the background current and the Amps setting.
+static int pulseLevelAmps(byte level)
+{
+  int bgAmps;
+
+  bgAmps = (int)(setAmps) * pulseAmpsPc / 100; // Background current, Pulse Current (%) Setting.
+  bgAmps = constrain(bgAmps, MIN_SET_AMPS, MAX_SET_AMPS);
+
+  return bgAmps + ((((int)(setAmps) - bgAmps) * level) + (PULSE_LEVEL_MAX / 2)) / PULSE_LEVEL_MAX;
+}
+
+// *********************************************************************************************
+// Pulse edge timer callback: Write the level of the waveform edge between Control Task updates.
+// Runs in the esp_timer task. Ignored if the next update has already run, or modulation has stopped.
+static void pulseEdge(void)
+{
+  if (edgeArmed && (arcSwitch == ARC_ON) && (pulseSwitch != PULSE_OFF) && pulseArcStable) {
+    edgeArmed = false;
+    setPotAmps(outputAmps((byte)(pulseLevelAmps(edgeLevel))), VERBOSE_OFF);
+  }
+}
+
+// *********************************************************************************************
+// Create the Pulse edge timer. Called once by initControlTask().
+void initPulseWave(void)
+{
+  halPulseTimerBegin(pulseEdge);
+}
+
+// *********************************************************************************************
+// Modulate the Welding Arc Current if Pulse Mode is Enabled.
+// This is called by the Control Task at PULSE_UPDATE_HZ. Do not draw on the TFT here; see refreshPulseIcon().
+// Modulation freq is provided by PulseFreqHz() function (user's pulse frequency setting).
+// Pulse current follows the selected waveform table (pulseWave) between the Normal current and a percentage of it
+// (user setting pulseAmpsPc). The table position is a phase accumulator that is advanced on every update, so the
+// pulse period is exact. A level change before the next update is timed by the Pulse edge timer (see Notes).
+// If the arc is not established the modulation is postponed (normal current is used).
+// The arc features and Closed-Loop Regulator trim (if enabled) are applied to all pulse levels, see outputAmps().
+// On new rod strikes the pulse modulation is delayed to allow the arc to fully ignite.
+void pulseModulation(void)
+{
+  byte  level;
+  byte  nextLevel;
+  bool  lowLevel;
+  uint32_t toEdge;
+  static long previousMillis = 0;
+  static long arcTimer       = 0;
+  static uint32_t phaseInc   = 0; // Phase change per update.
+  static byte     incFreqX10 = 0; // Pulse frequency used for phaseInc.
+
+  edgeArmed = false; // This update writes the present level.
+
+  if (arcSwitch == ARC_ON && pulseSwitch == PULSE_OFF) { // Pulse mode is disabled.
+    if (halMillis() > previousMillis + 500) {               // Refresh Digital POT every 0.5Sec (written only if changed).
+        previousMillis = halMillis();
+        arcTimer = halMillis();
+        setPotAmps(outputAmps(setAmps), VERBOSE_OFF);
+    }
+    pulseState = false;                      // Pulsed current is Off.
+    pulsePhase = 0;
+  }
+  else if (arcSwitch == ARC_ON) {
+    if (incFreqX10 != pulseFreqX10) {        // Frequency setting changed.
+        incFreqX10 = pulseFreqX10;
+        phaseInc   = (uint32_t)(((uint64_t)(incFreqX10) << 32) / (10ULL * PULSE_UPDATE_HZ));
+    }
+
+    pulsePhase += phaseInc;
+    level       = pulseWaveLevel(pulseWave, pulsePhase >> (32 - PULSE_TABLE_BITS));
+    lowLevel    = level <= PULSE_LEVEL_MAX / 2;
+
+    if (lowLevel != pulseState) {
+        pulseState    = lowLevel;
+        pulseIconFlag = true;                // Request Pulse Arc icon update, see refreshPulseIcon().
+        inaFastWindow();                     // Fast INA219 conversions while the current changes.
+    }
+
+    if(!pulseArcStable) {                    // Arc not established, don't pulse modulate current.
+        arcTimer = halMillis();
+        setPotAmps(outputAmps(setAmps), VERBOSE_OFF);
+    }
+    else if(halMillis() > arcTimer+ ARC_STABLIZE_TM) { // Arc should be stabilized, OK to modulate.
+        setPotAmps(outputAmps((byte)(pulseLevelAmps(level))), VERBOSE_OFF); // Pot is only written if the value changed.
+
+        // Phase to the next table entry (wraps at the end of the period). Time it if it changes the level first.
+        toEdge    = ((uint32_t)((pulsePhase >> (32 - PULSE_TABLE_BITS)) + 1) << (32 - PULSE_TABLE_BITS)) - pulsePhase;
+        nextLevel = pulseWaveLevel(pulseWave, (pulsePhase >> (32 - PULSE_TABLE_BITS)) + 1);
+
+        if ((toEdge < phaseInc) && (nextLevel != level)) {
+            edgeLevel = nextLevel;
+            edgeArmed = true;
+            halPulseTimerStart((uint32_t)(((uint64_t)(toEdge) * (1000000UL / PULSE_UPDATE_HZ)) / phaseInc));
+        }
+    }
+  }
+}
+
+// *********************************************************************************************
+// On exit, returns the Pulse waveform phase, 0-255 is one pulse period (zero if Pulse mode is off).
+byte getPulsePhase(void)
+{
+  return (byte)(pulsePhase >> 24);
+}
+
+// *********************************************************************************************
+// Arc State change subscriber for Pulse modulation. Called by the Control Task.
+void pulseArcEvent(const ArcEvent& evt)
+{
+  pulseArcStable = arcEstablished(evt.state);
+}
+
+// *********************************************************************************************
+// Redraw the Pulse lightning icon if the pulse state has changed. Called from loop().
+void refreshPulseIcon(void)
+{
+  if (pulseIconFlag) {
+    pulseIconFlag = false;
+    drawPulseLightning();
+  }
+}
+
+// EOF
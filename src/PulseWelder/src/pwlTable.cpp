@@ -0,0 +1,132 @@
+/*
+   File: pwlTable.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+ */
+
+#include "pwlTable.h"
+
+// *********************************************************************************************
+PwlTable::PwlTable(void)
+{
+  clear();
+}
+
+// *********************************************************************************************
+// Empty the table (y = x).
+void PwlTable::clear(void)
+{
+  size = 0;
+}
+
+// *********************************************************************************************
+// Load count points. The table is unchanged if the points are not monotonic or do not fit.
+// On exit, returns false if the points were rejected.
+bool PwlTable::load(const int32_t *xs, const int32_t *ys, int count)
+{
+  int32_t newX[PWL_MAX_POINTS];
+  int32_t newY[PWL_MAX_POINTS];
+  int     n = 0;
+
+  if (count <= 0) {
+    clear();
+    return true;
+  }
+
+  if ((xs[0] > 0) && (ys[0] >= 0)) { // Pass through the origin.
+    newX[n] = 0;
+    newY[n] = 0;
+    n++;
+  }
+
+  if (n + count > PWL_MAX_POINTS) {
+    return false;
+  }
+
+  for (int i = 0; i < count; i++, n++) {
+    if ((n > 0) && ((xs[i] <= newX[n - 1]) || (ys[i] < newY[n - 1]))) {
+      return false;
+    }
+    newX[n] = xs[i];
+    newY[n] = ys[i];
+  }
+
+  if (n < 2) { // One point at x = 0, no slope.
+    return false;
+  }
+
+  for (int i = 0; i < n; i++) {
+    xp[i] = newX[i];
+    yp[i] = newY[i];
+  }
+
+  for (int i = 0; i < n - 1; i++) {
+    slope[i] = (int32_t)((((int64_t)(yp[i + 1] - yp[i])) << 16) / (xp[i + 1] - xp[i]));
+  }
+  size = n;
+
+  return true;
+}
+
+// *********************************************************************************************
+// Load the inverse of count samples of y = f(x), in increasing x order. A sample is skipped unless its y is above
+// the last kept sample's y (the first x of a flat section is kept). The table is unchanged if the samples are rejected.
+// On exit, returns false if fewer than two samples were kept or the points do not fit.
+bool PwlTable::loadInverse(const int32_t *xs, const int32_t *ys, int count)
+{
+  int32_t invX[PWL_MAX_POINTS];
+  int32_t invY[PWL_MAX_POINTS];
+  int     n = 0;
+
+  for (int i = 0; i < count; i++) {
+    if ((n > 0) && (ys[i] <= invX[n - 1])) {
+      continue;
+    }
+    else if (n >= PWL_MAX_POINTS - 1) { // Room for the (0, 0) point.
+      return false;
+    }
+    invX[n] = ys[i];
+    invY[n] = xs[i];
+    n++;
+  }
+
+  if (n < 2) {
+    return false;
+  }
+
+  return load(invX, invY, n);
+}
+
+// *********************************************************************************************
+// On exit, returns f(x).
+int32_t PwlTable::lookup(int32_t x) const
+{
+  int i = 0;
+
+  if (size == 0) {
+    return x;
+  }
+
+  while ((i < size - 2) && (x >= xp[i + 1])) {
+    i++;
+  }
+
+  return yp[i] + (int32_t)((((int64_t)(x - xp[i])) * slope[i]) >> 16);
+}
+
+// *********************************************************************************************
+// On exit, returns the number of points, including the added (0, 0) point. Zero is y = x.
+int PwlTable::points(void) const
+{
+  return size;
+}
+
+// EOF
@@ -0,0 +1,55 @@
+/*
+   File: pwlTable.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Piecewise-linear lookup table, y = f(x), for the calibration tables. Integers in the caller's units (mA).
+   2. load() points must be in order: Increasing x and non-decreasing y (monotonic). A (0, 0) point is
+      added if the first x is above zero, so one point is a gain correction. An empty table is y = x.
+   3. Each segment's slope is computed once (16 fraction bits), so lookup() is a short search and one multiply.
+      Readings outside the table follow the first or last segment.
+   4. loadInverse() builds x = f^-1(y) from measured samples of y = f(x) (Pot characterization sweep). Samples that
+      do not increase y (flat or noisy) are skipped, so the inverse is always monotonic.
+   5. This file and pwlTable.cpp do not use the Arduino libraries. They can be compiled on a PC, see weldSim.cpp.
+ */
+#ifndef __PWL_TABLE_H__
+#define __PWL_TABLE_H__
+
+#include <stdint.h>
+
+#define PWL_MAX_POINTS 12 // Most points in a table, including the (0, 0) point.
+
+class PwlTable {
+public:
+
+  PwlTable(void);
+  void    clear(void);
+  bool    load(const int32_t *xs,
+               const int32_t *ys,
+               int            count);
+  bool    loadInverse(const int32_t *xs,
+                      const int32_t *ys,
+                      int            count);
+  int32_t lookup(int32_t x) const;
+  int     points(void) const;
+
+private:
+
+  int32_t xp[PWL_MAX_POINTS];    // Point x values, increasing.
+  int32_t yp[PWL_MAX_POINTS];    // Point y values, non-decreasing.
+  int32_t slope[PWL_MAX_POINTS]; // Slope from each point to the next one, 16 fraction bits.
+  int     size;                  // Number of points. Zero is y = x.
+};
+
+#endif // ifndef __PWL_TABLE_H__
+
+// EOF
@@ -0,0 +1,343 @@
+/*
+   File: recorder.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Telemetry Recorder. The Control Task writes one sample (WeldSample) per tick into a ring buffer in PSRAM. The buffer is
+      allocated once at boot (initRecorder()); Nothing is allocated while recording.
+   2. A trigger (rod strike, arc out, stuck rod, over temperature, or the "rec trig" command) starts a capture. The
+      capture window is REC_PRE_TIME before the trigger and REC_POST_TIME after it. Triggers that occur during a
+      capture window are added to that capture; They do not start a new one.
+   3. A capture is not copied. It stays valid until the ring buffer wraps over its first sample (the ring holds about
+      two minutes at 1KHz with the default REC_BUFFER_KB).
+   4. Serial Log commands (115200 baud, newline terminated):
+        rec help        List the commands.
+        rec list        List the captures.
+        rec dump <n>    Send capture n as CSV: t_us (relative to trigger), amps, volts, wiper, phase, state, flags.
+        rec trig        Start a capture now.
+        rec clear       Delete all captures.
+      The dump is sent a few lines per loop() pass so the touchscreen and audio are not stalled.
+ */
+
+#include <Arduino.h>
+#include "PulseWelder.h"
+#include "telemetry.h"
+#include "config.h"
+
+#define REC_PRE_SAMPLES ((REC_PRE_TIME * CONTROL_RATE_HZ) / 1000)   // Samples kept before the trigger.
+#define REC_POST_SAMPLES ((REC_POST_TIME * CONTROL_RATE_HZ) / 1000) // Samples kept after the trigger.
+
+// Capture window. Positions are sample sequence numbers (they do not wrap with the ring buffer).
+struct RecCapture {
+  uint32_t startSeq; // First sample.
+  uint32_t trigSeq;  // Trigger sample.
+  uint32_t endSeq;   // One past the last sample.
+  byte     trig;     // Trigger that started the capture, REC_TRIG_xxx.
+  byte     also;     // Triggers that occurred during the capture window.
+};
+
+// Global System vars
+extern bool overTempAlert; // Over Temperature (OC) Alert.
+
+// Local Scope Vars
+static WeldSample       *recBuf     = NULL;  // Ring buffer.
+static uint32_t          recMask    = 0;     // Ring buffer size - 1. The size is a power of two.
+static uint32_t          preSamples = 0;     // Samples kept before the trigger.
+static uint32_t          postSamples = 0;    // Samples kept after the trigger.
+static volatile uint32_t recSeq     = 0;     // Number of samples recorded.
+static volatile byte     pendingTrig = 0;    // Triggers waiting for the Control Task.
+static RecCapture        active;             // Capture in progress (Control Task only).
+static bool              capturing  = false; // A capture is in progress (Control Task only).
+static RecCapture        captures[REC_CAPTURES]; // Finished captures, oldest is replaced.
+static volatile uint32_t captureCnt = 0;     // Number of finished captures.
+static portMUX_TYPE      captureMux = portMUX_INITIALIZER_UNLOCKED; // Protects the capture list and pendingTrig.
+static int               dumpIdx    = -1;    // Capture being sent by processRecorder(), -1 = none.
+static uint32_t          dumpSeq    = 0;     // Next sample to send.
+static RecCapture        dumpCap;            // Copy of the capture being sent.
+static uint32_t          dumpTrigUs = 0;     // Trigger time of the capture being sent, in uS.
+
+// *********************************************************************************************
+// On exit, returns the name of the lowest trigger bit in trig.
+static const char *trigName(byte trig)
+{
+  if (trig & REC_TRIG_STRIKE) {
+    return "Strike";
+  }
+  else if (trig & REC_TRIG_OUT) {
+    return "Arc Out";
+  }
+  else if (trig & REC_TRIG_SHORT) {
+    return "Stuck Rod";
+  }
+  else if (trig & REC_TRIG_HEAT) {
+    return "Over Temp";
+  }
+
+  return "User";
+}
+
+// *********************************************************************************************
+// Copy a finished capture. Capture 0 is the oldest one still in the list.
+// On exit, returns false if there is no such capture.
+static bool getCapture(int idx, RecCapture *cap)
+{
+  bool     success = false;
+  uint32_t first;
+
+  portENTER_CRITICAL(&captureMux);
+  first = captureCnt > REC_CAPTURES ? captureCnt - REC_CAPTURES : 0;
+
+  if ((idx >= 0) && (first + idx < captureCnt)) {
+    *cap    = captures[(first + idx) % REC_CAPTURES];
+    success = true;
+  }
+  portEXIT_CRITICAL(&captureMux);
+
+  return success;
+}
+
+// *********************************************************************************************
+// On exit, returns true if the sample has not been overwritten by the ring buffer.
+static bool sampleValid(uint32_t seq)
+{
+  return (recSeq - seq) <= recMask;
+}
+
+// *********************************************************************************************
+// Allocate the ring buffer (PSRAM if found). Call once from initControlTask(), before the Control Task starts.
+void initRecorder(void)
+{
+#ifdef TELEMETRY_REC_ON
+  uint32_t bytes = 0;
+  uint32_t size  = 1;
+  uint32_t count;
+
+  if (recBuf != NULL) {
+    return; // Already allocated.
+  }
+
+  if (psramFound()) {
+    bytes  = REC_BUFFER_KB * 1024UL;
+    recBuf = (WeldSample *)(ps_malloc(bytes));
+  }
+
+  if (recBuf == NULL) {
+    Serial.println("Telemetry Recorder: PSRAM Not Available, Using " + String(REC_HEAP_KB) + "KB Heap Buffer.");
+    bytes  = REC_HEAP_KB * 1024UL;
+    recBuf = (WeldSample *)(malloc(bytes));
+  }
+
+  if (recBuf == NULL) {
+    Serial.println("Telemetry Recorder: Buffer Allocation Failed, Recorder Disabled.");
+    return;
+  }
+
+  count = bytes / sizeof(WeldSample);
+
+  while ((size << 1) <= count) { // Ring size is a power of two (index is masked, not divided).
+    size <<= 1;
+  }
+  recMask     = size - 1;
+  preSamples  = REC_PRE_SAMPLES;
+  postSamples = REC_POST_SAMPLES;
+
+  if (preSamples + postSamples > size / 2) { // Small buffer, shorten the window.
+    preSamples  = (preSamples * (size / 2)) / (REC_PRE_SAMPLES + REC_POST_SAMPLES);
+    postSamples = (size / 2) - preSamples;
+  }
+
+  Serial.println("Telemetry Recorder: " + String(size) + " Samples (" + String((float)(size) / CONTROL_RATE_HZ, 1) +
+                 "S), Capture " + String(preSamples) + " Pre / " + String(postSamples) + " Post Samples.");
+#endif // ifdef TELEMETRY_REC_ON
+}
+
+// *********************************************************************************************
+// Request a capture. May be called from the Control Task or loop().
+void triggerRecorder(byte trig)
+{
+  portENTER_CRITICAL(&captureMux);
+  pendingTrig |= trig;
+  portEXIT_CRITICAL(&captureMux);
+}
+
+// *********************************************************************************************
+// Arc State change subscriber for the Telemetry Recorder. Called by the Control Task.
+void recArcEvent(const ArcEvent& evt)
+{
+  if ((evt.state == ARC_ST_STRIKE) && ((evt.prevState == ARC_ST_OPEN) || (evt.prevState == ARC_ST_OUT))) {
+    triggerRecorder(REC_TRIG_STRIKE);
+  }
+  else if (evt.state == ARC_ST_OUT) {
+    triggerRecorder(REC_TRIG_OUT);
+  }
+  else if (evt.state == ARC_ST_STUCK) {
+    triggerRecorder(REC_TRIG_SHORT);
+  }
+}
+
+// *********************************************************************************************
+// Record one sample and run the capture trigger. Called by the Control Task on every tick.
+void recordSample(const WeldSample& smp)
+{
+#ifdef TELEMETRY_REC_ON
+  static bool lastHeat = false; // Over temperature alert on the previous tick.
+  uint32_t    seq;
+  byte        trig;
+
+  if (recBuf == NULL) {
+    return;
+  }
+
+  seq                   = recSeq;
+  recBuf[seq & recMask] = smp;
+  recSeq                = seq + 1; // Sample is complete, readers may use it.
+
+  if (overTempAlert && !lastHeat) {
+    triggerRecorder(REC_TRIG_HEAT);
+  }
+  lastHeat = overTempAlert;
+
+  portENTER_CRITICAL(&captureMux);
+  trig        = pendingTrig;
+  pendingTrig = 0;
+  portEXIT_CRITICAL(&captureMux);
+
+  if (capturing) {
+    active.also |= trig;
+
+    if (recSeq - active.trigSeq > postSamples) {
+      active.endSeq = recSeq;
+      portENTER_CRITICAL(&captureMux);
+      captures[captureCnt % REC_CAPTURES] = active;
+      captureCnt++;
+      portEXIT_CRITICAL(&captureMux);
+      capturing = false;
+    }
+  }
+  else if (trig != 0) {
+    active.trig     = trig & (~trig + 1); // Lowest trigger bit.
+    active.also     = trig & ~active.trig;
+    active.trigSeq  = seq;
+    active.startSeq = seq >= preSamples ? seq - preSamples : 0;
+    active.endSeq   = 0;
+    capturing       = true;
+  }
+#endif // ifdef TELEMETRY_REC_ON
+}
+
+// *********************************************************************************************
+// Log new captures and send the next lines of a capture dump. Called from loop().
+void processRecorder(void)
+{
+#ifdef TELEMETRY_REC_ON
+  static uint32_t reportedCnt = 0;
+  WeldSample smp;
+  RecCapture cap;
+  int lines = 0;
+
+  if (captureCnt != reportedCnt) {
+    reportedCnt = captureCnt;
+
+    if (getCapture(min((int)(reportedCnt), REC_CAPTURES) - 1, &cap)) {
+      Serial.println("Telemetry Recorder: " + String(trigName(cap.trig)) + " Captured, " +
+                     String(cap.endSeq - cap.startSeq) + " Samples.");
+      telemEvent(TLM_EVT_CAPTURE, cap.trig);
+    }
+  }
+
+  while ((dumpIdx >= 0) && (lines < REC_DUMP_LINES) && (Serial.availableForWrite() >= 64)) {
+    if (dumpSeq >= dumpCap.endSeq) {
+      Serial.println("# end");
+      dumpIdx = -1;
+      break;
+    }
+
+    smp = recBuf[dumpSeq & recMask];
+
+    if (!sampleValid(dumpSeq)) { // Check after the copy; The Control Task may have just overwritten it.
+      Serial.println("# error: capture was overwritten");
+      dumpIdx = -1;
+      break;
+    }
+
+    Serial.println(String((int32_t)(smp.timeUs - dumpTrigUs)) + "," +
+                   String(smp.amps) + "," + String(smp.voltsCv / 100.0f, 2) + "," + String(smp.wiper) + "," +
+                   String(smp.phase) + "," + String(smp.state) + "," + String(smp.flags));
+    dumpSeq++;
+    lines++;
+  }
+#endif // ifdef TELEMETRY_REC_ON
+}
+
+// *********************************************************************************************
+// Telemetry Recorder serial commands, see Notes.
+// On exit, returns false if cmd is not a recorder command.
+bool recorderCmd(const String& cmd)
+{
+  RecCapture cap;
+  int i;
+
+  if (!cmd.startsWith("rec")) {
+    return false;
+  }
+
+#ifdef TELEMETRY_REC_ON
+  if (recBuf == NULL) {
+    Serial.println("Telemetry Recorder: Disabled (no buffer).");
+  }
+  else if (cmd == "rec list") {
+    Serial.println("Telemetry Recorder: " + String(recSeq) + " Samples Recorded, " + String(min((uint32_t)(captureCnt),
+                   (uint32_t)(REC_CAPTURES))) + " Captures.");
+
+    for (i = 0; getCapture(i, &cap); i++) {
+      Serial.println(" #" + String(i) + ": " + String(trigName(cap.trig)) + (cap.also ? " (+" + String(trigName(cap.also)) + ")" : "") +
+                     ", " + String(cap.endSeq - cap.startSeq) + " Samples, " +
+                     (sampleValid(cap.startSeq) ? "Valid." : "Overwritten."));
+    }
+  }
+  else if (cmd.startsWith("rec dump ")) {
+    i = cmd.substring(9).toInt();
+
+    if (!getCapture(i, &cap) || !sampleValid(cap.startSeq)) {
+      Serial.println("# error: no capture #" + String(i));
+    }
+    else {
+      Serial.println("# capture " + String(i) + ", trigger " + String(trigName(cap.trig)) + ", " + String(CONTROL_RATE_HZ) + "Hz");
+      Serial.println("t_us,amps,volts,wiper,phase,state,flags");
+      dumpCap    = cap;
+      dumpSeq    = cap.startSeq;
+      dumpTrigUs = recBuf[cap.trigSeq & recMask].timeUs;
+      dumpIdx    = i;
+    }
+  }
+  else if (cmd == "rec trig") {
+    triggerRecorder(REC_TRIG_USER);
+    Serial.println("Telemetry Recorder: Trigger Requested.");
+  }
+  else if (cmd == "rec clear") {
+    portENTER_CRITICAL(&captureMux);
+    captureCnt = 0;
+    portEXIT_CRITICAL(&captureMux);
+    dumpIdx = -1;
+    Serial.println("Telemetry Recorder: Captures Cleared.");
+  }
+  else {
+    Serial.println("Telemetry Recorder Commands: rec list, rec dump <n>, rec trig, rec clear.");
+  }
+#else // ifdef TELEMETRY_REC_ON
+  Serial.println("Telemetry Recorder: Disabled in config.h.");
+#endif // ifdef TELEMETRY_REC_ON
+
+  return true;
+}
+
+// EOF
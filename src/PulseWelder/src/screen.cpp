@@ -20,25 +20,30 @@
 #include "digPot.h"
 #include "config.h"
 #include "speaker.h"
+#include "tftCanvas.h"
+#include "weldStats.h"
 
 // Touch Screen
 extern XPT2046_Touchscreen ts;
-extern Adafruit_ILI9341    tft;
+extern TftDisplay          tft;
 
 // Global Vars
-extern int  Amps;             // Live Welding Output Current.
+extern volatile int Amps;    // Live Welding Output Current.
 extern byte arcSwitch;        // Welder Arc Current On/Off Flag. Pseudo Boolean.
 extern byte bleSwitch;        // Bluetooth On/Off Switch.
 extern byte pulseSwitch;      // Pulse Mode On/Off Switch.
+extern byte hotStartPc;       // Hot Start boost (%). Zero is Off.
+extern byte hotStartX10;      // Hot Start time, in seconds times ten.
 extern bool overTempAlert;    // High Heat Detected.
 extern byte pulseAmpsPc;      // Arc modulation Background Current (%) for Pulse mode.
 extern byte pulseFreqX10;     // Pulse mode modulation frequency.
-extern bool pulseState;       // Arc Pulse modulation state (on/off).
+extern byte pulseWave;        // Pulse mode modulation waveform.
+extern volatile bool pulseState; // Arc Pulse modulation state (on/off).
 extern byte setAmps;          // Welding Amps Setting.
 extern bool setAmpsTimerFlag; // User has Changed Amps Setting when true.
 extern byte spkrVolSwitch;    // Audio Volume, five levels.
 extern byte systemError;      // Captures General hardware errors (bad current sensor or bad Digital Pot).
-extern unsigned int Volts;    // Live Welding Volts.
+extern volatile unsigned int Volts; // Live Welding Volts.
 
 
 
@@ -49,10 +54,100 @@ static int  page = PG_HOME;          // Current Menu Page.
 static int  x, y;                    // Screen's Touch coordinates.
 static long abortMillis     = 0;     // Info Page Abort Timer, in mS.
 static long previousEepMillis   = 0; // Previous Home Page time.
+static volatile ArcState screenArcState = ARC_ST_OPEN; // Latest arc state (Arc State event).
+static int  statsAge = 0;            // Weld Session shown on the Weld Stats page, 0 is the newest.
+static int  calPoint = 0;            // Calibration point shown on the Amps Calibration page.
 
 #define COORD(BOXNAME) BOXNAME ## _X , BOXNAME ## _Y , BOXNAME ## _W , BOXNAME ## _H
 #define IS_IN_BOX(BOXNAME) (isInBox(x, y, COORD(BOXNAME)))
 
+// Off-screen canvases for the Home page values (see tftCanvas.h).
+static TftCanvas ampsCanvas(tft, COORD(AMPCVS));
+static TftCanvas barCanvas(tft, COORD(BARCVS));
+static TftCanvas voltsCanvas(tft, COORD(VOLTCVS));
+
+
+// *********************************************************************************************
+// Allocate the Home page canvases (PSRAM). Call once from setup(), after the TFT is initialized.
+void initScreenCanvas(void)
+{
+#ifdef TFT_CANVAS_ON
+  if (ampsCanvas.begin() && barCanvas.begin() && voltsCanvas.begin()) {
+    Serial.println("Home Page Canvas: Using PSRAM Buffers, Changed Pixels Only.");
+  }
+  else {
+    Serial.println("Home Page Canvas: PSRAM Not Available, Drawing Directly.");
+  }
+#endif // ifdef TFT_CANVAS_ON
+}
+
+// *********************************************************************************************
+// Log one canvas' statistics and clear them.
+static void logCanvasStats(const char *name, TftCanvas& canvas)
+{
+  CanvasStats stats;
+
+  canvas.getStats(&stats, true);
+  Serial.println("TFT " + String(name) + ": " + String(stats.frames) + " frames, " + String(stats.pushes) +
+                 " pushed, " + String(stats.frames == 0 ? 0 : stats.pixels / stats.frames) + " pixels/frame (region " +
+                 String(stats.regionPx) + "), " + String(stats.avgUs) + "uS avg / " + String(stats.maxUs) +
+                 "uS max per frame, " + (stats.buffered ? "Canvas." : "Direct."));
+}
+
+// *********************************************************************************************
+// Display serial command: tft (Page draw and Home page value statistics since the last tft command).
+// On exit, returns false if cmd is not a display command.
+bool screenCmd(const String& cmd)
+{
+  static uint32_t lastOverruns = 0;
+  TftStats        stats;
+  ControlStats    ctrl;
+
+  if (cmd != "tft") {
+    return false;
+  }
+
+  tft.getStats(&stats, true);
+  getControlStats(&ctrl, false);
+  Serial.println("TFT Pages: " + String(stats.pages) + " draws, loop() " + String(stats.loopAvgUs / 1000.0f, 1) + "mS avg / " +
+                 String(stats.loopMaxUs / 1000.0f, 1) + "mS max, On screen " + String(stats.drawAvgUs / 1000.0f, 1) +
+                 "mS avg / " + String(stats.drawMaxUs / 1000.0f, 1) + "mS max, " + (stats.async ? "Async." : "Synchronous."));
+
+  if (stats.async) {
+    Serial.println("TFT Display Engine: " + String(stats.jobs) + " jobs, " + String(stats.pixels) + " pixels, Bus hold " +
+                   String(stats.busMaxUs) + "uS max, loop() waits " + String(stats.waits) + " (" +
+                   String(stats.waitUs / 1000.0f, 1) + "mS), Control Task overruns " +
+                   String(ctrl.overruns - lastOverruns) + ".");
+  }
+  lastOverruns = ctrl.overruns;
+
+  logCanvasStats("Amps", ampsCanvas);
+  logCanvasStats("Amps Bar", barCanvas);
+  logCanvasStats("Volts", voltsCanvas);
+
+  return true;
+}
+
+// *********************************************************************************************
+// Arc State change subscriber for the display. Called by the Control Task, the screen is refreshed by loop().
+void screenArcEvent(const ArcEvent& evt)
+{
+  screenArcState = evt.state;
+}
+
+// *********************************************************************************************
+// On exit, returns the Amps setting used to capture a calibration point. The points span the Amps setting range.
+static byte calSetAmps(int point)
+{
+  return MIN_SET_AMPS + (point * (MAX_SET_AMPS - MIN_SET_AMPS)) / (CAL_POINTS - 1);
+}
+
+// *********************************************************************************************
+// Leave the Amps Calibration page: Release the calibration Amps, the user's Amps setting is used again.
+static void exitAmpsCal(void)
+{
+  setCalAmps(0);
+}
 
 // *********************************************************************************************
 // Change Welder's Pulse Mode amps, Increase or decrement from 10% to 90%.
@@ -132,6 +227,59 @@ bool adjustPulseFreq(bool direction)
   return limitHit;
 }
 
+// *********************************************************************************************
+// Change Hot Start boost, Increase or decrement from 0% (Off) to 100%.
+// Used by processScreen().
+// On exit, true returned if end of travel was reached.
+bool adjustHotStartPc(bool direction)
+{
+  bool limitHit = false;
+
+  if ((direction == INCR) && (hotStartPc < MAX_HOT_PC)) {
+    hotStartPc += HOT_PC_STEP;
+  }
+  else if ((direction == DECR) && (hotStartPc > MIN_HOT_PC)) {
+    hotStartPc -= HOT_PC_STEP;
+  }
+
+  // Check for out of bounds values. Constrain in necessary.
+  if (hotStartPc >= MAX_HOT_PC) {
+    hotStartPc = MAX_HOT_PC;
+    limitHit   = true;
+  }
+  else if (hotStartPc <= MIN_HOT_PC) {
+    hotStartPc = MIN_HOT_PC;
+    limitHit   = true;
+  }
+
+  // Refresh the Hot Start display (if on page PG_SET_ARC)
+  drawHotStartPcSettings(true);
+
+  eepromActive      = true;     // Request EEPROM save for new settings.
+  previousEepMillis = millis(); // Set EEPROM write delay timer.
+
+  return limitHit;
+}
+
+// *********************************************************************************************
+// Change Hot Start time, Increase or decrement from 0.1 to 2.0 Secs (0.1S increments).
+// Used by processScreen().
+// On exit, true returned if end of travel was reached.
+bool adjustHotStartTime(bool direction)
+{
+  int nextTime = hotStartX10 + (direction == INCR ? 1 : -1);
+
+  hotStartX10 = constrain(nextTime, MIN_HOT_X10, MAX_HOT_X10);
+
+  // Refresh the Hot Start display (if on page PG_SET_ARC)
+  drawHotStartTmSettings(true);
+
+  eepromActive      = true;     // Request EEPROM save for new settings.
+  previousEepMillis = millis(); // Set EEPROM write delay timer.
+
+  return hotStartX10 != nextTime;
+}
+
 
 // *********************************************************************************************
 // Update EEPROM with new data.
@@ -144,6 +292,7 @@ static bool checkAndUpdateEEPROM(int addr, byte value, const char *label, const
   {                      // Save new Current setting.
     eepromActive = true; // New Data is available to write.
     EEPROM.write(addr, value);
+    telemSetting(addr, value);
     Serial.println("Write E2Prom Addr: " + String(addr) + ", " + label + ": " + (valueString == NULL?String(value) : valueString));
   }
   return retval;
@@ -310,6 +459,9 @@ void processScreen(void)
       eepromActive |= checkAndUpdateEEPROM(PULSE_SW_ADDR, pulseSwitch, "Pulse Mode", pulseSwitch == PULSE_ON ? "On" : "Off");
       eepromActive |= checkAndUpdateEEPROM(ARC_SW_ADDR, arcSwitch, "Arc Power", arcSwitch == ARC_ON ? "On" : "Off");
       eepromActive |= checkAndUpdateEEPROM(BLE_SW_ADDR, bleSwitch, "Bluetooth", bleSwitch == PULSE_ON ? "On" : "Off");
+      eepromActive |= checkAndUpdateEEPROM(HOT_PC_ADDR, hotStartPc, "Hot Start Boost", (String(hotStartPc) + "%").c_str());
+      eepromActive |= checkAndUpdateEEPROM(PULSE_WAVE_ADDR, pulseWave, "Pulse Wave", pulseWaveName(pulseWave));
+      eepromActive |= checkAndUpdateEEPROM(HOT_TM_ADDR, hotStartX10, "Hot Start Time", (String(hotStartX10 / 10.0f, 1) + String(" S")).c_str());
 
       if (eepromActive) {// New data available to write. Commit it to the flash.
         eepromActive = false;
@@ -430,7 +582,7 @@ void processScreen(void)
           setAmpsActive    = true;
           setAmps++;
           setAmps = constrain(setAmps, MIN_SET_AMPS, MAX_SET_AMPS);
-          setPotAmps(setAmps, VERBOSE_ON);// Refresh Digital Pot.
+          setPotAmps(outputAmps(setAmps), VERBOSE_ON);// Refresh Digital Pot.
           displayAmps(true);              // Refresh displayed value.
           arrowMillis       = millis();
           previousEepMillis = millis();
@@ -461,7 +613,7 @@ void processScreen(void)
           }
 
           setAmps = constrain(setAmps, MIN_SET_AMPS, MAX_SET_AMPS);
-          setPotAmps(setAmps, VERBOSE_ON);// Refresh Digital Pot.
+          setPotAmps(outputAmps(setAmps), VERBOSE_ON);// Refresh Digital Pot.
           displayAmps(true);              // Refresh displayed value.
           arrowMillis       = millis();
           previousEepMillis = millis();
@@ -525,7 +677,7 @@ void processScreen(void)
             eepromActive      = true;       // Request EEProm Write after timer expiry.
 
             setAmps = constrain(setAmps, MIN_SET_AMPS, MAX_SET_AMPS);
-            setPotAmps(setAmps, VERBOSE_ON);// Refresh Digital Pot.
+            setPotAmps(outputAmps(setAmps), VERBOSE_ON);// Refresh Digital Pot.
             displayAmps(true);              // Refresh amps value.
 
             if (repeatCnt == 1) {           // First Repeated keypress.
@@ -627,7 +779,13 @@ void processScreen(void)
       wasTouched          = true;
       getTouchPoints();
 
-      if (IS_IN_BOX(RTNBOX))// Return button. Return to home page.
+      if (IS_IN_BOX(NXTBOX))// Next page button. Go to Arc Settings page.
+      {
+        drawArcSettingsPage();
+
+        spkr.highBeep();
+      }
+      else if (IS_IN_BOX(RTNBOX))// Return button. Return to home page.
       {
         Serial.println("User Exit Machine Settings, returned to Home page");
         abortMillis = millis();
@@ -725,6 +883,296 @@ void processScreen(void)
     }
   }
 
+  else if (page == PG_SET_ARC)// Arc Settings Page
+  {
+    if (!ts.touched())
+    {
+      wasTouched = false;
+
+      if (millis() > abortMillis + PG_RD_TIME_MS)
+      {
+        Serial.println("Arc Settings page timeout, exit.");
+        abortMillis = millis();// Reset the settings page's keypress abort timer.
+        drawHomePage();
+
+        spkr.lowBeep();
+      }
+    }
+    else if (ts.touched() && !wasTouched)
+    {
+      abortMillis = millis();
+      wasTouched  = true;
+      getTouchPoints();
+
+      if (IS_IN_BOX(NXTBOX))// Next page button. Go to Pulse Shape page.
+      {
+        drawPulseShapePage();
+
+        spkr.highBeep();
+      }
+      else if (IS_IN_BOX(RTNBOX))// Return button. Return to Machine Settings page.
+      {
+        Serial.println("User Exit Arc Settings, returned to Machine Settings page");
+        drawSettingsPage();
+
+        spkr.lowBeep();
+      }
+      else if (isInBox(x, y, PSBOX_X  + PSBOX_W - 45, PSBOX_Y, 45, PSBOX_H))
+      {
+        limitHit = adjustHotStartPc(INCR);
+        Serial.println("Increased Hot Start Boost: " + String(hotStartPc) + "%");
+
+        spkr.limitHit(blip, limitHit);
+      }
+      else if (isInBox(x, y, PSBOX_X, PSBOX_Y, 45, PSBOX_H))
+      {
+        limitHit = adjustHotStartPc(DECR);
+        Serial.println("Decreased Hot Start Boost: " + String(hotStartPc) + "%");
+
+        spkr.limitHit(bleep, limitHit);
+      }
+      else if (isInBox(x, y, PCBOX_X  + PCBOX_W - 45, PCBOX_Y, 45, PCBOX_H))
+      {
+        limitHit = adjustHotStartTime(INCR);
+        Serial.println("Increased Hot Start Time: " + String(hotStartX10 / 10.0f, 1) + " S");
+
+        spkr.limitHit(blip, limitHit);
+      }
+      else if (isInBox(x, y, PCBOX_X, PCBOX_Y, 45, PCBOX_H))
+      {
+        limitHit = adjustHotStartTime(DECR);
+        Serial.println("Decreased Hot Start Time: " + String(hotStartX10 / 10.0f, 1) + " S");
+
+        spkr.limitHit(bleep, limitHit);
+      }
+    }
+  }
+
+  else if (page == PG_SET_PULSE)// Pulse Shape Settings Page
+  {
+    if (!ts.touched())
+    {
+      wasTouched = false;
+
+      if (millis() > abortMillis + PG_RD_TIME_MS)
+      {
+        Serial.println("Pulse Shape page timeout, exit.");
+        abortMillis = millis();// Reset the settings page's keypress abort timer.
+        drawHomePage();
+
+        spkr.lowBeep();
+      }
+    }
+    else if (ts.touched() && !wasTouched)
+    {
+      abortMillis = millis();
+      wasTouched  = true;
+      getTouchPoints();
+
+      if (IS_IN_BOX(NXTBOX))// Next page button. Go to Weld Stats page.
+      {
+        statsAge = 0;
+        drawWeldStatsPage();
+
+        spkr.highBeep();
+      }
+      else if (IS_IN_BOX(RTNBOX))// Return button. Return to Machine Settings page.
+      {
+        Serial.println("User Exit Pulse Shape, returned to Machine Settings page");
+        drawSettingsPage();
+
+        spkr.lowBeep();
+      }
+      else if (isInBox(x, y, PSBOX_X  + PSBOX_W - 45, PSBOX_Y, 45, PSBOX_H))
+      {
+        pulseWave = (pulseWave + 1) % PULSE_WAVE_CNT;
+        drawPulseWaveSettings(true);
+        eepromActive      = true;     // Request EEPROM save for new settings.
+        previousEepMillis = millis(); // Set EEPROM write delay timer.
+        Serial.println("Pulse Waveform: " + String(pulseWaveName(pulseWave)));
+
+        spkr.blip();
+      }
+      else if (isInBox(x, y, PSBOX_X, PSBOX_Y, 45, PSBOX_H))
+      {
+        pulseWave = (pulseWave + PULSE_WAVE_CNT - 1) % PULSE_WAVE_CNT;
+        drawPulseWaveSettings(true);
+        eepromActive      = true;     // Request EEPROM save for new settings.
+        previousEepMillis = millis(); // Set EEPROM write delay timer.
+        Serial.println("Pulse Waveform: " + String(pulseWaveName(pulseWave)));
+
+        spkr.bleep();
+      }
+    }
+  }
+
+  else if (page == PG_STATS)// Weld Session Statistics Page
+  {
+    if (!ts.touched())
+    {
+      wasTouched = false;
+
+      if (millis() > abortMillis + PG_RD_TIME_MS)
+      {
+        Serial.println("Weld Stats page timeout, exit.");
+        abortMillis = millis();// Reset the settings page's keypress abort timer.
+        drawHomePage();
+
+        spkr.lowBeep();
+      }
+    }
+    else if (ts.touched() && !wasTouched)
+    {
+      WeldSession ses;
+
+      abortMillis = millis();
+      wasTouched  = true;
+      getTouchPoints();
+
+      if (IS_IN_BOX(NXTBOX))// Next page button. Go to Amps Calibration page.
+      {
+        calPoint = 0;
+        setCalAmps(calSetAmps(calPoint));
+        drawAmpsCalPage();
+
+        spkr.highBeep();
+      }
+      else if (IS_IN_BOX(RTNBOX))// Return button. Return to Machine Settings page.
+      {
+        Serial.println("User Exit Weld Stats, returned to Machine Settings page");
+        drawSettingsPage();
+
+        spkr.lowBeep();
+      }
+      else if (isInBox(x, y, PSBOX_X  + PSBOX_W - 45, PSBOX_Y, 45, PSBOX_H))// Newer session.
+      {
+        limitHit = statsAge == 0;
+        statsAge = limitHit ? 0 : statsAge - 1;
+        drawWeldStats(true);
+
+        spkr.limitHit(blip, limitHit);
+      }
+      else if (isInBox(x, y, PSBOX_X, PSBOX_Y, 45, PSBOX_H))// Older session.
+      {
+        limitHit = !getWeldSession(statsAge + 1, &ses);
+        statsAge = limitHit ? statsAge : statsAge + 1;
+        drawWeldStats(true);
+
+        spkr.limitHit(bleep, limitHit);
+      }
+      else if (getWeldSession(statsAge, &ses) && isInBox(x, y, TRVBOX_X  + TRVBOX_W - 45, TRVBOX_Y, 45, TRVBOX_H))
+      {
+        limitHit = ses.travelMm >= SESSION_TRAVEL_MAX;
+        setSessionTravel(statsAge, min(ses.travelMm + SESSION_TRAVEL_STEP, SESSION_TRAVEL_MAX));
+        drawWeldStats(true);
+
+        spkr.limitHit(blip, limitHit);
+      }
+      else if (getWeldSession(statsAge, &ses) && isInBox(x, y, TRVBOX_X, TRVBOX_Y, 45, TRVBOX_H))
+      {
+        limitHit = ses.travelMm == 0;
+        setSessionTravel(statsAge, max(ses.travelMm - SESSION_TRAVEL_STEP, 0));
+        drawWeldStats(true);
+
+        spkr.limitHit(bleep, limitHit);
+      }
+    }
+  }
+
+  else if (page == PG_CAL)// Amps Calibration Page
+  {
+    if (!ts.touched())
+    {
+      wasTouched = false;
+
+      if ((millis() > abortMillis + PG_RD_TIME_MS) && !isAmpsCapturing())
+      {
+        Serial.println("Amps Calibration page timeout, exit.");
+        abortMillis = millis();// Reset the settings page's keypress abort timer.
+        exitAmpsCal();
+        drawHomePage();
+
+        spkr.lowBeep();
+      }
+    }
+    else if (ts.touched() && !wasTouched)
+    {
+      uint16_t readX10;
+      uint16_t meterX10;
+      bool     found;
+
+      abortMillis = millis();
+      wasTouched  = true;
+      getTouchPoints();
+      found = getAmpsCalPoint(calPoint, &readX10, &meterX10);
+
+      if (IS_IN_BOX(RTNBOX))// Return button. Return to Machine Settings page.
+      {
+        Serial.println("User Exit Amps Calibration, returned to Machine Settings page");
+        exitAmpsCal();
+        drawSettingsPage();
+
+        spkr.lowBeep();
+      }
+      else if (isAmpsCapturing())// Keep the setpoint until the capture is done.
+      {
+        spkr.bleep();
+      }
+      else if (isInBox(x, y, PSBOX_X  + PSBOX_W - 45, PSBOX_Y, 45, PSBOX_H))// Next point (higher setpoint).
+      {
+        limitHit = calPoint >= CAL_POINTS - 1;
+        calPoint = limitHit ? calPoint : calPoint + 1;
+        setCalAmps(calSetAmps(calPoint));
+        drawAmpsCalPage(); // Full redraw, the point may not have a Meter button.
+
+        spkr.limitHit(blip, limitHit);
+      }
+      else if (isInBox(x, y, PSBOX_X, PSBOX_Y, 45, PSBOX_H))// Previous point (lower setpoint).
+      {
+        limitHit = calPoint == 0;
+        calPoint = limitHit ? 0 : calPoint - 1;
+        setCalAmps(calSetAmps(calPoint));
+        drawAmpsCalPage();
+
+        spkr.limitHit(bleep, limitHit);
+      }
+      else if (IS_IN_BOX(CAPBOX))
+      {
+        if (pulseSwitch == PULSE_ON) {
+          Serial.println("Amps Calibration: Turn off Pulse mode before capturing.");
+          spkr.bleep();
+        }
+        else {
+          startAmpsCapture(calPoint);
+          drawAmpsCal(true);
+          spkr.blip();
+        }
+      }
+      else if (found && IS_IN_BOX(CLRBOX))
+      {
+        setAmpsCalPoint(calPoint, 0, 0);
+        Serial.println("Amps Calibration: Point " + String(calPoint + 1) + " cleared.");
+        drawAmpsCalPage();
+
+        spkr.bleep();
+      }
+      else if (found && isInBox(x, y, TRVBOX_X  + TRVBOX_W - 45, TRVBOX_Y, 45, TRVBOX_H))
+      {
+        limitHit = !setAmpsCalPoint(calPoint, readX10, meterX10 + CAL_METER_STEP);
+        drawAmpsCal(true);
+
+        spkr.limitHit(blip, limitHit);
+      }
+      else if (found && isInBox(x, y, TRVBOX_X, TRVBOX_Y, 45, TRVBOX_H))
+      {
+        limitHit = (meterX10 <= CAL_METER_STEP) || !setAmpsCalPoint(calPoint, readX10, meterX10 - CAL_METER_STEP);
+        drawAmpsCal(true);
+
+        spkr.limitHit(bleep, limitHit);
+      }
+    }
+  }
+
   else if (page == PG_ERROR)// System Error page.
   {
     if (!ts.touched())
@@ -765,7 +1213,7 @@ void displayAmps(bool forceRefresh)
     return;
   }
 
-  if ((Amps >= MIN_DET_AMPS) && (arcSwitch == ARC_ON) && (setAmpsTimerFlag == false))
+  if (arcBurning(screenArcState) && (arcSwitch == ARC_ON) && (setAmpsTimerFlag == false))
   {
     oldsetAmps = -1; // Force setting value refresh when rod burning ends.
 
@@ -806,14 +1254,15 @@ void displayAmps(bool forceRefresh)
     color = ILI9341_WHITE;
   }
 
-  tft.fillRect(AMPBOX_X + 5, AMPBOX_Y + 10, AMPBOX_W, AMPBOX_Y + AMPVAL_H + 5, color); // Erase old value
-  tft.setFont(&FreeMonoBold24pt7b);
-  tft.setCursor(AMPBOX_X + 5, AMPBOX_Y + AMPVAL_H + 5);
-  tft.setTextSize(2);
+  ampsCanvas.beginFrame();
+  ampsCanvas.fillRect(AMPBOX_X + 5, AMPBOX_Y + 10, AMPBOX_W, AMPBOX_Y + AMPVAL_H + 5, color); // Erase old value
+  ampsCanvas.setFont(&FreeMonoBold24pt7b);
+  ampsCanvas.setCursor(AMPBOX_X + 5, AMPBOX_Y + AMPVAL_H + 5);
+  ampsCanvas.setTextSize(2);
 
-  if ((Amps >= MIN_DET_AMPS) && (arcSwitch == ARC_ON) && (setAmpsTimerFlag == false))
+  if (arcBurning(screenArcState) && (arcSwitch == ARC_ON) && (setAmpsTimerFlag == false))
   { // Burning a rod. Show live current draw.
-    tft.setTextColor(ILI9341_RED);
+    ampsCanvas.setTextColor(ILI9341_RED);
     sprintf(StringBuff, "%3d", Amps);
   }
   else
@@ -828,10 +1277,11 @@ void displayAmps(bool forceRefresh)
     else {
       color = ILI9341_GREEN;
     }
-    tft.setTextColor(color);
+    ampsCanvas.setTextColor(color);
     sprintf(StringBuff, "%3d", dispAmps);
   }
-  tft.println(StringBuff);
+  ampsCanvas.print(StringBuff);
+  ampsCanvas.flush(); // Send the changed pixels.
 
   // Display the moving amp bar.
   drawAmpBar(AMPBAR_X, AMPBAR_Y, forceRefresh);
@@ -840,6 +1290,8 @@ void displayAmps(bool forceRefresh)
 // *********************************************************************************************
 void displaySplash(void)
 {
+  tft.beginPage();
+
   // Draw Image.
   tft.fillScreen(ILI9341_WHITE);
   tft.drawBitmap(20, 61, sparky, 280, 166, ILI9341_BLACK);
@@ -862,6 +1314,7 @@ void displaySplash(void)
   tft.setTextColor(ILI9341_WHITE);
   tft.setCursor(70, 215);
   tft.print(VERSION_STR);
+  tft.endPage();
 }
 
 // *********************************************************************************************
@@ -902,15 +1355,21 @@ void displayVolts(bool forceRefresh = false)
   oldVolts = Volts;
 
   color = arcSwitch == ARC_ON ? ARC_BG_COLOR : ILI9341_BLUE;
-  tft.fillRect(VOLTBOX_X + 5, VOLTBOX_Y + 10, VOLTBOX_W, VOLTBOX_H, color); // Erase old value
-  tft.setFont(&FreeMonoBold24pt7b);
-  tft.setTextSize(2);
-  tft.setCursor(VOLTBOX_X + 5, VOLTBOX_Y + VOLTVAL_H + 5);
+  voltsCanvas.beginFrame();
+  voltsCanvas.fillRect(VOLTBOX_X + 5, VOLTBOX_Y + 10, VOLTBOX_W, VOLTBOX_H, color); // Erase old value
+  voltsCanvas.setFont(&FreeMonoBold24pt7b);
+  voltsCanvas.setTextSize(2);
+  voltsCanvas.setCursor(VOLTBOX_X + 5, VOLTBOX_Y + VOLTVAL_H + 5);
 
   color = Volts <= MIN_VOLTS ? ILI9341_YELLOW : ILI9341_GREEN;
-  tft.setTextColor(color);
+  voltsCanvas.setTextColor(color);
   sprintf(StringBuff, "%2d", Volts);
-  tft.print(StringBuff);
+  voltsCanvas.print(StringBuff);
+  voltsCanvas.flush(); // Send the changed pixels.
+
+  // The units and lightning bolt are outside the erased area, they are drawn over themselves.
+  tft.setTextColor(color);
+  tft.setCursor(voltsCanvas.getCursorX(), voltsCanvas.getCursorY());
   tft.setFont(&FreeSansBold12pt7b);
   tft.setTextSize(1);
   tft.println('V');
@@ -922,6 +1381,8 @@ void displayVolts(bool forceRefresh = false)
 // *********************************************************************************************
 void drawAmpsBox(void)
 {
+  ampsCanvas.invalidate();
+  barCanvas.invalidate();
   tft.fillRoundRect(AMPBOX_X, AMPBOX_Y, SCREEN_W - AMPBOX_X - 2, AMPBOX_H, AMPBOX_R, ILI9341_WHITE);
   tft.drawRoundRect(AMPBOX_X,     AMPBOX_Y,     SCREEN_W - AMPBOX_X, AMPBOX_H,     AMPBOX_R, ILI9341_CYAN);
   tft.drawRoundRect(AMPBOX_X + 1, AMPBOX_Y + 1, SCREEN_W - AMPBOX_X, AMPBOX_H - 2, AMPBOX_R, ILI9341_CYAN);
@@ -938,6 +1399,7 @@ void drawAmpsBox(void)
 void drawAmpBar(int x, int y, bool forceRefresh)
 {
   unsigned int ampsMapped;
+  unsigned int limitMapped;
   static int   old_setAmps = -1;
 
   if (overTempAlert) {
@@ -949,14 +1411,34 @@ void drawAmpBar(int x, int y, bool forceRefresh)
   }
   old_setAmps = setAmps;
   ampsMapped  = map(setAmps, 0, MAX_SET_AMPS, 0, AMPBAR_W);
+  limitMapped = map(thermalLimitAmps(setAmps), 0, MAX_SET_AMPS, 0, AMPBAR_W);
+
+  barCanvas.beginFrame();
+  barCanvas.fillRect(COORD(BARCVS), ILI9341_WHITE); // Amp Box background, shows at the frame's rounded corners.
+  barCanvas.drawRoundRect(AMPBAR_X - 2, (AMPBAR_Y - 2), (AMPBAR_W + 4), (AMPBAR_H + 4), 3, ILI9341_WHITE);
+  barCanvas.fillRect(AMPBAR_X, AMPBAR_Y, AMPBAR_W,   AMPBAR_H, ILI9341_LIGHTGREY);
+  barCanvas.fillRect(AMPBAR_X, AMPBAR_Y, ampsMapped, AMPBAR_H, isThermalWarning() ? ILI9341_ORANGE : ILI9341_GREEN);
 
-  tft.drawRoundRect(AMPBAR_X - 2, (AMPBAR_Y - 2), (AMPBAR_W + 4), (AMPBAR_H + 4), 3, ILI9341_WHITE);
-  tft.fillRect(AMPBAR_X, AMPBAR_Y, AMPBAR_W,   AMPBAR_H, ILI9341_LIGHTGREY);
-  tft.fillRect(AMPBAR_X, AMPBAR_Y, ampsMapped, AMPBAR_H, ILI9341_GREEN);
+  if (limitMapped < ampsMapped) { // Thermal derating, show the cut back part in red.
+    barCanvas.fillRect(AMPBAR_X + limitMapped, AMPBAR_Y, ampsMapped - limitMapped, AMPBAR_H, ILI9341_RED);
+  }
+  barCanvas.flush();
+}
+
+// *********************************************************************************************
+// Redraw the Amps bar after a thermal model warning or derating change. Called from loop().
+void refreshThermal(void)
+{
+  if (page == PG_HOME) {
+    drawAmpBar(AMPBAR_X, AMPBAR_Y, true);
+  }
 }
 
 // *********************************************************************************************
 void drawPageFrame(uint32_t bgColor, uint32_t marginColor) {
+  ampsCanvas.invalidate(); // The canvases' areas are overwritten.
+  barCanvas.invalidate();
+  voltsCanvas.invalidate();
   tft.fillScreen(ILI9341_BLACK); // CLS.
   tft.fillRoundRect(0, 0, SCREEN_W, SCREEN_H, 5, bgColor);
   tft.drawRoundRect(0, 0, SCREEN_W,     SCREEN_H,     5, marginColor);
@@ -979,10 +1461,17 @@ void drawSubPage(String title, int pg, uint32_t bgColor, uint32_t marginColor) {
   tft.setTextSize(1);
   tft.setTextColor(ILI9341_BLACK);
   tft.setCursor(55, 32);
-  tft.println("MACHINE SETTINGS");
+  tft.println(title);
   tft.drawBitmap(5, 5, returnBitMap, 35, 35, ILI9341_RED);
 }
 
+// *********************************************************************************************
+// Show the Next Page arrow at the end of the title banner (see NXTBOX).
+void drawNextArrow(void)
+{
+  tft.fillTriangle(SCREEN_W - 18, 12, SCREEN_W - 18, 32, SCREEN_W - 6, 22, ILI9341_BLUE);
+}
+
 // *********************************************************************************************
 // Information page.
 void drawInfoPage(void)
@@ -1190,6 +1679,7 @@ void drawErrorPage()
 // Home Page.
 void drawHomePage()
 {
+  tft.beginPage();
   page = PG_HOME;
 
   unsigned int color = arcSwitch == ARC_ON ? ARC_BG_COLOR : ILI9341_BLUE;
@@ -1241,6 +1731,7 @@ void drawHomePage()
 
   displayAmps(true);
   displayVolts(true);
+  tft.endPage();
 }
 
 // *********************************************************************************************
@@ -1301,7 +1792,7 @@ void drawPulseLightning(void)
   {
     unsigned int color;
     if (pulseState) {
-      color = Amps >= PULSE_AMPS_THRS ? ILI9341_YELLOW : LIGHT_BLUE;
+      color = arcEstablished(screenArcState) ? ILI9341_YELLOW : LIGHT_BLUE;
     }
     else {
       color = BUTTONBACKGROUND; // Erase Icon Image
@@ -1331,7 +1822,9 @@ void drawPulseHzSettings(bool update_only)
 // *********************************************************************************************
 void drawSettingsPage()
 {
+  tft.beginPage();
   drawSubPage("MACHINE SETTINGS", PG_SET, ILI9341_WHITE, ILI9341_CYAN);
+  drawNextArrow(); // Next page is Arc Settings.
 
   // Show Pulse Settings Buttons (Left / Right arrows)
   drawPulseHzSettings(false);
@@ -1346,7 +1839,239 @@ void drawSettingsPage()
 
   // Show the Bluetooth On/Off Button.
   drawBasicButton(FBBOX_X + FBBOX_W + 12,FBBOX_Y, BOBOX_W, FBBOX_H, ILI9341_BLACK);
+  tft.endPage();
+}
 
+// *********************************************************************************************
+// Show Hot Start Boost Settings Button Box (Left / Right arrows with hotStartPc value).
+// The boosted Amps (at the present Amps setting) are shown below the buttons.
+void drawHotStartPcSettings(bool update_only)
+{
+  int    boostAmps;
+  String label;
+
+  if (page == PG_SET_ARC) {
+    drawPlusMinusButtons(COORD(PSBOX), hotStartPc == 0 ? String("Boost: Off") : "Boost: " + String(hotStartPc) + "%", update_only);
+
+    boostAmps = min(setAmps + (setAmps * hotStartPc) / 100, MAX_SET_AMPS);
+#ifdef HOT_START_ON
+    label = hotStartPc == 0 ? String("Hot Start Off") : "Strike at " + String(boostAmps) + " Amps";
+#else // ifdef HOT_START_ON
+    label = "Hot Start Disabled";
+#endif // ifdef HOT_START_ON
+    tft.setFont(&FreeSansBold12pt7b);
+    tft.setTextSize(1);
+    tft.setTextColor(ILI9341_BLACK);
+    drawCenteredText(FBBOX_X, FBBOX_Y, PCBOX_W, FBBOX_H, label, ILI9341_WHITE);
+  }
+}
+
+// *********************************************************************************************
+// Show Hot Start Time Settings Button Box (Left / Right arrows with hotStartX10 value).
+void drawHotStartTmSettings(bool update_only)
+{
+  if (page == PG_SET_ARC) {
+    drawPlusMinusButtons(COORD(PCBOX), "Time: " + String(hotStartX10 / 10.0f, 1) + " S", update_only);
+  }
+}
+
+// *********************************************************************************************
+// Arc Settings page (Hot Start). Reached from the Machine Settings page.
+void drawArcSettingsPage(void)
+{
+  drawSubPage("ARC SETTINGS", PG_SET_ARC, ILI9341_WHITE, ILI9341_CYAN);
+  drawNextArrow(); // Next page is Pulse Shape.
+
+  // Hot Start Boost Button.
+  drawHotStartPcSettings(false);
+
+  // Hot Start Time Button.
+  drawHotStartTmSettings(false);
+}
+
+// *********************************************************************************************
+// Show Pulse Waveform Settings Button Box (Left / Right arrows with the waveform name) and draw two periods of the
+// pulse shape at the present Amps and background current settings.
+void drawPulseWaveSettings(bool update_only)
+{
+  int bgAmps;
+  int amps;
+  int px;
+  int py;
+  int lastY = -1;
+
+  if (page != PG_SET_PULSE) {
+    return;
+  }
+
+  drawPlusMinusButtons(COORD(PSBOX), pulseWaveName(pulseWave), update_only);
+
+  bgAmps = constrain((int)(setAmps) * pulseAmpsPc / 100, MIN_SET_AMPS, MAX_SET_AMPS);
+
+  tft.fillRect(WAVEBOX_X, WAVEBOX_Y, WAVEBOX_W, WAVEBOX_H, ILI9341_WHITE); // Erase old shape.
+  tft.drawRect(WAVEBOX_X, WAVEBOX_Y, WAVEBOX_W, WAVEBOX_H, ILI9341_BLACK);
+
+  for (px = 0; px < WAVEBOX_W - 4; px++) {
+    amps = bgAmps + (((int)(setAmps) - bgAmps) *
+                     pulseWaveLevel(pulseWave, (px * 2 * PULSE_TABLE_SIZE) / (WAVEBOX_W - 4))) / PULSE_LEVEL_MAX;
+    py   = WAVEBOX_Y + WAVEBOX_H - 6 - (amps * (WAVEBOX_H - 12)) / MAX_SET_AMPS;
+
+    if (lastY >= 0) {
+      tft.drawLine(WAVEBOX_X + 1 + px, lastY, WAVEBOX_X + 2 + px, py, ILI9341_BLUE);
+      tft.drawLine(WAVEBOX_X + 1 + px, lastY + 1, WAVEBOX_X + 2 + px, py + 1, ILI9341_BLUE);
+    }
+    lastY = py;
+  }
+}
+
+// *********************************************************************************************
+// Pulse Shape settings page. Reached from the Arc Settings page.
+void drawPulseShapePage(void)
+{
+  drawSubPage("PULSE SHAPE", PG_SET_PULSE, ILI9341_WHITE, ILI9341_CYAN);
+  drawNextArrow(); // Next page is Weld Stats.
+
+  // Pulse Waveform Button and shape display.
+  drawPulseWaveSettings(false);
+}
+
+// *********************************************************************************************
+// Show the Weld Session selected by statsAge: Session number (Left / Right arrows), statistics, and travel length
+// (Left / Right arrows) with the heat input.
+void drawWeldStats(bool update_only)
+{
+  WeldSession ses;
+  bool        found;
+  float       heat;
+  String      lines[3];
+
+  if (page != PG_STATS) {
+    return;
+  }
+
+  found = getWeldSession(statsAge, &ses);
+
+  if (found) {
+    lines[0] = "Arc " + String(ses.arcMs / 1000.0f, 1) + "S, " + String(ses.energyJ / 1000.0f, 1) + "kJ, Set " +
+               String(ses.setAmps) + "A" + ((ses.flags & SESSION_FLAG_PULSE) ? " Pulse" : "");
+    lines[1] = "Amps " + String(ses.meanAmpsX10 / 10.0f, 1) + " (sd " + String(ses.sdAmpsX10 / 10.0f, 1) +
+               "), Peak " + String(ses.peakAmps);
+    lines[2] = "Volts " + String(ses.meanVoltsCv / 100.0f, 1) + " (sd " + String(ses.sdVoltsCv / 100.0f, 1) +
+               "), Peak " + String(ses.peakVoltsCv / 100.0f, 1);
+    drawPlusMinusButtons(COORD(PSBOX), ((ses.flags & SESSION_FLAG_STUCK) ? "#" + String(ses.number) + " Stuck" :
+                                        "Weld #" + String(ses.number)), update_only);
+    drawPlusMinusButtons(COORD(TRVBOX), ses.travelMm == 0 ? String("Length: ?") :
+                         "Length: " + String(ses.travelMm) + "mm", update_only);
+  }
+  else {
+    lines[1] = "No Welds Recorded";
+    drawPlusMinusButtons(COORD(PSBOX), "Weld #-", update_only);
+  }
+
+  tft.setFont(&FreeSans9pt7b);
+  tft.setTextSize(1);
+  tft.setTextColor(ILI9341_BLACK);
+
+  for (int i = 0; i < 3; i++) {
+    drawCenteredText(STATBOX_X, STATBOX_Y + i * STATBOX_H, STATBOX_W, STATBOX_H, lines[i], ILI9341_WHITE);
+  }
+
+  heat = found ? heatInputKjMm(ses.energyJ, ses.travelMm, SESSION_EFF_PC / 100.0f) : 0;
+  drawCenteredText(STATBOX_X, TRVBOX_Y + TRVBOX_H + 6, STATBOX_W, STATBOX_H,
+                   !found ? String("") : ses.travelMm == 0 ? String("Enter Length for Heat Input") :
+                   "Heat Input: " + String(heat, 2) + " kJ/mm", ILI9341_WHITE);
+}
+
+// *********************************************************************************************
+// Weld Session statistics page. Reached from the Pulse Shape page.
+void drawWeldStatsPage(void)
+{
+  drawSubPage("WELD STATS", PG_STATS, ILI9341_WHITE, ILI9341_CYAN);
+  drawNextArrow(); // Next page is Amps Calibration.
+
+  // Session selection, statistics, and travel length buttons.
+  drawWeldStats(false);
+}
+
+// *********************************************************************************************
+// A Weld Session was saved. Redraw the Weld Stats page if it is shown; The selected session is kept.
+void refreshWeldStats(void)
+{
+  if (page == PG_STATS) {
+    statsAge = statsAge == 0 ? 0 : min(statsAge + 1, SESSION_HISTORY - 1);
+    drawWeldStatsPage(); // Full redraw, the first session adds the Length buttons.
+  }
+}
+
+// *********************************************************************************************
+// Show the calibration point selected by calPoint: Point and setpoint (Left / Right arrows), the captured welder
+// reading, the Capture and Clear buttons, and the clamp meter reading (Left / Right arrows).
+void drawAmpsCal(bool update_only)
+{
+  uint16_t readX10;
+  uint16_t meterX10;
+  bool     found;
+  String   label;
+
+  if (page != PG_CAL) {
+    return;
+  }
+
+  found = getAmpsCalPoint(calPoint, &readX10, &meterX10);
+  drawPlusMinusButtons(COORD(PSBOX), "Point " + String(calPoint + 1) + ": " + String(getCalAmps()) + "A", update_only);
+
+  if (isAmpsCapturing()) {
+    label = "Capturing, Keep Welding";
+  }
+  else if (found) {
+    label = "Welder Read " + String(readX10 / 10.0f, 1) + "A";
+  }
+  else {
+    label = "Weld, Then Touch Capture";
+  }
+
+  tft.setFont(&FreeSans9pt7b);
+  tft.setTextSize(1);
+  tft.setTextColor(ILI9341_BLACK);
+  drawCenteredText(STATBOX_X, STATBOX_Y, STATBOX_W, STATBOX_H, label, ILI9341_WHITE);
+
+  if (!update_only) {
+    drawBasicButton(COORD(CAPBOX), ILI9341_BLACK);
+    drawCenteredText(COORD(CAPBOX), "Capture", ILI9341_WHITE);
+
+    if (found) {
+      drawBasicButton(COORD(CLRBOX), ILI9341_BLACK);
+      drawCenteredText(COORD(CLRBOX), "Clear", ILI9341_WHITE);
+    }
+  }
+
+  if (found) {
+    drawPlusMinusButtons(COORD(TRVBOX), "Meter: " + String(meterX10 / 10.0f, 1) + "A", update_only);
+  }
+
+  drawCenteredText(STATBOX_X, TRVBOX_Y + TRVBOX_H + 6, STATBOX_W, STATBOX_H,
+                   found ? String("Enter the Clamp Meter Amps") : String(""), ILI9341_WHITE);
+}
+
+// *********************************************************************************************
+// Amps Calibration page (calibration wizard). Reached from the Weld Stats page.
+// Each point sets the Amps to a setpoint; Weld (or use a load bank), touch Capture, then enter the clamp meter Amps.
+void drawAmpsCalPage(void)
+{
+  drawSubPage("AMPS CALIBRATION", PG_CAL, ILI9341_WHITE, ILI9341_CYAN);
+
+  // Point selection, welder reading, Capture / Clear, and meter reading buttons.
+  drawAmpsCal(false);
+}
+
+// *********************************************************************************************
+// A capture finished or the calibration was changed by a serial command. Redraw the Amps Calibration page if it is
+// shown.
+void refreshAmpsCal(void)
+{
+  if (page == PG_CAL) {
+    drawAmpsCalPage();
+  }
 }
 
 
@@ -38,6 +38,10 @@
 #define PG_INFO_6013 22       // E-6013 Rod Info Page.
 #define PG_INFO_7018 23       // E-7018 Rod Info Page.
 #define PG_SET 30             // Settings Page.
+#define PG_SET_ARC 31         // Arc Settings Page (Hot Start).
+#define PG_SET_PULSE 32       // Pulse Shape Settings Page.
+#define PG_STATS 33           // Weld Session Statistics Page.
+#define PG_CAL 34             // Amps Calibration Page.
 #define PG_ERROR 40           // Error (Caution) Page.
 #define PG_RD_TIME_MS 45000   // Timeout time (mS) for reading a rod information page automatic before exit.
 #define MENU_RD_TIME_MS 10000 // Timeout time (mS) for chosing a menu item before automatic exit.
@@ -115,6 +119,38 @@
 #define PSBOX_H 40
 #define PSBOX_R 3
 
+#define NXTBOX_X 260 // Next Settings Page Button Box area X (right end of title banner)
+#define NXTBOX_Y 0
+#define NXTBOX_W (SCREEN_W - NXTBOX_X)
+#define NXTBOX_H 50
+#define NXTBOX_R 3
+
+#define WAVEBOX_X 20 // Pulse Shape display area X
+#define WAVEBOX_Y 112
+#define WAVEBOX_W (SCREEN_W - (WAVEBOX_X + 15))
+#define WAVEBOX_H 110
+
+#define STATBOX_X 20 // Weld Stats text area X (three lines)
+#define STATBOX_Y 100
+#define STATBOX_W (SCREEN_W - (STATBOX_X + 15))
+#define STATBOX_H 20 // Height of one line
+
+#define TRVBOX_X 20 // Weld Stats Travel Length Left/Right Button Box area X
+#define TRVBOX_Y 172
+#define TRVBOX_W (SCREEN_W - (TRVBOX_X + 15))
+#define TRVBOX_H 40
+#define TRVBOX_R 3
+
+#define CAPBOX_X 20 // Amps Calibration Capture Button Box area X
+#define CAPBOX_Y 127
+#define CAPBOX_W ((PCBOX_W - 12) / 2)
+#define CAPBOX_H 32
+
+#define CLRBOX_X (CAPBOX_X + CAPBOX_W + 12) // Amps Calibration Clear Button Box area X
+#define CLRBOX_Y CAPBOX_Y
+#define CLRBOX_W CAPBOX_W
+#define CLRBOX_H CAPBOX_H
+
 #define RTNBOX_X 0 // Return Button Box area X
 #define RTNBOX_Y 0
 #define RTNBOX_W SCREEN_W
@@ -144,6 +180,22 @@
 #define VOLTBOX_W 110 // Volt Box Width
 #define VOLTVAL_H 70  // Height of Volt Value Font
 
+// Off-screen canvas regions (tftCanvas.h). Each covers the area that was erased before its value is redrawn.
+#define AMPCVS_X (AMPBOX_X + 5) // Amps value canvas X
+#define AMPCVS_Y (AMPBOX_Y + 10)
+#define AMPCVS_W AMPBOX_W
+#define AMPCVS_H (AMPBOX_Y + AMPVAL_H + 5)
+
+#define BARCVS_X (AMPBAR_X - 2) // Amps bar canvas X (bar and its frame)
+#define BARCVS_Y (AMPBAR_Y - 2)
+#define BARCVS_W (AMPBAR_W + 4)
+#define BARCVS_H (AMPBAR_H + 4)
+
+#define VOLTCVS_X (VOLTBOX_X + 5) // Volts value canvas X
+#define VOLTCVS_Y (VOLTBOX_Y + 10)
+#define VOLTCVS_W VOLTBOX_W
+#define VOLTCVS_H VOLTBOX_H
+
 #define BATTERY_X 260 // Battery Icon X Location
 #define BATTERY_Y 220 // Battery Icon Y Location
 #define BATTERY_W 22  // Battery Icon Width
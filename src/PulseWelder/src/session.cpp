@@ -0,0 +1,235 @@
+/*
+   File: session.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Weld Sessions. A session starts when the rod strikes from open circuit and ends when the Arc State Machine
+      returns to open circuit (ARC_OUT_TIME after the arc goes out). A restrike before then is the same session.
+   2. The Control Task adds every tick's sample to the session statistics (weldStats.cpp). The finished session is
+      passed to loop(), which saves it in E2Prom. Sessions shorter than SESSION_MIN_TIME (arc time) are not saved.
+   3. The last SESSION_HISTORY sessions are kept. Session n is saved in record n % SESSION_HISTORY, so no index needs
+      to be saved; The newest record is the one with the highest session number.
+   4. The travel (bead) length is entered on the Weld Stats page. It is saved after EEP_DELAY_TIME without changes.
+ */
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "PulseWelder.h"
+#include "weldStats.h"
+#include "config.h"
+
+#define SESSION_MAX_DT 0.01f // Longest sample time, in seconds (Control Task was held off).
+
+static_assert(sizeof(WeldSession) == SESSION_REC_SIZE, "SESSION_REC_SIZE does not match WeldSession.");
+static_assert(SESSION_ADDR + SESSION_HISTORY * SESSION_REC_SIZE <= EEPROM_SIZE, "Weld Session history does not fit.");
+
+// Global System vars
+extern byte pulseSwitch; // Pulse Mode On/Off state.
+extern byte setAmps;     // Amps setting.
+
+// Local Scope Vars
+static WeldStats         stats;                   // Statistics of the session in progress (Control Task only).
+static bool              active      = false;     // A session is in progress (Control Task only).
+static uint32_t          lastUs      = 0;         // Previous sample time, in uS (Control Task only).
+static byte              sesFlags    = 0;         // SESSION_FLAG_xxx bits of the session in progress.
+static byte              sesAmps     = 0;         // Amps setting at the strike.
+static WeldSession       finished;                // Finished session, waiting for loop().
+static volatile bool     finishedNew = false;     // finished holds a session that has not been saved.
+static portMUX_TYPE      sessionMux  = portMUX_INITIALIZER_UNLOCKED; // Protects finished.
+static uint16_t          newestNum   = SESSION_EMPTY; // Number of the newest saved session.
+static bool              travelDirty = false;     // A travel length was changed, E2Prom commit is pending.
+static unsigned long     travelMillis = 0;        // Time of the last travel length change, in mS.
+
+// *********************************************************************************************
+// On exit, returns the checksum of a session record (all bytes except the checksum).
+static uint8_t sessionCheck(const WeldSession& ses)
+{
+  const uint8_t *data = (const uint8_t *)(&ses);
+  uint8_t sum = 0x5a;
+
+  for (size_t i = 0; i < offsetof(WeldSession, check); i++) {
+    sum = (sum << 1 | sum >> 7) ^ data[i];
+  }
+
+  return sum;
+}
+
+// *********************************************************************************************
+// E2Prom address of the record for session number num.
+static int sessionAddr(uint16_t num)
+{
+  return SESSION_ADDR + (num % SESSION_HISTORY) * SESSION_REC_SIZE;
+}
+
+// *********************************************************************************************
+// Find the newest saved session. Call from setup() after EEPROM.begin().
+// On entry erase = true to clear the history (virgin EEPROM).
+void initSessions(bool erase)
+{
+  WeldSession ses;
+
+  if (erase) {
+    for (int i = SESSION_ADDR; i < SESSION_ADDR + SESSION_HISTORY * SESSION_REC_SIZE; i++) {
+      EEPROM.write(i, 0xff);
+    }
+    EEPROM.commit();
+  }
+
+  newestNum = SESSION_EMPTY;
+
+  for (int i = 0; i < SESSION_HISTORY; i++) {
+    EEPROM.get(SESSION_ADDR + i * SESSION_REC_SIZE, ses);
+
+    if ((ses.number != SESSION_EMPTY) && (ses.check == sessionCheck(ses)) &&
+        ((newestNum == SESSION_EMPTY) || (ses.number > newestNum))) {
+      newestNum = ses.number;
+    }
+  }
+
+  Serial.println("Weld Sessions: " + (newestNum == SESSION_EMPTY ? String("None Saved") :
+                                      "Newest is #" + String(newestNum)) + ".");
+}
+
+// *********************************************************************************************
+// Arc State change subscriber for the Weld Sessions. Called by the Control Task.
+void sessionArcEvent(const ArcEvent& evt)
+{
+  WeldSession ses;
+
+  if ((evt.state == ARC_ST_STRIKE) && (evt.prevState == ARC_ST_OPEN)) {
+    stats.begin();
+    active   = true;
+    lastUs   = evt.timeUs;
+    sesFlags = pulseSwitch == PULSE_ON ? SESSION_FLAG_PULSE : 0;
+    sesAmps  = setAmps;
+  }
+  else if (active && (evt.state == ARC_ST_STUCK)) {
+    sesFlags |= SESSION_FLAG_STUCK;
+  }
+  else if (active && (evt.state == ARC_ST_OPEN)) {
+    active = false;
+
+    if (stats.arcSec() * 1000.0f < SESSION_MIN_TIME) {
+      return; // Scratch start, not a weld.
+    }
+
+    memset(&ses, 0, sizeof(ses));
+    ses.arcMs       = (uint32_t)(stats.arcSec() * 1000.0f);
+    ses.energyJ     = (uint32_t)(stats.energyJ());
+    ses.meanAmpsX10 = (uint16_t)(stats.amps().mean() * 10.0f + 0.5f);
+    ses.sdAmpsX10   = (uint16_t)(stats.amps().stdDev() * 10.0f + 0.5f);
+    ses.peakAmps    = (uint16_t)(stats.amps().peak() + 0.5f);
+    ses.meanVoltsCv = (uint16_t)(stats.volts().mean() * 100.0f + 0.5f);
+    ses.sdVoltsCv   = (uint16_t)(stats.volts().stdDev() * 100.0f + 0.5f);
+    ses.peakVoltsCv = (uint16_t)(stats.volts().peak() * 100.0f + 0.5f);
+    ses.setAmps     = sesAmps;
+    ses.flags       = sesFlags;
+
+    portENTER_CRITICAL(&sessionMux);
+    finished    = ses;
+    finishedNew = true; // An unsaved session is replaced; loop() was stalled for several seconds.
+    portEXIT_CRITICAL(&sessionMux);
+  }
+}
+
+// *********************************************************************************************
+// Add one sample to the session in progress. Called by the Control Task on every tick.
+void sessionSample(const WeldSample& smp)
+{
+  float dt;
+  bool  arcOn;
+
+  if (!active) {
+    return;
+  }
+
+  dt     = (smp.timeUs - lastUs) / 1000000.0f;
+  dt     = dt > SESSION_MAX_DT ? SESSION_MAX_DT : dt;
+  lastUs = smp.timeUs;
+  arcOn  = (smp.state == ARC_ST_STRIKE) || (smp.state == ARC_ST_STABLE) || (smp.state == ARC_ST_SHORT);
+
+  stats.add(smp.voltsCv / 100.0f, smp.amps, dt, arcOn);
+}
+
+// *********************************************************************************************
+// Save a finished session and commit travel length changes. Called from loop().
+void processSessions(void)
+{
+  WeldSession ses;
+  bool        isNew;
+
+  portENTER_CRITICAL(&sessionMux);
+  isNew       = finishedNew;
+  ses         = finished;
+  finishedNew = false;
+  portEXIT_CRITICAL(&sessionMux);
+
+  if (isNew) {
+    newestNum  = newestNum == SESSION_EMPTY ? 0 : newestNum + 1;
+    ses.number = newestNum;
+    ses.check  = sessionCheck(ses);
+    EEPROM.put(sessionAddr(ses.number), ses);
+    EEPROM.commit();
+    travelDirty = false; // Included in this commit.
+
+    Serial.println("Weld Session #" + String(ses.number) + ": Arc " + String(ses.arcMs / 1000.0f, 1) + "S, Amps " +
+                   String(ses.meanAmpsX10 / 10.0f, 1) + " (Peak " + String(ses.peakAmps) + "), Volts " +
+                   String(ses.meanVoltsCv / 100.0f, 1) + " (Peak " + String(ses.peakVoltsCv / 100.0f, 1) + "), Energy " +
+                   String(ses.energyJ / 1000.0f, 1) + "kJ.");
+    refreshWeldStats();
+  }
+
+  if (travelDirty && (millis() - travelMillis >= EEP_DELAY_TIME)) {
+    travelDirty = false;
+    EEPROM.commit();
+    Serial.println("Weld Session travel length saved.");
+  }
+}
+
+// *********************************************************************************************
+// Get a saved session. age = 0 is the newest, 1 the one before it, and so on.
+// On exit, returns false if there is no such session.
+bool getWeldSession(int age, WeldSession *ses)
+{
+  uint16_t num;
+
+  if ((newestNum == SESSION_EMPTY) || (age < 0) || (age >= SESSION_HISTORY) || (age > newestNum)) {
+    return false;
+  }
+
+  num = newestNum - age;
+  EEPROM.get(sessionAddr(num), *ses);
+
+  return (ses->number == num) && (ses->check == sessionCheck(*ses));
+}
+
+// *********************************************************************************************
+// Change the travel (bead) length of a saved session. The E2Prom commit is delayed (flash wear).
+// On exit, returns false if there is no such session.
+bool setSessionTravel(int age, uint16_t travelMm)
+{
+  WeldSession ses;
+
+  if (!getWeldSession(age, &ses)) {
+    return false;
+  }
+
+  ses.travelMm = travelMm;
+  ses.check    = sessionCheck(ses);
+  EEPROM.put(sessionAddr(ses.number), ses);
+  travelDirty  = true;
+  travelMillis = millis();
+
+  return true;
+}
+
+// EOF
@@ -0,0 +1,359 @@
+/*
+   File: telemetry.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Binary Telemetry stream. See telemetry.h for the frame and record layout.
+   2. Records are put in lock-free single producer / single consumer queues. There is one queue per producer:
+      The Control Task (measurements, arc state changes) and loop() (events, settings changes). Do not call the
+      telemetry functions from any other task. A full queue drops the record; Nothing waits.
+   3. The Telemetry task empties the queues, adds the CRC, COBS encodes, and writes the frames. It only writes when
+      the UART FIFO has room for a whole frame, so it never spins on the Serial port.
+ */
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "PulseWelder.h"
+#include "telemetry.h"
+#include "config.h"
+
+// Queued record. The header's sequence number is added when the record is sent.
+struct TlmRecord {
+  uint32_t timeUs;             // Record time, in uS (lower 32 bits of esp_timer).
+  uint8_t  type;               // Record type, TLM_xxx.
+  uint8_t  len;                // Body length, in bytes.
+  uint8_t  body[TLM_BODY_MAX]; // Record body, little endian.
+};
+
+// Single producer / single consumer record queue.
+struct TlmQueue {
+  TlmRecord        *rec;     // Record storage.
+  uint32_t          mask;    // Queue size - 1.
+  volatile uint32_t head;    // Records added (producer only).
+  volatile uint32_t tail;    // Records removed (consumer only).
+  volatile uint32_t dropped; // Records dropped, queue was full (producer only).
+};
+
+// Global System vars
+extern byte systemError; // General hardware error state.
+
+#ifdef TELEMETRY_ON
+
+// Local Scope Vars
+static TlmRecord    ctrlRecs[TLM_CTRL_QUEUE];                        // Control Task queue storage.
+static TlmRecord    loopRecs[TLM_LOOP_QUEUE];                        // loop() queue storage.
+static TlmQueue     ctrlQueue = { ctrlRecs, TLM_CTRL_QUEUE - 1, 0, 0, 0 }; // Control Task records.
+static TlmQueue     loopQueue = { loopRecs, TLM_LOOP_QUEUE - 1, 0, 0, 0 }; // loop() records.
+static TaskHandle_t tlmTaskHandle = NULL;                              // Telemetry sender task.
+static uint16_t     tlmSeq        = 0;                                 // Sequence number of the next frame.
+
+static_assert((TLM_CTRL_QUEUE & (TLM_CTRL_QUEUE - 1)) == 0, "TLM_CTRL_QUEUE must be a power of two.");
+static_assert((TLM_LOOP_QUEUE & (TLM_LOOP_QUEUE - 1)) == 0, "TLM_LOOP_QUEUE must be a power of two.");
+
+// *********************************************************************************************
+// Compile-time CRC-16/CCITT-FALSE lookup table.
+constexpr uint16_t crcShift(uint16_t crc, int bits)
+{
+  return bits == 0 ? crc : crcShift((crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1), bits - 1);
+}
+
+constexpr uint16_t crcEntry(int idx)
+{
+  return crcShift((uint16_t)(idx << 8), 8);
+}
+
+constexpr uint16_t crcString(const char *str, uint16_t crc)
+{
+  return *str == 0 ? crc : crcString(str + 1, (uint16_t)((crc << 8) ^ crcEntry(((crc >> 8) ^ (uint8_t)(*str)) & 0xff)));
+}
+
+template<int... Idx>
+struct CrcTable {
+  static const uint16_t entry[sizeof...(Idx)];
+};
+
+template<int... Idx>
+const uint16_t CrcTable<Idx...>::entry[sizeof...(Idx)] = { crcEntry(Idx)... };
+
+template<int Cnt, int... Idx>
+struct MakeCrcTable : MakeCrcTable<Cnt - 1, Cnt - 1, Idx...> {};
+
+template<int... Idx>
+struct MakeCrcTable<0, Idx...> {
+  typedef CrcTable<Idx...> table;
+};
+
+typedef MakeCrcTable<256>::table Crc16Table;
+
+static_assert(crcString("123456789", 0xffff) == 0x29b1, "CRC-16/CCITT-FALSE check value is wrong.");
+
+// *********************************************************************************************
+// On exit, returns the CRC-16/CCITT-FALSE of buf.
+static uint16_t crc16(const uint8_t *buf, int len)
+{
+  uint16_t crc = 0xffff;
+
+  while (len-- > 0) {
+    crc = (uint16_t)((crc << 8) ^ Crc16Table::entry[((crc >> 8) ^ *buf++) & 0xff]);
+  }
+
+  return crc;
+}
+
+// *********************************************************************************************
+// COBS encode src into dst (dst must hold len + 1 + len / 254 bytes). The output has no zero bytes.
+// On exit, returns the encoded length.
+static int cobsEncode(const uint8_t *src, int len, uint8_t *dst)
+{
+  int     codeIdx = 0; // Position of the current code byte.
+  int     out     = 1;
+  uint8_t code    = 1;
+
+  for (int i = 0; i < len; i++) {
+    if (src[i] == 0) {
+      dst[codeIdx] = code;
+      codeIdx      = out++;
+      code         = 1;
+    }
+    else {
+      dst[out++] = src[i];
+
+      if (++code == 0xff) {
+        dst[codeIdx] = code;
+        codeIdx      = out++;
+        code         = 1;
+      }
+    }
+  }
+  dst[codeIdx] = code;
+
+  return out;
+}
+
+// *********************************************************************************************
+// Little endian body packing.
+static inline void put16(uint8_t *buf, uint16_t val)
+{
+  buf[0] = (uint8_t)(val);
+  buf[1] = (uint8_t)(val >> 8);
+}
+
+static inline void put32(uint8_t *buf, uint32_t val)
+{
+  put16(buf, (uint16_t)(val));
+  put16(buf + 2, (uint16_t)(val >> 16));
+}
+
+// *********************************************************************************************
+// Reserve the next record in a queue. Producer only.
+// On exit, returns NULL if the queue is full (the record is counted as dropped).
+static TlmRecord *tlmAlloc(TlmQueue *q, uint8_t type, uint8_t len, uint32_t timeUs)
+{
+  TlmRecord *rec;
+
+  if (q->head - q->tail > q->mask) {
+    q->dropped++;
+    return NULL;
+  }
+
+  rec         = &q->rec[q->head & q->mask];
+  rec->timeUs = timeUs;
+  rec->type   = type;
+  rec->len    = len;
+
+  return rec;
+}
+
+// *********************************************************************************************
+// Publish the record reserved by tlmAlloc(). Producer only.
+static void tlmCommit(TlmQueue *q)
+{
+  __sync_synchronize(); // Record contents must be visible before the head moves.
+  q->head = q->head + 1;
+}
+
+// *********************************************************************************************
+// Remove the oldest record from a queue. Consumer only.
+// On exit, returns false if the queue is empty.
+static bool tlmPop(TlmQueue *q, TlmRecord *rec)
+{
+  uint32_t tail = q->tail;
+
+  if (tail == q->head) {
+    return false;
+  }
+  __sync_synchronize(); // Read the record after the head.
+  *rec = q->rec[tail & q->mask];
+  __sync_synchronize(); // Finish the copy before the slot is released.
+  q->tail = tail + 1;
+
+  return true;
+}
+
+// *********************************************************************************************
+// Build and write one frame. Waits (without spinning) for room in the UART FIFO.
+static void sendFrame(uint8_t type, uint32_t timeUs, const uint8_t *body, int len)
+{
+  uint8_t rec[7 + TLM_BODY_MAX + 2];
+  uint8_t frame[TLM_FRAME_MAX];
+  int     cnt;
+
+  rec[0] = type;
+  put16(&rec[1], tlmSeq++);
+  put32(&rec[3], timeUs);
+  memcpy(&rec[7], body, len);
+  put16(&rec[7 + len], crc16(rec, 7 + len));
+
+  frame[0] = 0;
+  cnt      = 1 + cobsEncode(rec, 7 + len + 2, &frame[1]);
+  frame[cnt++] = 0;
+
+  while (Serial.availableForWrite() < cnt) {
+    vTaskDelay(1);
+  }
+  Serial.write(frame, cnt);
+}
+
+// *********************************************************************************************
+// Telemetry sender task. Empties the queues and sends the periodic status and settings records.
+static void telemetryTask(void *param)
+{
+  TlmRecord    rec;
+  ControlStats stats;
+  uint8_t      body[TLM_BODY_MAX];
+  uint32_t     statusMs   = 0;
+  uint32_t     settingsMs = 0;
+  bool         busy;
+
+  for (;;) {
+    busy = false;
+
+    while (tlmPop(&ctrlQueue, &rec)) {
+      sendFrame(rec.type, rec.timeUs, rec.body, rec.len);
+      busy = true;
+    }
+
+    while (tlmPop(&loopQueue, &rec)) {
+      sendFrame(rec.type, rec.timeUs, rec.body, rec.len);
+      busy = true;
+    }
+
+    if (millis() - statusMs >= TLM_STATUS_TIME) {
+      statusMs = millis();
+      getControlStats(&stats, false);
+      put32(&body[0], ctrlQueue.dropped);
+      put32(&body[4], loopQueue.dropped);
+      put32(&body[8], stats.overruns);
+      sendFrame(TLM_STATUS, (uint32_t)(esp_timer_get_time()), body, 12);
+    }
+
+    if (millis() - settingsMs >= TLM_SETTINGS_TIME) { // Saved settings, for decoders that start mid-stream.
+      settingsMs = millis();
+
+      for (int addr = AMP_SET_ADDR; addr <= LAST_SET_ADDR; addr++) {
+        body[0] = (uint8_t)(addr);
+        put16(&body[1], EEPROM.read(addr));
+        sendFrame(TLM_SETTING, (uint32_t)(esp_timer_get_time()), body, 3);
+      }
+    }
+
+    if (!busy) {
+      vTaskDelay(1);
+    }
+  }
+}
+
+#endif // ifdef TELEMETRY_ON
+
+// *********************************************************************************************
+// Start the Telemetry sender task. Call once from initControlTask(), before the Control Task starts.
+void initTelemetry(void)
+{
+#ifdef TELEMETRY_ON
+  if (tlmTaskHandle != NULL) {
+    return; // Already running.
+  }
+
+  xTaskCreatePinnedToCore(telemetryTask, "Telemetry", TLM_TASK_STACK, NULL, TLM_TASK_PRIO, &tlmTaskHandle, TLM_TASK_CORE);
+  telemEvent(TLM_EVT_BOOT, systemError);
+  Serial.println("Started Telemetry Stream: " + String(TELEM_MEAS_HZ) + "Hz Measurements, " + String(TELEM_BAUD) + " Baud.");
+#endif // ifdef TELEMETRY_ON
+}
+
+// *********************************************************************************************
+// Queue a measurement record. Control Task only.
+void telemSample(const WeldSample& smp)
+{
+#ifdef TELEMETRY_ON
+  TlmRecord *rec = tlmAlloc(&ctrlQueue, TLM_MEAS, 8, smp.timeUs);
+
+  if (rec != NULL) {
+    put16(&rec->body[0], (uint16_t)(smp.amps));
+    put16(&rec->body[2], smp.voltsCv);
+    rec->body[4] = smp.wiper;
+    rec->body[5] = smp.phase;
+    rec->body[6] = smp.state;
+    rec->body[7] = smp.flags;
+    tlmCommit(&ctrlQueue);
+  }
+#endif // ifdef TELEMETRY_ON
+}
+
+// *********************************************************************************************
+// Arc State change subscriber for the Telemetry stream. Called by the Control Task.
+void telemArcEvent(const ArcEvent& evt)
+{
+#ifdef TELEMETRY_ON
+  TlmRecord *rec = tlmAlloc(&ctrlQueue, TLM_ARC, 10, evt.timeUs);
+
+  if (rec != NULL) {
+    rec->body[0] = (uint8_t)(evt.state);
+    rec->body[1] = (uint8_t)(evt.prevState);
+    put32(&rec->body[2], evt.prevUs);
+    put16(&rec->body[6], (uint16_t)(evt.volts * 100.0f + 0.5f));
+    put16(&rec->body[8], (uint16_t)(evt.amps));
+    tlmCommit(&ctrlQueue);
+  }
+#endif // ifdef TELEMETRY_ON
+}
+
+// *********************************************************************************************
+// Queue an event record (TLM_EVT_xxx). loop() only.
+void telemEvent(byte code, int32_t value)
+{
+#ifdef TELEMETRY_ON
+  TlmRecord *rec = tlmAlloc(&loopQueue, TLM_EVENT, 5, (uint32_t)(esp_timer_get_time()));
+
+  if (rec != NULL) {
+    rec->body[0] = code;
+    put32(&rec->body[1], (uint32_t)(value));
+    tlmCommit(&loopQueue);
+  }
+#endif // ifdef TELEMETRY_ON
+}
+
+// *********************************************************************************************
+// Queue a settings change record. The id is the setting's E2Prom address. loop() only.
+void telemSetting(byte id, int value)
+{
+#ifdef TELEMETRY_ON
+  TlmRecord *rec = tlmAlloc(&loopQueue, TLM_SETTING, 3, (uint32_t)(esp_timer_get_time()));
+
+  if (rec != NULL) {
+    rec->body[0] = id;
+    put16(&rec->body[1], (uint16_t)(value));
+    tlmCommit(&loopQueue);
+  }
+#endif // ifdef TELEMETRY_ON
+}
+
+// EOF
@@ -0,0 +1,53 @@
+/*
+   File: telemetry.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Telemetry frame: 0x00, COBS(record + CRC), 0x00. The zero bytes are frame delimiters; Text log messages
+      between frames do not contain zeros, so the decoder can separate them (a text chunk fails the CRC check).
+   2. Record (little endian): type (1 byte), sequence (2 bytes), time in uS (4 bytes), body (TLM_xxx, below).
+      The CRC is CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) of the record, sent low byte first.
+      A gap in the sequence number is a frame lost on the Serial link (bad CRC). Records dropped because a queue was
+      full are counted in the TLM_STATUS record.
+   3. tools/telemetry_decode.py decodes the stream. Keep it in step with this file.
+ */
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+// Record types and bodies.
+#define TLM_MEAS 0x01             // amps (i16), voltsCv (u16), wiper (u8), phase (u8), state (u8), flags (u8).
+#define TLM_ARC 0x02              // state (u8), prevState (u8), prevUs (u32), voltsCv (u16), amps (i16).
+#define TLM_SETTING 0x03          // id (u8, E2Prom address), value (i16).
+#define TLM_EVENT 0x04            // code (u8, TLM_EVT_xxx), value (i32).
+#define TLM_STATUS 0x05           // ctrlDropped (u32), loopDropped (u32), overruns (u32).
+
+// Event codes.
+#define TLM_EVT_BOOT 0x01         // Telemetry started. Value is the System Error bits (ERROR_xxx).
+#define TLM_EVT_STICK 0x02        // Anti-Stick reduced the current. Value is the stuck rod count.
+#define TLM_EVT_UNSTICK 0x03      // Anti-Stick restored the current.
+#define TLM_EVT_HOT_START 0x04    // Hot Start boost at rod strike. Value is the strike count.
+#define TLM_EVT_HEAT 0x05         // Over temperature alert. Value is 1 (alert) or 0 (cleared).
+#define TLM_EVT_CAPTURE 0x06      // Telemetry Recorder capture finished. Value is the trigger (REC_TRIG_xxx).
+
+#define TLM_BODY_MAX 12           // Largest record body, in bytes.
+#define TLM_FRAME_MAX (2 + 7 + TLM_BODY_MAX + 2 + 2) // Delimiters, header, body, CRC, COBS overhead.
+#define TLM_CTRL_QUEUE 256        // Control Task record queue size (power of two).
+#define TLM_LOOP_QUEUE 32         // loop() record queue size (power of two).
+#define TLM_TASK_CORE 0           // CPU Core for the Telemetry sender task.
+#define TLM_TASK_PRIO 1           // Telemetry sender task priority.
+#define TLM_TASK_STACK 3072       // Telemetry sender task stack size, in bytes.
+#define TLM_STATUS_TIME 1000      // Status record interval, in mS.
+#define TLM_SETTINGS_TIME 5000    // All settings are sent at this interval, in mS.
+
+#endif // ifndef __TELEMETRY_H__
+
+// EOF
@@ -0,0 +1,251 @@
+/*
+   File: tftCanvas.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Off-screen region canvas with dirty rectangle flush, see tftCanvas.h.
+   2. The canvas is the size of the screen in landscape (rotation 1), so text clipping and wrapping are the same as
+      on the display. Adafruit_GFX draws text and shapes with drawPixel() and fillRect(), which are clipped here.
+ */
+
+#include <Arduino.h>
+#include "tftCanvas.h"
+
+// *********************************************************************************************
+TftCanvas::TftCanvas(TftDisplay& display, int16_t x, int16_t y, int16_t w, int16_t h) :
+  Adafruit_GFX(ILI9341_TFTHEIGHT, ILI9341_TFTWIDTH), tft(display)
+{
+  rgnX       = x;
+  rgnY       = y;
+  rgnW       = w;
+  rgnH       = h;
+  back       = NULL;
+  front      = NULL;
+  frontValid = false;
+  pushSeq    = 0;
+  frameUs    = 0;
+  directPx   = 0;
+  getStats(NULL, true);
+}
+
+// *********************************************************************************************
+// Allocate the back and front buffers in PSRAM. Call once after the display is initialized.
+// On exit, returns false if PSRAM is not available; Drawing then goes straight to the display.
+bool TftCanvas::begin(void)
+{
+  size_t bytes = (size_t)(rgnW) * rgnH * sizeof(uint16_t);
+
+  if (back != NULL) {
+    return true; // Already allocated.
+  }
+
+  if (!psramFound()) {
+    return false;
+  }
+
+  back  = (uint16_t *)(ps_malloc(bytes));
+  front = (uint16_t *)(ps_malloc(bytes));
+
+  if ((back == NULL) || (front == NULL)) {
+    free(back);
+    free(front);
+    back  = NULL;
+    front = NULL;
+    return false;
+  }
+
+  memset(back, 0, bytes);
+  frontValid = false;
+
+  return true;
+}
+
+// *********************************************************************************************
+// Start a frame (before the drawing). The frame time is measured from here to the end of flush().
+void TftCanvas::beginFrame(void)
+{
+  frameUs  = micros();
+  directPx = 0;
+}
+
+// *********************************************************************************************
+// Clip a rectangle to the canvas region.
+// On exit, returns false if nothing is left.
+bool TftCanvas::clip(int16_t *x, int16_t *y, int16_t *w, int16_t *h)
+{
+  int16_t x1 = min((int16_t)(*x + *w), (int16_t)(rgnX + rgnW));
+  int16_t y1 = min((int16_t)(*y + *h), (int16_t)(rgnY + rgnH));
+
+  *x = max(*x, rgnX);
+  *y = max(*y, rgnY);
+  *w = x1 - *x;
+  *h = y1 - *y;
+
+  return (*w > 0) && (*h > 0);
+}
+
+// *********************************************************************************************
+void TftCanvas::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+  if ((x < rgnX) || (y < rgnY) || (x >= rgnX + rgnW) || (y >= rgnY + rgnH)) {
+    return;
+  }
+
+  if (back == NULL) {
+    tft.drawPixel(x, y, color);
+    directPx++;
+    return;
+  }
+  back[(y - rgnY) * rgnW + (x - rgnX)] = color;
+}
+
+// *********************************************************************************************
+void TftCanvas::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  uint16_t *row;
+
+  if (!clip(&x, &y, &w, &h)) {
+    return;
+  }
+
+  if (back == NULL) {
+    tft.fillRect(x, y, w, h, color);
+    directPx += (uint32_t)(w) * h;
+    return;
+  }
+
+  for (int16_t j = 0; j < h; j++) {
+    row = &back[(y - rgnY + j) * rgnW + (x - rgnX)];
+
+    for (int16_t i = 0; i < w; i++) {
+      row[i] = color;
+    }
+  }
+}
+
+// *********************************************************************************************
+void TftCanvas::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  fillRect(x, y, w, 1, color);
+}
+
+// *********************************************************************************************
+void TftCanvas::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  fillRect(x, y, 1, h, color);
+}
+
+// *********************************************************************************************
+// Fill the canvas region (not the whole screen).
+void TftCanvas::fillScreen(uint16_t color)
+{
+  fillRect(rgnX, rgnY, rgnW, rgnH, color);
+}
+
+// *********************************************************************************************
+// Find the bounding box of the pixels that differ between the back and front buffers (region coordinates, inclusive).
+// On exit, returns false if nothing has changed.
+bool TftCanvas::dirtyBox(int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1)
+{
+  const uint16_t *b;
+  const uint16_t *f;
+  int16_t         i;
+
+  *x0 = rgnW;
+  *x1 = -1;
+  *y0 = -1;
+  *y1 = -1;
+
+  for (int16_t j = 0; j < rgnH; j++) {
+    b = &back[j * rgnW];
+    f = &front[j * rgnW];
+
+    if (memcmp(b, f, rgnW * sizeof(uint16_t)) == 0) {
+      continue;
+    }
+
+    for (i = 0; (i < *x0) && (b[i] == f[i]); i++) {
+    }
+    *x0 = i;
+
+    for (i = rgnW - 1; (i > *x1) && (b[i] == f[i]); i--) {
+    }
+    *x1 = i;
+
+    *y0 = *y0 < 0 ? j : *y0;
+    *y1 = j;
+  }
+
+  return *y0 >= 0;
+}
+
+// *********************************************************************************************
+// End a frame: Send the changed pixels to the display, one address window for their bounding box.
+// On exit, returns the number of pixels sent.
+uint32_t TftCanvas::flush(void)
+{
+  uint32_t pixels = directPx;
+  uint32_t us;
+  int16_t  x0     = 0;
+  int16_t  y0     = 0;
+  int16_t  x1     = rgnW - 1;
+  int16_t  y1     = rgnH - 1;
+  int16_t  w;
+
+  if ((back != NULL) && (!frontValid || dirtyBox(&x0, &y0, &x1, &y1))) {
+    w      = x1 - x0 + 1;
+    pixels = (uint32_t)(w) * (y1 - y0 + 1);
+    tft.waitDone(pushSeq); // The last push reads the front buffer.
+
+    for (int16_t j = y0; j <= y1; j++) {
+      memcpy(&front[j * rgnW + x0], &back[j * rgnW + x0], w * sizeof(uint16_t));
+    }
+    pushSeq    = tft.pushPixels(rgnX + x0, rgnY + y0, w, y1 - y0 + 1, &front[y0 * rgnW + x0], rgnW);
+    frontValid = true;
+  }
+
+  us        = micros() - frameUs;
+  totalUs  += us;
+  maxUs     = max(maxUs, us);
+  pixelCnt += pixels;
+  pushCnt  += pixels > 0 ? 1 : 0;
+  frameCnt++;
+  directPx = 0;
+
+  return pixels;
+}
+
+// *********************************************************************************************
+// Get a copy of the canvas statistics (stats may be NULL).
+// On entry rst = true to clear the statistics after they are copied.
+void TftCanvas::getStats(CanvasStats *stats, bool rst)
+{
+  if (stats != NULL) {
+    stats->frames   = frameCnt;
+    stats->pushes   = pushCnt;
+    stats->pixels   = pixelCnt;
+    stats->regionPx = (uint32_t)(rgnW) * rgnH;
+    stats->avgUs    = frameCnt == 0 ? 0 : (uint32_t)(totalUs / frameCnt);
+    stats->maxUs    = maxUs;
+    stats->buffered = back != NULL;
+  }
+
+  if (rst) {
+    frameCnt = 0;
+    pushCnt  = 0;
+    pixelCnt = 0;
+    totalUs  = 0;
+    maxUs    = 0;
+  }
+}
+
+// EOF
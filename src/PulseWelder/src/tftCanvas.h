@@ -0,0 +1,108 @@
+/*
+   File: tftCanvas.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Off-screen region canvas (sprite) for the TFT display. It is an Adafruit_GFX, so the existing drawing code is
+      unchanged: It draws with screen coordinates, and only the pixels inside the canvas region are kept.
+   2. Two RGB565 buffers are kept in PSRAM: The back buffer is drawn into, the front buffer holds what the display
+      shows. flush() finds the bounding box of the changed pixels and sends it in one address window burst, so
+      erasing and redrawing a value does not flash and unchanged pixels are not sent.
+   3. If begin() is not called (TFT_CANVAS_ON disabled) or PSRAM is not available, drawing goes straight to the
+      display as before. The statistics are kept in both modes, for a before and after comparison.
+   4. Call invalidate() after anything else draws over the region (page redraws), so the next flush() sends all of it.
+   5. The changed pixels are sent from the front buffer by the Display Engine (tftDisplay.h). The next flush() waits
+      for that job before the front buffer is updated again.
+ */
+#ifndef __TFT_CANVAS_H__
+#define __TFT_CANVAS_H__
+
+#include <Adafruit_GFX.h>
+#include "tftDisplay.h"
+
+// Canvas statistics, see TftCanvas::getStats().
+struct CanvasStats {
+  uint32_t frames;   // Frames (flush() calls).
+  uint32_t pushes;   // Frames that sent pixels to the display.
+  uint32_t pixels;   // Pixels sent to the display.
+  uint32_t regionPx; // Canvas region size, in pixels. Erasing and redrawing the region sends at least this per frame.
+  uint32_t avgUs;    // Average frame time in loop() (drawing, and sending or queuing), in uS.
+  uint32_t maxUs;    // Worst case frame time, in uS.
+  bool     buffered; // Off-screen buffers in use (false: drawing goes straight to the display).
+};
+
+class TftCanvas : public Adafruit_GFX {
+public:
+
+  TftCanvas(TftDisplay& display,
+            int16_t     x,
+            int16_t     y,
+            int16_t     w,
+            int16_t     h);
+
+  bool     begin(void);
+  void     beginFrame(void);
+  uint32_t flush(void);
+  void     invalidate(void) { frontValid = false; }
+  void     getStats(CanvasStats *stats,
+                    bool         rst);
+
+  void     drawPixel(int16_t  x,
+                     int16_t  y,
+                     uint16_t color);
+  void     drawFastHLine(int16_t  x,
+                         int16_t  y,
+                         int16_t  w,
+                         uint16_t color);
+  void     drawFastVLine(int16_t  x,
+                         int16_t  y,
+                         int16_t  h,
+                         uint16_t color);
+  void     fillRect(int16_t  x,
+                    int16_t  y,
+                    int16_t  w,
+                    int16_t  h,
+                    uint16_t color);
+  void     fillScreen(uint16_t color);
+
+private:
+
+  bool     clip(int16_t *x,
+                int16_t *y,
+                int16_t *w,
+                int16_t *h);
+  bool     dirtyBox(int16_t *x0,
+                    int16_t *y0,
+                    int16_t *x1,
+                    int16_t *y1);
+
+  TftDisplay& tft;        // Display.
+  int16_t     rgnX;       // Region on the screen.
+  int16_t     rgnY;
+  int16_t     rgnW;
+  int16_t     rgnH;
+  uint16_t   *back;       // Back buffer (drawn into), rgnW x rgnH. NULL if not buffered.
+  uint16_t   *front;      // Front buffer (what the display shows).
+  bool        frontValid; // Front buffer matches the display.
+  uint32_t    pushSeq;    // Display Engine job that sends the front buffer.
+  uint32_t    frameUs;    // Frame start time, see beginFrame().
+  uint32_t    directPx;   // Pixels sent straight to the display in this frame (not buffered).
+  uint32_t    frameCnt;   // Statistics.
+  uint32_t    pushCnt;
+  uint32_t    pixelCnt;
+  uint64_t    totalUs;
+  uint32_t    maxUs;
+};
+
+#endif // ifndef __TFT_CANVAS_H__
+
+// EOF
@@ -0,0 +1,578 @@
+/*
+   File: tftDisplay.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. ILI9341 display with the Display Engine, see tftDisplay.h.
+   2. The job queue has one writer (loop()) and one reader (the Display Engine task), so it needs no lock: loop()
+      fills a slot then advances head, the Display Engine runs a job then advances tail. A job's sequence number is
+      head after it is queued; It is done when tail reaches it.
+   3. The Adafruit ILI9341 library has no DMA support on the ESP32 (the Arduino SPI driver sends from its FIFO). The
+      Display Engine gives the same effect for loop(): The transfers run on the other core while loop() goes on.
+   4. Bitmaps are sent as runs of set pixels, one address window per run, instead of one window per pixel.
+ */
+
+#include <Arduino.h>
+#include "PulseWelder.h"
+#include "config.h"
+#include "tftDisplay.h"
+
+#define TFT_JOB_FILL 0      // Solid rectangle.
+#define TFT_JOB_BITMAP 1    // 1 bit bitmap (MSB first, rows padded to bytes), set pixels only.
+#define TFT_JOB_PIXELS 2    // RGB565 pixel block.
+#define TFT_WINDOW_COST 6   // Address window setup (CASET, PASET, RAMWR), in pixel times. For the burst length.
+
+static portMUX_TYPE tftStatsMux = portMUX_INITIALIZER_UNLOCKED; // Protects the statistics and page draw state.
+
+// *********************************************************************************************
+TftDisplay::TftDisplay(int8_t cs, int8_t dc, int8_t rst) : Adafruit_ILI9341(cs, dc, rst)
+{
+  ring         = NULL;
+  head         = 0;
+  tail         = 0;
+  pendingValid = false;
+  writeDepth   = 0;
+  taskHandle   = NULL;
+  inBurst      = false;
+  burstPx      = 0;
+  burstUs      = 0;
+  pageStartUs  = 0;
+  pageSeq      = 0;
+  pageOpen     = false;
+  getStats(NULL, true);
+}
+
+// *********************************************************************************************
+// Allocate the job queue and start the Display Engine task. Call once, after begin() and setRotation().
+// On exit, returns false if the queue could not be allocated; Drawing stays synchronous.
+bool TftDisplay::beginAsync(void)
+{
+  if (taskHandle != NULL) {
+    return true; // Already running.
+  }
+
+  ring = (TftJob *)(malloc(TFT_RING_JOBS * sizeof(TftJob)));
+
+  if (ring == NULL) {
+    return false;
+  }
+
+  xTaskCreatePinnedToCore(engineTask, "Display", TFT_TASK_STACK, this, TFT_TASK_PRIO, &taskHandle, TFT_TASK_CORE);
+
+  return taskHandle != NULL;
+}
+
+// *********************************************************************************************
+void TftDisplay::engineTask(void *param)
+{
+  ((TftDisplay *)(param))->engine();
+}
+
+// *********************************************************************************************
+// Display Engine task. Runs the queued jobs in order; Sleeps (bus released) when the queue is empty.
+void TftDisplay::engine(void)
+{
+  TftJob   job;
+  uint32_t pixels;
+
+  for (;;) {
+    if (tail == head) {
+      endBurst();
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY); // Sleep until jobs are queued.
+      continue;
+    }
+    __sync_synchronize();
+    job = ring[tail & (TFT_RING_JOBS - 1)];
+
+    if (!inBurst) {
+      startBurst();
+    }
+    pixels = runJob(job);
+    __sync_synchronize();
+
+    portENTER_CRITICAL(&tftStatsMux);
+    tail++;
+    stats.jobs++;
+    stats.pixels += pixels;
+
+    if (pageOpen && ((int32_t)(tail - pageSeq) >= 0)) {
+      pageDone(micros());
+    }
+    portEXIT_CRITICAL(&tftStatsMux);
+  }
+}
+
+// *********************************************************************************************
+// Take the SPI bus (Display Engine).
+void TftDisplay::startBurst(void)
+{
+  Adafruit_ILI9341::startWrite();
+  inBurst = true;
+  burstPx = 0;
+  burstUs = micros();
+}
+
+// *********************************************************************************************
+// Release the SPI bus (Display Engine).
+void TftDisplay::endBurst(void)
+{
+  uint32_t us;
+
+  if (!inBurst) {
+    return;
+  }
+  Adafruit_ILI9341::endWrite();
+  inBurst = false;
+  us      = micros() - burstUs;
+
+  portENTER_CRITICAL(&tftStatsMux);
+  stats.busMaxUs = max(stats.busMaxUs, us);
+  portEXIT_CRITICAL(&tftStatsMux);
+}
+
+// *********************************************************************************************
+// Count the pixels of the next address window (px includes its setup). If they would make this bus hold longer than
+// TFT_BURST_PX, the bus is released first, so the Touch controller (and the Digital Pot, MCP41HV51 variant) can get in.
+void TftDisplay::burstPixels(uint32_t px)
+{
+  if ((burstPx != 0) && (burstPx + px > TFT_BURST_PX)) {
+    endBurst();
+    startBurst();
+  }
+  burstPx += px;
+}
+
+// *********************************************************************************************
+// Send one job to the display (Display Engine). Large jobs are sent in bursts of rows.
+// On exit, returns the number of pixels sent.
+uint32_t TftDisplay::runJob(const TftJob& job)
+{
+  const uint16_t *pixels = (const uint16_t *)(job.data);
+  int16_t         rows;
+  int16_t         n;
+
+  if (job.type == TFT_JOB_BITMAP) {
+    return runBitmap(job);
+  }
+  rows = max(1, (TFT_BURST_PX - TFT_WINDOW_COST) / job.w); // Rows per address window.
+
+  for (int16_t r = 0; r < job.h; r += n) {
+    n = min(rows, (int16_t)(job.h - r));
+    burstPixels((uint32_t)(job.w) * n + TFT_WINDOW_COST);
+    setAddrWindow(job.x, job.y + r, job.w, n);
+
+    if (job.type == TFT_JOB_FILL) {
+      writeColor(job.color, (uint32_t)(job.w) * n);
+    }
+    else {
+      for (int16_t j = r; j < r + n; j++) {
+        writePixels((uint16_t *)(&pixels[j * job.stride]), job.w);
+      }
+    }
+  }
+
+  return (uint32_t)(job.w) * job.h;
+}
+
+// *********************************************************************************************
+// Send a bitmap job's set pixels, as horizontal runs (Display Engine). Clipped to the screen.
+// On exit, returns the number of pixels sent.
+uint32_t TftDisplay::runBitmap(const TftJob& job)
+{
+  const uint8_t *bitmap    = (const uint8_t *)(job.data);
+  int16_t        byteWidth = (job.w + 7) / 8;
+  uint32_t       pixels    = 0;
+  int16_t        x0;
+  int16_t        x1;
+  int16_t        i;
+
+  for (int16_t j = 0; j < job.h; j++) {
+    if ((job.y + j < 0) || (job.y + j >= _height)) {
+      continue;
+    }
+
+    for (i = 0; i < job.w; ) {
+      if ((pgm_read_byte(&bitmap[j * byteWidth + i / 8]) & (0x80 >> (i & 7))) == 0) {
+        i++;
+        continue;
+      }
+
+      for (x0 = i; (i < job.w) && (pgm_read_byte(&bitmap[j * byteWidth + i / 8]) & (0x80 >> (i & 7))); i++) {
+      }
+      x1 = i;                                             // Run is x0 to x1 - 1.
+      x0 = max((int16_t)(job.x + x0), (int16_t)(0));
+      x1 = min((int16_t)(job.x + x1), (int16_t)(_width));
+
+      if (x1 > x0) {
+        burstPixels(x1 - x0 + TFT_WINDOW_COST);
+        setAddrWindow(x0, job.y + j, x1 - x0, 1);
+        writeColor(job.color, x1 - x0);
+        pixels += x1 - x0;
+      }
+    }
+  }
+
+  return pixels;
+}
+
+// *********************************************************************************************
+// Queue a fill, clipped to the screen.
+void TftDisplay::queueFill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  TftJob job;
+
+  if (x < 0) {
+    w += x;
+    x  = 0;
+  }
+
+  if (y < 0) {
+    h += y;
+    y  = 0;
+  }
+  w = min(w, (int16_t)(_width - x));
+  h = min(h, (int16_t)(_height - y));
+
+  if ((w <= 0) || (h <= 0)) {
+    return;
+  }
+
+  job.type  = TFT_JOB_FILL;
+  job.x     = x;
+  job.y     = y;
+  job.w     = w;
+  job.h     = h;
+  job.color = color;
+  job.data  = NULL;
+  queueJob(job);
+}
+
+// *********************************************************************************************
+// Add a job. A fill that continues the last one (same row and color) is merged into it.
+void TftDisplay::queueJob(const TftJob& job)
+{
+  if (pendingValid && (job.type == TFT_JOB_FILL) && (pending.type == TFT_JOB_FILL) && (job.color == pending.color) &&
+      (job.y == pending.y) && (job.h == pending.h) && (job.x == pending.x + pending.w)) {
+    pending.w += job.w;
+    return;
+  }
+  publish();
+  pending      = job;
+  pendingValid = true;
+}
+
+// *********************************************************************************************
+// Put the pending job in the queue. Waits for the Display Engine if the queue is full.
+void TftDisplay::publish(void)
+{
+  uint32_t startUs;
+
+  if (!pendingValid) {
+    return;
+  }
+
+  if (head - tail >= TFT_RING_JOBS) {
+    startUs = micros();
+    xTaskNotifyGive(taskHandle);
+
+    while (head - tail >= TFT_RING_JOBS) {
+      vTaskDelay(1);
+    }
+    waitStats(startUs);
+  }
+
+  ring[head & (TFT_RING_JOBS - 1)] = pending;
+  __sync_synchronize();
+  head++;
+  pendingValid = false;
+}
+
+// *********************************************************************************************
+// Queue the pending job and wake the Display Engine.
+void TftDisplay::kick(void)
+{
+  publish();
+  xTaskNotifyGive(taskHandle);
+}
+
+// *********************************************************************************************
+// Count a loop() wait for the Display Engine.
+void TftDisplay::waitStats(uint32_t startUs)
+{
+  portENTER_CRITICAL(&tftStatsMux);
+  stats.waits++;
+  stats.waitUs += micros() - startUs;
+  portEXIT_CRITICAL(&tftStatsMux);
+}
+
+// *********************************************************************************************
+// Wait until a job (sequence number from pushPixels()) is done, so its data can be changed. Zero does not wait.
+void TftDisplay::waitDone(uint32_t seq)
+{
+  uint32_t startUs;
+
+  if ((taskHandle == NULL) || ((int32_t)(tail - seq) >= 0)) {
+    return;
+  }
+  startUs = micros();
+  kick();
+
+  while ((int32_t)(tail - seq) < 0) {
+    vTaskDelay(1);
+  }
+  waitStats(startUs);
+}
+
+// *********************************************************************************************
+// Send an RGB565 pixel block (stride pixels per row). The pixels must not change until the job is done.
+// On exit, returns the job's sequence number for waitDone() (zero when drawing is synchronous).
+uint32_t TftDisplay::pushPixels(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t *pixels, uint16_t stride)
+{
+  TftJob job;
+
+  if (taskHandle == NULL) {
+    Adafruit_ILI9341::startWrite();
+    setAddrWindow(x, y, w, h);
+
+    for (int16_t j = 0; j < h; j++) {
+      writePixels((uint16_t *)(&pixels[j * stride]), w); // Rows of the window are sent back to back (one burst).
+    }
+    Adafruit_ILI9341::endWrite();
+
+    return 0;
+  }
+
+  job.type   = TFT_JOB_PIXELS;
+  job.x      = x;
+  job.y      = y;
+  job.w      = w;
+  job.h      = h;
+  job.data   = pixels;
+  job.stride = stride;
+  queueJob(job);
+  kick();
+
+  return head;
+}
+
+// *********************************************************************************************
+// Draw a 1 bit bitmap (set pixels only) as a single job.
+void TftDisplay::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+{
+  TftJob job;
+
+  if (taskHandle == NULL) {
+    Adafruit_GFX::drawBitmap(x, y, bitmap, w, h, color);
+    return;
+  }
+
+  job.type  = TFT_JOB_BITMAP;
+  job.x     = x;
+  job.y     = y;
+  job.w     = w;
+  job.h     = h;
+  job.color = color;
+  job.data  = bitmap;
+  queueJob(job);
+
+  if (writeDepth == 0) {
+    kick();
+  }
+}
+
+// *********************************************************************************************
+void TftDisplay::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+  if (taskHandle == NULL) {
+    Adafruit_ILI9341::drawPixel(x, y, color);
+    return;
+  }
+  queueFill(x, y, 1, 1, color);
+
+  if (writeDepth == 0) {
+    kick();
+  }
+}
+
+// *********************************************************************************************
+void TftDisplay::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  if (taskHandle == NULL) {
+    Adafruit_ILI9341::drawFastHLine(x, y, w, color);
+    return;
+  }
+  queueFill(x, y, w, 1, color);
+
+  if (writeDepth == 0) {
+    kick();
+  }
+}
+
+// *********************************************************************************************
+void TftDisplay::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  if (taskHandle == NULL) {
+    Adafruit_ILI9341::drawFastVLine(x, y, h, color);
+    return;
+  }
+  queueFill(x, y, 1, h, color);
+
+  if (writeDepth == 0) {
+    kick();
+  }
+}
+
+// *********************************************************************************************
+// Also used by fillScreen().
+void TftDisplay::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  if (taskHandle == NULL) {
+    Adafruit_ILI9341::fillRect(x, y, w, h, color);
+    return;
+  }
+  queueFill(x, y, w, h, color);
+
+  if (writeDepth == 0) {
+    kick();
+  }
+}
+
+// *********************************************************************************************
+// Adafruit_GFX brackets its drawing (text, shapes) with startWrite() and endWrite(). When the Display Engine runs they
+// only group the jobs; The queue is sent when the outer endWrite() is reached.
+void TftDisplay::startWrite(void)
+{
+  if (taskHandle == NULL) {
+    Adafruit_ILI9341::startWrite();
+    return;
+  }
+  writeDepth++;
+}
+
+// *********************************************************************************************
+void TftDisplay::endWrite(void)
+{
+  if (taskHandle == NULL) {
+    Adafruit_ILI9341::endWrite();
+    return;
+  }
+  writeDepth = max(writeDepth - 1, 0);
+
+  if (writeDepth == 0) {
+    kick();
+  }
+}
+
+// *********************************************************************************************
+void TftDisplay::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+  if (taskHandle == NULL) {
+    Adafruit_ILI9341::writePixel(x, y, color);
+    return;
+  }
+  queueFill(x, y, 1, 1, color);
+}
+
+// *********************************************************************************************
+void TftDisplay::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  if (taskHandle == NULL) {
+    Adafruit_ILI9341::writeFastHLine(x, y, w, color);
+    return;
+  }
+  queueFill(x, y, w, 1, color);
+}
+
+// *********************************************************************************************
+void TftDisplay::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  if (taskHandle == NULL) {
+    Adafruit_ILI9341::writeFastVLine(x, y, h, color);
+    return;
+  }
+  queueFill(x, y, 1, h, color);
+}
+
+// *********************************************************************************************
+void TftDisplay::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  if (taskHandle == NULL) {
+    Adafruit_ILI9341::writeFillRect(x, y, w, h, color);
+    return;
+  }
+  queueFill(x, y, w, h, color);
+}
+
+// *********************************************************************************************
+// Start timing a page draw.
+void TftDisplay::beginPage(void)
+{
+  pageStartUs = micros();
+}
+
+// *********************************************************************************************
+// End of a page draw in loop(). The page draw time ends when its last job is done (now, if synchronous).
+void TftDisplay::endPage(void)
+{
+  uint32_t loopUs = micros() - pageStartUs;
+
+  if (taskHandle != NULL) {
+    kick();
+  }
+
+  portENTER_CRITICAL(&tftStatsMux);
+  stats.pages++;
+  stats.loopMaxUs = max(stats.loopMaxUs, loopUs);
+  loopTotalUs    += loopUs;
+  pageSeq         = head;
+  pageOpen        = true;
+
+  if ((int32_t)(tail - pageSeq) >= 0) {
+    pageDone(micros());
+  }
+  portEXIT_CRITICAL(&tftStatsMux);
+}
+
+// *********************************************************************************************
+// Record the page draw time. Called with tftStatsMux held.
+void TftDisplay::pageDone(uint32_t nowUs)
+{
+  uint32_t us = nowUs - pageStartUs;
+
+  pageOpen        = false;
+  stats.drawMaxUs = max(stats.drawMaxUs, us);
+  drawTotalUs    += us;
+}
+
+// *********************************************************************************************
+// Get a copy of the display statistics (stats may be NULL).
+// On entry rst = true to clear the statistics after they are copied.
+void TftDisplay::getStats(TftStats *stats, bool rst)
+{
+  portENTER_CRITICAL(&tftStatsMux);
+
+  if (stats != NULL) {
+    *stats           = this->stats;
+    stats->loopAvgUs = this->stats.pages == 0 ? 0 : (uint32_t)(loopTotalUs / this->stats.pages);
+    stats->drawAvgUs = this->stats.pages == 0 ? 0 : (uint32_t)(drawTotalUs / this->stats.pages);
+    stats->async     = taskHandle != NULL;
+  }
+
+  if (rst) {
+    memset(&this->stats, 0, sizeof(this->stats));
+    loopTotalUs = 0;
+    drawTotalUs = 0;
+  }
+  portEXIT_CRITICAL(&tftStatsMux);
+}
+
+// EOF
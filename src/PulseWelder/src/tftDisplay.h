@@ -0,0 +1,165 @@
+/*
+   File: tftDisplay.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. ILI9341 display with asynchronous transfers (Display Engine). The drawing primitives that all Adafruit_GFX
+      drawing reduces to (pixels, lines, fills) and bitmap blits are queued as jobs; loop() returns as soon as they
+      are queued. The Display Engine task (core 0) sends them to the display in queue order, so the drawing order is
+      unchanged and page code still draws with tft as before.
+   2. The display shares the SPI bus with the Touch controller, and with the Digital Pot on boards with the MCP41HV51
+      (SPI) variant; The MCP45HV51 is on the I2C bus. Each of them takes the bus with SPI.beginTransaction(). The
+      Display Engine releases the bus before a hold passes TFT_BURST_PX pixels, so a full screen fill holds off a touch
+      read or an MCP41HV51 write (Control Task) for less than TFT_BURST_PX pixel times.
+   3. Jobs point to their data (bitmaps in flash, canvas buffers); It must not change until the job is done, see
+      waitDone(). Adjacent single row fills of the same color (text glyph pixels) are merged into one job.
+   4. Until beginAsync() is called (TFT_ASYNC_ON disabled, or no memory for the queue) drawing is synchronous, as in
+      V1.3. The page draw and loop() stall times are measured in both modes, for a before and after comparison.
+ */
+#ifndef __TFT_DISPLAY_H__
+#define __TFT_DISPLAY_H__
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_ILI9341.h>
+
+// Display Engine job (see TftDisplay).
+struct TftJob {
+  const void *data;   // Bitmap or RGB565 pixels. Not copied.
+  int16_t     x;      // Screen area.
+  int16_t     y;
+  int16_t     w;
+  int16_t     h;
+  uint16_t    color;  // Fill or bitmap color.
+  uint16_t    stride; // Pixel row pitch, in pixels.
+  uint8_t     type;   // TFT_JOB_xxx.
+};
+
+// Display statistics, see TftDisplay::getStats().
+struct TftStats {
+  uint32_t pages;      // Page draws (beginPage() to endPage()).
+  uint32_t loopAvgUs;  // loop() time spent in a page draw, in uS.
+  uint32_t loopMaxUs;
+  uint32_t drawAvgUs;  // Page draw time until it is all on the display, in uS.
+  uint32_t drawMaxUs;
+  uint32_t jobs;       // Display Engine jobs done.
+  uint32_t pixels;     // Pixels sent by the Display Engine.
+  uint32_t busMaxUs;   // Longest SPI bus hold by the Display Engine, in uS.
+  uint32_t waits;      // Times loop() waited for the Display Engine (queue full, or job data reuse).
+  uint32_t waitUs;     // Total loop() wait time, in uS.
+  bool     async;      // Display Engine is running (false: synchronous drawing).
+};
+
+class TftDisplay : public Adafruit_ILI9341 {
+public:
+
+  TftDisplay(int8_t cs,
+             int8_t dc,
+             int8_t rst);
+
+  bool     beginAsync(void);
+  void     beginPage(void);
+  void     endPage(void);
+  void     getStats(TftStats *stats,
+                    bool      rst);
+  uint32_t pushPixels(int16_t         x,
+                      int16_t         y,
+                      int16_t         w,
+                      int16_t         h,
+                      const uint16_t *pixels,
+                      uint16_t        stride);
+  void     waitDone(uint32_t seq);
+
+  using Adafruit_GFX::drawBitmap;
+  void     drawBitmap(int16_t       x,
+                      int16_t       y,
+                      const uint8_t bitmap[],
+                      int16_t       w,
+                      int16_t       h,
+                      uint16_t      color);
+
+  // Adafruit_SPITFT drawing primitives. Queued when the Display Engine is running.
+  void     drawPixel(int16_t  x,
+                     int16_t  y,
+                     uint16_t color);
+  void     drawFastHLine(int16_t  x,
+                         int16_t  y,
+                         int16_t  w,
+                         uint16_t color);
+  void     drawFastVLine(int16_t  x,
+                         int16_t  y,
+                         int16_t  h,
+                         uint16_t color);
+  void     fillRect(int16_t  x,
+                    int16_t  y,
+                    int16_t  w,
+                    int16_t  h,
+                    uint16_t color);
+  void     startWrite(void);
+  void     endWrite(void);
+  void     writePixel(int16_t  x,
+                      int16_t  y,
+                      uint16_t color);
+  void     writeFastHLine(int16_t  x,
+                          int16_t  y,
+                          int16_t  w,
+                          uint16_t color);
+  void     writeFastVLine(int16_t  x,
+                          int16_t  y,
+                          int16_t  h,
+                          uint16_t color);
+  void     writeFillRect(int16_t  x,
+                         int16_t  y,
+                         int16_t  w,
+                         int16_t  h,
+                         uint16_t color);
+
+private:
+
+  static void engineTask(void *param);
+  void        engine(void);
+  void        startBurst(void);
+  void        endBurst(void);
+  void        burstPixels(uint32_t px);
+  uint32_t    runJob(const TftJob& job);
+  uint32_t    runBitmap(const TftJob& job);
+  void        queueFill(int16_t  x,
+                        int16_t  y,
+                        int16_t  w,
+                        int16_t  h,
+                        uint16_t color);
+  void        queueJob(const TftJob& job);
+  void        publish(void);
+  void        kick(void);
+  void        waitStats(uint32_t startUs);
+  void        pageDone(uint32_t nowUs);
+
+  TftJob           *ring;         // Job queue, TFT_RING_JOBS.
+  volatile uint32_t head;         // Jobs queued (written by loop()).
+  volatile uint32_t tail;         // Jobs done (written by the Display Engine).
+  TftJob            pending;      // Last job, not yet queued (may still be merged).
+  bool              pendingValid;
+  int               writeDepth;   // startWrite() nesting.
+  TaskHandle_t      taskHandle;   // Display Engine task.
+  bool              inBurst;      // Display Engine holds the SPI bus.
+  uint32_t          burstPx;      // Pixels sent in this bus hold.
+  uint32_t          burstUs;      // Bus hold start time.
+  uint32_t          pageStartUs;  // Page draw start, see beginPage().
+  uint32_t          pageSeq;      // Last job of the page draw.
+  bool              pageOpen;     // Page draw is not on the display yet.
+  TftStats          stats;        // Statistics. The averages are set by getStats().
+  uint64_t          loopTotalUs;  // Page draw time totalizers, for the averages.
+  uint64_t          drawTotalUs;
+};
+
+#endif // ifndef __TFT_DISPLAY_H__
+
+// EOF
@@ -0,0 +1,263 @@
+/*
+   File: thermal.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Predictive overheat warning. The thermal model (thermalModel.cpp) is fed the RMS welding current: The Control
+      Task adds every tick's Amps squared (thermalSample()), loop() updates the model every THERMAL_TIME.
+   2. At THERMAL_WARN_PC the user is warned (voice, orange Amps bar, Serial Log). With THERMAL_DERATE_ON the Amps
+      sent to the Digital Pot are limited at THERMAL_DERATE_PC (thermalLimitAmps(), used by outputAmps()).
+   3. Each OC LED alert is logged with the model heat. A thermal trip corrects the continuous Amps, which is saved in
+      E2Prom between welds. The model starts cold at boot.
+   4. Each weld is logged ("Thermal: Weld end ...") so a Serial Log capture can be replayed on a PC (weldSim.cpp).
+ */
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "PulseWelder.h"
+#include "arcState.h"
+#include "speaker.h"
+#include "thermalModel.h"
+#include "config.h"
+
+static_assert(THERMAL_ADDR + 2 <= SESSION_ADDR, "Thermal model data overlaps the Weld Session history.");
+
+// Global Vars
+extern byte arcSwitch;      // Welding Arc On/Off Switch.
+extern bool overTempAlert;  // Over Temperature (OC) Alert.
+extern byte setAmps;        // Welding Amps *User Setting*.
+
+// Local Scope Vars
+static ThermalModel   thermal;                   // Thermal model (loop() only).
+static int64_t        sqSum      = 0;            // Amps squared total (Control Task, under thermMux).
+static uint32_t       sqCnt      = 0;            // Amps squared count.
+static uint32_t       arcCnt     = 0;            // Ticks with welding current flowing.
+static volatile byte  limitAmps  = MAX_SET_AMPS; // Derating limit, read by the Control Task.
+static volatile float heatPc     = 0;            // Model heat, percent of the OC trip point.
+static volatile bool  warning    = false;        // Heat warning is on.
+static bool           wasAlert   = false;        // Previous OC LED alert state.
+static float          burnSec    = 0;            // Arc time of the weld in progress, in seconds.
+static float          burnSq     = 0;            // Amps squared * seconds of the weld in progress.
+static bool           burnTrip   = false;        // The OC LED alert came on during the weld in progress.
+static byte           savedAmps  = 0;            // Continuous Amps saved in E2Prom.
+static portMUX_TYPE   thermMux   = portMUX_INITIALIZER_UNLOCKED; // Protects the Amps squared totals.
+
+// *********************************************************************************************
+// Save the continuous Amps (and its check byte) to E2Prom.
+static void saveContAmps(void)
+{
+  savedAmps = (byte)(lroundf(thermal.contAmps()));
+  EEPROM.write(THERMAL_ADDR,     savedAmps);
+  EEPROM.write(THERMAL_ADDR + 1, savedAmps ^ 0xa5);
+  EEPROM.commit();
+}
+
+// *********************************************************************************************
+// Load the thermal model. Call from setup() after EEPROM.begin().
+// On entry erase = true to clear the learned continuous Amps (virgin EEPROM).
+void initThermal(bool erase)
+{
+  ThermalCfg cfg;
+  byte       amps  = EEPROM.read(THERMAL_ADDR);
+  byte       check = EEPROM.read(THERMAL_ADDR + 1);
+
+  cfg.contAmps    = THERMAL_CONT_AMPS;
+  cfg.tauSec      = THERMAL_TAU_SEC;
+  cfg.fastSec     = THERMAL_FAST_SEC;
+  cfg.fastPc      = THERMAL_FAST_PC;
+  cfg.warnPc      = THERMAL_WARN_PC;
+  cfg.deratePc    = THERMAL_DERATE_PC;
+  cfg.clearPc     = THERMAL_CLEAR_PC;
+  cfg.minTripPc   = THERMAL_MIN_TRIP_PC;
+  cfg.noTripPc    = THERMAL_NO_TRIP_PC;
+  cfg.learnPc     = THERMAL_LEARN_PC;
+  cfg.minContAmps = THERMAL_MIN_CONT;
+  cfg.maxContAmps = THERMAL_MAX_CONT;
+  thermal.begin(cfg);
+
+  if (erase || (check != (amps ^ 0xa5))) {
+    saveContAmps();
+  }
+  else {
+    thermal.setContAmps(amps);
+    savedAmps = amps;
+  }
+
+  Serial.println("Thermal Model: Continuous " + String(thermal.contAmps(), 0) + "A, Warning at " +
+                 String(THERMAL_WARN_PC) + "%" +
+#ifdef THERMAL_DERATE_ON
+                 ", Derating at " + String(THERMAL_DERATE_PC) + "%" +
+#endif // ifdef THERMAL_DERATE_ON
+                 ".");
+}
+
+// *********************************************************************************************
+// Add one sample's Amps to the RMS total. Called by the Control Task on every tick.
+void thermalSample(const WeldSample& smp)
+{
+  int32_t amps = smp.amps > 0 ? smp.amps : 0;
+
+  portENTER_CRITICAL(&thermMux);
+  sqSum += amps * amps;
+  sqCnt++;
+  arcCnt += arcBurning((ArcState)(smp.state)) ? 1 : 0;
+  portEXIT_CRITICAL(&thermMux);
+}
+
+// *********************************************************************************************
+// Limit the requested Amps while the thermal model is derating (THERMAL_DERATE_ON). Called by outputAmps().
+// On exit, returns the Amps value to use.
+byte thermalLimitAmps(byte amps)
+{
+  return amps > limitAmps ? limitAmps : amps;
+}
+
+// *********************************************************************************************
+// On exit, returns the thermal model heat, percent of the OC trip point.
+float getThermalHeat(void)
+{
+  return heatPc;
+}
+
+// *********************************************************************************************
+// On exit, returns true if the thermal model warning is on.
+bool isThermalWarning(void)
+{
+  return warning;
+}
+
+// *********************************************************************************************
+// Update the thermal model, and handle its warnings and the OC LED alerts. Called from loop().
+void processThermal(void)
+{
+  static unsigned long thermMillis = 0;
+  int64_t  sum;
+  uint32_t cnt;
+  uint32_t arc;
+  float    dt;
+  float    rms;
+  byte     newLimit;
+
+  if (millis() - thermMillis < THERMAL_TIME) {
+    return;
+  }
+  dt          = (millis() - thermMillis) / 1000.0f;
+  thermMillis = millis();
+
+  portENTER_CRITICAL(&thermMux);
+  sum    = sqSum;
+  cnt    = sqCnt;
+  arc    = arcCnt;
+  sqSum  = 0;
+  sqCnt  = 0;
+  arcCnt = 0;
+  portEXIT_CRITICAL(&thermMux);
+
+  rms = cnt == 0 ? 0 : sqrtf((float)(sum) / cnt);
+  thermal.update(rms, dt);
+  heatPc = thermal.heat();
+
+  if (overTempAlert && !wasAlert) {
+    Serial.println("Thermal: OC Alert at Heat " + String(heatPc, 0) + "%.");
+    burnTrip = burnSec > 0;
+    thermal.learnTrip();
+    heatPc = thermal.heat();
+  }
+  wasAlert = overTempAlert;
+
+  if (arc * 2 > cnt) { // Welding for most of the update time.
+    burnSec += dt;
+    burnSq  += rms * rms * dt;
+  }
+  else if (burnSec > 0) {
+    Serial.println("Thermal: Weld end " + String(millis() / 1000.0f, 1) + "S, Arc " + String(burnSec, 1) + "S, " +
+                   String(sqrtf(burnSq / burnSec), 1) + "A RMS, Heat " + String(heatPc, 0) + "%" +
+                   (burnTrip ? ", OC Trip." : "."));
+    burnSec  = 0;
+    burnSq   = 0;
+    burnTrip = false;
+  }
+
+  if ((burnSec == 0) && ((byte)(lroundf(thermal.contAmps())) != savedAmps)) { // Learned, save between welds.
+    Serial.println("Thermal Model: Continuous Amps " + String(savedAmps) + "A -> " + String(thermal.contAmps(), 1) +
+                   "A.");
+    saveContAmps();
+  }
+
+  if (thermal.warning() != warning) {
+    warning = thermal.warning();
+    Serial.println("Thermal: Heat " + String(heatPc, 0) + "%, Warning " + String(warning ? "On." : "Off."));
+    refreshThermal();
+
+    if (warning) {
+      evlogEvent(EVT_HEAT_WARN, (int16_t)(lroundf(heatPc)), setAmps);
+    }
+
+    if (warning && !overTempAlert) {
+      spkr.stopSounds(); // Override existing announcement.
+      spkr.addSoundList({ &bleep, &silence100ms, &bleep, &silence100ms, &overHeatMsg });
+      spkr.playSoundList();
+    }
+  }
+
+#ifdef THERMAL_DERATE_ON
+  newLimit = thermal.derating() ? (byte)(constrain(lroundf(thermal.limitAmps()), (long)(MIN_AMPS), (long)(MAX_SET_AMPS))) :
+             MAX_SET_AMPS;
+#else // ifdef THERMAL_DERATE_ON
+  newLimit = MAX_SET_AMPS;
+#endif // ifdef THERMAL_DERATE_ON
+
+  if (newLimit != limitAmps) {
+    limitAmps = newLimit;
+    Serial.println("Thermal: Welding current " + (limitAmps < MAX_SET_AMPS ? "limited to " + String(limitAmps) + "A." :
+                                                  String("not limited.")));
+    evlogEvent(EVT_HEAT_LIMIT, limitAmps, (int16_t)(lroundf(heatPc)));
+    refreshThermal();
+
+    if ((arcSwitch == ARC_ON) && !overTempAlert) {
+      setPotAmps(outputAmps(setAmps), VERBOSE_OFF); // Refresh Digital Pot.
+    }
+  }
+}
+
+// *********************************************************************************************
+// Thermal model serial commands: heat, heat reset (continuous Amps back to THERMAL_CONT_AMPS).
+// On exit, returns false if cmd is not a thermal model command.
+bool thermalCmd(const String& cmd)
+{
+  float tripSec;
+
+  if (!cmd.startsWith("heat")) {
+    return false;
+  }
+
+  if (cmd == "heat") {
+    tripSec = thermal.tripSec(setAmps);
+    Serial.println("Thermal Model: Heat " + String(heatPc, 1) + "%, Continuous " + String(thermal.contAmps(), 1) +
+                   "A, Trip at " + String(setAmps) + "A " + (tripSec < 0 ? String("never") :
+                                                             "in " + String(tripSec, 0) + "S") +
+                   (warning ? ", Warning" : "") + (limitAmps < MAX_SET_AMPS ? ", Limit " + String(limitAmps) + "A" :
+                                                   String("")) + ".");
+  }
+  else if (cmd == "heat reset") {
+    thermal.setContAmps(THERMAL_CONT_AMPS);
+    saveContAmps();
+    Serial.println("Thermal Model: Continuous Amps reset to " + String(THERMAL_CONT_AMPS) + "A.");
+  }
+  else {
+    Serial.println("Thermal Model Commands: heat, heat reset.");
+  }
+
+  return true;
+}
+
+// EOF
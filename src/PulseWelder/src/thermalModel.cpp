@@ -0,0 +1,173 @@
+/*
+   File: thermalModel.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+ */
+
+#include <math.h>
+#include "thermalModel.h"
+
+// *********************************************************************************************
+ThermalModel::ThermalModel(void)
+{
+  cfg.contAmps    = 1.0f;
+  cfg.tauSec      = 1.0f;
+  cfg.fastSec     = 1.0f;
+  cfg.fastPc      = 0.0f;
+  cfg.warnPc      = 100.0f;
+  cfg.deratePc    = 100.0f;
+  cfg.clearPc     = 100.0f;
+  cfg.minTripPc   = 0.0f;
+  cfg.noTripPc    = 1000.0f;
+  cfg.learnPc     = 0.0f;
+  cfg.minContAmps = 1.0f;
+  cfg.maxContAmps = 1.0f;
+  reset(0);
+}
+
+// *********************************************************************************************
+// Load the thermal model settings. The welder is assumed to be cold.
+void ThermalModel::begin(const ThermalCfg& newCfg)
+{
+  cfg = newCfg;
+  reset(0);
+}
+
+// *********************************************************************************************
+// Set the heat, percent of the trip point. It is shared by the two paths as in steady welding.
+void ThermalModel::reset(float newHeatPc)
+{
+  heatPc     = newHeatPc;
+  fastHeat   = newHeatPc * cfg.fastPc / 100.0f;
+  slowHeat   = newHeatPc - fastHeat;
+  isWarning  = heatPc >= cfg.warnPc;
+  isDerating = heatPc >= cfg.deratePc;
+}
+
+// *********************************************************************************************
+// Change contAmps and scale the heat to match (the same I²t history).
+void ThermalModel::rescale(float newContAmps)
+{
+  float scale;
+
+  newContAmps  = newContAmps < cfg.minContAmps ? cfg.minContAmps : newContAmps;
+  newContAmps  = newContAmps > cfg.maxContAmps ? cfg.maxContAmps : newContAmps;
+  scale        = (cfg.contAmps * cfg.contAmps) / (newContAmps * newContAmps);
+  fastHeat    *= scale;
+  slowHeat    *= scale;
+  heatPc       = fastHeat + slowHeat;
+  cfg.contAmps = newContAmps;
+}
+
+// *********************************************************************************************
+// Update the heat with the RMS welding current over the last dt seconds.
+void ThermalModel::update(float rmsAmps, float dt)
+{
+  float target = 100.0f * (rmsAmps * rmsAmps) / (cfg.contAmps * cfg.contAmps);
+
+  fastHeat += (target * cfg.fastPc / 100.0f - fastHeat) * (1.0f - expf(-dt / cfg.fastSec));
+  slowHeat += (target * (100.0f - cfg.fastPc) / 100.0f - slowHeat) * (1.0f - expf(-dt / cfg.tauSec));
+  heatPc    = fastHeat + slowHeat;
+
+  if (heatPc > cfg.noTripPc) { // The welder runs cooler than the model.
+    rescale(cfg.contAmps + (cfg.contAmps * sqrtf(heatPc / 100.0f) - cfg.contAmps) * cfg.learnPc / 100.0f);
+  }
+
+  isWarning  = heatPc >= cfg.warnPc ? true : (heatPc < cfg.clearPc ? false : isWarning);
+  isDerating = heatPc >= cfg.deratePc ? true : (heatPc < cfg.clearPc ? false : isDerating);
+}
+
+// *********************************************************************************************
+// The welder's OC protection has tripped. Correct contAmps (thermal trip) and set the heat to the trip point.
+// On exit, returns true if contAmps was changed.
+bool ThermalModel::learnTrip(void)
+{
+  float oldAmps = cfg.contAmps;
+
+  if (heatPc < cfg.minTripPc) {
+    return false; // Over-current, not heat.
+  }
+
+  if (heatPc < 100.0f) {
+    rescale(cfg.contAmps + (cfg.contAmps * sqrtf(heatPc / 100.0f) - cfg.contAmps) * cfg.learnPc / 100.0f);
+  }
+  reset(100.0f);
+
+  return cfg.contAmps != oldAmps;
+}
+
+// *********************************************************************************************
+// On exit, returns the heat, percent of the trip point.
+float ThermalModel::heat(void) const
+{
+  return heatPc;
+}
+
+// *********************************************************************************************
+// On exit, returns true if the heat has reached warnPc (until it is below clearPc).
+bool ThermalModel::warning(void) const
+{
+  return isWarning;
+}
+
+// *********************************************************************************************
+// On exit, returns true if the heat has reached deratePc (until it is below clearPc).
+bool ThermalModel::derating(void) const
+{
+  return isDerating;
+}
+
+// *********************************************************************************************
+// On exit, returns the RMS current that holds the heat at deratePc, in Amps.
+float ThermalModel::limitAmps(void) const
+{
+  return cfg.contAmps * sqrtf(cfg.deratePc / 100.0f);
+}
+
+// *********************************************************************************************
+// On exit, returns the time to the trip point at rmsAmps, in seconds. Negative if it is not reached within five
+// heatsink time constants.
+float ThermalModel::tripSec(float rmsAmps) const
+{
+  const float dt     = cfg.tauSec / 200.0f;
+  const float fastK  = 1.0f - expf(-dt / cfg.fastSec);
+  const float slowK  = 1.0f - expf(-dt / cfg.tauSec);
+  float       target = 100.0f * (rmsAmps * rmsAmps) / (cfg.contAmps * cfg.contAmps);
+  float       fast   = fastHeat;
+  float       slow   = slowHeat;
+
+  for (int i = 0; i < 1000; i++) {
+    if (fast + slow >= 100.0f) {
+      return i * dt;
+    }
+    fast += (target * cfg.fastPc / 100.0f - fast) * fastK;
+    slow += (target * (100.0f - cfg.fastPc) / 100.0f - slow) * slowK;
+  }
+
+  return -1.0f;
+}
+
+// *********************************************************************************************
+// On exit, returns the continuous (100% duty cycle) current, in Amps.
+float ThermalModel::contAmps(void) const
+{
+  return cfg.contAmps;
+}
+
+// *********************************************************************************************
+// Set the continuous current (learned value from E2Prom), in Amps. The heat is not changed.
+void ThermalModel::setContAmps(float amps)
+{
+  amps         = amps < cfg.minContAmps ? cfg.minContAmps : amps;
+  cfg.contAmps = amps > cfg.maxContAmps ? cfg.maxContAmps : amps;
+}
+
+// EOF
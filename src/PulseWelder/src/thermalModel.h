@@ -0,0 +1,76 @@
+/*
+   File: thermalModel.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Welder thermal (I²t) model. Heat is percent of the welder's over-temperature trip point. It follows
+      100 * (RMS Amps / contAmps)² through two first order paths: The power devices (fastPc percent of the heat, time
+      constant fastSec) and the heatsink (the rest, tauSec). Welding at contAmps reaches the trip point after a long
+      time. contAmps is the 100% duty cycle current: Rated Amps * sqrt(duty cycle).
+   2. warning() is set at warnPc and derating() at deratePc; Both clear below clearPc. While derating, limitAmps() is
+      the current that holds the heat at deratePc.
+   3. learnTrip() is called when the welder's OC protection trips. If the model heat is at least minTripPc, contAmps is
+      moved learnPc percent of the way to the value that would have predicted the trip. A trip at lower heat is not a
+      thermal trip (over-current) and is ignored. Heat above noTripPc without a trip moves contAmps up the same way.
+   4. This file and thermalModel.cpp do not use the Arduino libraries. They can be compiled on a PC, see weldSim.cpp.
+ */
+#ifndef __THERMAL_MODEL_H__
+#define __THERMAL_MODEL_H__
+
+// Thermal model settings.
+struct ThermalCfg {
+  float contAmps;    // Continuous (100% duty cycle) current, in Amps.
+  float tauSec;      // Heatsink time constant, in seconds.
+  float fastSec;     // Power device time constant, in seconds.
+  float fastPc;      // Share of the heat in the power device path, percent.
+  float warnPc;      // Warning heat, percent of the trip point.
+  float deratePc;    // Derating heat, percent of the trip point.
+  float clearPc;     // Warning and derating end below this heat, percent of the trip point.
+  float minTripPc;   // Lowest heat for a thermal OC trip, percent of the trip point.
+  float noTripPc;    // Heat without an OC trip that raises contAmps, percent of the trip point.
+  float learnPc;     // contAmps correction per trip, percent of the error.
+  float minContAmps; // contAmps learning limits, in Amps.
+  float maxContAmps;
+};
+
+class ThermalModel {
+public:
+
+  ThermalModel(void);
+  void  begin(const ThermalCfg& cfg);
+  void  reset(float heatPc);
+  void  update(float rmsAmps,
+               float dt);
+  bool  learnTrip(void);
+  float heat(void) const;
+  bool  warning(void) const;
+  bool  derating(void) const;
+  float limitAmps(void) const;
+  float tripSec(float rmsAmps) const;
+  float contAmps(void) const;
+  void  setContAmps(float amps);
+
+private:
+
+  void rescale(float newContAmps);
+
+  ThermalCfg cfg;         // Thermal model settings.
+  float      heatPc;      // Present heat, percent of the trip point (fastHeat + slowHeat).
+  float      fastHeat;    // Power device path heat, percent of the trip point.
+  float      slowHeat;    // Heatsink path heat, percent of the trip point.
+  bool       isWarning;   // Heat reached warnPc.
+  bool       isDerating;  // Heat reached deratePc.
+};
+
+#endif // ifndef __THERMAL_MODEL_H__
+
+// EOF
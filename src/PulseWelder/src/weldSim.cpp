@@ -0,0 +1,1281 @@
+/*
+   File: weldSim.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. The Simulated Welder is a first order model: The output current follows the Digital Pot command (with gain and
+      offset errors) through a time constant. The measured current is the output current through a second time
+      constant, which stands in for the INA219 conversion time and the measureCurrent() display filter.
+   2. runRegStepTest() mimics the firmware: The Amps command is whole Amps (same as setPotAmps()) and the measured
+      current is whole Amps (same as the Amps global).
+   3. The synthetic arc waveform uses 1mS steps, the same as the Welding Voltage blocks (VDC_BLOCK_SIZE in config.h).
+      Normal welding is 24V with a 6mS droplet short (3V) every 80mS. A stuck rod is 1.5V. After release the welder
+      returns to open circuit voltage (60V). Before a rod strike the welder is at open circuit voltage; The measured
+      current (INA219) reaches the welding current WAVE_AMPS_LAG after the strike.
+   4. runFilterBench() input is Welding Volts (centivolts, as read from the ADC table) with noise. The baseline is the
+      measureVoltage() code used before the fixed-point filters (16 sample boxcar, float scaling). The step and spike
+      tests use a 10000 unit step; The lag and spike results do not depend on the input units.
+   5. runInaAdaptTest() models the INA219 conversions: Each 12 bit sample is the average current over 532uS, rounded
+      to the Shunt Voltage LSB (10uV across SHUNT_OHMS). A reading is one sample in the fast mode, or the mean of 32
+      samples (17.02mS) with hardware averaging. The welding current has 1mS correlated arc noise. measureCurrent() is
+      called every MEAS_TIME and uses a reading only once (INA219_SYNC_ON). A mode change restarts the conversion and
+      skips that call (Configuration write). The I2C bus time is not modeled.
+   6. runPotSweepTest() welder: Amps = lowAmps + (highAmps - lowAmps) * (Wiper / 255)^curve. Each sweep step averages
+      SWEEP_SIM_READS whole Amps readings with noise (same as processPotSweep() and the Amps global). The Wiper table
+      is built the same way as buildPotTable().
+   7. runThermalTest() reference welder: The heat is the sum of a fast path (power devices) and a slow path (heatsink),
+      each a first order response to (RMS Amps / contAmps)². The OC protection trips at 100% and resets at resetPc.
+      The model under test has different settings (the config.h defaults), so it must learn contAmps from the trips.
+ */
+
+#include <math.h>
+#include "weldSim.h"
+
+#define SIM_SUBSTEPS 10        // Plant model updates per regulator update.
+#define SIM_PRESETTLE_SEC 3.0f // Time to run at the starting current before the step, in seconds.
+#define SIM_SETTLE_BAND 2.0f   // Settling band, +/- Amps.
+#define WAVE_DT 0.001f         // Synthetic arc waveform time step, in seconds.
+#define WAVE_ARC_VOLTS 24.0f   // Normal arc voltage.
+#define WAVE_SHORT_VOLTS 3.0f  // Droplet short voltage.
+#define WAVE_STICK_VOLTS 1.5f  // Stuck rod voltage.
+#define WAVE_OCV_VOLTS 60.0f   // Open circuit voltage.
+#define WAVE_ARC_AMPS 90.0f    // Welding current.
+#define WAVE_DROP_PERIOD 0.08f // Droplet short period, in seconds.
+#define WAVE_DROP_SEC 0.006f   // Droplet short duration, in seconds.
+#define WAVE_AMPS_LAG 0.017f   // Measured current delay after a rod strike (INA219 32 sample average), in seconds.
+#define BENCH_BUF_SIZE 1024    // Filter benchmark input samples (power of two), reused until the sample count is reached.
+#define BENCH_BOX_SIZE 16      // Baseline boxcar average size.
+#define BENCH_STEP 10000       // Step and spike test size.
+#define INA_SIM_DT 0.00001f     // INA219 test time step, in seconds.
+#define INA_SIM_MEAS_STEPS 500  // INA219 test time steps per measureCurrent() call (5mS).
+#define INA_SIM_SAMPLE 0.000532f // 12 bit sample time, in seconds.
+#define INA_SIM_AVG_SAMPLES 32  // Samples per reading with hardware averaging.
+#define INA_SIM_LSB (0.00001f / 0.000428f) // Shunt Voltage LSB (10uV) in Amps, with the default SHUNT_OHMS.
+#define INA_SIM_STRIKE 0.2f     // Rod strike time, in seconds.
+#define INA_SIM_DETECT 0.001f   // Strike to Arc State event (Voltage block), in seconds.
+#define INA_SIM_STABLE 0.3f     // Arc State is Stable at this time, in seconds.
+#define INA_SIM_STEADY 1.5f     // Display noise is measured from this time to the end, in seconds.
+#define INA_SIM_END 3.5f        // Test duration, in seconds.
+#define INA_SIM_AMPS 80.0f      // Welding current.
+#define INA_SIM_RISE 0.002f     // Welding current rise time constant at the strike, in seconds.
+#define INA_SIM_NOISE_TAU 0.001f // Arc noise correlation time, in seconds.
+#define INA_SIM_NOISE_SD 4.0f   // Arc noise standard deviation, in Amps.
+#define SWEEP_SIM_POINTS 9     // Sweep steps, same as POT_SWEEP_POINTS (PulseWelder.h).
+#define SWEEP_SIM_READS 500    // Amps readings averaged at each sweep step.
+#define THERM_SIM_DT 0.5f      // Thermal model test time step, in seconds.
+#define FORCE_DT 0.0001f       // Arc Force test time step, in seconds.
+#define FORCE_SEC 0.1f         // Arc Force test duration, in seconds.
+
+// *********************************************************************************************
+// Load the Simulated Welder settings. Output starts at minAmps.
+void WeldSim::begin(const WeldSimCfg& newCfg)
+{
+  cfg  = newCfg;
+  seed = 12345;
+  reset(cfg.minAmps);
+}
+
+// *********************************************************************************************
+// Force the output current (steady state).
+void WeldSim::reset(float amps)
+{
+  actAmps  = amps;
+  measAmps = amps;
+  noise    = 0;
+}
+
+// *********************************************************************************************
+// Advance the Simulated Welder by dt seconds with Amps command cmdAmps.
+void WeldSim::step(float cmdAmps, float dt)
+{
+  float target;
+
+  cmdAmps   = cmdAmps < cfg.minAmps ? cfg.minAmps : (cmdAmps > cfg.maxAmps ? cfg.maxAmps : cmdAmps);
+  target    = (cfg.gain * cmdAmps) + cfg.offset;
+  actAmps  += (target - actAmps) * (1.0f - expf(-dt / cfg.tau));
+  measAmps += (actAmps - measAmps) * (1.0f - expf(-dt / cfg.measTau));
+
+  seed  = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL; // Repeatable pseudo-random noise.
+  noise = cfg.noiseAmps * (((float)(seed % 2001) / 1000.0f) - 1.0f);
+}
+
+// *********************************************************************************************
+// On exit, returns the actual output current, in Amps.
+float WeldSim::amps(void) const
+{
+  return actAmps;
+}
+
+// *********************************************************************************************
+// On exit, returns the measured output current, in Amps.
+float WeldSim::measured(void) const
+{
+  return measAmps + noise;
+}
+
+// *********************************************************************************************
+// Run a closed-loop (regOn = true) or open-loop setpoint step from fromAmps to toAmps on the Simulated Welder.
+// The regulator update period is regCfg.dt. The step response is recorded for the given number of seconds.
+// Rise time is the time to cover 90% of the distance from the actual current at the step to toAmps.
+RegStepResult runRegStepTest(const CurrentRegCfg& regCfg, const WeldSimCfg& simCfg, bool regOn, float fromAmps,
+                             float toAmps, float seconds)
+{
+  RegStepResult result;
+  CurrentReg    reg;
+  WeldSim       sim;
+  float setAmps   = fromAmps;
+  float subDt     = regCfg.dt / SIM_SUBSTEPS;
+  float startAmps = 0;
+  float span      = 0;
+  float peak      = 0;
+  float trim      = 0;
+  float progress;
+  float time;
+  float cmd;
+  bool  started = false;
+
+  result.riseSec   = -1;
+  result.settleSec = -1;
+  result.overshoot = 0;
+
+  reg.begin(regCfg);
+  sim.begin(simCfg);
+  sim.reset((simCfg.gain * fromAmps) + simCfg.offset);
+
+  for (time = -SIM_PRESETTLE_SEC; time < seconds; time += regCfg.dt) {
+    if (!started && (time >= 0)) {
+      started   = true;
+      setAmps   = toAmps;    // Apply the step.
+      startAmps = sim.amps(); // Actual current before the step (includes any open-loop error).
+      span      = toAmps - startAmps;
+    }
+
+    if (regOn) {
+      trim = reg.update(setAmps, roundf(sim.measured()));
+    }
+    cmd = roundf(setAmps + trim);
+
+    for (int i = 0; i < SIM_SUBSTEPS; i++) {
+      sim.step(cmd, subDt);
+    }
+
+    if (!started || (span == 0)) {
+      continue;
+    }
+
+    progress = (sim.amps() - startAmps) / span; // 0.0 at start, 1.0 at target.
+    peak     = progress > peak ? progress : peak;
+
+    if ((result.riseSec < 0) && (progress >= 0.9f)) {
+      result.riseSec = time; // Measured from the step (the 10% point is passed on the first update).
+    }
+
+    if (fabsf(toAmps - sim.amps()) > SIM_SETTLE_BAND) {
+      result.settleSec = -1;
+    }
+    else if (result.settleSec < 0) {
+      result.settleSec = time;
+    }
+  }
+
+  result.overshoot = peak > 1.0f ? (peak - 1.0f) * fabsf(span) : 0;
+  result.finalErr  = toAmps - sim.amps();
+  result.finalTrim = trim;
+
+  return result;
+}
+
+// *********************************************************************************************
+// Synthetic arc voltage at the given time. The rod is stuck from stickAtSec to releaseAtSec.
+static float arcWaveVolts(float time, float stickAtSec, float releaseAtSec, unsigned long *seed)
+{
+  float volts;
+
+  if ((time >= stickAtSec) && (time < releaseAtSec)) {
+    volts = WAVE_STICK_VOLTS;
+  }
+  else if (time >= releaseAtSec) {
+    volts = WAVE_OCV_VOLTS;
+  }
+  else if (fmodf(time, WAVE_DROP_PERIOD) < WAVE_DROP_SEC) {
+    volts = WAVE_SHORT_VOLTS;
+  }
+  else {
+    volts = WAVE_ARC_VOLTS;
+  }
+
+  *seed = (*seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+
+  return volts + (((float)(*seed % 1001) / 1000.0f) - 0.5f); // +/- 0.5V noise.
+}
+
+// *********************************************************************************************
+// Run the Anti-Stick Detector against the synthetic arc waveform: Normal welding, then the rod sticks at
+// stickAtSec and is pulled free at releaseAtSec.
+StickTestResult runStickTest(const StickCfg& stickCfg, float stickAtSec, float releaseAtSec)
+{
+  StickTestResult result;
+  StickDetector   detector;
+  unsigned long   seed = 12345;
+  float volts;
+  float amps;
+  bool  wasStuck = false;
+  bool  stuck;
+
+  result.falseTrips = 0;
+  result.detectSec  = -1;
+  result.clearSec   = -1;
+
+  detector.begin(stickCfg);
+
+  for (int i = 0; i * WAVE_DT < releaseAtSec + 1.0f; i++) {
+    float time = i * WAVE_DT;
+
+    volts = arcWaveVolts(time, stickAtSec, releaseAtSec, &seed);
+    amps  = time < releaseAtSec ? WAVE_ARC_AMPS : 0;
+    stuck = detector.update(volts, amps, WAVE_DT);
+
+    if (stuck && !wasStuck) {
+      if (time < stickAtSec) {
+        result.falseTrips++;
+      }
+      else if (result.detectSec < 0) {
+        result.detectSec = time - stickAtSec;
+      }
+    }
+    else if (!stuck && wasStuck && (time >= releaseAtSec) && (result.clearSec < 0)) {
+      result.clearSec = time - releaseAtSec;
+    }
+    wasStuck = stuck;
+  }
+
+  return result;
+}
+
+// *********************************************************************************************
+// Run the Arc Force path against a voltage sag (WAVE_ARC_VOLTS to sagVolts at time zero) on the Simulated Welder.
+// Mimics the firmware: The Voltage samples arrive in DMA buffers (one every dmaSec), only the newest 1mS block is
+// used, the boost is whole Amps, and the Digital Pot write takes busSec (I2C Engine queue and bus time).
+ArcForceTestResult runArcForceTest(const ArcForceCfg& forceCfg, const WeldSimCfg& simCfg, float demandAmps,
+                                   float sagVolts, float dmaSec, float busSec)
+{
+  ArcForceTestResult result;
+  ArcForce arcForce;
+  WeldSim  sim;
+  float    startAmps = (simCfg.gain * demandAmps) + simCfg.offset;
+  float    cmd       = demandAmps;
+  float    newCmd    = demandAmps;
+  float    writeAt   = -1; // Time the pending Pot write completes, in seconds.
+  float    nextDma   = dmaSec;
+  float    blkTotal  = 0;  // Newest 1mS block totalizer.
+  int      blkCnt    = 0;
+  float    volts;
+  float    time;
+
+  result.boostAmps = 0;
+  result.detectSec = -1;
+  result.writeSec  = -1;
+  result.outputSec = -1;
+
+  arcForce.begin(forceCfg);
+  sim.begin(simCfg);
+  sim.reset(startAmps);
+
+  for (time = -0.01f; time < FORCE_SEC; time += FORCE_DT) {
+    volts     = time < 0 ? WAVE_ARC_VOLTS : sagVolts;
+    blkTotal += volts;
+
+    if (++blkCnt >= (int)(WAVE_DT / FORCE_DT + 0.5f)) { // Block complete; Keep the newest block average.
+      volts    = blkTotal / blkCnt;
+      blkTotal = 0;
+      blkCnt   = 0;
+
+      if (time >= nextDma - (FORCE_DT / 2)) {           // DMA buffer complete, the Control Task sees the block.
+        nextDma += dmaSec;
+        newCmd   = demandAmps + roundf(arcForce.update(volts, sim.amps(), demandAmps));
+
+        if ((newCmd != cmd) && (writeAt < 0)) {
+          writeAt          = time + busSec;
+          result.boostAmps = newCmd - demandAmps;
+          result.detectSec = result.detectSec < 0 ? time : result.detectSec;
+        }
+      }
+    }
+
+    if ((writeAt >= 0) && (time >= writeAt)) {
+      writeAt         = -1;
+      cmd             = newCmd;
+      result.writeSec = result.writeSec < 0 ? time : result.writeSec;
+    }
+
+    sim.step(cmd, FORCE_DT);
+
+    if ((result.boostAmps > 0) && (result.outputSec < 0) &&
+        (sim.amps() - startAmps >= 0.9f * simCfg.gain * result.boostAmps)) {
+      result.outputSec = time;
+    }
+  }
+
+  return result;
+}
+
+// *********************************************************************************************
+// Run the Arc State Machine against the synthetic arc waveform: One second at open circuit voltage, rod strike
+// (time zero), normal welding, the rod sticks at stickAtSec and is pulled free at releaseAtSec.
+ArcStateTestResult runArcStateTest(const ArcStateCfg& stateCfg, float stickAtSec, float releaseAtSec)
+{
+  ArcStateTestResult result;
+  ArcStateMachine    arcState;
+  unsigned long      seed = 12345;
+  float volts;
+  float amps;
+  bool  wasShort = false;
+
+  result.badChanges = 0;
+  result.shortCnt   = 0;
+  result.dropCnt    = 0;
+  result.strikeSec  = -1;
+  result.stableSec  = -1;
+  result.stuckSec   = -1;
+  result.outSec     = -1;
+  result.openSec    = -1;
+
+  arcState.begin(stateCfg);
+
+  for (int i = -1000; i * WAVE_DT < releaseAtSec + 3.0f; i++) {
+    float time = i * WAVE_DT;
+
+    volts = time < 0 ? arcWaveVolts(time, -1.0f, -1.0f, &seed) : arcWaveVolts(time, stickAtSec, releaseAtSec, &seed);
+    amps  = (time < WAVE_AMPS_LAG) || (time >= releaseAtSec) ? 0 : WAVE_ARC_AMPS;
+
+    bool isShort = (time >= 0) && (time < stickAtSec) && (volts < WAVE_ARC_VOLTS / 2);
+    result.dropCnt += (isShort && !wasShort && (result.stableSec >= 0)) ? 1 : 0;
+    wasShort        = isShort;
+
+    if (!arcState.update(volts, amps, WAVE_DT)) {
+      continue;
+    }
+
+    switch (arcState.state()) {
+      case ARC_ST_STRIKE:
+        result.strikeSec   = result.strikeSec < 0 ? time : result.strikeSec;
+        result.badChanges += (time > 0) && (time < stickAtSec) ? 1 : 0;
+        break;
+
+      case ARC_ST_STABLE:
+        result.stableSec = result.stableSec < 0 ? time : result.stableSec;
+        break;
+
+      case ARC_ST_SHORT:
+        result.shortCnt += time < stickAtSec ? 1 : 0;
+        break;
+
+      case ARC_ST_STUCK:
+        result.stuckSec    = (time >= stickAtSec) && (result.stuckSec < 0) ? time - stickAtSec : result.stuckSec;
+        result.badChanges += time < stickAtSec ? 1 : 0;
+        break;
+
+      case ARC_ST_OUT:
+        result.outSec      = (time >= releaseAtSec) && (result.outSec < 0) ? time - releaseAtSec : result.outSec;
+        result.badChanges += time < releaseAtSec ? 1 : 0;
+        break;
+
+      case ARC_ST_OPEN:
+        result.openSec     = (time >= releaseAtSec) && (result.openSec < 0) ? time - releaseAtSec : result.openSec;
+        result.badChanges += time < releaseAtSec ? 1 : 0;
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return result;
+}
+
+// *********************************************************************************************
+// Run the Hot Start detector against the synthetic arc waveform: One second at open circuit voltage, then the rod
+// strikes (time zero) and normal welding (with droplet shorts) continues for the given seconds.
+HotStartTestResult runHotStartTest(const HotStartCfg& hotCfg, float demandAmps, float seconds)
+{
+  HotStartTestResult result;
+  HotStart      hotStart;
+  unsigned long seed = 12345;
+  float volts;
+  float amps;
+  float boost;
+  bool  wasActive = false;
+  int   strikes   = 0;
+
+  result.falseStrikes = 0;
+  result.boostAmps    = 0;
+  result.detectSec    = -1;
+  result.endSec       = -1;
+
+  hotStart.begin(hotCfg);
+
+  for (int i = -1000; i * WAVE_DT < seconds; i++) {
+    float time = i * WAVE_DT;
+
+    volts = time < 0 ? arcWaveVolts(time, -1.0f, -1.0f, &seed) : arcWaveVolts(time, seconds, seconds, &seed);
+    amps  = time < WAVE_AMPS_LAG ? 0 : WAVE_ARC_AMPS;
+    boost = hotStart.update(volts, amps, demandAmps, WAVE_DT);
+
+    if (hotStart.active() && !wasActive) {
+      strikes++;
+      result.falseStrikes = strikes - 1;
+      result.detectSec    = result.detectSec < 0 ? time : result.detectSec;
+    }
+    else if (!hotStart.active() && wasActive && (result.endSec < 0)) {
+      result.endSec = time;
+    }
+    result.boostAmps = boost > result.boostAmps ? boost : result.boostAmps;
+    wasActive        = hotStart.active();
+  }
+
+  return result;
+}
+
+// *********************************************************************************************
+// Weld Session statistics check. Normal welding (90A +/- 5A noise) until stickAtSec, a stuck rod until releaseAtSec,
+// then open circuit. The streamed (float) statistics are compared with a two pass double precision calculation.
+WeldStatsTestResult runWeldStatsTest(float stickAtSec, float releaseAtSec)
+{
+  WeldStatsTestResult result;
+  WeldStats     stats;
+  unsigned long seed;
+  unsigned long ampSeed;
+  double        ampSum;
+  double        voltSum;
+  double        energy;
+  double        sqSum;
+  double        ampMean;
+  long          cnt;
+  float         volts;
+  float         amps;
+  int           pass;
+  int           i;
+
+  stats.begin();
+  ampSum  = 0;
+  voltSum = 0;
+  energy  = 0;
+  sqSum   = 0;
+  ampMean = 0;
+  cnt     = 0;
+
+  for (pass = 0; pass < 3; pass++) { // Streamed, reference mean, reference variance. Same waveform each pass.
+    seed    = 12345;
+    ampSeed = 54321;
+
+    for (i = 0; i * WAVE_DT < releaseAtSec + 0.5f; i++) {
+      float time = i * WAVE_DT;
+      bool  arcOn = time < stickAtSec;
+
+      volts   = arcWaveVolts(time, stickAtSec, releaseAtSec, &seed);
+      ampSeed = (ampSeed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+      amps    = time < releaseAtSec ? WAVE_ARC_AMPS + (((float)(ampSeed % 1001) / 100.0f) - 5.0f) : 0;
+
+      if (pass == 0) {
+        stats.add(volts, amps, WAVE_DT, arcOn);
+      }
+      else if (pass == 1) {
+        energy += (double)(volts) * amps * WAVE_DT;
+
+        if (arcOn) {
+          ampSum  += amps;
+          voltSum += volts;
+          cnt++;
+        }
+      }
+      else if (arcOn) {
+        sqSum += (amps - ampMean) * (amps - ampMean);
+      }
+    }
+    ampMean = cnt == 0 ? 0 : ampSum / cnt;
+  }
+
+  result.arcSec    = stats.arcSec();
+  result.energyKj  = stats.energyJ() / 1000.0f;
+  result.meanErr   = 100.0f * (float)((stats.amps().mean() - ampMean) / ampMean);
+  result.sdErr     = 100.0f * (float)((stats.amps().stdDev() - sqrt(sqSum / cnt)) / sqrt(sqSum / cnt));
+  result.voltsErr  = 100.0f * (float)((stats.volts().mean() - voltSum / cnt) / (voltSum / cnt));
+  result.energyErr = 100.0f * (float)((stats.energyJ() - energy) / energy);
+
+  return result;
+}
+
+// *********************************************************************************************
+// Baseline for the filter benchmark: The previous 16 sample boxcar average.
+class BoxFilter {
+public:
+
+  BoxFilter(void)
+  {
+    for (int i = 0; i < BENCH_BOX_SIZE; i++) {
+      buff[i] = 0;
+    }
+    total = 0;
+    pos   = 0;
+  }
+
+  int32_t update(int32_t x)
+  {
+    total     = total - buff[pos] + x;
+    buff[pos] = x;
+    pos       = pos + 1 >= BENCH_BOX_SIZE ? 0 : pos + 1;
+
+    return value();
+  }
+
+  int32_t value(void) const
+  {
+    return total / BENCH_BOX_SIZE;
+  }
+
+private:
+
+  int32_t buff[BENCH_BOX_SIZE]; // Last 16 samples.
+  int32_t total;                // Sum of the buffer.
+  int     pos;                  // Next buffer position to replace.
+};
+
+// *********************************************************************************************
+// Measure the filter CPU time and response. The cycleCount() function returns a free running cycle counter
+// (ESP.getCycleCount() on the ESP32). samples is the number of samples timed for each filter.
+FilterBenchResult runFilterBench(const DualRateCfg& cfg, int samples, uint32_t (*cycleCount)(void))
+{
+  static int32_t input[BENCH_BUF_SIZE]; // Noisy Welding Volts samples, in centivolts.
+  volatile int32_t  sink = 0;           // Keeps the compiler from removing the filters.
+  FilterBenchResult result;
+  BoxFilter      box;
+  DualRateFilter dual;
+  MedianFilter   median;
+  EmaFilter      ema;
+  unsigned long  seed = 12345;
+  uint32_t start;
+  int32_t  err;
+  int      i;
+
+  for (i = 0; i < BENCH_BUF_SIZE; i++) {
+    seed     = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    input[i] = 2400 + (int32_t)(seed % 101) - 50; // 24V arc, +/- 0.5V noise.
+  }
+
+  dual.begin(cfg);
+  median.begin(cfg.medianN);
+  ema.begin(cfg.fastShift);
+
+  // CPU time. Each loop is the same as the measureVoltage() code for the filter.
+  start = cycleCount();
+
+  for (i = 0; i < samples; i++) {
+    sink = (int32_t)((float)(box.update(input[i & (BENCH_BUF_SIZE - 1)])) * 27.111f / 1000.0f);
+  }
+  result.boxCycles = (float)(cycleCount() - start) / samples;
+
+  start = cycleCount();
+
+  for (i = 0; i < samples; i++) {
+    dual.update(input[i & (BENCH_BUF_SIZE - 1)] * 10);
+    sink = dual.fast() / 10;
+    sink = dual.slow() / 1000;
+  }
+  result.dualCycles = (float)(cycleCount() - start) / samples;
+
+  start = cycleCount();
+
+  for (i = 0; i < samples; i++) {
+    sink = median.update(input[i & (BENCH_BUF_SIZE - 1)]);
+  }
+  result.medianCycles = (float)(cycleCount() - start) / samples;
+
+  start = cycleCount();
+
+  for (i = 0; i < samples; i++) {
+    sink = ema.update(input[i & (BENCH_BUF_SIZE - 1)]);
+  }
+  result.emaCycles = (float)(cycleCount() - start) / samples;
+  (void)sink;
+
+  // Step response, 0 to BENCH_STEP.
+  BoxFilter stepBox;
+  dual.begin(cfg);
+  result.boxLag  = -1;
+  result.fastLag = -1;
+  result.slowLag = -1;
+
+  for (i = 1; i <= 1000; i++) {
+    stepBox.update(BENCH_STEP);
+    dual.update(BENCH_STEP);
+    result.boxLag  = (result.boxLag < 0) && (stepBox.value() >= BENCH_STEP * 9 / 10) ? i : result.boxLag;
+    result.fastLag = (result.fastLag < 0) && (dual.fast() >= BENCH_STEP * 9 / 10) ? i : result.fastLag;
+    result.slowLag = (result.slowLag < 0) && (dual.slow() >= BENCH_STEP * 9 / 10) ? i : result.slowLag;
+  }
+
+  // One sample spike (2 x BENCH_STEP) on a steady BENCH_STEP input. The filters have settled from the step test.
+  result.boxSpike  = 0;
+  result.fastSpike = 0;
+  result.slowSpike = 0;
+
+  for (i = 0; i < 1000; i++) {
+    stepBox.update(i == 0 ? 2 * BENCH_STEP : BENCH_STEP);
+    dual.update(i == 0 ? 2 * BENCH_STEP : BENCH_STEP);
+    err              = stepBox.value() - BENCH_STEP;
+    result.boxSpike  = 100.0f * err / BENCH_STEP > result.boxSpike ? 100.0f * err / BENCH_STEP : result.boxSpike;
+    err              = dual.fast() - BENCH_STEP;
+    result.fastSpike = 100.0f * err / BENCH_STEP > result.fastSpike ? 100.0f * err / BENCH_STEP : result.fastSpike;
+    err              = dual.slow() - BENCH_STEP;
+    result.slowSpike = 100.0f * err / BENCH_STEP > result.slowSpike ? 100.0f * err / BENCH_STEP : result.slowSpike;
+  }
+
+  // Steady input noise (+/- 0.5V) at the display outputs, after the filters have settled on it.
+  double boxSum  = 0;
+  double boxSq   = 0;
+  double slowSum = 0;
+  double slowSq  = 0;
+
+  for (i = 0; i < 3 * BENCH_BUF_SIZE; i++) {
+    stepBox.update(input[i & (BENCH_BUF_SIZE - 1)]);
+    dual.update(input[i & (BENCH_BUF_SIZE - 1)]);
+
+    if (i >= BENCH_BUF_SIZE) {
+      boxSum  += stepBox.value();
+      boxSq   += (double)(stepBox.value()) * stepBox.value();
+      slowSum += dual.slow();
+      slowSq  += (double)(dual.slow()) * dual.slow();
+    }
+  }
+  boxSum         /= 2 * BENCH_BUF_SIZE;
+  slowSum        /= 2 * BENCH_BUF_SIZE;
+  result.boxNoise  = (float)(sqrt(boxSq / (2 * BENCH_BUF_SIZE) - boxSum * boxSum));
+  result.slowNoise = (float)(sqrt(slowSq / (2 * BENCH_BUF_SIZE) - slowSum * slowSum));
+
+  return result;
+}
+
+// *********************************************************************************************
+// INA219 conversion mode test: An 80A rod strike, then steady burn. avgCfg is the Amps filter (INA219_SYNC_ON,
+// one sample per 17mS conversion); fastShift is the display filter time constant used in the fast mode
+// (AMPS_FAST_DISP_SHIFT). holdSec is the fast mode hold time after the strike and stable events (INA_FAST_HOLD_MS).
+InaAdaptResult runInaAdaptTest(InaSimMode mode, const DualRateCfg& avgCfg, int fastShift, float holdSec)
+{
+  InaAdaptResult result;
+  DualRateFilter filter;
+  RunningStats   disp;
+  unsigned long  seed      = 12345;
+  const float    noiseA    = expf(-INA_SIM_DT / INA_SIM_NOISE_TAU);
+  const float    noiseB    = INA_SIM_NOISE_SD * sqrtf(1.0f - noiseA * noiseA) / 0.57735f; // Uniform noise sd is 1/sqrt(3).
+  float          actAmps   = 0;
+  float          arcNoise  = 0;
+  double         sampleSum = 0;
+  int            sampleN   = 0;
+  float          convSum   = 0;
+  int            convN     = 0;
+  float          convAmps  = 0;
+  bool           convReady = false;
+  bool           fast      = mode == INA_SIM_FAST;
+  bool           want;
+  float          time;
+  int32_t        ma;
+
+  result.detectSec   = -1;
+  result.samples     = 0;
+  result.modeChanges = 0;
+  filter.begin(avgCfg);
+  filter.setShifts(avgCfg.fastShift, fast ? fastShift : avgCfg.slowShift);
+  disp.reset();
+
+  for (long n = 0; n * INA_SIM_DT < INA_SIM_END; n++) {
+    time = n * INA_SIM_DT;
+
+    // Welding current and arc noise.
+    seed     = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    arcNoise = noiseA * arcNoise + noiseB * (((float)(seed % 2001) / 1000.0f) - 1.0f);
+    actAmps += time >= INA_SIM_STRIKE ? (INA_SIM_AMPS - actAmps) * INA_SIM_DT / INA_SIM_RISE : 0;
+
+    // INA219 conversion.
+    sampleSum += time >= INA_SIM_STRIKE ? actAmps + arcNoise : 0;
+    sampleN++;
+
+    if (sampleN * INA_SIM_DT >= INA_SIM_SAMPLE) {
+      convSum  += roundf((float)(sampleSum / sampleN) / INA_SIM_LSB) * INA_SIM_LSB;
+      convN++;
+      sampleSum = 0;
+      sampleN   = 0;
+    }
+
+    if (convN >= (fast ? 1 : INA_SIM_AVG_SAMPLES)) {
+      convAmps  = convSum / convN;
+      convReady = true;
+      convSum   = 0;
+      convN     = 0;
+    }
+
+    if (n % INA_SIM_MEAS_STEPS != 0) {
+      continue;
+    }
+
+    // measureCurrent().
+    want = (mode == INA_SIM_FAST) ||
+           ((mode == INA_SIM_ADAPT) && (time >= INA_SIM_STRIKE + INA_SIM_DETECT) && (time < INA_SIM_STABLE + holdSec));
+
+    if (want != fast) {
+      fast      = want;
+      sampleSum = 0;
+      sampleN   = 0;
+      convSum   = 0;
+      convN     = 0;
+      convReady = false;
+      result.modeChanges++;
+      filter.setShifts(avgCfg.fastShift, fast ? fastShift : avgCfg.slowShift);
+      continue;
+    }
+
+    if (convReady) {
+      convReady = false;
+      ma        = (int32_t)(convAmps * 1000.0f);
+      filter.update(ma);
+      result.samples++;
+    }
+
+    if ((result.detectSec < 0) && (time >= INA_SIM_STRIKE) && (filter.fast() >= INA_SIM_AMPS * 900.0f)) {
+      result.detectSec = time - INA_SIM_STRIKE;
+    }
+
+    if (time >= INA_SIM_STEADY) {
+      disp.add(filter.slow() / 1000.0f);
+    }
+  }
+
+  result.dispSd = disp.stdDev();
+
+  return result;
+}
+
+// *********************************************************************************************
+// On exit, returns the Pot characterization test welder's Amps at a Wiper value.
+static float sweepSimAmps(int wiper, float lowAmps, float highAmps, float curve)
+{
+  return lowAmps + (highAmps - lowAmps) * powf(wiper / 255.0f, curve);
+}
+
+// *********************************************************************************************
+// Pot characterization test: Sweep the welder, build the Wiper table, then compare the delivered Amps of every setting
+// (minSet to maxSet) using the linear table and the sweep table.
+PotSweepTestResult runPotSweepTest(int minSet, int maxSet, float lowAmps, float highAmps, float curve, float noiseAmps)
+{
+  PotSweepTestResult result;
+  PwlTable      inverse;
+  int32_t       xs[SWEEP_SIM_POINTS];
+  int32_t       ys[SWEEP_SIM_POINTS];
+  unsigned long seed = 12345;
+  long          sum;
+  int           wiper;
+  float         err;
+
+  for (int i = 0; i < SWEEP_SIM_POINTS; i++) {
+    wiper = (i * 0xff) / (SWEEP_SIM_POINTS - 1);
+    sum   = 0;
+
+    for (int n = 0; n < SWEEP_SIM_READS; n++) {
+      seed = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+      sum += lroundf(sweepSimAmps(wiper, lowAmps, highAmps, curve) +
+                     noiseAmps * (((float)(seed % 2001) / 1000.0f) - 1.0f));
+    }
+    xs[i] = wiper << 8;
+    ys[i] = ((sum * 10 + SWEEP_SIM_READS / 2) / SWEEP_SIM_READS) * 100;
+  }
+
+  result.linearErr = 0;
+  result.sweepErr  = 0;
+  result.points    = inverse.loadInverse(xs, ys, SWEEP_SIM_POINTS) ? inverse.points() : 0;
+
+  for (int amps = minSet; amps <= maxSet; amps++) {
+    wiper            = ((amps - minSet) * 0xff) / (maxSet - minSet);
+    err              = fabsf(sweepSimAmps(wiper, lowAmps, highAmps, curve) - amps);
+    result.linearErr = err > result.linearErr ? err : result.linearErr;
+
+    wiper           = (inverse.lookup(amps * 1000) + 0x80) >> 8;
+    wiper           = wiper < 0 ? 0 : (wiper > 0xff ? 0xff : wiper);
+    err             = fabsf(sweepSimAmps(wiper, lowAmps, highAmps, curve) - amps);
+    result.sweepErr = err > result.sweepErr ? err : result.sweepErr;
+  }
+
+  return result;
+}
+
+// *********************************************************************************************
+// Thermal model test time step: Update the model and the reference welder (if used), and track the warning start.
+static void thermalSimStep(ThermalModel *model, const ThermalPlantCfg *plant, float amps, float *fastHeat,
+                           float *slowHeat, float *time, float *warnAt)
+{
+  float target;
+
+  *time += THERM_SIM_DT;
+  model->update(amps, THERM_SIM_DT);
+
+  if (plant != NULL) {
+    target     = 100.0f * (amps * amps) / (plant->contAmps * plant->contAmps);
+    *fastHeat += (target * plant->fastPc / 100.0f - *fastHeat) * (1.0f - expf(-THERM_SIM_DT / plant->fastSec));
+    *slowHeat += (target * (100.0f - plant->fastPc) / 100.0f - *slowHeat) * (1.0f - expf(-THERM_SIM_DT / plant->slowSec));
+  }
+
+  if (!model->warning()) {
+    *warnAt = -1.0f;
+  }
+  else if (*warnAt < 0) {
+    *warnAt = *time;
+  }
+}
+
+// *********************************************************************************************
+// Thermal model test: Replay the welds. With a reference welder (plant), it decides the OC trips; A trip ends the weld
+// and the next weld waits for the OC reset. Without one (plant = NULL), the recorded trips are used.
+// derate = true limits the welding current while the model is derating (THERMAL_DERATE_ON).
+ThermalTestResult runThermalTest(const ThermalCfg& cfg, const ThermalPlantCfg *plant, const ThermalWeld *welds,
+                                 int count, bool derate)
+{
+  ThermalTestResult result;
+  ThermalModel      model;
+  float fastHeat = 0;
+  float slowHeat = 0;
+  float time     = 0;
+  float warnAt   = -1.0f;
+  bool  tripped  = false;
+  float amps;
+  float t;
+
+  result.trips       = 0;
+  result.warnedTrips = 0;
+  result.minLeadSec  = -1.0f;
+  result.firstTripPc = -1.0f;
+  result.deratedSec  = 0;
+  result.lostSec     = 0;
+  model.begin(cfg);
+
+  for (int i = 0; i < count; i++) {
+    for (t = 0; (t < welds[i].restSec) || (tripped && (plant != NULL) && (fastHeat + slowHeat >= plant->resetPc));
+         t += THERM_SIM_DT) {
+      result.lostSec += t >= welds[i].restSec ? THERM_SIM_DT : 0;
+      thermalSimStep(&model, plant, 0, &fastHeat, &slowHeat, &time, &warnAt);
+    }
+    tripped = false;
+
+    for (t = 0; t < welds[i].arcSec; t += THERM_SIM_DT) {
+      amps = welds[i].rmsAmps;
+
+      if (derate && model.derating() && (amps > model.limitAmps())) {
+        amps               = model.limitAmps();
+        result.deratedSec += THERM_SIM_DT;
+      }
+      thermalSimStep(&model, plant, amps, &fastHeat, &slowHeat, &time, &warnAt);
+
+      if ((plant != NULL) && (fastHeat + slowHeat >= 100.0f)) {
+        tripped         = true;
+        result.lostSec += welds[i].arcSec - t - THERM_SIM_DT;
+        break;
+      }
+    }
+
+    if ((plant == NULL) && welds[i].ocTrip) {
+      tripped = true;
+    }
+
+    if (tripped) {
+      result.trips++;
+      result.firstTripPc = result.firstTripPc < 0 ? model.heat() : result.firstTripPc;
+
+      if (warnAt >= 0) {
+        result.warnedTrips++;
+        result.minLeadSec = (result.minLeadSec < 0) || (time - warnAt < result.minLeadSec) ? time - warnAt :
+                            result.minLeadSec;
+      }
+      model.learnTrip();
+    }
+  }
+
+  result.contAmps = model.contAmps();
+
+  return result;
+}
+
+#ifdef WELD_SIM_MAIN
+
+// *********************************************************************************************
+// PC checks of the controller features, PASS/FAIL (same as ctrlSim.cpp). The exit code is the number of failed checks.
+// Build: g++ -O2 -DWELD_SIM_MAIN antiStick.cpp arcForce.cpp arcState.cpp currentReg.cpp filters.cpp hotStart.cpp
+//        pwlTable.cpp thermalModel.cpp weldSim.cpp weldStats.cpp -o weldsim
+// Usage: weldsim [kp] [ki] [Serial Log capture file, replayed by the thermal model test]
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <time.h>
+
+// *********************************************************************************************
+// PC cycle counter for the filter benchmark: The CPU time stamp counter on x86 PCs, otherwise nS.
+static uint32_t pcCycles(void)
+{
+ #if defined(__x86_64__) || defined(__i386__)
+  return (uint32_t)(__builtin_ia32_rdtsc());
+ #else // if defined(__x86_64__) || defined(__i386__)
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint32_t)(now.tv_sec * 1000000000UL + now.tv_nsec);
+ #endif // if defined(__x86_64__) || defined(__i386__)
+}
+
+// *********************************************************************************************
+// Print a check result (same format as ctrlSim.cpp).
+// On exit, returns ok.
+static bool check(bool ok, const char *what, float value, const char *unit)
+{
+  printf("    %s %-52s %8.1f%s\n", ok ? "PASS" : "FAIL", what, value, unit);
+
+  return ok;
+}
+
+// *********************************************************************************************
+// Current Regulator step response, open loop and PI. The PI regulator must settle within 0.5S, with less than 1A
+// error and 5A overshoot, and must beat the open loop error.
+// On exit, returns the number of failed checks.
+static int regChecks(const CurrentRegCfg& regCfg, const WeldSimCfg& simCfg)
+{
+  RegStepResult res[2];
+  const float   steps[][2] = { { 70, 110 }, { 110, 70 }, { 80, 90 } };
+  char          what[64];
+  int           fails      = 0;
+
+  printf("Current Regulator: Kp=%.3f Ki=%.3f dt=%.3fs\n", regCfg.kp, regCfg.ki, regCfg.dt);
+
+  for (unsigned i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+    for (int regOn = 0; regOn <= 1; regOn++) {
+      res[regOn] = runRegStepTest(regCfg, simCfg, regOn, steps[i][0], steps[i][1], 3.0f);
+      printf("  %s %3.0fA->%3.0fA: rise %.3fs, settle %.3fs, overshoot %.1fA, error %.1fA, trim %.1fA\n",
+             regOn ? "PI  " : "Open", steps[i][0], steps[i][1], res[regOn].riseSec, res[regOn].settleSec,
+             res[regOn].overshoot, res[regOn].finalErr, res[regOn].finalTrim);
+    }
+    snprintf(what, sizeof(what), "PI %.0fA->%.0fA settling time, mS", steps[i][0], steps[i][1]);
+    fails += !check((res[1].settleSec >= 0) && (res[1].settleSec <= 0.5f), what, res[1].settleSec * 1000, "");
+    snprintf(what, sizeof(what), "PI %.0fA->%.0fA overshoot, A", steps[i][0], steps[i][1]);
+    fails += !check(res[1].overshoot <= 5.0f, what, res[1].overshoot, "");
+    snprintf(what, sizeof(what), "PI %.0fA->%.0fA final error (open loop %.1fA), A", steps[i][0], steps[i][1],
+             fabsf(res[0].finalErr));
+    fails += !check((fabsf(res[1].finalErr) <= 1.0f) && (fabsf(res[1].finalErr) < fabsf(res[0].finalErr)), what,
+                    fabsf(res[1].finalErr), "");
+  }
+
+  return fails;
+}
+
+// *********************************************************************************************
+// Anti-Stick on the synthetic waveform: No trips on droplet shorts, stuck rod cut and release restore within 100mS.
+// On exit, returns the number of failed checks.
+static int stickChecks(void)
+{
+  StickCfg        stickCfg = { 8.0f, 20.0f, 0.05f, 12.0f, 0.02f };
+  StickTestResult res      = runStickTest(stickCfg, 1.0f, 2.0f);
+  int             fails    = 0;
+
+  printf("Anti-Stick: Rod sticks at 1.0s, released at 2.0s\n");
+  fails += !check(res.falseTrips == 0, "False trips on droplet shorts", res.falseTrips, "");
+  fails += !check((res.detectSec >= 0) && (res.detectSec <= 0.1f), "Stick to current cut, mS", res.detectSec * 1000, "");
+  fails += !check((res.clearSec >= 0) && (res.clearSec <= 0.1f), "Release to current restore, mS", res.clearSec * 1000,
+                  "");
+
+  return fails;
+}
+
+// *********************************************************************************************
+// Arc Force on a 24V to 14V sag (1.6mS DMA buffers, 0.3mS bus time): The boost must reach the Digital Pot within
+// 5mS of the sag, and stay within MAX_SET_AMPS (125A) near the top of the range.
+// On exit, returns the number of failed checks.
+static int arcForceChecks(const WeldSimCfg& simCfg)
+{
+  ArcForceCfg        forceCfg = { 30.0f, 18.0f, 8.0f, 20.0f, 125.0f };
+  ArcForceTestResult res      = runArcForceTest(forceCfg, simCfg, 80.0f, 14.0f, 0.0016f, 0.0003f);
+  ArcForceTestResult top      = runArcForceTest(forceCfg, simCfg, 120.0f, 14.0f, 0.0016f, 0.0003f);
+  int                fails    = 0;
+
+  printf("Arc Force: 24V->14V at 80A, boost %.0fA, detect %.4fs, pot write %.4fs, 90%% output %.4fs\n",
+         res.boostAmps, res.detectSec, res.writeSec, res.outputSec);
+  fails += !check(res.boostAmps > 0, "Boost at 80A, A", res.boostAmps, "");
+  fails += !check((res.writeSec >= 0) && (res.writeSec <= 0.005f), "Sag to Digital Pot write, mS", res.writeSec * 1000,
+                  "");
+  fails += !check((top.boostAmps > 0) && (120.0f + top.boostAmps <= 125.0f), "Boosted Amps at 120A (limit 125A), A",
+                  120.0f + top.boostAmps, "");
+
+  return fails;
+}
+
+// *********************************************************************************************
+// Arc State Machine on the synthetic waveform: Every droplet short is seen without other state changes, and each
+// state is reached within 20mS of its configured time (stable 0.1S, stuck 0.05S, open 2S).
+// On exit, returns the number of failed checks.
+static int arcStateChecks(void)
+{
+  ArcStateCfg        stateCfg = { 45.0f, 35.0f, 8.0f, 12.0f, 5.0f, 2000.0f, 1000.0f, 0.002f, 0.1f, 0.05f, 2.0f };
+  ArcStateTestResult res      = runArcStateTest(stateCfg, 1.0f, 1.5f);
+  int                fails    = 0;
+
+  printf("Arc State: strike %.3fs, stable %.3fs, %d/%d shorts, stuck %.3fs, out %.3fs, open %.3fs, %d bad changes\n",
+         res.strikeSec, res.stableSec, res.shortCnt, res.dropCnt, res.stuckSec, res.outSec, res.openSec,
+         res.badChanges);
+  fails += !check(res.badChanges == 0, "Unexpected state changes while welding", res.badChanges, "");
+  fails += !check(res.shortCnt == res.dropCnt, "Droplet shorts detected", res.shortCnt, "");
+  fails += !check((res.strikeSec >= 0) && (res.strikeSec <= 0.02f), "Strike to STRIKE, mS", res.strikeSec * 1000, "");
+  fails += !check((res.stableSec >= 0) && (res.stableSec <= 0.1f + 0.02f), "Strike to STABLE, mS", res.stableSec * 1000,
+                  "");
+  fails += !check((res.stuckSec >= 0) && (res.stuckSec <= 0.05f + 0.02f), "Stick to STUCK, mS", res.stuckSec * 1000, "");
+  fails += !check((res.outSec >= 0) && (res.outSec <= 0.02f), "Release to OUT, mS", res.outSec * 1000, "");
+  fails += !check((res.openSec >= 0) && (res.openSec <= 2.0f + 0.02f), "Release to OPEN, mS", res.openSec * 1000, "");
+
+  return fails;
+}
+
+// *********************************************************************************************
+// Hot Start (30% for 0.5S, 0.2S ramp) at 80A: The boost must start within 20mS of the strike (the averaged Amps lag
+// 80mS), be 30% of the Amps, and end within 50mS of the hold plus ramp time. Droplet shorts must not restart it.
+// On exit, returns the number of failed checks.
+static int hotStartChecks(void)
+{
+  HotStartCfg        hotCfg = { 30.0f, 0.5f, 0.2f, 45.0f, 0.1f, 35.0f, 20.0f, 125.0f };
+  HotStartTestResult res    = runHotStartTest(hotCfg, 80.0f, 2.0f);
+  int                fails  = 0;
+
+  printf("Hot Start: 30%% for 0.5s at 80A, boost %.0fA, detect %.4fs, end %.3fs, %d false strikes\n",
+         res.boostAmps, res.detectSec, res.endSec, res.falseStrikes);
+  fails += !check(res.falseStrikes == 0, "False strikes on droplet shorts", res.falseStrikes, "");
+  fails += !check((res.detectSec >= 0) && (res.detectSec <= 0.02f), "Strike to boost, mS", res.detectSec * 1000, "");
+  fails += !check(fabsf(res.boostAmps - 24.0f) <= 1.0f, "Boost (30% of 80A), A", res.boostAmps, "");
+  fails += !check((res.endSec >= 0) && (fabsf(res.endSec - 0.7f) <= 0.05f), "Strike to end of boost (0.7S), mS",
+                  res.endSec * 1000, "");
+
+  return fails;
+}
+
+// *********************************************************************************************
+// Weld Session statistics: The streamed (float) results must match the double precision ones within 0.01%, and only
+// the arc time (not the stuck rod) is counted.
+// On exit, returns the number of failed checks.
+static int weldStatsChecks(void)
+{
+  WeldStatsTestResult res   = runWeldStatsTest(60.0f, 61.0f);
+  int                 fails = 0;
+
+  printf("Weld Stats: %.1fs arc, %.1fkJ, error Amps mean %.4f%%, sd %.4f%%, Volts mean %.4f%%, energy %.4f%%\n",
+         res.arcSec, res.energyKj, res.meanErr, res.sdErr, res.voltsErr, res.energyErr);
+  fails += !check(fabsf(res.arcSec - 60.0f) <= 2 * WAVE_DT, "Arc time (60S), S", res.arcSec, "");
+  fails += !check(fabsf(res.meanErr) <= 0.01f, "Amps mean error, %", res.meanErr, "");
+  fails += !check(fabsf(res.sdErr) <= 0.01f, "Amps sd error, %", res.sdErr, "");
+  fails += !check(fabsf(res.voltsErr) <= 0.01f, "Volts mean error, %", res.voltsErr, "");
+  fails += !check(fabsf(res.energyErr) <= 0.01f, "Energy error, %", res.energyErr, "");
+
+  return fails;
+}
+
+// *********************************************************************************************
+// Measurement filters against the V1.3 16 sample boxcar average: The display (slow) output must have less spike error
+// and less noise than the boxcar, and the control (fast) output less step lag. The CPU time is not checked (PC).
+// On exit, returns the number of failed checks.
+static int filterChecks(const DualRateCfg *cfgs, int count)
+{
+  FilterBenchResult res;
+  char              what[64];
+  int               fails = 0;
+
+  for (int i = 0; i < count; i++) {
+    res = runFilterBench(cfgs[i], 100000, pcCycles);
+    printf("Filter %s: median %d, fast 2^%d, slow 2^%d: %.1f cycles/sample (boxcar %.1f, median %.1f, EMA %.1f)\n",
+           i == 0 ? "Amps" : "Volts", cfgs[i].medianN, cfgs[i].fastShift, cfgs[i].slowShift, res.dualCycles,
+           res.boxCycles, res.medianCycles, res.emaCycles);
+    printf("  90%% step lag fast %d, slow %d, boxcar %d samples; Spike error fast %.0f%%, slow %.0f%%, boxcar %.0f%%\n",
+           res.fastLag, res.slowLag, res.boxLag, res.fastSpike, res.slowSpike, res.boxSpike);
+    snprintf(what, sizeof(what), "Display spike error (boxcar %.1f%%), %%", res.boxSpike);
+    fails += !check(res.slowSpike < res.boxSpike, what, res.slowSpike, "");
+    snprintf(what, sizeof(what), "Display noise sd (boxcar %.1f)", res.boxNoise);
+    fails += !check(res.slowNoise < res.boxNoise, what, res.slowNoise, "");
+    snprintf(what, sizeof(what), "Control 90%% step lag (boxcar %d), samples", res.boxLag);
+    fails += !check((res.fastLag > 0) && (res.fastLag < res.boxLag), what, res.fastLag, "");
+  }
+
+  return fails;
+}
+
+// *********************************************************************************************
+// INA219 conversion modes: Hardware averaging must give a steadier display than fast conversions alone, and the
+// adaptive mode must detect the strike sooner than averaging without a noisier display.
+// On exit, returns the number of failed checks.
+static int inaChecks(const DualRateCfg& ampsCfg)
+{
+  const char    *names[] = { "Averaging", "Adaptive ", "Fast only" };
+  InaAdaptResult res[3];
+  char           what[64];
+  int            fails = 0;
+
+  for (int i = INA_SIM_AVG; i <= INA_SIM_FAST; i++) {
+    res[i] = runInaAdaptTest((InaSimMode)(i), ampsCfg, 4, 0.1f); // AMPS_FAST_DISP_SHIFT, INA_FAST_HOLD_MS.
+    printf("INA219 %s: 80A strike detect %.3fs, display noise %.2fA sd, %d samples, %d mode changes\n", names[i],
+           res[i].detectSec, res[i].dispSd, res[i].samples, res[i].modeChanges);
+  }
+  snprintf(what, sizeof(what), "Averaging display noise (fast only %.2fA), A", res[INA_SIM_FAST].dispSd);
+  fails += !check(res[INA_SIM_AVG].dispSd < res[INA_SIM_FAST].dispSd, what, res[INA_SIM_AVG].dispSd, "");
+  snprintf(what, sizeof(what), "Adaptive strike detect (averaging %.0fmS), mS", res[INA_SIM_AVG].detectSec * 1000);
+  fails += !check((res[INA_SIM_ADAPT].detectSec >= 0) && (res[INA_SIM_ADAPT].detectSec < res[INA_SIM_AVG].detectSec),
+                  what, res[INA_SIM_ADAPT].detectSec * 1000, "");
+  snprintf(what, sizeof(what), "Adaptive display noise (averaging %.2fA), A", res[INA_SIM_AVG].dispSd);
+  fails += !check(res[INA_SIM_ADAPT].dispSd <= res[INA_SIM_AVG].dispSd * 1.1f, what, res[INA_SIM_ADAPT].dispSd, "");
+  fails += !check(res[INA_SIM_ADAPT].modeChanges == 2, "Adaptive mode changes (strike, hold end)",
+                  res[INA_SIM_ADAPT].modeChanges, "");
+
+  return fails;
+}
+
+// *********************************************************************************************
+// Pot characterization: On a non-linear welder the swept Wiper table must deliver the set Amps within 1A, and beat the
+// linear table.
+// On exit, returns the number of failed checks.
+static int potSweepChecks(void)
+{
+  PotSweepTestResult res   = runPotSweepTest(65, 125, 60.0f, 130.0f, 1.6f, 3.0f);
+  char               what[64];
+  int                fails = 0;
+
+  printf("Pot Sweep: 65-125A setting on a 60-130A^1.6 welder, error linear %.1fA, swept %.1fA (%d points)\n",
+         res.linearErr, res.sweepErr, res.points);
+  snprintf(what, sizeof(what), "Swept table error (linear %.1fA), A", res.linearErr);
+  fails += !check((res.sweepErr <= 1.0f) && (res.sweepErr < res.linearErr), what, res.sweepErr, "");
+
+  return fails;
+}
+
+// *********************************************************************************************
+// Thermal model on the reference welder, a shop session of 40 x 60S welds at 110A: Before learning, the warning must
+// come before nearly every OC trip. After learning (contAmps from the first run's trips), it must come before every
+// trip with the model near 100% heat. With derating there must be no trips.
+// On exit, returns the number of failed checks.
+static int thermalChecks(ThermalCfg cfg)
+{
+  ThermalPlantCfg   plant   = { 78.0f, 20.0f, 400.0f, 30.0f, 80.0f };
+  ThermalWeld       welds[40];
+  ThermalTestResult res[3];
+  const char       *names[] = { "Warn  ", "Learnt", "Derate" };
+  char              what[64];
+  int               fails = 0;
+
+  for (unsigned i = 0; i < sizeof(welds) / sizeof(welds[0]); i++) {
+    welds[i] = { 30.0f, 60.0f, 110.0f, false }; // 110A rods, 67% duty cycle.
+  }
+
+  for (int i = 0; i < 3; i++) {
+    res[i] = runThermalTest(cfg, &plant, welds, 40, i == 2);
+    printf("Thermal %s: 40 x 60s at 110A, %d trips (%d warned, lead %.0fs), first trip heat %.0f%%, contAmps %.1fA, "
+           "derated %.0fs, lost %.0fs\n", names[i], res[i].trips, res[i].warnedTrips, res[i].minLeadSec,
+           res[i].firstTripPc, res[i].contAmps, res[i].deratedSec, res[i].lostSec);
+    cfg.contAmps = res[i].contAmps; // Next run starts from the learned value (E2Prom).
+  }
+  snprintf(what, sizeof(what), "Warned trips before learning (of %d)", res[0].trips);
+  fails += !check((res[0].trips > 0) && (res[0].warnedTrips >= res[0].trips * 9 / 10), what, res[0].warnedTrips, "");
+  fails += !check(res[0].minLeadSec > 0, "Shortest warning lead before learning, S", res[0].minLeadSec, "");
+  fails += !check(fabsf(res[0].contAmps - plant.contAmps) <= 5.0f, "Learned contAmps (welder 78A), A", res[0].contAmps,
+                  "");
+  snprintf(what, sizeof(what), "Warned trips after learning (of %d)", res[1].trips);
+  fails += !check((res[1].trips > 0) && (res[1].warnedTrips == res[1].trips), what, res[1].warnedTrips, "");
+  fails += !check((res[1].firstTripPc >= 90.0f) && (res[1].firstTripPc <= 110.0f), "Heat at the first trip, %",
+                  res[1].firstTripPc, "");
+  fails += !check(res[2].trips == 0, "Trips with derating", res[2].trips, "");
+  fails += !check(res[2].lostSec < res[0].lostSec, "Arc time lost with derating, S", res[2].lostSec, "");
+
+  return fails;
+}
+
+// *********************************************************************************************
+// Run the checks. Kp and Ki can be set on the command line for regulator tuning.
+// On exit, returns the number of failed checks.
+int main(int argc, char **argv)
+{
+  CurrentRegCfg regCfg = { 0.3f, 4.0f, 0.05f, 20.0f, 100.0f };
+  WeldSimCfg    simCfg = { 65.0f, 125.0f, 0.9f, 4.0f, 0.02f, 0.04f, 0.5f };
+  int           fails  = 0;
+
+  if (argc > 1) {
+    regCfg.kp = atof(argv[1]);
+  }
+
+  if (argc > 2) {
+    regCfg.ki = atof(argv[2]);
+  }
+
+  fails += regChecks(regCfg, simCfg);
+
+  fails += stickChecks();
+
+  fails += arcForceChecks(simCfg);
+
+  fails += arcStateChecks();
+
+  fails += hotStartChecks();
+
+  fails += weldStatsChecks();
+
+  const DualRateCfg filterCfgs[] = { { 3, 0, 4 }, { 3, 1, 4 } }; // Amps and Volts defaults (config.h).
+
+  fails += filterChecks(filterCfgs, 2);
+
+  fails += inaChecks(filterCfgs[0]);
+
+  fails += potSweepChecks();
+
+  ThermalCfg thermCfg = { 90.0f, 300.0f, 30.0f, 25.0f, 80.0f, 85.0f, 70.0f, 50.0f, 110.0f, 50.0f, 40.0f, 200.0f }; // config.h.
+
+  fails += thermalChecks(thermCfg);
+
+  if (argc > 3) { // Replay the "Thermal: Weld end" lines of a Serial Log capture.
+    static ThermalWeld logWelds[2000];
+    FILE *logFile = fopen(argv[3], "r");
+    char  line[256];
+    char *text;
+    float endSec;
+    float prevEnd = 0;
+    int   count   = 0;
+
+    while ((logFile != NULL) && (count < 2000) && (fgets(line, sizeof(line), logFile) != NULL)) {
+      text = strstr(line, "Thermal: Weld end");
+
+      if ((text != NULL) && (sscanf(text, "Thermal: Weld end %fS, Arc %fS, %fA RMS", &endSec, &logWelds[count].arcSec,
+                                    &logWelds[count].rmsAmps) == 3)) {
+        logWelds[count].restSec = endSec - logWelds[count].arcSec - prevEnd;
+        logWelds[count].restSec = logWelds[count].restSec < 0 ? 0 : logWelds[count].restSec;
+        logWelds[count].ocTrip  = strstr(text, "OC Trip") != NULL;
+        prevEnd                 = endSec;
+        count++;
+      }
+    }
+
+    if (logFile != NULL) {
+      fclose(logFile);
+    }
+    thermCfg.contAmps = 90.0f;
+    ThermalTestResult logRes = runThermalTest(thermCfg, NULL, logWelds, count, false);
+    printf("Thermal Log: %d welds, %d OC trips (%d warned, lead %.0fs), first trip heat %.0f%%, contAmps %.1fA\n",
+           count, logRes.trips, logRes.warnedTrips, logRes.minLeadSec, logRes.firstTripPc, logRes.contAmps);
+  }
+  printf("%d checks failed.\n", fails);
+
+  return fails;
+}
+
+#endif // ifdef WELD_SIM_MAIN
+
+// EOF
@@ -0,0 +1,249 @@
+/*
+   File: weldSim.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Simulated Welder (plant model) for tuning the Closed-Loop Current Regulator and checking the Arc Force response
+      time without a welder attached.
+   2. Synthetic arc voltage waveforms (rod strike, normal arc with droplet shorts, stuck rod, release) for testing the
+      arc feature detectors.
+   3. Weld Session statistics check (weldStats.cpp): The streamed results are compared with a two pass calculation.
+   4. Measurement filter benchmark (filters.cpp): CPU cycles per sample, step response lag, spike rejection, and
+      display noise, compared with the previous 16 sample boxcar average.
+   5. INA219 conversion mode test: Strike detection time and display noise with hardware averaging, the adaptive
+      mode, and the fast mode.
+   6. Pot characterization test: Setting to delivered Amps error of a nonlinear welder with the linear Wiper table
+      and with the table built from a simulated sweep (potSweep.cpp, pwlTable.cpp).
+   7. Thermal model test (thermalModel.cpp): Weld sessions are replayed on a reference welder with two heat paths, or
+      the "Thermal: Weld" lines of a Serial Log capture are replayed with their recorded OC trips.
+   8. This file and weldSim.cpp do not use the Arduino libraries. They can be compiled on a PC along with
+      the other Arduino-free files, for example:
+      g++ -DWELD_SIM_MAIN antiStick.cpp arcForce.cpp arcState.cpp currentReg.cpp filters.cpp hotStart.cpp pwlTable.cpp
+      thermalModel.cpp weldSim.cpp weldStats.cpp
+ */
+#ifndef __WELD_SIM_H__
+#define __WELD_SIM_H__
+
+#include "antiStick.h"
+#include "arcForce.h"
+#include "arcState.h"
+#include "currentReg.h"
+#include "filters.h"
+#include "hotStart.h"
+#include "pwlTable.h"
+#include "thermalModel.h"
+#include "weldStats.h"
+
+// Simulated Welder settings.
+struct WeldSimCfg {
+  float minAmps;   // Lowest Amps command (Digital Pot at minimum).
+  float maxAmps;   // Highest Amps command (Digital Pot at maximum).
+  float gain;      // Actual Amps per commanded Amp (calibration error).
+  float offset;    // Actual Amps offset (calibration error).
+  float tau;       // Welder output response time constant, in seconds.
+  float measTau;   // Current measurement (averaging) time constant, in seconds.
+  float noiseAmps; // Peak measurement noise, in Amps. Pseudo-random with fixed seed, results are repeatable.
+};
+
+// Step Response results.
+struct RegStepResult {
+  float riseSec;    // 10% to 90% rise time, in seconds. Negative if never reached.
+  float settleSec;  // Time to stay within +/- 2 Amps of the target, in seconds. Negative if never settled.
+  float overshoot;  // Peak overshoot, in Amps.
+  float finalErr;   // Final error (target - actual), in Amps.
+  float finalTrim;  // Final regulator trim, in Amps.
+};
+
+// Anti-Stick test results.
+struct StickTestResult {
+  int   falseTrips; // Stuck rod detections during normal welding (droplet shorts). Must be zero.
+  float detectSec;  // Time from rod stick to detection, in seconds. Negative if not detected.
+  float clearSec;   // Time from rod release to current restore, in seconds. Negative if not restored.
+};
+
+// Arc Force test results.
+struct ArcForceTestResult {
+  float boostAmps; // Commanded boost, in Amps.
+  float detectSec; // Time from voltage sag to boost calculation, in seconds. Negative if no boost.
+  float writeSec;  // Time from voltage sag to Digital Pot write, in seconds. Negative if no boost.
+  float outputSec; // Time from voltage sag to 90% of the boosted welder current, in seconds. Negative if not reached.
+};
+
+// Hot Start test results.
+struct HotStartTestResult {
+  int   falseStrikes; // Strike detections after the first (droplet shorts). Must be zero.
+  float boostAmps;    // Peak boost, in Amps.
+  float detectSec;    // Time from rod strike to boost, in seconds. Negative if not detected.
+  float endSec;       // Time from rod strike to end of boost (back to requested Amps), in seconds. Negative if not ended.
+};
+
+// Arc State Machine test results. Times are negative if the state was never reached.
+struct ArcStateTestResult {
+  int   badChanges; // Unexpected state changes during normal welding. Must be zero.
+  int   shortCnt;   // Short circuit (droplet) states during normal welding.
+  int   dropCnt;    // Droplet shorts in the synthetic waveform during normal welding.
+  float strikeSec;  // Time from rod strike to ARC_ST_STRIKE, in seconds.
+  float stableSec;  // Time from rod strike to ARC_ST_STABLE, in seconds.
+  float stuckSec;   // Time from rod stick to ARC_ST_STUCK, in seconds.
+  float outSec;     // Time from rod release to ARC_ST_OUT, in seconds.
+  float openSec;    // Time from rod release to ARC_ST_OPEN, in seconds.
+};
+
+// Weld Session statistics test results. Errors are percent of the two pass (double precision) result.
+struct WeldStatsTestResult {
+  float arcSec;     // Arc on time, in seconds.
+  float energyKj;   // Arc energy, in kJ.
+  float meanErr;    // Amps mean error.
+  float sdErr;      // Amps standard deviation error.
+  float voltsErr;   // Volts mean error.
+  float energyErr;  // Arc energy error.
+};
+
+// Measurement filter benchmark results. Cycles are per sample, counted by the cycleCount() function.
+struct FilterBenchResult {
+  float boxCycles;    // Previous method: 16 sample boxcar average and float scaling (baseline).
+  float dualCycles;   // Fixed-point scaling and Dual Rate Filter (median, fast and slow EMA).
+  float medianCycles; // Median stage alone.
+  float emaCycles;    // One EMA stage alone.
+  int   boxLag;       // Samples from an input step to 90% of the step, boxcar average.
+  int   fastLag;      // Samples from an input step to 90% of the step, fast (control) output.
+  int   slowLag;      // Samples from an input step to 90% of the step, slow (display) output.
+  float boxSpike;     // Peak output error from a one sample spike, percent of the spike, boxcar average.
+  float fastSpike;    // Peak output error from a one sample spike, percent of the spike, fast output.
+  float slowSpike;    // Peak output error from a one sample spike, percent of the spike, slow output.
+  float boxNoise;     // Output standard deviation with a noisy steady input (+/- 50 units), boxcar average.
+  float slowNoise;    // Output standard deviation with a noisy steady input (+/- 50 units), slow output.
+};
+
+// INA219 conversion modes, see runInaAdaptTest().
+enum InaSimMode {
+  INA_SIM_AVG = 0, // 32 sample hardware averaging only (INA219_SYNC_ON).
+  INA_SIM_ADAPT,   // Fast conversions from the strike until the hold time after the arc is stable (INA219_ADAPT_ON).
+  INA_SIM_FAST     // Fast conversions only. Shows the display noise of the fast mode.
+};
+
+// INA219 conversion mode test results.
+struct InaAdaptResult {
+  float detectSec;   // Strike to control Amps (getFastAmps()) at 90% of the welding current, in seconds.
+  float dispSd;      // Display Amps (Amps global) standard deviation during steady burn, in Amps.
+  int   samples;     // Conversions passed to the Amps filter.
+  int   modeChanges; // INA219 Configuration writes.
+};
+
+// Pot characterization test results.
+struct PotSweepTestResult {
+  float linearErr; // Largest setting to delivered Amps error with the linear (compile-time) Wiper table.
+  float sweepErr;  // Largest setting to delivered Amps error with the sweep's Wiper table.
+  int   points;    // Inverse table points, including the (0, 0) point.
+};
+
+// Reference welder for the thermal model test. Heat is percent of the OC trip point.
+struct ThermalPlantCfg {
+  float contAmps; // Actual continuous (100% duty cycle) current, in Amps.
+  float fastSec;  // Power device time constant, in seconds.
+  float slowSec;  // Heatsink time constant, in seconds.
+  float fastPc;   // Share of the heat in the power device path, percent.
+  float resetPc;  // The OC protection resets below this heat, percent of the trip point.
+};
+
+// One recorded weld (rod burn) for the thermal model test.
+struct ThermalWeld {
+  float restSec; // Time from the end of the previous weld, in seconds.
+  float arcSec;  // Arc time, in seconds.
+  float rmsAmps; // RMS welding current, in Amps.
+  bool  ocTrip;  // The OC protection tripped during this weld (recorded welds only).
+};
+
+// Thermal model test results.
+struct ThermalTestResult {
+  int   trips;       // OC trips.
+  int   warnedTrips; // OC trips with the warning on.
+  float minLeadSec;  // Shortest warning to trip time, in seconds. Negative if there were no warned trips.
+  float firstTripPc; // Model heat at the first trip (before learning), percent. Negative if there were no trips.
+  float contAmps;    // Learned continuous current, in Amps.
+  float deratedSec;  // Arc time with derated current, in seconds.
+  float lostSec;     // Arc time lost to trips (rest of the weld, and waiting for the OC reset), in seconds.
+};
+
+class WeldSim {
+public:
+
+  void  begin(const WeldSimCfg& cfg);
+  void  reset(float amps);
+  void  step(float cmdAmps,
+             float dt);
+  float amps(void) const;
+  float measured(void) const;
+
+private:
+
+  WeldSimCfg cfg;     // Simulated Welder settings.
+  float      actAmps; // Actual output Amps.
+  float      measAmps; // Measured (filtered) Amps, before noise.
+  float      noise;   // Present measurement noise, in Amps.
+  unsigned long seed; // Noise generator state.
+};
+
+RegStepResult runRegStepTest(const CurrentRegCfg& regCfg,
+                             const WeldSimCfg  & simCfg,
+                             bool                regOn,
+                             float               fromAmps,
+                             float               toAmps,
+                             float               seconds);
+
+StickTestResult runStickTest(const StickCfg& stickCfg,
+                             float           stickAtSec,
+                             float           releaseAtSec);
+
+ArcForceTestResult runArcForceTest(const ArcForceCfg& forceCfg,
+                                   const WeldSimCfg & simCfg,
+                                   float              demandAmps,
+                                   float              sagVolts,
+                                   float              dmaSec,
+                                   float              busSec);
+
+ArcStateTestResult runArcStateTest(const ArcStateCfg& stateCfg,
+                                   float              stickAtSec,
+                                   float              releaseAtSec);
+
+HotStartTestResult runHotStartTest(const HotStartCfg& hotCfg,
+                                   float              demandAmps,
+                                   float              seconds);
+
+WeldStatsTestResult runWeldStatsTest(float stickAtSec,
+                                     float releaseAtSec);
+
+InaAdaptResult runInaAdaptTest(InaSimMode         mode,
+                               const DualRateCfg& avgCfg,
+                               int                fastShift,
+                               float              holdSec);
+
+PotSweepTestResult runPotSweepTest(int   minSet,
+                                   int   maxSet,
+                                   float lowAmps,
+                                   float highAmps,
+                                   float curve,
+                                   float noiseAmps);
+
+ThermalTestResult runThermalTest(const ThermalCfg     & cfg,
+                                 const ThermalPlantCfg *plant,
+                                 const ThermalWeld     *welds,
+                                 int                    count,
+                                 bool                   derate);
+
+FilterBenchResult runFilterBench(const DualRateCfg& cfg,
+                                 int                samples,
+                                 uint32_t (*cycleCount)(void));
+
+#endif // ifndef __WELD_SIM_H__
+
+// EOF
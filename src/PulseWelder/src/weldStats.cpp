@@ -0,0 +1,125 @@
+/*
+   File: weldStats.cpp
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+ */
+
+#include <math.h>
+#include "weldStats.h"
+
+// *********************************************************************************************
+RunningStats::RunningStats(void)
+{
+  reset();
+}
+
+// *********************************************************************************************
+// Clear the statistics.
+void RunningStats::reset(void)
+{
+  n      = 0;
+  avg    = 0;
+  m2     = 0;
+  maxVal = 0;
+}
+
+// *********************************************************************************************
+// Add a sample (Welford's update).
+void RunningStats::add(float x)
+{
+  float delta = x - avg;
+
+  n++;
+  avg   += delta / n;
+  m2    += delta * (x - avg);
+  maxVal = (n == 1) || (x > maxVal) ? x : maxVal;
+}
+
+// *********************************************************************************************
+unsigned long RunningStats::count(void) const
+{
+  return n;
+}
+
+// *********************************************************************************************
+float RunningStats::mean(void) const
+{
+  return avg;
+}
+
+// *********************************************************************************************
+// On exit, returns the population standard deviation. Zero if there are less than two samples.
+float RunningStats::stdDev(void) const
+{
+  return n < 2 ? 0 : sqrtf(m2 / n);
+}
+
+// *********************************************************************************************
+float RunningStats::peak(void) const
+{
+  return maxVal;
+}
+
+// *********************************************************************************************
+// Start a new session.
+void WeldStats::begin(void)
+{
+  ampStats.reset();
+  voltStats.reset();
+  arcTime = 0;
+  energy  = 0;
+}
+
+// *********************************************************************************************
+// Add one sample, dt seconds long. arcOn is false while the arc is out or the rod is stuck.
+void WeldStats::add(float volts, float amps, float dt, bool arcOn)
+{
+  energy += (double)(volts * amps * dt);
+
+  if (arcOn) {
+    arcTime += dt;
+    ampStats.add(amps);
+    voltStats.add(volts);
+  }
+}
+
+// *********************************************************************************************
+float WeldStats::arcSec(void) const
+{
+  return (float)(arcTime);
+}
+
+// *********************************************************************************************
+float WeldStats::energyJ(void) const
+{
+  return (float)(energy);
+}
+
+// *********************************************************************************************
+const RunningStats& WeldStats::amps(void) const
+{
+  return ampStats;
+}
+
+// *********************************************************************************************
+const RunningStats& WeldStats::volts(void) const
+{
+  return voltStats;
+}
+
+// *********************************************************************************************
+// On exit, returns the heat input in kJ/mm. Zero if the travel length is unknown (zero).
+float heatInputKjMm(float energyJ, float travelMm, float efficiency)
+{
+  return travelMm <= 0 ? 0 : (efficiency * energyJ) / (1000.0f * travelMm);
+}
+
+// EOF
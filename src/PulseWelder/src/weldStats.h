@@ -0,0 +1,74 @@
+/*
+   File: weldStats.h
+   Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+   Version: 1.4
+   Creation: Oct-16-2026
+   Revised: Oct-16-2026
+   Revision History: See PulseWelder.cpp
+   Project Leader: T. Black (thomastech)
+   Contributors: thomastech, hogthrob
+
+   (c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+   This Code was formatted with the uncrustify extension.
+
+   Notes:
+   1. Weld Session statistics. One session is one rod burn. The statistics are streamed (Welford's method): Each
+      sample updates the count, mean, and sum of squared differences, so the memory used does not depend on the
+      session length and a long session does not lose precision the way a sum of squares does.
+   2. Amps and Volts statistics are only collected while the arc is on. The arc energy (integral of Volts x Amps) is
+      collected for the whole session, so a stuck rod is included.
+   3. Heat input (kJ/mm) is the arc energy divided by the travel (bead) length, times the process thermal efficiency
+      (0.8 for MMA, EN 1011-1).
+   4. This file and weldStats.cpp do not use the Arduino libraries. They can be compiled on a PC, see weldSim.cpp.
+ */
+#ifndef __WELD_STATS_H__
+#define __WELD_STATS_H__
+
+// Streaming mean, standard deviation, and peak of one value.
+class RunningStats {
+public:
+
+  RunningStats(void);
+  void          reset(void);
+  void          add(float x);
+  unsigned long count(void) const;
+  float         mean(void) const;
+  float         stdDev(void) const;
+  float         peak(void) const;
+
+private:
+
+  unsigned long n;      // Number of samples.
+  float         avg;    // Running mean.
+  float         m2;     // Sum of squared differences from the mean.
+  float         maxVal; // Largest sample.
+};
+
+class WeldStats {
+public:
+
+  void                begin(void);
+  void                add(float volts,
+                          float amps,
+                          float dt,
+                          bool  arcOn);
+  float               arcSec(void) const;
+  float               energyJ(void) const;
+  const RunningStats& amps(void) const;
+  const RunningStats& volts(void) const;
+
+private:
+
+  RunningStats ampStats;  // Amps while the arc is on.
+  RunningStats voltStats; // Volts while the arc is on.
+  double       arcTime;   // Arc on time, in seconds. Double for the same reason.
+  double       energy;    // Arc energy, in Joules. A float would lose the small steps of a long session.
+};
+
+float heatInputKjMm(float energyJ,
+                    float travelMm,
+                    float efficiency);
+
+#endif // ifndef __WELD_STATS_H__
+
+// EOF
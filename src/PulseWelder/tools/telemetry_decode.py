@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""
+File: telemetry_decode.py
+Project: ZX7-200 MMA Stick Welder Controller with Pulse Mode.
+Version: 1.4
+Creation: Oct-16-2026
+Revised: Oct-16-2026
+Revision History: See src/PulseWelder.cpp
+
+(c) copyright T. Black 2019-2020, Licensed under GNU GPL 3.0 and later, under this license absolutely no warranty is given.
+
+Decodes the welder's binary Telemetry stream (TELEMETRY_ON in config.h, record layout in src/telemetry.h).
+Each record type is written to its own CSV file (one column per field) in the output folder, and the text log
+messages are written to log.txt. With --parquet (requires pyarrow) Parquet files are written instead of CSV.
+
+Examples:
+  Live capture (requires pyserial):  telemetry_decode.py --port /dev/ttyUSB0 --out weld1
+  Decode a raw capture file:         telemetry_decode.py --file capture.bin --out weld1
+  Raw capture with Linux tools:      stty -F /dev/ttyUSB0 921600 raw && cat /dev/ttyUSB0 > capture.bin
+"""
+
+import argparse
+import csv
+import os
+import struct
+import sys
+
+ARC_STATES = ["Open", "Strike", "Stable", "Short", "Stuck", "Out"]
+
+EVENTS = {1: "Boot", 2: "Stick", 3: "Unstick", 4: "HotStart", 5: "Heat", 6: "Capture"}
+
+SETTINGS = {1: "Amps", 2: "Volume", 3: "PulseSwitch", 4: "PulseFreqX10", 5: "PulseAmpsPc", 6: "ArcSwitch",
+            7: "BleSwitch", 8: "HotStartPc", 9: "HotStartX10", 10: "PulseWave"}
+
+# Record type: (table name, struct format of the body, column names). Keep in step with src/telemetry.h.
+RECORDS = {
+    0x01: ("meas", "<hHBBBB", ["amps", "volts", "wiper", "phase", "state", "flags"]),
+    0x02: ("arc", "<BBIHh", ["state", "prev_state", "prev_us", "volts", "amps"]),
+    0x03: ("settings", "<Bh", ["id", "value"]),
+    0x04: ("events", "<Bi", ["code", "value"]),
+    0x05: ("status", "<III", ["ctrl_dropped", "loop_dropped", "overruns"]),
+}
+
+HEADER = struct.Struct("<BHI")
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    """On exit, returns the decoded bytes, or None if data is not valid COBS."""
+    out = bytearray()
+    idx = 0
+    while idx < len(data):
+        code = data[idx]
+        if code == 0 or idx + code > len(data):
+            return None
+        out += data[idx + 1:idx + code]
+        idx += code
+        if code < 0xFF and idx < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class Decoder:
+    """Splits the stream at the zero delimiters, checks the frames, and collects the records by type."""
+
+    def __init__(self):
+        self.tables = {name: [] for name, _, _ in RECORDS.values()}
+        self.text = bytearray()
+        self.log = []
+        self.pending = bytearray()
+        self.frames = 0
+        self.bad = 0
+        self.gaps = 0
+        self.last_seq = None
+        self.time_hi = 0
+        self.last_us = None
+
+    def feed(self, data):
+        self.pending += data
+        while True:
+            end = self.pending.find(b"\x00")
+            if end < 0:
+                break
+            chunk = bytes(self.pending[:end])
+            del self.pending[:end + 1]
+            if chunk and not self.frame(chunk):
+                self.add_text(chunk)
+
+    def finish(self):
+        """End of stream. Text after the last frame is added to the log."""
+        self.add_text(bytes(self.pending) + b"\n")
+        self.pending = bytearray()
+
+    def frame(self, chunk):
+        rec = cobs_decode(chunk)
+        if rec is None or len(rec) < HEADER.size + 2:
+            return False
+        if crc16(rec[:-2]) != struct.unpack("<H", rec[-2:])[0]:
+            if len(rec) <= HEADER.size + 14:  # Frame sized, but damaged.
+                self.bad += 1
+            return False
+        rtype, seq, time_us = HEADER.unpack_from(rec)
+        body = rec[HEADER.size:-2]
+        if rtype not in RECORDS or len(body) != struct.calcsize(RECORDS[rtype][1]):
+            self.bad += 1
+            return True
+        if self.last_seq is not None and seq != (self.last_seq + 1) & 0xFFFF:
+            self.gaps += (seq - self.last_seq - 1) & 0xFFFF
+        self.last_seq = seq
+        if self.last_us is not None and time_us < self.last_us and self.last_us - time_us > 0x80000000:
+            self.time_hi += 1  # 32 bit uS timer wrapped (every 71 minutes).
+        self.last_us = time_us
+        name, fmt, cols = RECORDS[rtype]
+        row = {"seq": seq, "time_s": ((self.time_hi << 32) + time_us) / 1e6}
+        row.update(zip(cols, struct.unpack(fmt, body)))
+        self.convert(name, row)
+        self.tables[name].append(row)
+        self.frames += 1
+        return True
+
+    @staticmethod
+    def convert(name, row):
+        if "volts" in row:
+            row["volts"] = row["volts"] / 100.0
+        if name in ("meas", "arc"):
+            row["state"] = ARC_STATES[row["state"]] if row["state"] < len(ARC_STATES) else row["state"]
+        if name == "arc":
+            row["prev_state"] = ARC_STATES[row["prev_state"]] if row["prev_state"] < len(ARC_STATES) else row["prev_state"]
+        if name == "settings":
+            row["name"] = SETTINGS.get(row["id"], "Addr%d" % row["id"])
+        if name == "events":
+            row["name"] = EVENTS.get(row["code"], "Event%d" % row["code"])
+
+    def add_text(self, chunk):
+        self.text += chunk
+        while b"\n" in self.text:
+            line, _, rest = bytes(self.text).partition(b"\n")
+            self.text = bytearray(rest)
+            line = line.decode("ascii", "replace").rstrip("\r")
+            if line:
+                self.log.append(line)
+                print(line)
+
+
+def write_tables(dec, out_dir, parquet):
+    os.makedirs(out_dir, exist_ok=True)
+    if parquet:
+        import pyarrow
+        import pyarrow.parquet
+    for name, rows in dec.tables.items():
+        if not rows:
+            continue
+        cols = list(rows[0].keys())
+        if parquet:
+            table = pyarrow.table({col: [row.get(col) for row in rows] for col in cols})
+            pyarrow.parquet.write_table(table, os.path.join(out_dir, name + ".parquet"))
+        else:
+            with open(os.path.join(out_dir, name + ".csv"), "w", newline="") as fh:
+                writer = csv.DictWriter(fh, fieldnames=cols)
+                writer.writeheader()
+                writer.writerows(rows)
+    with open(os.path.join(out_dir, "log.txt"), "w") as fh:
+        fh.write("\n".join(dec.log) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the welder's binary Telemetry stream.")
+    src = parser.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port", help="Serial port to read (requires pyserial). Stop with Ctrl-C.")
+    src.add_argument("--file", help="Raw capture file to decode.")
+    parser.add_argument("--baud", type=int, default=921600, help="Serial baud rate (TELEM_BAUD), default 921600.")
+    parser.add_argument("--out", default="telemetry", help="Output folder, default ./telemetry.")
+    parser.add_argument("--parquet", action="store_true", help="Write Parquet files (requires pyarrow).")
+    args = parser.parse_args()
+
+    dec = Decoder()
+    try:
+        if args.file:
+            with open(args.file, "rb") as fh:
+                for block in iter(lambda: fh.read(65536), b""):
+                    dec.feed(block)
+        else:
+            import serial
+            with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+                while True:
+                    dec.feed(port.read(4096))
+    except KeyboardInterrupt:
+        pass
+    dec.finish()
+
+    write_tables(dec, args.out, args.parquet)
+    dropped = dec.tables["status"][-1] if dec.tables["status"] else {}
+    sys.stderr.write("%d records, %d bad frames, %d lost (sequence gaps), %d dropped on the welder. Output in %s\n" %
+                     (dec.frames, dec.bad, dec.gaps, dropped.get("ctrl_dropped", 0) + dropped.get("loop_dropped", 0),
+                      args.out))
+
+
+if __name__ == "__main__":
+    main()
+
+# EOF